@@ -0,0 +1,906 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include "hook_profile.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <link.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/* Number of stubs, and so of hooks which can be profiled */
+#define PROFILE_SLOTS 1024
+
+/* Counters are allocated in chunks of this many hooks per thread */
+#define PROFILE_CHUNK_SLOTS 64
+
+/* Nesting of profiled calls per thread, deeper calls are only counted */
+#define PROFILE_MAX_DEPTH 64
+
+/* Histogram bucket n counts calls which took less than 2^n ticks */
+#define PROFILE_BUCKETS 40
+
+/* Every this many calls of a thread one is timed, all are counted */
+#define PROFILE_DEFAULT_INTERVAL 16
+
+#define PROFILE_STR_(x) #x
+#define PROFILE_STR(x) PROFILE_STR_(x)
+
+/*
+ * The stubs. Stub n loads n into a scratch register which is not used to
+ * pass arguments and jumps to hook_profile_entry, which saves all argument
+ * registers, calls hook_profile_enter, restores them and jumps to the
+ * hook. hook_profile_enter points the return address of the call to
+ * hook_profile_return, which saves the return value registers and calls
+ * hook_profile_exit to get back the original return address.
+ *
+ * A call is identified by the stack pointer on entry to the stub, which
+ * is the same when the hook returns.
+ */
+#if defined(__x86_64__)
+
+#define PROFILE_STUB_SIZE 16
+
+__asm__(
+    ".text\n"
+    ".balign 16\n"
+    "hook_profile_stubs:\n"
+    ".set hook_profile_n, 0\n"
+    ".rept " PROFILE_STR(PROFILE_SLOTS) "\n"
+    "    movl $hook_profile_n, %r11d\n"
+    "    jmp hook_profile_entry\n"
+    "    .balign 16\n"
+    "    .set hook_profile_n, hook_profile_n + 1\n"
+    ".endr\n"
+
+    /* rsp points to the return address, and is 8 off 16 byte alignment.
+     * rax holds the number of vector registers used by variadic calls */
+    "hook_profile_entry:\n"
+    "    push %rax\n"
+    "    push %rdi\n"
+    "    push %rsi\n"
+    "    push %rdx\n"
+    "    push %rcx\n"
+    "    push %r8\n"
+    "    push %r9\n"
+    "    sub $128, %rsp\n"
+    "    movaps %xmm0, 0(%rsp)\n"
+    "    movaps %xmm1, 16(%rsp)\n"
+    "    movaps %xmm2, 32(%rsp)\n"
+    "    movaps %xmm3, 48(%rsp)\n"
+    "    movaps %xmm4, 64(%rsp)\n"
+    "    movaps %xmm5, 80(%rsp)\n"
+    "    movaps %xmm6, 96(%rsp)\n"
+    "    movaps %xmm7, 112(%rsp)\n"
+    "    mov %r11d, %edi\n"
+    "    lea 184(%rsp), %rsi\n"
+    "    mov %rsi, %rdx\n"
+    "    call hook_profile_enter\n"
+    "    mov %rax, %r11\n"
+    "    movaps 0(%rsp), %xmm0\n"
+    "    movaps 16(%rsp), %xmm1\n"
+    "    movaps 32(%rsp), %xmm2\n"
+    "    movaps 48(%rsp), %xmm3\n"
+    "    movaps 64(%rsp), %xmm4\n"
+    "    movaps 80(%rsp), %xmm5\n"
+    "    movaps 96(%rsp), %xmm6\n"
+    "    movaps 112(%rsp), %xmm7\n"
+    "    add $128, %rsp\n"
+    "    pop %r9\n"
+    "    pop %r8\n"
+    "    pop %rcx\n"
+    "    pop %rdx\n"
+    "    pop %rsi\n"
+    "    pop %rdi\n"
+    "    pop %rax\n"
+    "    jmp *%r11\n"
+
+    /* the return address was popped, rsp is 16 byte aligned */
+    "hook_profile_return:\n"
+    "    push %rax\n"
+    "    push %rdx\n"
+    "    sub $32, %rsp\n"
+    "    movaps %xmm0, 0(%rsp)\n"
+    "    movaps %xmm1, 16(%rsp)\n"
+    "    lea 40(%rsp), %rdi\n"
+    "    call hook_profile_exit\n"
+    "    mov %rax, %r11\n"
+    "    movaps 0(%rsp), %xmm0\n"
+    "    movaps 16(%rsp), %xmm1\n"
+    "    add $32, %rsp\n"
+    "    pop %rdx\n"
+    "    pop %rax\n"
+    "    jmp *%r11\n"
+);
+
+#elif defined(__aarch64__)
+
+#define PROFILE_STUB_SIZE 8
+
+__asm__(
+    ".text\n"
+    ".balign 8\n"
+    "hook_profile_stubs:\n"
+    ".set hook_profile_n, 0\n"
+    ".rept " PROFILE_STR(PROFILE_SLOTS) "\n"
+    "    mov x16, #hook_profile_n\n"
+    "    b hook_profile_entry\n"
+    "    .set hook_profile_n, hook_profile_n + 1\n"
+    ".endr\n"
+
+    /* x8 holds the address of returned structures, x30 the return address */
+    "hook_profile_entry:\n"
+    "    sub sp, sp, #208\n"
+    "    stp x0, x1, [sp, #0]\n"
+    "    stp x2, x3, [sp, #16]\n"
+    "    stp x4, x5, [sp, #32]\n"
+    "    stp x6, x7, [sp, #48]\n"
+    "    stp x8, x30, [sp, #64]\n"
+    "    stp q0, q1, [sp, #80]\n"
+    "    stp q2, q3, [sp, #112]\n"
+    "    stp q4, q5, [sp, #144]\n"
+    "    stp q6, q7, [sp, #176]\n"
+    "    mov w0, w16\n"
+    "    add x1, sp, #208\n"
+    "    add x2, sp, #72\n"
+    "    bl hook_profile_enter\n"
+    "    mov x16, x0\n"
+    "    ldp q6, q7, [sp, #176]\n"
+    "    ldp q4, q5, [sp, #144]\n"
+    "    ldp q2, q3, [sp, #112]\n"
+    "    ldp q0, q1, [sp, #80]\n"
+    "    ldp x8, x30, [sp, #64]\n"
+    "    ldp x6, x7, [sp, #48]\n"
+    "    ldp x4, x5, [sp, #32]\n"
+    "    ldp x2, x3, [sp, #16]\n"
+    "    ldp x0, x1, [sp, #0]\n"
+    "    add sp, sp, #208\n"
+    "    br x16\n"
+
+    "hook_profile_return:\n"
+    "    sub sp, sp, #96\n"
+    "    stp x0, x1, [sp, #0]\n"
+    "    stp q0, q1, [sp, #16]\n"
+    "    stp q2, q3, [sp, #48]\n"
+    "    add x0, sp, #96\n"
+    "    bl hook_profile_exit\n"
+    "    mov x30, x0\n"
+    "    ldp q2, q3, [sp, #48]\n"
+    "    ldp q0, q1, [sp, #16]\n"
+    "    ldp x0, x1, [sp, #0]\n"
+    "    add sp, sp, #96\n"
+    "    ret\n"
+);
+
+#elif defined(__arm__) && __ARM_ARCH >= 7
+
+#define PROFILE_STUB_SIZE 8
+
+#ifdef __ARM_PCS_VFP
+#define PROFILE_VPUSH_ARGS "    vpush {d0-d7}\n"
+#define PROFILE_VPOP_ARGS "    vpop {d0-d7}\n"
+#define PROFILE_VPUSH_RETURN "    vpush {d0-d3}\n"
+#define PROFILE_VPOP_RETURN "    vpop {d0-d3}\n"
+#define PROFILE_VSIZE_ARGS "64"
+#define PROFILE_VSIZE_RETURN "32"
+#else
+#define PROFILE_VPUSH_ARGS ""
+#define PROFILE_VPOP_ARGS ""
+#define PROFILE_VPUSH_RETURN ""
+#define PROFILE_VPOP_RETURN ""
+#define PROFILE_VSIZE_ARGS "0"
+#define PROFILE_VSIZE_RETURN "0"
+#endif
+
+__asm__(
+    ".text\n"
+    ".arm\n"
+    ".balign 8\n"
+    "hook_profile_stubs:\n"
+    ".set hook_profile_n, 0\n"
+    ".rept " PROFILE_STR(PROFILE_SLOTS) "\n"
+    "    movw ip, #hook_profile_n\n"
+    "    b hook_profile_entry\n"
+    "    .set hook_profile_n, hook_profile_n + 1\n"
+    ".endr\n"
+
+    /* six registers keep the stack 8 byte aligned */
+    "hook_profile_entry:\n"
+    "    push {r0-r3, ip, lr}\n"
+    PROFILE_VPUSH_ARGS
+    "    mov r0, ip\n"
+    "    add r1, sp, #(24 + " PROFILE_VSIZE_ARGS ")\n"
+    "    add r2, sp, #(20 + " PROFILE_VSIZE_ARGS ")\n"
+    "    bl hook_profile_enter\n"
+    "    mov ip, r0\n"
+    PROFILE_VPOP_ARGS
+    "    pop {r0-r3}\n"
+    "    add sp, sp, #4\n"
+    "    pop {lr}\n"
+    "    bx ip\n"
+
+    "hook_profile_return:\n"
+    "    push {r0-r3}\n"
+    PROFILE_VPUSH_RETURN
+    "    add r0, sp, #(16 + " PROFILE_VSIZE_RETURN ")\n"
+    "    bl hook_profile_exit\n"
+    "    mov ip, r0\n"
+    PROFILE_VPOP_RETURN
+    "    pop {r0-r3}\n"
+    "    bx ip\n"
+);
+
+#endif
+
+#ifdef PROFILE_STUB_SIZE
+extern char hook_profile_stubs[] __attribute__((visibility("hidden")));
+extern char hook_profile_return[] __attribute__((visibility("hidden")));
+
+void *hook_profile_enter(uint32_t slot, uintptr_t sp, void **return_address)
+    __attribute__((visibility("hidden"), used));
+void *hook_profile_exit(uintptr_t sp)
+    __attribute__((visibility("hidden"), used));
+#endif
+
+struct profile_counters {
+    uint64_t calls;
+    /* time spent in calls which returned */
+    uint64_t ticks;
+    uint64_t histogram[PROFILE_BUCKETS];
+};
+
+struct profile_frame {
+    uintptr_t sp;
+    void *return_address;
+    uint64_t start;
+    uint32_t slot;
+};
+
+/*
+ * Counters of a thread, only written by that thread. Blocks of threads
+ * which exited are reused, keeping their counts.
+ */
+struct profile_thread {
+    struct profile_thread *next;
+    int in_use;
+    unsigned int depth;
+    /* calls until the next one which is timed */
+    unsigned int countdown;
+    struct profile_frame frames[PROFILE_MAX_DEPTH];
+    struct profile_counters *counters[PROFILE_SLOTS / PROFILE_CHUNK_SLOTS];
+};
+
+struct profile_slot {
+    const char *name;
+    void *func;
+};
+
+/* a resolved hook, slot is -1 for hooks which are not profiled */
+struct profile_map_entry {
+    const void *key;
+    int slot;
+};
+
+static int profile_enabled;
+static const char *profile_path;
+static unsigned int profile_interval = PROFILE_DEFAULT_INTERVAL;
+static pthread_once_t profile_once = PTHREAD_ONCE_INIT;
+
+static struct profile_slot profile_slots[PROFILE_SLOTS];
+static unsigned int profile_slot_count;
+static struct profile_map_entry profile_map[4 * PROFILE_SLOTS];
+static pthread_mutex_t profile_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* all thread blocks, new ones are pushed at the head */
+static struct profile_thread *profile_threads;
+static pthread_mutex_t profile_threads_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t profile_key;
+
+/* read on every call, initial-exec avoids a call to __tls_get_addr */
+static __thread struct profile_thread *profile_self __attribute__((tls_model("initial-exec")));
+
+/* ticks and time when profiling started, to convert ticks to time */
+static uint64_t profile_start_ticks;
+static uint64_t profile_start_ns;
+
+/* set while a table is being printed */
+static int profile_dumping;
+
+/* HYBRIS_HOOK_PROFILE_SIGNAL only writes to this pipe, the dump isn't
+ * async-signal-safe: a helper thread reading it does the dump */
+static int profile_signal_pipe[2] = { -1, -1 };
+
+/* hooks which must return to their caller the normal way */
+static const char *const profile_excluded[] = {
+    "setjmp", "_setjmp", "sigsetjmp", "__sigsetjmp", "vfork",
+    "getcontext", "swapcontext", "strtold", "wcstold",
+};
+
+static uint64_t profile_ns()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static inline uint64_t profile_ticks()
+{
+#if defined(__x86_64__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r" (ticks));
+    return ticks;
+#else
+    return profile_ns();
+#endif
+}
+
+static double profile_ns_per_tick()
+{
+#if defined(__aarch64__)
+    uint64_t frequency;
+
+    __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r" (frequency));
+    if (frequency)
+        return 1000000000.0 / frequency;
+    return 1.0;
+#elif defined(__x86_64__)
+    uint64_t ns = profile_ns() - profile_start_ns;
+    uint64_t ticks = profile_ticks() - profile_start_ticks;
+
+    /* too short to be accurate, measure a bit longer */
+    if (ns < 10 * 1000 * 1000) {
+        struct timespec interval = { 0, 10 * 1000 * 1000 };
+
+        nanosleep(&interval, NULL);
+        ns = profile_ns() - profile_start_ns;
+        ticks = profile_ticks() - profile_start_ticks;
+    }
+
+    return ticks ? (double) ns / ticks : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+static void profile_thread_exit(void *data)
+{
+    struct profile_thread *thread = data;
+
+    /* hooks called by later destructors get a new block */
+    profile_self = NULL;
+    __atomic_store_n(&thread->in_use, 0, __ATOMIC_RELEASE);
+}
+
+static int profile_start_signal_thread();
+
+static void profile_atfork_child()
+{
+    struct profile_thread *thread;
+    unsigned int n;
+
+    /* only the forking thread is left, and the child counts its own
+     * calls. Its frames stay, it returns from the fork hook */
+    pthread_mutex_init(&profile_mutex, NULL);
+    pthread_mutex_init(&profile_threads_mutex, NULL);
+    profile_dumping = 0;
+
+    for (thread = profile_threads; thread; thread = thread->next) {
+        if (thread != profile_self) {
+            thread->in_use = 0;
+            thread->depth = 0;
+        }
+
+        for (n = 0; n < PROFILE_SLOTS / PROFILE_CHUNK_SLOTS; n++) {
+            if (thread->counters[n])
+                memset(thread->counters[n], 0, PROFILE_CHUNK_SLOTS * sizeof(struct profile_counters));
+        }
+    }
+
+    /* the helper thread is gone, and the pipe is shared with the parent */
+    if (profile_signal_pipe[0] >= 0) {
+        close(profile_signal_pipe[0]);
+        close(profile_signal_pipe[1]);
+        profile_signal_pipe[0] = profile_signal_pipe[1] = -1;
+        profile_start_signal_thread();
+    }
+}
+
+static void profile_signal(int sig)
+{
+    int saved_errno = errno;
+    char byte = 0;
+    ssize_t r;
+
+    (void) sig;
+
+    /* if the pipe is full, a dump is pending anyway */
+    r = write(profile_signal_pipe[1], &byte, 1);
+    (void) r;
+    errno = saved_errno;
+}
+
+static void *profile_signal_thread(void *data)
+{
+    char byte;
+    ssize_t r;
+
+    (void) data;
+
+    for (;;) {
+        r = read(profile_signal_pipe[0], &byte, 1);
+        if (r > 0)
+            hybris_hook_profile_dump();
+        else if (r == 0 || errno != EINTR)
+            return NULL;
+    }
+}
+
+static int profile_start_signal_thread()
+{
+    pthread_attr_t attr;
+    pthread_t thread;
+    sigset_t all, old;
+    int ret;
+
+    if (pipe2(profile_signal_pipe, O_CLOEXEC) < 0)
+        return -1;
+    fcntl(profile_signal_pipe[1], F_SETFL, O_NONBLOCK);
+
+    /* the signals are for the threads of the application */
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    ret = pthread_create(&thread, &attr, profile_signal_thread, NULL);
+    pthread_attr_destroy(&attr);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    if (ret != 0) {
+        close(profile_signal_pipe[0]);
+        close(profile_signal_pipe[1]);
+        profile_signal_pipe[0] = profile_signal_pipe[1] = -1;
+        errno = ret;
+        return -1;
+    }
+
+    return 0;
+}
+
+static void profile_init()
+{
+    const char *env = getenv("HYBRIS_HOOK_PROFILE");
+
+    if (!env || strcmp(env, "1") != 0)
+        return;
+
+#ifndef PROFILE_STUB_SIZE
+    fprintf(stderr, "libhybris: hook profiling is not supported on this architecture\n");
+    return;
+#endif
+
+    profile_path = getenv("HYBRIS_HOOK_PROFILE_FILE");
+
+    env = getenv("HYBRIS_HOOK_PROFILE_INTERVAL");
+    if (env && atoi(env) > 0)
+        profile_interval = atoi(env);
+
+    profile_start_ns = profile_ns();
+    profile_start_ticks = profile_ticks();
+
+    pthread_key_create(&profile_key, profile_thread_exit);
+    pthread_atfork(NULL, NULL, profile_atfork_child);
+    atexit(hybris_hook_profile_dump);
+
+    env = getenv("HYBRIS_HOOK_PROFILE_SIGNAL");
+    if (env) {
+        struct sigaction action;
+
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = profile_signal;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if (profile_start_signal_thread() < 0 || sigaction(atoi(env), &action, NULL) < 0)
+            fprintf(stderr, "libhybris: can't dump the hook profile on signal %s: %s\n",
+                    env, strerror(errno));
+    }
+
+    profile_enabled = 1;
+}
+
+int hybris_hook_profile_enabled()
+{
+    pthread_once(&profile_once, profile_init);
+    return profile_enabled;
+}
+
+#ifdef PROFILE_STUB_SIZE
+
+static struct profile_thread *profile_register()
+{
+    struct profile_thread *thread;
+
+    pthread_mutex_lock(&profile_threads_mutex);
+
+    for (thread = profile_threads; thread; thread = thread->next) {
+        if (!__atomic_load_n(&thread->in_use, __ATOMIC_ACQUIRE))
+            break;
+    }
+
+    if (!thread) {
+        thread = calloc(1, sizeof(*thread));
+        if (!thread) {
+            pthread_mutex_unlock(&profile_threads_mutex);
+            return NULL;
+        }
+        thread->next = profile_threads;
+        __atomic_store_n(&profile_threads, thread, __ATOMIC_RELEASE);
+    }
+
+    thread->depth = 0;
+    thread->countdown = 1;
+    __atomic_store_n(&thread->in_use, 1, __ATOMIC_RELEASE);
+
+    pthread_mutex_unlock(&profile_threads_mutex);
+
+    pthread_setspecific(profile_key, thread);
+    profile_self = thread;
+
+    return thread;
+}
+
+static struct profile_counters *profile_counters(struct profile_thread *thread, uint32_t slot)
+{
+    struct profile_counters *chunk = thread->counters[slot / PROFILE_CHUNK_SLOTS];
+
+    if (__builtin_expect(!chunk, 0)) {
+        chunk = calloc(PROFILE_CHUNK_SLOTS, sizeof(struct profile_counters));
+        if (!chunk)
+            return NULL;
+        __atomic_store_n(&thread->counters[slot / PROFILE_CHUNK_SLOTS], chunk, __ATOMIC_RELEASE);
+    }
+
+    return &chunk[slot % PROFILE_CHUNK_SLOTS];
+}
+
+void *hook_profile_enter(uint32_t slot, uintptr_t sp, void **return_address)
+{
+    struct profile_thread *thread = profile_self;
+    struct profile_counters *counters;
+    struct profile_frame *frame;
+    unsigned int depth;
+
+    if (__builtin_expect(!thread, 0)) {
+        thread = profile_register();
+        if (!thread)
+            return profile_slots[slot].func;
+    }
+
+    counters = profile_counters(thread, slot);
+    if (!counters)
+        return profile_slots[slot].func;
+
+    __atomic_store_n(&counters->calls, counters->calls + 1, __ATOMIC_RELAXED);
+
+    /* reading the clock costs more than the rest, most calls are only
+     * counted and go straight to the hook */
+    if (--thread->countdown != 0)
+        return profile_slots[slot].func;
+    thread->countdown = profile_interval;
+
+    /* frames at the same stack address are left from calls which were
+     * jumped out of with longjmp */
+    depth = thread->depth;
+    while (depth > 0 && thread->frames[depth - 1].sp == sp)
+        depth--;
+
+    if (depth == PROFILE_MAX_DEPTH) {
+        thread->depth = depth;
+        return profile_slots[slot].func;
+    }
+
+    frame = &thread->frames[depth];
+    frame->sp = sp;
+    frame->return_address = *return_address;
+    frame->slot = slot;
+
+    /* a signal handler calling hooks from here on pushes its frames
+     * above this one */
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    thread->depth = depth + 1;
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+
+    *return_address = hook_profile_return;
+    frame->start = profile_ticks();
+
+    return profile_slots[slot].func;
+}
+
+void *hook_profile_exit(uintptr_t sp)
+{
+    uint64_t end = profile_ticks();
+    struct profile_thread *thread = profile_self;
+    struct profile_counters *counters;
+    struct profile_frame *frame;
+    unsigned int depth, bucket;
+    uint64_t ticks;
+
+    /* frames above the one returning were jumped out of with longjmp */
+    for (depth = thread ? thread->depth : 0; depth > 0; depth--) {
+        if (thread->frames[depth - 1].sp == sp)
+            break;
+    }
+
+    if (depth == 0) {
+        fprintf(stderr, "libhybris: hook profiler lost the return address of a call\n");
+        abort();
+    }
+
+    frame = &thread->frames[depth - 1];
+    ticks = end - frame->start;
+    counters = &thread->counters[frame->slot / PROFILE_CHUNK_SLOTS][frame->slot % PROFILE_CHUNK_SLOTS];
+
+    bucket = ticks ? 64 - __builtin_clzll(ticks) : 0;
+    if (bucket >= PROFILE_BUCKETS)
+        bucket = PROFILE_BUCKETS - 1;
+
+    __atomic_store_n(&counters->ticks, counters->ticks + ticks, __ATOMIC_RELAXED);
+    __atomic_store_n(&counters->histogram[bucket], counters->histogram[bucket] + 1, __ATOMIC_RELAXED);
+
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    thread->depth = depth - 1;
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+
+    return frame->return_address;
+}
+
+struct profile_find_code {
+    uintptr_t address;
+    int found;
+};
+
+static int profile_find_code_cb(struct dl_phdr_info *info, size_t size, void *data)
+{
+    struct profile_find_code *find = data;
+    int n;
+
+    (void) size;
+
+    for (n = 0; n < info->dlpi_phnum; n++) {
+        const ElfW(Phdr) *phdr = &info->dlpi_phdr[n];
+        uintptr_t start = info->dlpi_addr + phdr->p_vaddr;
+
+        if (phdr->p_type != PT_LOAD ||
+            find->address < start || find->address - start >= phdr->p_memsz)
+            continue;
+
+        find->found = (phdr->p_flags & PF_X) != 0 ? 1 : -1;
+        return 1;
+    }
+
+    return 0;
+}
+
+/* Some hooks are variables, only functions can be profiled */
+static int profile_is_code(void *func)
+{
+    struct profile_find_code find = { (uintptr_t) func, 0 };
+
+    dl_iterate_phdr(profile_find_code_cb, &find);
+
+    return find.found > 0;
+}
+
+static int profile_new_slot(const char *name, void *func)
+{
+    size_t n;
+
+    for (n = 0; n < sizeof(profile_excluded) / sizeof(profile_excluded[0]); n++) {
+        if (strcmp(name, profile_excluded[n]) == 0)
+            return -1;
+    }
+
+    if (profile_slot_count == PROFILE_SLOTS || !profile_is_code(func))
+        return -1;
+
+    profile_slots[profile_slot_count].name = name;
+    profile_slots[profile_slot_count].func = func;
+
+    return profile_slot_count++;
+}
+
+#endif
+
+void *hybris_hook_profile_wrap(const void *key, const char *name, void *func)
+{
+#ifdef PROFILE_STUB_SIZE
+    const size_t mask = sizeof(profile_map) / sizeof(profile_map[0]) - 1;
+    size_t n;
+    int slot;
+
+    if (!hybris_hook_profile_enabled() || !func)
+        return func;
+
+    pthread_mutex_lock(&profile_mutex);
+
+    for (n = ((uintptr_t) key >> 3) & mask; profile_map[n].key; n = (n + 1) & mask) {
+        if (profile_map[n].key == key)
+            break;
+    }
+
+    if (!profile_map[n].key) {
+        profile_map[n].key = key;
+        profile_map[n].slot = profile_new_slot(name, func);
+    }
+    slot = profile_map[n].slot;
+
+    pthread_mutex_unlock(&profile_mutex);
+
+    if (slot >= 0)
+        return hook_profile_stubs + slot * PROFILE_STUB_SIZE;
+#else
+    (void) key;
+    (void) name;
+#endif
+
+    return func;
+}
+
+struct profile_row {
+    const char *name;
+    uint64_t calls;
+    /* calls which were timed */
+    uint64_t returns;
+    uint64_t ticks;
+    /* time of all calls, estimated from the timed ones */
+    double total_ticks;
+    uint64_t histogram[PROFILE_BUCKETS];
+};
+
+static struct profile_row profile_rows[PROFILE_SLOTS];
+
+static int profile_row_compare(const void *a, const void *b)
+{
+    const struct profile_row *row_a = a, *row_b = b;
+
+    if (row_a->total_ticks != row_b->total_ticks)
+        return row_a->total_ticks < row_b->total_ticks ? 1 : -1;
+    if (row_a->calls != row_b->calls)
+        return row_a->calls < row_b->calls ? 1 : -1;
+    return strcmp(row_a->name, row_b->name);
+}
+
+/* Upper bound of the bucket holding the given fraction of the calls, in ns */
+static double profile_percentile(const struct profile_row *row, double fraction, double ns_per_tick)
+{
+    uint64_t count = 0, wanted = row->returns * fraction;
+    unsigned int bucket;
+
+    if (wanted == 0)
+        wanted = 1;
+
+    for (bucket = 0; bucket < PROFILE_BUCKETS; bucket++) {
+        count += row->histogram[bucket];
+        if (count >= wanted)
+            break;
+    }
+
+    if (bucket >= PROFILE_BUCKETS)
+        bucket = PROFILE_BUCKETS - 1;
+
+    return (double) (1ULL << bucket) * ns_per_tick;
+}
+
+void hybris_hook_profile_dump()
+{
+#ifdef PROFILE_STUB_SIZE
+    unsigned int slot_count = profile_slot_count, rows = 0, n, i;
+    struct profile_thread *thread;
+    double ns_per_tick;
+    int fd = 2;
+
+    if (!profile_enabled || __atomic_exchange_n(&profile_dumping, 1, __ATOMIC_ACQUIRE))
+        return;
+
+    for (n = 0; n < slot_count; n++) {
+        struct profile_row *row = &profile_rows[rows];
+
+        memset(row, 0, sizeof(*row));
+        row->name = profile_slots[n].name;
+
+        for (thread = __atomic_load_n(&profile_threads, __ATOMIC_ACQUIRE); thread; thread = thread->next) {
+            struct profile_counters *chunk =
+                __atomic_load_n(&thread->counters[n / PROFILE_CHUNK_SLOTS], __ATOMIC_ACQUIRE);
+            struct profile_counters *counters;
+
+            if (!chunk)
+                continue;
+
+            counters = &chunk[n % PROFILE_CHUNK_SLOTS];
+            row->calls += __atomic_load_n(&counters->calls, __ATOMIC_RELAXED);
+            row->ticks += __atomic_load_n(&counters->ticks, __ATOMIC_RELAXED);
+            for (i = 0; i < PROFILE_BUCKETS; i++) {
+                uint64_t count = __atomic_load_n(&counters->histogram[i], __ATOMIC_RELAXED);
+
+                row->histogram[i] += count;
+                row->returns += count;
+            }
+        }
+
+        if (row->returns)
+            row->total_ticks = (double) row->ticks * row->calls / row->returns;
+        if (row->calls)
+            rows++;
+    }
+
+    qsort(profile_rows, rows, sizeof(struct profile_row), profile_row_compare);
+    ns_per_tick = profile_ns_per_tick();
+
+    if (profile_path) {
+        fd = open(profile_path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0)
+            fd = 2;
+    }
+
+    dprintf(fd, "libhybris: hook profile of process %d, %u hooks called\n", (int) getpid(), rows);
+    dprintf(fd, "%-32s %12s %10s %12s %10s %10s %10s %10s\n",
+            "hook", "calls", "timed", "total ms", "avg ns", "p50 ns", "p99 ns", "max ns");
+
+    for (n = 0; n < rows; n++) {
+        const struct profile_row *row = &profile_rows[n];
+        unsigned int max;
+
+        if (!row->returns) {
+            /* not timed yet, or the hook never returned, like exit */
+            dprintf(fd, "%-32s %12llu %10s %12s %10s %10s %10s %10s\n", row->name,
+                    (unsigned long long) row->calls, "0", "-", "-", "-", "-", "-");
+            continue;
+        }
+
+        for (max = PROFILE_BUCKETS - 1; max > 0 && !row->histogram[max]; max--)
+            ;
+
+        dprintf(fd, "%-32s %12llu %10llu %12.3f %10.1f %10.0f %10.0f %10.0f\n", row->name,
+                (unsigned long long) row->calls, (unsigned long long) row->returns,
+                row->total_ticks * ns_per_tick / 1000000.0,
+                row->ticks * ns_per_tick / row->returns,
+                profile_percentile(row, 0.5, ns_per_tick),
+                profile_percentile(row, 0.99, ns_per_tick),
+                (double) (1ULL << max) * ns_per_tick);
+    }
+
+    if (fd != 2)
+        close(fd);
+
+    __atomic_store_n(&profile_dumping, 0, __ATOMIC_RELEASE);
+#endif
+}
+
+// vim: noai:ts=4:sw=4:ss=4:expandtab
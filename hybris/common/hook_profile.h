@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef HYBRIS_HOOK_PROFILE_H
+#define HYBRIS_HOOK_PROFILE_H
+
+/*
+ * Hook profiler, enabled with HYBRIS_HOOK_PROFILE=1.
+ *
+ * When a symbol is resolved to a hook, the hook is replaced by a small
+ * stub which counts the call and jumps to the hook. Every 16th call of a
+ * thread (HYBRIS_HOOK_PROFILE_INTERVAL) is timed as well: its return
+ * address is diverted through a return stub, which adds the time spent in
+ * the hook to a log2 histogram. Counters and histograms are
+ * kept per thread and summed up when the table is printed, which happens
+ * at exit and, with HYBRIS_HOOK_PROFILE_SIGNAL=<signal number>, whenever
+ * the process receives that signal: the handler wakes up a helper thread
+ * which prints it. The table goes to stderr, or is appended to
+ * HYBRIS_HOOK_PROFILE_FILE.
+ *
+ * Only x86_64, ARMv7 and aarch64 have the stubs, elsewhere the hooks are
+ * left alone. Hooks which return twice (setjmp), share their stack with
+ * another process (vfork) or return in x87 registers are not profiled.
+ * Stack unwinding through a profiled hook, as done by C++ exceptions
+ * thrown from callbacks or by backtrace(), stops at the return stub.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Returns nonzero if HYBRIS_HOOK_PROFILE is set */
+int hybris_hook_profile_enabled();
+
+/*
+ * Returns the stub profiling func, which is the hook of symbol name. key
+ * identifies the hook, resolving the same key again returns the same
+ * stub. Returns func itself if it can't be profiled.
+ */
+void *hybris_hook_profile_wrap(const void *key, const char *name, void *func);
+
+/* Prints the table of the hooks called so far */
+void hybris_hook_profile_dump();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HYBRIS_HOOK_PROFILE_H */
+// vim: noai:ts=4:sw=4:ss=4:expandtab
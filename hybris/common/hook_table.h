@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef HYBRIS_HOOK_TABLE_H
+#define HYBRIS_HOOK_TABLE_H
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * The hooks of libhybris as an open addressing hash table, keyed by the
+ * GNU hash of the symbol name (the same hash the linker computes for
+ * DT_GNU_HASH lookups). hooks.c builds it and hands it to the linker with
+ * android_linker_set_hook_table, so that the linker can look up the
+ * symbols it relocates without calling back into libhybris: most of the
+ * symbols of a library aren't hooked, and for those a lookup usually
+ * ends at the first, empty slot.
+ *
+ * The table can't answer for itself while use_callback is set: a
+ * context specific hook callback is registered, hooks are profiled or
+ * debug logging is on. The linker then calls get_hooked_symbol for every
+ * symbol, as it does with linkers which don't take the table.
+ */
+
+struct hybris_hook_slot {
+    uint32_t hash;
+    const char *name;   /* NULL if the slot is empty */
+    void *func;         /* the hook, or its tracing variant */
+    const void *hook;   /* private to hooks.c */
+};
+
+struct hybris_hook_table {
+    struct hybris_hook_slot *slots;
+    uint32_t mask;      /* number of slots - 1 */
+    int use_callback;   /* accessed atomically */
+};
+
+static inline uint32_t hybris_hook_hash(const char *name)
+{
+    /* no casts: the linker includes this and builds with -Wold-style-cast */
+    unsigned char c;
+    uint32_t h = 5381;
+
+    while ((c = *name++) != 0)
+        h += (h << 5) + c; /* h*33 + c = h + h * 32 + c = h + h << 5 + c */
+
+    return h;
+}
+
+static inline const struct hybris_hook_slot *
+hybris_hook_table_find(const struct hybris_hook_table *table, const char *name, uint32_t hash)
+{
+    uint32_t n;
+
+    for (n = hash & table->mask; table->slots[n].name != NULL; n = (n + 1) & table->mask) {
+        if (table->slots[n].hash == hash && strcmp(table->slots[n].name, name) == 0)
+            return &table->slots[n];
+    }
+
+    return NULL;
+}
+
+/*
+ * Symbols which aren't in the table still go through get_hooked_symbol
+ * if this returns nonzero: unhooked pthread functions get a fake address
+ * there, which makes calls to them easy to spot.
+ */
+static inline int hybris_hook_table_miss_needs_callback(const char *name)
+{
+    return strncmp(name, "pthread", 7) == 0 || strncmp(name, "__pthread", 9) == 0;
+}
+
+#endif /* HYBRIS_HOOK_TABLE_H */
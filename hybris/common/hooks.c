@@ -72,11 +72,14 @@
 #include <hybris/properties/properties.h>
 #include <hybris/common/hooks.h>
 
+#include "hook_table.h"
+
 static locale_t hybris_locale;
 static int locale_inited = 0;
 static hybris_hook_cb hook_callback = NULL;
 
 static void (*_android_linker_init)(int sdk_version, void* (*get_hooked_symbol)(const char*, const char*)) = NULL;
+static void (*_android_linker_set_hook_table)(const struct hybris_hook_table *table) = NULL;
 static void* (*_android_dlopen)(const char *filename, int flags) = NULL;
 static void* (*_android_dlsym)(void *handle, const char *symbol) = NULL;
 static void* (*_android_dladdr)(void *addr, Dl_info *info) = NULL;
@@ -113,6 +116,7 @@ static const char* (*_android_dlerror)(void) = NULL;
 
 /* Debug */
 #include "logging.h"
+#include "hook_profile.h"
 #define LOGD(message, ...) HYBRIS_DEBUG_LOG(HOOKS, message, ##__VA_ARGS__)
 
 #define TRACE_HOOK(message, ...) \
@@ -244,31 +248,225 @@ static void hybris_set_mutex_attr(unsigned int android_value, pthread_mutexattr_
     }
 }
 
-static pthread_mutex_t* hybris_alloc_init_mutex(unsigned int android_mutex)
+/*
+ * Shadow objects
+ *
+ * A bionic mutex, cond or rwlock only holds a pointer to the glibc object
+ * doing the actual work (or an shm handle for process-shared ones, or the
+ * bionic static initializer value until first use). The glibc objects
+ * live in a slab of cache line sized slots so that two hot locks never
+ * share a cache line.
+ *
+ * Statically initialized locks get their object on first use. Threads
+ * racing on that first use install their object with a CAS and the
+ * losers throw theirs away, so everybody ends up with the same one.
+ */
+
+#define HYBRIS_SHADOW_ALIGN      64
+#define HYBRIS_SHADOW_CHUNK_SIZE (64 * 1024)
+
+union hybris_shadow_slot {
+    union hybris_shadow_slot *next;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    pthread_rwlock_t rwlock;
+} __attribute__((aligned(HYBRIS_SHADOW_ALIGN)));
+
+#define HYBRIS_SHADOW_SLOTS_PER_CHUNK \
+        (HYBRIS_SHADOW_CHUNK_SIZE / sizeof(union hybris_shadow_slot))
+
+static pthread_mutex_t shadow_lock = PTHREAD_MUTEX_INITIALIZER;
+/* the first slot of every chunk links to the previous chunk */
+static union hybris_shadow_slot *shadow_chunks = NULL;
+static union hybris_shadow_slot *shadow_free = NULL;
+static union hybris_shadow_slot *shadow_next = NULL;
+static union hybris_shadow_slot *shadow_end = NULL;
+static pthread_once_t shadow_atfork_once = PTHREAD_ONCE_INIT;
+
+/* A thread forking while another one holds shadow_lock would leave the
+ * child without a way to create its first lock, so hold it across fork */
+static void hybris_shadow_atfork_prepare(void)
+{
+    pthread_mutex_lock(&shadow_lock);
+}
+
+static void hybris_shadow_atfork_parent(void)
 {
-    pthread_mutex_t *realmutex = malloc(sizeof(pthread_mutex_t));
+    pthread_mutex_unlock(&shadow_lock);
+}
+
+static void hybris_shadow_atfork_child(void)
+{
+    pthread_mutex_init(&shadow_lock, NULL);
+}
+
+static void hybris_shadow_atfork_init(void)
+{
+    pthread_atfork(hybris_shadow_atfork_prepare, hybris_shadow_atfork_parent,
+            hybris_shadow_atfork_child);
+}
+
+static void *hybris_shadow_alloc(void)
+{
+    union hybris_shadow_slot *slot;
+
+    pthread_once(&shadow_atfork_once, hybris_shadow_atfork_init);
+    pthread_mutex_lock(&shadow_lock);
+
+    slot = shadow_free;
+    if (slot) {
+        shadow_free = slot->next;
+    } else {
+        if (shadow_next == shadow_end) {
+            union hybris_shadow_slot *chunk = mmap(NULL, HYBRIS_SHADOW_CHUNK_SIZE,
+                    PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (chunk == MAP_FAILED) {
+                pthread_mutex_unlock(&shadow_lock);
+                fprintf(stderr, "%s: failed to allocate shadow objects: %s\n",
+                        __FUNCTION__, strerror(errno));
+                abort();
+            }
+
+            chunk->next = shadow_chunks;
+            shadow_chunks = chunk;
+            shadow_next = chunk + 1;
+            shadow_end = chunk + HYBRIS_SHADOW_SLOTS_PER_CHUNK;
+        }
+        slot = shadow_next++;
+    }
+
+    pthread_mutex_unlock(&shadow_lock);
+
+    return slot;
+}
+
+static void hybris_shadow_free(void *ptr)
+{
+    union hybris_shadow_slot *slot = ptr;
+    union hybris_shadow_slot *chunk;
+
+    pthread_mutex_lock(&shadow_lock);
+
+    for (chunk = shadow_chunks; chunk; chunk = chunk->next) {
+        if (slot > chunk && slot < chunk + HYBRIS_SHADOW_SLOTS_PER_CHUNK &&
+                ((uintptr_t) slot - (uintptr_t) chunk) % sizeof(*slot) == 0) {
+            slot->next = shadow_free;
+            shadow_free = slot;
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&shadow_lock);
+
+    if (!chunk)
+        LOGD("%p is not a shadow object, not freeing it", ptr);
+}
+
+static inline uintptr_t hybris_get_lock_word(const void *lock)
+{
+    /* pairs with the CAS publishing a new shadow object */
+    return __atomic_load_n((const uintptr_t *) lock, __ATOMIC_ACQUIRE);
+}
+
+/* Installs a new shadow object unless another thread was faster, returns
+ * the new value of the bionic lock either way */
+static uintptr_t hybris_install_shadow(void *lock, uintptr_t android_value, void *shadow)
+{
+    return __sync_val_compare_and_swap((uintptr_t *) lock, android_value, (uintptr_t) shadow);
+}
+
+static uintptr_t hybris_alloc_init_mutex(pthread_mutex_t *mutex, uintptr_t android_mutex)
+{
+    pthread_mutex_t *realmutex = hybris_shadow_alloc();
     pthread_mutexattr_t attr;
+    uintptr_t value;
+
     hybris_set_mutex_attr(android_mutex, &attr);
     pthread_mutex_init(realmutex, &attr);
-    return realmutex;
+    pthread_mutexattr_destroy(&attr);
+
+    value = hybris_install_shadow(mutex, android_mutex, realmutex);
+    if (value != android_mutex) {
+        pthread_mutex_destroy(realmutex);
+        hybris_shadow_free(realmutex);
+        return value;
+    }
+
+    return (uintptr_t) realmutex;
 }
 
-static pthread_cond_t* hybris_alloc_init_cond(void)
+static uintptr_t hybris_alloc_init_cond(pthread_cond_t *cond, uintptr_t android_cond)
 {
-    pthread_cond_t *realcond = malloc(sizeof(pthread_cond_t));
-    pthread_condattr_t attr;
-    pthread_condattr_init(&attr);
-    pthread_cond_init(realcond, &attr);
-    return realcond;
+    pthread_cond_t *realcond = hybris_shadow_alloc();
+    uintptr_t value;
+
+    pthread_cond_init(realcond, NULL);
+
+    value = hybris_install_shadow(cond, android_cond, realcond);
+    if (value != android_cond) {
+        pthread_cond_destroy(realcond);
+        hybris_shadow_free(realcond);
+        return value;
+    }
+
+    return (uintptr_t) realcond;
+}
+
+static uintptr_t hybris_alloc_init_rwlock(pthread_rwlock_t *rwlock, uintptr_t android_rwlock)
+{
+    pthread_rwlock_t *realrwlock = hybris_shadow_alloc();
+    uintptr_t value;
+
+    pthread_rwlock_init(realrwlock, NULL);
+
+    value = hybris_install_shadow(rwlock, android_rwlock, realrwlock);
+    if (value != android_rwlock) {
+        pthread_rwlock_destroy(realrwlock);
+        hybris_shadow_free(realrwlock);
+        return value;
+    }
+
+    return (uintptr_t) realrwlock;
+}
+
+/*
+ * Map the value of a bionic lock to the glibc object behind it, creating
+ * that first if the lock is still statically initialized. Callers have
+ * already ruled out locks shared with Android.
+ */
+static inline pthread_mutex_t *hybris_get_realmutex(pthread_mutex_t *mutex, uintptr_t value)
+{
+    if (value <= ANDROID_TOP_ADDR_VALUE_MUTEX)
+        value = hybris_alloc_init_mutex(mutex, value);
+
+    if (hybris_is_pointer_in_shm((void*)value))
+        return (pthread_mutex_t *)hybris_get_shmpointer((hybris_shm_pointer_t)value);
+
+    return (pthread_mutex_t *) value;
+}
+
+static inline pthread_cond_t *hybris_get_realcond(pthread_cond_t *cond, uintptr_t value)
+{
+    if (value <= ANDROID_TOP_ADDR_VALUE_COND)
+        value = hybris_alloc_init_cond(cond, value);
+
+    if (hybris_is_pointer_in_shm((void*)value))
+        return (pthread_cond_t *)hybris_get_shmpointer((hybris_shm_pointer_t)value);
+
+    return (pthread_cond_t *) value;
 }
 
-static pthread_rwlock_t* hybris_alloc_init_rwlock(void)
+static inline pthread_rwlock_t *hybris_get_realrwlock(pthread_rwlock_t *rwlock)
 {
-    pthread_rwlock_t *realrwlock = malloc(sizeof(pthread_rwlock_t));
-    pthread_rwlockattr_t attr;
-    pthread_rwlockattr_init(&attr);
-    pthread_rwlock_init(realrwlock, &attr);
-    return realrwlock;
+    uintptr_t value = hybris_get_lock_word(rwlock);
+
+    if (value <= ANDROID_TOP_ADDR_VALUE_RWLOCK)
+        value = hybris_alloc_init_rwlock(rwlock, value);
+
+    if (hybris_is_pointer_in_shm((void*)value))
+        return (pthread_rwlock_t *)hybris_get_shmpointer((hybris_shm_pointer_t)value);
+
+    return (pthread_rwlock_t *) value;
 }
 
 /*
@@ -598,8 +796,8 @@ static int _hybris_hook_pthread_mutex_init(pthread_mutex_t *__mutex,
         pthread_mutexattr_getpshared(__mutexattr, &pshared);
 
     if (!pshared) {
-        /* non shared, standard mutex: use malloc */
-        realmutex = malloc(sizeof(pthread_mutex_t));
+        /* non shared, standard mutex: use a shadow object */
+        realmutex = hybris_shadow_alloc();
 
         *((uintptr_t *)__mutex) = (uintptr_t) realmutex;
     }
@@ -632,11 +830,13 @@ static int _hybris_hook_pthread_mutex_destroy(pthread_mutex_t *__mutex)
 
     if (!hybris_is_pointer_in_shm((void*)realmutex)) {
         ret = pthread_mutex_destroy(realmutex);
-        free(realmutex);
+        hybris_shadow_free(realmutex);
     }
     else {
-        realmutex = (pthread_mutex_t *)hybris_get_shmpointer((hybris_shm_pointer_t)realmutex);
+        hybris_shm_pointer_t handle = (hybris_shm_pointer_t) realmutex;
+        realmutex = (pthread_mutex_t *)hybris_get_shmpointer(handle);
         ret = pthread_mutex_destroy(realmutex);
+        hybris_shm_free(handle, sizeof(pthread_mutex_t));
     }
 
     *((uintptr_t *)__mutex) = 0;
@@ -653,29 +853,20 @@ static int _hybris_hook_pthread_mutex_lock(pthread_mutex_t *__mutex)
         return 0;
     }
 
-    uintptr_t value = (*(uintptr_t *) __mutex);
+    uintptr_t value = hybris_get_lock_word(__mutex);
     if (hybris_check_android_shared_mutex(value)) {
         LOGD("Shared mutex with Android, not locking.");
         return 0;
     }
 
-    pthread_mutex_t *realmutex = (pthread_mutex_t *) value;
-    if (hybris_is_pointer_in_shm((void*)value))
-        realmutex = (pthread_mutex_t *)hybris_get_shmpointer((hybris_shm_pointer_t)value);
-
-    if (value <= ANDROID_TOP_ADDR_VALUE_MUTEX) {
-        TRACE("value %p <= ANDROID_TOP_ADDR_VALUE_MUTEX 0x%x",
-              (void*) value, ANDROID_TOP_ADDR_VALUE_MUTEX);
-        realmutex = hybris_alloc_init_mutex(value);
-        *((uintptr_t *)__mutex) = (uintptr_t) realmutex;
-    }
+    pthread_mutex_t *realmutex = hybris_get_realmutex(__mutex, value);
 
     return pthread_mutex_lock(realmutex);
 }
 
 static int _hybris_hook_pthread_mutex_trylock(pthread_mutex_t *__mutex)
 {
-    uintptr_t value = (*(uintptr_t *) __mutex);
+    uintptr_t value = hybris_get_lock_word(__mutex);
 
     TRACE_HOOK("mutex %p", __mutex);
 
@@ -684,14 +875,7 @@ static int _hybris_hook_pthread_mutex_trylock(pthread_mutex_t *__mutex)
         return 0;
     }
 
-    pthread_mutex_t *realmutex = (pthread_mutex_t *) value;
-    if (hybris_is_pointer_in_shm((void*)value))
-        realmutex = (pthread_mutex_t *)hybris_get_shmpointer((hybris_shm_pointer_t)value);
-
-    if (value <= ANDROID_TOP_ADDR_VALUE_MUTEX) {
-        realmutex = hybris_alloc_init_mutex(value);
-        *((uintptr_t *)__mutex) = (uintptr_t) realmutex;
-    }
+    pthread_mutex_t *realmutex = hybris_get_realmutex(__mutex, value);
 
     return pthread_mutex_trylock(realmutex);
 }
@@ -705,7 +889,7 @@ static int _hybris_hook_pthread_mutex_unlock(pthread_mutex_t *__mutex)
         return 0;
     }
 
-    uintptr_t value = (*(uintptr_t *) __mutex);
+    uintptr_t value = hybris_get_lock_word(__mutex);
     if (hybris_check_android_shared_mutex(value)) {
         LOGD("Shared mutex with Android, not unlocking.");
         return 0;
@@ -728,7 +912,7 @@ static int _hybris_hook_pthread_mutex_lock_timeout_np(pthread_mutex_t *__mutex,
 {
     struct timespec tv;
     pthread_mutex_t *realmutex;
-    uintptr_t value = (*(uintptr_t *) __mutex);
+    uintptr_t value = hybris_get_lock_word(__mutex);
 
     TRACE_HOOK("mutex %p msecs %u", __mutex, __msecs);
 
@@ -737,12 +921,7 @@ static int _hybris_hook_pthread_mutex_lock_timeout_np(pthread_mutex_t *__mutex,
         return 0;
     }
 
-    realmutex = (pthread_mutex_t *) value;
-
-    if (value <= ANDROID_TOP_ADDR_VALUE_MUTEX) {
-        realmutex = hybris_alloc_init_mutex(value);
-        *((uintptr_t *)__mutex) = (uintptr_t) realmutex;
-    }
+    realmutex = hybris_get_realmutex(__mutex, value);
 
     clock_gettime(CLOCK_REALTIME, &tv);
     tv.tv_sec += __msecs/1000;
@@ -765,17 +944,13 @@ static int _hybris_hook_pthread_mutex_timedlock(pthread_mutex_t *__mutex,
         return 0;
     }
 
-    uintptr_t value = (*(uintptr_t *) __mutex);
+    uintptr_t value = hybris_get_lock_word(__mutex);
     if (hybris_check_android_shared_mutex(value)) {
         LOGD("Shared mutex with Android, not lock timeout np.");
         return 0;
     }
 
-    pthread_mutex_t *realmutex = (pthread_mutex_t *) value;
-    if (value <= ANDROID_TOP_ADDR_VALUE_MUTEX) {
-        realmutex = hybris_alloc_init_mutex(value);
-        *((uintptr_t *)__mutex) = (uintptr_t) realmutex;
-    }
+    pthread_mutex_t *realmutex = hybris_get_realmutex(__mutex, value);
 
     return pthread_mutex_timedlock(realmutex, __abs_timeout);
 }
@@ -809,8 +984,8 @@ static int _hybris_hook_pthread_cond_init(pthread_cond_t *cond,
         pthread_condattr_getpshared(attr, &pshared);
 
     if (!pshared) {
-        /* non shared, standard cond: use malloc */
-        realcond = malloc(sizeof(pthread_cond_t));
+        /* non shared, standard cond: use a shadow object */
+        realcond = hybris_shadow_alloc();
 
         *((uintptr_t *) cond) = (uintptr_t) realcond;
     }
@@ -840,11 +1015,13 @@ static int _hybris_hook_pthread_cond_destroy(pthread_cond_t *cond)
 
     if (!hybris_is_pointer_in_shm((void*)realcond)) {
         ret = pthread_cond_destroy(realcond);
-        free(realcond);
+        hybris_shadow_free(realcond);
     }
     else {
-        realcond = (pthread_cond_t *)hybris_get_shmpointer((hybris_shm_pointer_t)realcond);
+        hybris_shm_pointer_t handle = (hybris_shm_pointer_t) realcond;
+        realcond = (pthread_cond_t *)hybris_get_shmpointer(handle);
         ret = pthread_cond_destroy(realcond);
+        hybris_shm_free(handle, sizeof(pthread_cond_t));
     }
 
     *((uintptr_t *)cond) = 0;
@@ -854,7 +1031,7 @@ static int _hybris_hook_pthread_cond_destroy(pthread_cond_t *cond)
 
 static int _hybris_hook_pthread_cond_broadcast(pthread_cond_t *cond)
 {
-    uintptr_t value = (*(uintptr_t *) cond);
+    uintptr_t value = hybris_get_lock_word(cond);
 
     TRACE_HOOK("cond %p", cond);
 
@@ -863,21 +1040,14 @@ static int _hybris_hook_pthread_cond_broadcast(pthread_cond_t *cond)
         return android_pthread_cond_broadcast((android_cond_t *) cond);
     }
 
-    pthread_cond_t *realcond = (pthread_cond_t *) value;
-    if (hybris_is_pointer_in_shm((void*)value))
-        realcond = (pthread_cond_t *)hybris_get_shmpointer((hybris_shm_pointer_t)value);
-
-    if (value <= ANDROID_TOP_ADDR_VALUE_COND) {
-        realcond = hybris_alloc_init_cond();
-        *((uintptr_t *) cond) = (uintptr_t) realcond;
-    }
+    pthread_cond_t *realcond = hybris_get_realcond(cond, value);
 
     return pthread_cond_broadcast(realcond);
 }
 
 static int _hybris_hook_pthread_cond_signal(pthread_cond_t *cond)
 {
-    uintptr_t value = (*(uintptr_t *) cond);
+    uintptr_t value = hybris_get_lock_word(cond);
 
     TRACE_HOOK("cond %p", cond);
 
@@ -886,14 +1056,7 @@ static int _hybris_hook_pthread_cond_signal(pthread_cond_t *cond)
         return android_pthread_cond_signal((android_cond_t *) cond);
     }
 
-    pthread_cond_t *realcond = (pthread_cond_t *) value;
-    if (hybris_is_pointer_in_shm((void*)value))
-        realcond = (pthread_cond_t *)hybris_get_shmpointer((hybris_shm_pointer_t)value);
-
-    if (value <= ANDROID_TOP_ADDR_VALUE_COND) {
-        realcond = hybris_alloc_init_cond();
-        *((uintptr_t *) cond) = (uintptr_t) realcond;
-    }
+    pthread_cond_t *realcond = hybris_get_realcond(cond, value);
 
     return pthread_cond_signal(realcond);
 }
@@ -901,8 +1064,8 @@ static int _hybris_hook_pthread_cond_signal(pthread_cond_t *cond)
 static int _hybris_hook_pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex)
 {
     /* Both cond and mutex can be statically initialized, check for both */
-    uintptr_t cvalue = (*(uintptr_t *) cond);
-    uintptr_t mvalue = (*(uintptr_t *) mutex);
+    uintptr_t cvalue = hybris_get_lock_word(cond);
+    uintptr_t mvalue = hybris_get_lock_word(mutex);
 
     TRACE_HOOK("cond %p mutex %p", cond, mutex);
 
@@ -912,23 +1075,9 @@ static int _hybris_hook_pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t
         return 0;
     }
 
-    pthread_cond_t *realcond = (pthread_cond_t *) cvalue;
-    if (hybris_is_pointer_in_shm((void*)cvalue))
-        realcond = (pthread_cond_t *)hybris_get_shmpointer((hybris_shm_pointer_t)cvalue);
-
-    if (cvalue <= ANDROID_TOP_ADDR_VALUE_COND) {
-        realcond = hybris_alloc_init_cond();
-        *((uintptr_t *) cond) = (uintptr_t) realcond;
-    }
-
-    pthread_mutex_t *realmutex = (pthread_mutex_t *) mvalue;
-    if (hybris_is_pointer_in_shm((void*)mvalue))
-        realmutex = (pthread_mutex_t *)hybris_get_shmpointer((hybris_shm_pointer_t)mvalue);
+    pthread_cond_t *realcond = hybris_get_realcond(cond, cvalue);
 
-    if (mvalue <= ANDROID_TOP_ADDR_VALUE_MUTEX) {
-        realmutex = hybris_alloc_init_mutex(mvalue);
-        *((uintptr_t *) mutex) = (uintptr_t) realmutex;
-    }
+    pthread_mutex_t *realmutex = hybris_get_realmutex(mutex, mvalue);
 
     return pthread_cond_wait(realcond, realmutex);
 }
@@ -937,8 +1086,8 @@ static int _hybris_hook_pthread_cond_timedwait(pthread_cond_t *cond,
                 pthread_mutex_t *mutex, const struct timespec *abstime)
 {
     /* Both cond and mutex can be statically initialized, check for both */
-    uintptr_t cvalue = (*(uintptr_t *) cond);
-    uintptr_t mvalue = (*(uintptr_t *) mutex);
+    uintptr_t cvalue = hybris_get_lock_word(cond);
+    uintptr_t mvalue = hybris_get_lock_word(mutex);
 
     TRACE_HOOK("cond %p mutex %p abstime %p", cond, mutex, abstime);
 
@@ -948,23 +1097,9 @@ static int _hybris_hook_pthread_cond_timedwait(pthread_cond_t *cond,
         return 0;
     }
 
-    pthread_cond_t *realcond = (pthread_cond_t *) cvalue;
-    if (hybris_is_pointer_in_shm((void*)cvalue))
-        realcond = (pthread_cond_t *)hybris_get_shmpointer((hybris_shm_pointer_t)cvalue);
+    pthread_cond_t *realcond = hybris_get_realcond(cond, cvalue);
 
-    if (cvalue <= ANDROID_TOP_ADDR_VALUE_COND) {
-        realcond = hybris_alloc_init_cond();
-        *((uintptr_t *) cond) = (uintptr_t) realcond;
-    }
-
-    pthread_mutex_t *realmutex = (pthread_mutex_t *) mvalue;
-    if (hybris_is_pointer_in_shm((void*)mvalue))
-        realmutex = (pthread_mutex_t *)hybris_get_shmpointer((hybris_shm_pointer_t)mvalue);
-
-    if (mvalue <= ANDROID_TOP_ADDR_VALUE_MUTEX) {
-        realmutex = hybris_alloc_init_mutex(mvalue);
-        *((uintptr_t *) mutex) = (uintptr_t) realmutex;
-    }
+    pthread_mutex_t *realmutex = hybris_get_realmutex(mutex, mvalue);
 
     return pthread_cond_timedwait(realcond, realmutex, abstime);
 }
@@ -973,8 +1108,8 @@ static int _hybris_hook_pthread_cond_timedwait_relative_np(pthread_cond_t *cond,
                 pthread_mutex_t *mutex, const struct timespec *reltime)
 {
     /* Both cond and mutex can be statically initialized, check for both */
-    uintptr_t cvalue = (*(uintptr_t *) cond);
-    uintptr_t mvalue = (*(uintptr_t *) mutex);
+    uintptr_t cvalue = hybris_get_lock_word(cond);
+    uintptr_t mvalue = hybris_get_lock_word(mutex);
 
     TRACE_HOOK("cond %p mutex %p reltime %p", cond, mutex, reltime);
 
@@ -984,23 +1119,9 @@ static int _hybris_hook_pthread_cond_timedwait_relative_np(pthread_cond_t *cond,
         return 0;
     }
 
-    pthread_cond_t *realcond = (pthread_cond_t *) cvalue;
-    if( hybris_is_pointer_in_shm((void*)cvalue) )
-        realcond = (pthread_cond_t *)hybris_get_shmpointer((hybris_shm_pointer_t)cvalue);
-
-    if (cvalue <= ANDROID_TOP_ADDR_VALUE_COND) {
-        realcond = hybris_alloc_init_cond();
-        *((uintptr_t *) cond) = (uintptr_t) realcond;
-    }
-
-    pthread_mutex_t *realmutex = (pthread_mutex_t *) mvalue;
-    if (hybris_is_pointer_in_shm((void*)mvalue))
-        realmutex = (pthread_mutex_t *)hybris_get_shmpointer((hybris_shm_pointer_t)mvalue);
+    pthread_cond_t *realcond = hybris_get_realcond(cond, cvalue);
 
-    if (mvalue <= ANDROID_TOP_ADDR_VALUE_MUTEX) {
-        realmutex = hybris_alloc_init_mutex(mvalue);
-        *((uintptr_t *) mutex) = (uintptr_t) realmutex;
-    }
+    pthread_mutex_t *realmutex = hybris_get_realmutex(mutex, mvalue);
 
     struct timespec tv;
     clock_gettime(CLOCK_REALTIME, &tv);
@@ -1132,8 +1253,8 @@ static int _hybris_hook_pthread_rwlock_init(pthread_rwlock_t *__rwlock,
         pthread_rwlockattr_getpshared(realattr, &pshared);
 
     if (!pshared) {
-        /* non shared, standard rwlock: use malloc */
-        realrwlock = malloc(sizeof(pthread_rwlock_t));
+        /* non shared, standard rwlock: use a shadow object */
+        realrwlock = hybris_shadow_alloc();
 
         *((uintptr_t *) __rwlock) = (uintptr_t) realrwlock;
     }
@@ -1159,36 +1280,25 @@ static int _hybris_hook_pthread_rwlock_destroy(pthread_rwlock_t *__rwlock)
 
     if (!hybris_is_pointer_in_shm((void*)realrwlock)) {
         ret = pthread_rwlock_destroy(realrwlock);
-        free(realrwlock);
+        hybris_shadow_free(realrwlock);
     }
     else {
+        hybris_shm_pointer_t handle = (hybris_shm_pointer_t) realrwlock;
+        realrwlock = (pthread_rwlock_t *)hybris_get_shmpointer(handle);
         ret = pthread_rwlock_destroy(realrwlock);
-        realrwlock = (pthread_rwlock_t *)hybris_get_shmpointer((hybris_shm_pointer_t)realrwlock);
+        hybris_shm_free(handle, sizeof(pthread_rwlock_t));
     }
 
-    return ret;
-}
+    *((uintptr_t *)__rwlock) = 0;
 
-static pthread_rwlock_t* hybris_set_realrwlock(pthread_rwlock_t *rwlock)
-{
-    uintptr_t value = (*(uintptr_t *) rwlock);
-    pthread_rwlock_t *realrwlock = (pthread_rwlock_t *) value;
-
-    if (hybris_is_pointer_in_shm((void*)value))
-        realrwlock = (pthread_rwlock_t *)hybris_get_shmpointer((hybris_shm_pointer_t)value);
-
-    if ((uintptr_t)realrwlock <= ANDROID_TOP_ADDR_VALUE_RWLOCK) {
-        realrwlock = hybris_alloc_init_rwlock();
-        *((uintptr_t *)rwlock) = (uintptr_t) realrwlock;
-    }
-    return realrwlock;
+    return ret;
 }
 
 static int _hybris_hook_pthread_rwlock_rdlock(pthread_rwlock_t *__rwlock)
 {
     TRACE_HOOK("rwlock %p", __rwlock);
 
-    pthread_rwlock_t *realrwlock = hybris_set_realrwlock(__rwlock);
+    pthread_rwlock_t *realrwlock = hybris_get_realrwlock(__rwlock);
 
     return pthread_rwlock_rdlock(realrwlock);
 }
@@ -1197,7 +1307,7 @@ static int _hybris_hook_pthread_rwlock_tryrdlock(pthread_rwlock_t *__rwlock)
 {
     TRACE_HOOK("rwlock %p", __rwlock);
 
-    pthread_rwlock_t *realrwlock = hybris_set_realrwlock(__rwlock);
+    pthread_rwlock_t *realrwlock = hybris_get_realrwlock(__rwlock);
 
     return pthread_rwlock_tryrdlock(realrwlock);
 }
@@ -1207,7 +1317,7 @@ static int _hybris_hook_pthread_rwlock_timedrdlock(pthread_rwlock_t *__rwlock,
 {
     TRACE_HOOK("rwlock %p abs timeout %p", __rwlock, abs_timeout);
 
-    pthread_rwlock_t *realrwlock = hybris_set_realrwlock(__rwlock);
+    pthread_rwlock_t *realrwlock = hybris_get_realrwlock(__rwlock);
 
     return pthread_rwlock_timedrdlock(realrwlock, abs_timeout);
 }
@@ -1216,7 +1326,7 @@ static int _hybris_hook_pthread_rwlock_wrlock(pthread_rwlock_t *__rwlock)
 {
     TRACE_HOOK("rwlock %p", __rwlock);
 
-    pthread_rwlock_t *realrwlock = hybris_set_realrwlock(__rwlock);
+    pthread_rwlock_t *realrwlock = hybris_get_realrwlock(__rwlock);
 
     return pthread_rwlock_wrlock(realrwlock);
 }
@@ -1225,7 +1335,7 @@ static int _hybris_hook_pthread_rwlock_trywrlock(pthread_rwlock_t *__rwlock)
 {
     TRACE_HOOK("rwlock %p", __rwlock);
 
-    pthread_rwlock_t *realrwlock = hybris_set_realrwlock(__rwlock);
+    pthread_rwlock_t *realrwlock = hybris_get_realrwlock(__rwlock);
 
     return pthread_rwlock_trywrlock(realrwlock);
 }
@@ -1235,14 +1345,14 @@ static int _hybris_hook_pthread_rwlock_timedwrlock(pthread_rwlock_t *__rwlock,
 {
     TRACE_HOOK("rwlock %p abs timeout %p", __rwlock, abs_timeout);
 
-    pthread_rwlock_t *realrwlock = hybris_set_realrwlock(__rwlock);
+    pthread_rwlock_t *realrwlock = hybris_get_realrwlock(__rwlock);
 
     return pthread_rwlock_timedwrlock(realrwlock, abs_timeout);
 }
 
 static int _hybris_hook_pthread_rwlock_unlock(pthread_rwlock_t *__rwlock)
 {
-    uintptr_t value = (*(uintptr_t *) __rwlock);
+    uintptr_t value = hybris_get_lock_word(__rwlock);
 
     TRACE_HOOK("rwlock %p", __rwlock);
 
@@ -2797,16 +2907,6 @@ static struct _hook hooks_mm[] = {
 };
 
 
-static int hook_cmp(const void *a, const void *b)
-{
-    return strcmp(((struct _hook*)a)->name, ((struct _hook*)b)->name);
-}
-
-void hybris_set_hook_callback(hybris_hook_cb callback)
-{
-    hook_callback = callback;
-}
-
 static int get_android_sdk_version()
 {
     static int sdk_version = -1;
@@ -2848,49 +2948,121 @@ static int get_android_sdk_version()
 #define HOOKS_SIZE(hooks) \
     (sizeof(hooks) / sizeof(hooks[0]))
 
+/*
+ * Hook lookup table
+ *
+ * The hook tables above are merged once into an open addressed hash table
+ * keyed by the GNU ELF hash of the symbol name. The table is kept at most
+ * a quarter full and stores the full hash of each entry, so a lookup
+ * usually touches a single slot and does at most one strcmp (only when the
+ * 32 bit hashes match).
+ */
+
+/* See hook_table.h, handed to linkers which support it */
+static struct hybris_hook_table hook_table = { NULL, 0, 1 };
+static pthread_once_t hook_table_once = PTHREAD_ONCE_INIT;
 
-static void* __hybris_get_hooked_symbol(const char *sym, const char *requester)
+static void hook_table_insert(const struct _hook *hooks, size_t count)
 {
-    static int sorted = 0;
-    static intptr_t counter = -1;
-    void *found = NULL;
-    struct _hook key;
+    size_t i;
+    int trace = hybris_should_trace(NULL, NULL);
 
-    /* First check if we have a callback registered which could
-     * give us a context specific hook implementation */
-    if (hook_callback)
-    {
-        found = hook_callback(sym, requester);
-        if (found)
-            return (void*) found;
+    for (i = 0; i < count; i++) {
+        uint32_t hash = hybris_hook_hash(hooks[i].name);
+        uint32_t n;
+
+        /* The first table inserted wins, so newer hooks override the
+         * ones which are available for all versions */
+        if (hybris_hook_table_find(&hook_table, hooks[i].name, hash) != NULL)
+            continue;
+
+        for (n = hash & hook_table.mask; hook_table.slots[n].name != NULL;
+             n = (n + 1) & hook_table.mask)
+            ;
+
+        hook_table.slots[n].hash = hash;
+        hook_table.slots[n].name = hooks[i].name;
+        hook_table.slots[n].func = trace ? hooks[i].debug_func : hooks[i].func;
+        hook_table.slots[n].hook = &hooks[i];
     }
+}
 
-    if (!sorted)
-    {
-        qsort(hooks_common, HOOKS_SIZE(hooks_common), sizeof(hooks_common[0]), hook_cmp);
-        qsort(hooks_mm, HOOKS_SIZE(hooks_mm), sizeof(hooks_mm[0]), hook_cmp);
-        sorted = 1;
+/* The linker has to ask __hybris_get_hooked_symbol for every symbol if
+ * the answer depends on more than the table */
+static void hook_table_update_use_callback(void)
+{
+    int use_callback = hook_callback != NULL || hybris_hook_profile_enabled();
+
+#if defined(DEBUG)
+    /* for the "Could not find a hook" messages */
+    use_callback = use_callback || hybris_should_log(HYBRIS_LOG_DEBUG);
+#endif
+
+    __atomic_store_n(&hook_table.use_callback, use_callback, __ATOMIC_RELAXED);
+}
+
+static void hook_table_init(void)
+{
+    size_t count = HOOKS_SIZE(hooks_common) + HOOKS_SIZE(hooks_mm);
+    size_t size = 1;
+
+    while (size < count * 4)
+        size <<= 1;
+
+    hook_table.slots = calloc(size, sizeof(struct hybris_hook_slot));
+    if (!hook_table.slots) {
+        fprintf(stderr, "ERROR: Failed to allocate hook table\n");
+        exit(1);
     }
+    hook_table.mask = size - 1;
 
     /* Allow newer hooks to override those which are available for all versions */
-    key.name = sym;
 #if defined(WANT_LINKER_MM)
     if (get_android_sdk_version() > 21)
-        found = bsearch(&key, hooks_mm, HOOKS_SIZE(hooks_mm), sizeof(hooks_mm[0]), hook_cmp);
+        hook_table_insert(hooks_mm, HOOKS_SIZE(hooks_mm));
 #endif
-    if (!found)
-        found = bsearch(&key, hooks_common, HOOKS_SIZE(hooks_common), sizeof(hooks_common[0]), hook_cmp);
+    hook_table_insert(hooks_common, HOOKS_SIZE(hooks_common));
+
+    hook_table_update_use_callback();
+}
+
+static void* __hybris_find_hook(const char *sym, const char *requester)
+{
+    const struct hybris_hook_slot *found = NULL;
+
+    /* First check if we have a callback registered which could
+     * give us a context specific hook implementation */
+    if (hook_callback)
+    {
+        void *hook = hook_callback(sym, requester);
+        if (hook)
+            return hook;
+    }
+
+    pthread_once(&hook_table_once, hook_table_init);
+
+    found = hybris_hook_table_find(&hook_table, sym, hybris_hook_hash(sym));
 
     if (found)
     {
-        if(hybris_should_trace(NULL, NULL))
-            return ((struct _hook*) found)->debug_func;
-        else
-            return ((struct _hook*) found)->func;
+        if (hybris_hook_profile_enabled())
+            return hybris_hook_profile_wrap(found->hook, found->name, found->func);
+
+        return found->func;
     }
 
-    if (strncmp(sym, "pthread", 7) == 0 ||
-        strncmp(sym, "__pthread", 9) == 0)
+    return NULL;
+}
+
+static void* __hybris_get_hooked_symbol(const char *sym, const char *requester)
+{
+    static intptr_t counter = -1;
+    void *hook = __hybris_find_hook(sym, requester);
+
+    if (hook)
+        return hook;
+
+    if (hybris_hook_table_miss_needs_callback(sym))
     {
         /* safe */
         if (strcmp(sym, "pthread_sigmask") == 0)
@@ -2910,6 +3082,19 @@ static void* __hybris_get_hooked_symbol(const char *sym, const char *requester)
     return NULL;
 }
 
+void hybris_set_hook_callback(hybris_hook_cb callback)
+{
+    hook_callback = callback;
+    hook_table_update_use_callback();
+}
+
+void *hybris_get_hooked_symbol(const char *sym)
+{
+    /* without the fake addresses the linker gets for unhooked pthread
+     * symbols, callers only have to check for NULL */
+    return __hybris_find_hook(sym, NULL);
+}
+
 static void *linker_handle = NULL;
 
 static void* __hybris_load_linker(const char *path)
@@ -2979,6 +3164,14 @@ static void __hybris_linker_init()
     /* Now its time to setup the linker itself */
     _android_linker_init(sdk_version, __hybris_get_hooked_symbol);
 
+    /* Linkers which take the whole hook table only call
+     * __hybris_get_hooked_symbol when the table can't answer */
+    _android_linker_set_hook_table = dlsym(linker_handle, "android_linker_set_hook_table");
+    if (_android_linker_set_hook_table) {
+        pthread_once(&hook_table_once, hook_table_init);
+        _android_linker_set_hook_table(&hook_table);
+    }
+
     linker_initialized = 1;
 }
 
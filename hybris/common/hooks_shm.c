@@ -32,44 +32,76 @@
 #include <sys/ipc.h>
 #include <sys/shm.h>
 #include <sys/mman.h>
+#include <unistd.h>
 
 /* Debug */
 #include "logging.h"
 #define LOGD(message, ...) HYBRIS_DEBUG_LOG(HOOKS, message, ##__VA_ARGS__)
 
-#define HYBRIS_DATA_SIZE    4000
-#if defined(__LP64__)
-# define HYBRIS_SHM_MASK    0xFFFFFFFFFF000000ULL
-#else
-# define HYBRIS_SHM_MASK    0xFF000000UL
-#endif
-#define HYBRIS_SHM_PATH     "/hybris_shm_data"
+#define HYBRIS_SHM_PATH     "/hybris_shm_data_v2"
+
+/* The region starts out with one page (at least this much) and doubles
+ * whenever it is full, up to what fits in the offset part of a handle.
+ * It is always a whole number of pages, since it's mapped piecewise. */
+#define HYBRIS_SHM_INITIAL_SIZE  4096
+#define HYBRIS_SHM_MAX_DATA_SIZE ((size_t) (HYBRIS_SHM_MASK_TOP - HYBRIS_SHM_MASK))
+
+/* Freed objects are kept on one list per power of two size class,
+ * from 16 up to 512 bytes. Bigger objects are never reused. */
+#define HYBRIS_SHM_MIN_CLASS_SHIFT 4
+#define HYBRIS_SHM_NUM_CLASSES     6
+#define HYBRIS_SHM_ALIGN           64
 
 /* Structure of a shared memory region */
 typedef struct _hybris_shm_data_t {
     pthread_mutex_t access_mutex;
-    int current_offset;
-    int max_offset;
-    unsigned char data;
+    /* bumped whenever the region grows */
+    uint32_t generation;
+    uint32_t current_offset;
+    uint32_t max_offset;
+    /* offset + 1 of the first free object of each size class, 0 if none */
+    uint32_t free_lists[HYBRIS_SHM_NUM_CLASSES];
+    unsigned char data[] __attribute__((aligned(HYBRIS_SHM_ALIGN)));
 } hybris_shm_data_t;
 
 /* A helper to switch between the size of the data and the size of the shm object */
-const int HYBRIS_SHM_DATA_HEADER_SIZE = (sizeof(hybris_shm_data_t) - sizeof(unsigned char));
+#define HYBRIS_SHM_DATA_HEADER_SIZE (offsetof(hybris_shm_data_t, data))
 
-/* pointer to the shared memory region */
+/*
+ * The region is mapped at the start of an address range reserved for its
+ * maximum size, so growing it only ever maps more pages behind the ones
+ * already in use and pointers into it stay valid. This lets
+ * hybris_get_shmpointer translate handles without taking any lock.
+ */
 static hybris_shm_data_t *_hybris_shm_data = NULL;
 
 /* the SHM mem_id of the shared memory region */
 static int _hybris_shm_fd = -1;
 
-/* the size of the shared memory region that is currently mmap'ed to this process */
-static int _current_mapped_size = 0;
+/* the size of the shared memory region that is currently mmap'ed to this
+ * process, and the generation it corresponds to */
+static size_t _current_mapped_size = 0;
+static uint32_t _current_generation = 0;
+
+/* serializes attaching to and remapping the region within this process */
+static pthread_mutex_t _hybris_shm_local_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 /* forward-declare the internal static methods */
 static void _release_shm(void);
 static void _sync_mmap_with_shm(void);
 static void _hybris_shm_init(void);
-static void _hybris_shm_extend_region(void);
+static int _hybris_shm_extend_region(size_t needed);
+
+static size_t _hybris_shm_page_align(size_t size)
+{
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    return (size + page_size - 1) & ~(page_size - 1);
+}
+
+static size_t _hybris_shm_reserved_size(void)
+{
+    return _hybris_shm_page_align(HYBRIS_SHM_DATA_HEADER_SIZE + HYBRIS_SHM_MAX_DATA_SIZE);
+}
 
 /*
  * Detach the allocated memory region, and mark it for deletion
@@ -77,8 +109,9 @@ static void _hybris_shm_extend_region(void);
 static void _release_shm(void)
 {
     if (_hybris_shm_data) {
-        munmap(_hybris_shm_data, _current_mapped_size); /* unmap from this process */
+        munmap(_hybris_shm_data, _hybris_shm_reserved_size()); /* unmap from this process */
         _hybris_shm_data = NULL; /* pointer is no more valid */
+        _current_mapped_size = 0;
     }
     if (_hybris_shm_fd >= 0) {
         close(_hybris_shm_fd);   /* close the shm file descriptor */
@@ -88,138 +121,200 @@ static void _release_shm(void)
 }
 
 /*
- * Synchronize the size of the mmap with the size of the shm region
+ * Map the part of the shm region that other processes added since we last
+ * looked. Called with _hybris_shm_local_mutex held.
  */
 static void _sync_mmap_with_shm()
 {
     if (_hybris_shm_fd >= 0 && _hybris_shm_data) {
-        if (_current_mapped_size < _hybris_shm_data->max_offset + HYBRIS_SHM_DATA_HEADER_SIZE) {
-            /* Note that mremap may change the address pointed by _hybris_shm_data.
-             * But as we never point directly into _hybris_shm_data, it's fine.
-             * */
-            _hybris_shm_data = (hybris_shm_data_t *)mremap( _hybris_shm_data, _current_mapped_size,
-                                  _hybris_shm_data->max_offset + HYBRIS_SHM_DATA_HEADER_SIZE,
-                                  MREMAP_MAYMOVE );
-
-            _current_mapped_size = _hybris_shm_data->max_offset + HYBRIS_SHM_DATA_HEADER_SIZE;
+        uint32_t generation = __atomic_load_n(&_hybris_shm_data->generation, __ATOMIC_ACQUIRE);
+        size_t size = _hybris_shm_page_align(_hybris_shm_data->max_offset + HYBRIS_SHM_DATA_HEADER_SIZE);
+
+        if (_current_mapped_size < size) {
+            void *addr = mmap((char *) _hybris_shm_data + _current_mapped_size,
+                              size - _current_mapped_size, PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_FIXED, _hybris_shm_fd, _current_mapped_size);
+            if (addr == MAP_FAILED) {
+                HYBRIS_ERROR_LOG(HOOKS, "ERROR: failed to grow the shm mapping: %s\n", strerror(errno));
+                return;
+            }
+
+            __atomic_store_n(&_current_mapped_size, size, __ATOMIC_RELEASE);
         }
+
+        __atomic_store_n(&_current_generation, generation, __ATOMIC_RELEASE);
     }
 }
 
 /*
  * Initialize the shared memory region for hybris, in order to store
- * pshared mutex, condition and rwlock
+ * pshared mutex, condition and rwlock. Called with _hybris_shm_local_mutex
+ * held.
  */
 static void _hybris_shm_init()
 {
     if (_hybris_shm_fd < 0) {
-        const size_t size_to_map = HYBRIS_SHM_DATA_HEADER_SIZE + HYBRIS_DATA_SIZE; /* 4000 bytes for the data, plus the header size */
+        size_t initial_size = _hybris_shm_page_align(HYBRIS_SHM_INITIAL_SIZE);
+        int created = 0;
+        void *reserved;
 
         /* initialize or get shared memory segment */
         _hybris_shm_fd = shm_open(HYBRIS_SHM_PATH, O_RDWR, 0660);
-        if (_hybris_shm_fd >= 0) {
-            /* Map the memory object */
-            _hybris_shm_data = (hybris_shm_data_t *)mmap( NULL, size_to_map,
-                                             PROT_READ | PROT_WRITE, MAP_SHARED,
-                                             _hybris_shm_fd, 0 );
-            _current_mapped_size = size_to_map;
-
-            _sync_mmap_with_shm();
-        }
-        else {
+        if (_hybris_shm_fd < 0) {
             LOGD("Creating a new shared memory segment.");
 
             mode_t pumask = umask(0);
             _hybris_shm_fd = shm_open(HYBRIS_SHM_PATH, O_RDWR | O_CREAT, 0666);
             umask(pumask);
-            if (_hybris_shm_fd >= 0) {
-                TEMP_FAILURE_RETRY(ftruncate( _hybris_shm_fd, size_to_map ));
-                /* Map the memory object */
-                _hybris_shm_data = (hybris_shm_data_t *)mmap( NULL, size_to_map,
-                                             PROT_READ | PROT_WRITE, MAP_SHARED,
-                                             _hybris_shm_fd, 0 );
-                if (_hybris_shm_data == MAP_FAILED) {
-                    HYBRIS_ERROR_LOG(HOOKS, "ERROR: mmap failed: %s\n", strerror(errno));
-                    _release_shm();
-                }
-                else {
-                    _current_mapped_size = size_to_map;
-                    /* Initialize the memory object */
-                    memset((void*)_hybris_shm_data, 0, size_to_map);
-                    _hybris_shm_data->max_offset = HYBRIS_DATA_SIZE;
-
-                    pthread_mutexattr_t attr;
-                    pthread_mutexattr_init(&attr);
-                    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
-                    pthread_mutex_init(&_hybris_shm_data->access_mutex, &attr);
-                    pthread_mutexattr_destroy(&attr);
-
-                    atexit(_release_shm);
-                }
+            if (_hybris_shm_fd < 0) {
+                HYBRIS_ERROR_LOG(HOOKS, "ERROR: Couldn't create shared memory segment !");
+                return;
             }
+
+            TEMP_FAILURE_RETRY(ftruncate( _hybris_shm_fd, initial_size ));
+            created = 1;
+        }
+
+        reserved = mmap(NULL, _hybris_shm_reserved_size(), PROT_NONE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (reserved == MAP_FAILED) {
+            HYBRIS_ERROR_LOG(HOOKS, "ERROR: mmap failed: %s\n", strerror(errno));
+            close(_hybris_shm_fd);
+            _hybris_shm_fd = -1;
+            return;
+        }
+
+        /* Map the header and the first chunk, _sync_mmap_with_shm maps the rest */
+        _hybris_shm_data = (hybris_shm_data_t *)mmap( reserved, initial_size,
+                                         PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+                                         _hybris_shm_fd, 0 );
+        if (_hybris_shm_data == MAP_FAILED) {
+            HYBRIS_ERROR_LOG(HOOKS, "ERROR: mmap failed: %s\n", strerror(errno));
+            _hybris_shm_data = NULL;
+            munmap(reserved, _hybris_shm_reserved_size());
+            if (created)
+                _release_shm();
             else {
-                HYBRIS_ERROR_LOG(HOOKS, "ERROR: Couldn't create shared memory segment !");
+                close(_hybris_shm_fd);
+                _hybris_shm_fd = -1;
             }
+            return;
+        }
+        _current_mapped_size = initial_size;
+
+        if (created) {
+            /* Initialize the memory object */
+            memset((void*)_hybris_shm_data, 0, HYBRIS_SHM_DATA_HEADER_SIZE);
+            _hybris_shm_data->max_offset = initial_size - HYBRIS_SHM_DATA_HEADER_SIZE;
+
+            pthread_mutexattr_t attr;
+            pthread_mutexattr_init(&attr);
+            pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+            pthread_mutex_init(&_hybris_shm_data->access_mutex, &attr);
+            pthread_mutexattr_destroy(&attr);
+
+            atexit(_release_shm);
         }
+
+        _sync_mmap_with_shm();
     }
 }
 
 /*
- * Extend the SHM region's size
+ * Make sure this process is attached to the region and sees all of it
  */
-static void _hybris_shm_extend_region()
+static hybris_shm_data_t *_hybris_shm_attach(void)
 {
-    TEMP_FAILURE_RETRY(ftruncate( _hybris_shm_fd, _current_mapped_size + HYBRIS_DATA_SIZE ));
-    _hybris_shm_data->max_offset += HYBRIS_DATA_SIZE;
+    pthread_mutex_lock(&_hybris_shm_local_mutex);
+
+    if (_hybris_shm_fd < 0) {
+        /* if we are not yet attached to any shm region, then do it now */
+        _hybris_shm_init();
+    }
 
     _sync_mmap_with_shm();
-}
 
-/************ public functions *******************/
+    pthread_mutex_unlock(&_hybris_shm_local_mutex);
+
+    return _hybris_shm_data;
+}
 
- /*
-  * Determine if the pointer that has been extracted by hybris is
-  * pointing to an address in the shared memory.
-  */
-int hybris_is_pointer_in_shm(void *ptr)
+/*
+ * Extend the SHM region's size, doubling it until at least needed more
+ * bytes fit. Called with both mutexes held.
+ */
+static int _hybris_shm_extend_region(size_t needed)
 {
-    if (((uintptr_t) ptr >= HYBRIS_SHM_MASK) &&
-                    ((uintptr_t) ptr <= HYBRIS_SHM_MASK_TOP))
-        return 1;
+    size_t max_offset = _hybris_shm_data->max_offset;
+    size_t new_max_offset = max_offset;
+
+    do {
+        new_max_offset = _hybris_shm_page_align((new_max_offset + HYBRIS_SHM_DATA_HEADER_SIZE) * 2) -
+                         HYBRIS_SHM_DATA_HEADER_SIZE;
+    } while (new_max_offset - max_offset < needed);
+
+    if (new_max_offset > HYBRIS_SHM_MAX_DATA_SIZE) {
+        HYBRIS_ERROR_LOG(HOOKS, "ERROR: shared memory segment is full\n");
+        return -1;
+    }
+
+    if (TEMP_FAILURE_RETRY(ftruncate( _hybris_shm_fd, new_max_offset + HYBRIS_SHM_DATA_HEADER_SIZE )) != 0) {
+        HYBRIS_ERROR_LOG(HOOKS, "ERROR: failed to extend the shared memory segment: %s\n",
+                         strerror(errno));
+        return -1;
+    }
+
+    _hybris_shm_data->max_offset = new_max_offset;
+    __atomic_add_fetch(&_hybris_shm_data->generation, 1, __ATOMIC_RELEASE);
+
+    LOGD("Extended the shared memory segment to %zu bytes", new_max_offset + HYBRIS_SHM_DATA_HEADER_SIZE);
+
+    _sync_mmap_with_shm();
 
     return 0;
 }
 
+static int _hybris_shm_size_class(size_t size)
+{
+    int size_class = 0;
+
+    while ((size_t) 1 << (size_class + HYBRIS_SHM_MIN_CLASS_SHIFT) < size)
+        size_class++;
+
+    return size_class;
+}
+
+/************ public functions *******************/
+
 /*
  * Convert this offset pointer to the shared memory to an
  * absolute pointer that can be used in user space
  */
 void *hybris_get_shmpointer(hybris_shm_pointer_t handle)
 {
-    void *realpointer = NULL;
-    if (hybris_is_pointer_in_shm((void*)handle)) {
-        if (_hybris_shm_fd < 0) {
-            /* if we are not yet attached to any shm region, then do it now */
-            _hybris_shm_init();
-        }
-
-        pthread_mutex_lock(&_hybris_shm_data->access_mutex);
-
-        _sync_mmap_with_shm();  /* make sure our mmap is sync'ed */
-
-        if (_hybris_shm_data != NULL) {
-            uintptr_t offset = handle & (~HYBRIS_SHM_MASK);
-            realpointer = &(_hybris_shm_data->data) + offset;
-
-            /* Be careful when activating this trace: this method is called *a lot* !
-            LOGD("handle = %x, offset  = %d, realpointer = %x)", handle, offset, realpointer);
-             */
-        }
-
-        pthread_mutex_unlock(&_hybris_shm_data->access_mutex);
+    hybris_shm_data_t *data;
+    uintptr_t offset;
+
+    if (!hybris_is_pointer_in_shm((void*)handle))
+        return NULL;
+
+    /* This method is called *a lot*, so the common case is a couple of
+     * atomic loads: the region only needs to be remapped if another
+     * process has grown it since we last looked. Objects are never
+     * handed out across the end of a growth step, so a handle below the
+     * mapped size is fully mapped. */
+    offset = handle & (~HYBRIS_SHM_MASK);
+    data = __atomic_load_n(&_hybris_shm_data, __ATOMIC_ACQUIRE);
+
+    if (data == NULL ||
+        offset + HYBRIS_SHM_DATA_HEADER_SIZE >= __atomic_load_n(&_current_mapped_size, __ATOMIC_ACQUIRE) ||
+        __atomic_load_n(&data->generation, __ATOMIC_ACQUIRE) != __atomic_load_n(&_current_generation, __ATOMIC_ACQUIRE)) {
+        data = _hybris_shm_attach();
+        if (data == NULL || offset + HYBRIS_SHM_DATA_HEADER_SIZE >= _current_mapped_size)
+            return NULL;
     }
 
-    return realpointer;
+    return data->data + offset;
 }
 
 /*
@@ -228,33 +323,75 @@ void *hybris_get_shmpointer(hybris_shm_pointer_t handle)
 hybris_shm_pointer_t hybris_shm_alloc(size_t size)
 {
     hybris_shm_pointer_t location = 0;
+    int size_class = _hybris_shm_size_class(size);
+    size_t align = HYBRIS_SHM_ALIGN;
+    uint32_t offset;
 
-    if (_hybris_shm_fd < 0) {
-        /* if we are not yet attached to any shm region, then do it now */
-        _hybris_shm_init();
+    if (size == 0 || _hybris_shm_attach() == NULL)
+        return 0;
+
+    if (size_class < HYBRIS_SHM_NUM_CLASSES) {
+        size = (size_t) 1 << (size_class + HYBRIS_SHM_MIN_CLASS_SHIFT);
+        if (size < align)
+            align = size;
+    } else {
+        size = (size + HYBRIS_SHM_ALIGN - 1) & ~(HYBRIS_SHM_ALIGN - 1);
     }
 
+    pthread_mutex_lock(&_hybris_shm_local_mutex);
     pthread_mutex_lock(&_hybris_shm_data->access_mutex);
 
     /* Make sure our mmap is sync'ed */
     _sync_mmap_with_shm();
 
-    if (_hybris_shm_data == NULL || _hybris_shm_fd < 0)
-        return 0;
+    if (size_class < HYBRIS_SHM_NUM_CLASSES && _hybris_shm_data->free_lists[size_class]) {
+        offset = _hybris_shm_data->free_lists[size_class] - 1;
+        _hybris_shm_data->free_lists[size_class] = *(uint32_t *) (_hybris_shm_data->data + offset);
+        LOGD("Reused a shared object (size = %zu, at offset %u)", size, offset);
+    } else {
+        offset = (_hybris_shm_data->current_offset + align - 1) & ~(align - 1);
+
+        if (offset + size > _hybris_shm_data->max_offset) {
+            /* the current buffer is full: objects never straddle the
+             * end of a growth step, so start after it */
+            offset = _hybris_shm_data->max_offset;
+            if (_hybris_shm_extend_region(size) != 0)
+                goto out;
+        }
 
-    if (_hybris_shm_data->current_offset + size >= _hybris_shm_data->max_offset) {
-        /* the current buffer if full: extend it a little bit more */
-        _hybris_shm_extend_region();
-        _sync_mmap_with_shm();
+        _hybris_shm_data->current_offset = offset + size;
+        LOGD("Allocated a shared object (size = %zu, at offset %u)", size, offset);
     }
 
-    /* there is now enough place in this pool */
-    location = _hybris_shm_data->current_offset | HYBRIS_SHM_MASK;
-    LOGD("Allocated a shared object (size = %zu, at offset %d)", size, _hybris_shm_data->current_offset);
-
-    _hybris_shm_data->current_offset += size;
+    location = offset | HYBRIS_SHM_MASK;
 
+out:
     pthread_mutex_unlock(&_hybris_shm_data->access_mutex);
+    pthread_mutex_unlock(&_hybris_shm_local_mutex);
 
     return location;
 }
+
+/*
+ * Give back an object allocated with hybris_shm_alloc
+ */
+void hybris_shm_free(hybris_shm_pointer_t handle, size_t size)
+{
+    int size_class = _hybris_shm_size_class(size);
+    uint32_t offset = handle & (~HYBRIS_SHM_MASK);
+
+    if (!hybris_is_pointer_in_shm((void*)handle) || _hybris_shm_attach() == NULL)
+        return;
+
+    if (size_class >= HYBRIS_SHM_NUM_CLASSES) {
+        LOGD("Not reusing a shared object of %zu bytes", size);
+        return;
+    }
+
+    pthread_mutex_lock(&_hybris_shm_data->access_mutex);
+
+    *(uint32_t *) (_hybris_shm_data->data + offset) = _hybris_shm_data->free_lists[size_class];
+    _hybris_shm_data->free_lists[size_class] = offset + 1;
+
+    pthread_mutex_unlock(&_hybris_shm_data->access_mutex);
+}
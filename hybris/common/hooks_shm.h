@@ -21,6 +21,12 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#if defined(__LP64__)
+# define HYBRIS_SHM_MASK    0xFFFFFFFFFF000000ULL
+#else
+# define HYBRIS_SHM_MASK    0xFF000000UL
+#endif
+
 /* Leave space to workaround the issue that Android might pass negative int values */
 #define HYBRIS_SHM_MASK_TOP (UINTPTR_MAX - 15)
 
@@ -30,10 +36,19 @@ typedef uintptr_t hybris_shm_pointer_t;
  * Allocate a space in the shared memory region of hybris
  */
 hybris_shm_pointer_t hybris_shm_alloc(size_t size);
+/* 
+ * Give back space allocated with hybris_shm_alloc, size must be the same
+ */
+void hybris_shm_free(hybris_shm_pointer_t handle, size_t size);
 /* 
  * Test if the pointers points to the shm region
+ * Inline as the pthread hooks check every lock they get for this
  */
-int hybris_is_pointer_in_shm(void *ptr);
+static inline int hybris_is_pointer_in_shm(void *ptr)
+{
+    return ((uintptr_t) ptr >= HYBRIS_SHM_MASK) &&
+           ((uintptr_t) ptr <= HYBRIS_SHM_MASK_TOP);
+}
 /* 
  * Convert an offset pointer to the shared memory to an absolute pointer that can be used in user space 
  * This function will return a NULL pointer if the handle does not actually point to the shm region
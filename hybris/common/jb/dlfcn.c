@@ -32,8 +32,9 @@
 #define DL_ERR_SYMBOL_NOT_FOUND       4
 #define DL_ERR_SYMBOL_NOT_GLOBAL      5
 
-static char dl_err_buf[1024];
-static const char *dl_err_str;
+/* Per thread, dlsym fails on several threads at once */
+static __thread char dl_err_buf[1024];
+static __thread const char *dl_err_str;
 
 static const char *dl_errors[] = {
     [DL_ERR_CANNOT_LOAD_LIBRARY] = "Cannot load library",
@@ -84,17 +85,18 @@ void *android_dlsym(void *handle, const char *symbol)
     Elf_Sym *sym;
     unsigned bind;
 
-    pthread_mutex_lock(&dl_lock);
-
     if(unlikely(handle == 0)) { 
         set_dlerror(DL_ERR_INVALID_LIBRARY_HANDLE);
-        goto err;
+        return 0;
     }
     if(unlikely(symbol == 0)) {
         set_dlerror(DL_ERR_BAD_SYMBOL_NAME);
-        goto err;
+        return 0;
     }
 
+    /* Not dl_lock, lookups don't wait for a dlopen on another thread */
+    solist_read_lock();
+
     if(handle == RTLD_DEFAULT) {
         sym = lookup(symbol, &found, NULL);
     } else if(handle == RTLD_NEXT) {
@@ -115,7 +117,7 @@ void *android_dlsym(void *handle, const char *symbol)
 
         if(likely((bind == STB_GLOBAL) && (sym->st_shndx != 0))) {
             unsigned ret = sym->st_value + found->base;
-            pthread_mutex_unlock(&dl_lock);
+            solist_read_unlock();
             return (void*)ret;
         }
 
@@ -124,8 +126,7 @@ void *android_dlsym(void *handle, const char *symbol)
     else
         set_dlerror(DL_ERR_SYMBOL_NOT_FOUND);
 
-err:
-    pthread_mutex_unlock(&dl_lock);
+    solist_read_unlock();
     return 0;
 }
 
@@ -133,7 +134,7 @@ int android_dladdr(const void *addr, Dl_info *info)
 {
     int ret = 0;
 
-    pthread_mutex_lock(&dl_lock);
+    solist_read_lock();
 
     /* Determine if this address can be found in any library currently mapped */
     soinfo *si = find_containing_library(addr);
@@ -155,7 +156,7 @@ int android_dladdr(const void *addr, Dl_info *info)
         ret = 1;
     }
 
-    pthread_mutex_unlock(&dl_lock);
+    solist_read_unlock();
 
     return ret;
 }
@@ -90,6 +90,12 @@ static soinfo sopool[SO_MAX];
 static soinfo *freelist = NULL;
 static soinfo *solist = &libdl_info;
 static soinfo *sonext = &libdl_info;
+
+/* dlsym and dladdr hold this lock for reading instead of taking the dl
+ * lock, the linker holds it for writing while it changes solist. Writers
+ * are preferred, readers never nest.
+ */
+static pthread_rwlock_t solist_lock = PTHREAD_RWLOCK_WRITER_NONRECURSIVE_INITIALIZER_NP;
 #if ALLOW_SYMBOLS_FROM_MAIN
 static soinfo *somain; /* main process, always the one after libdl_info */
 #endif
@@ -288,15 +294,18 @@ static soinfo *alloc_info(const char *name)
     /* Make sure we get a clean block of soinfo */
     memset(si, 0, sizeof(soinfo));
     strlcpy((char*) si->name, name, sizeof(si->name));
-    sonext->next = si;
     si->next = NULL;
     si->refcount = 0;
+    pthread_rwlock_wrlock(&solist_lock);
+    sonext->next = si;
     sonext = si;
+    pthread_rwlock_unlock(&solist_lock);
 
     TRACE("%5d name %s: allocated soinfo @ %p\n", pid, name, si);
     return si;
 }
 
+/* Called with solist_lock held for writing */
 static void free_info(soinfo *si)
 {
     soinfo *prev = NULL, *trav;
@@ -383,55 +392,146 @@ android_dl_iterate_phdr(int (*cb)(struct dl_phdr_info *info, size_t size, void *
     return rv;
 }
 
-static Elf_Sym *_elf_lookup(soinfo *si, unsigned hash, const char *name)
+/* A symbol name with its hashes, which are computed when first needed */
+struct symbol_name {
+    const char *name;
+    unsigned elf_hash;
+    unsigned gnu_hash;
+    int has_elf_hash;
+    int has_gnu_hash;
+};
+
+static void symbol_name_init(struct symbol_name *sn, const char *name)
+{
+    sn->name = name;
+    sn->has_elf_hash = 0;
+    sn->has_gnu_hash = 0;
+}
+
+static unsigned elfhash(const char *_name)
+{
+    const unsigned char *name = (const unsigned char *) _name;
+    unsigned h = 0, g;
+
+    while(*name) {
+        h = (h << 4) + *name++;
+        g = h & 0xf0000000;
+        h ^= g;
+        h ^= g >> 24;
+    }
+    return h;
+}
+
+static unsigned gnuhash(const char *_name)
+{
+    const unsigned char *name = (const unsigned char *) _name;
+    unsigned h = 5381;
+
+    while(*name)
+        h += (h << 5) + *name++; /* h*33 + c */
+    return h;
+}
+
+static unsigned symbol_name_elf_hash(struct symbol_name *sn)
+{
+    if (!sn->has_elf_hash) {
+        sn->elf_hash = elfhash(sn->name);
+        sn->has_elf_hash = 1;
+    }
+    return sn->elf_hash;
+}
+
+static unsigned symbol_name_gnu_hash(struct symbol_name *sn)
+{
+    if (!sn->has_gnu_hash) {
+        sn->gnu_hash = gnuhash(sn->name);
+        sn->has_gnu_hash = 1;
+    }
+    return sn->gnu_hash;
+}
+
+/* only concern ourselves with global and weak symbol definitions */
+static int is_symbol_definition(const Elf_Sym *s)
 {
+    switch(ELF32_ST_BIND(s->st_info)){
+    case STB_GLOBAL:
+    case STB_WEAK:
+        /* no section == undefined */
+        return s->st_shndx != 0;
+    }
+
+    return 0;
+}
+
+static Elf_Sym *_gnu_lookup(soinfo *si, struct symbol_name *sn)
+{
+    unsigned hash = symbol_name_gnu_hash(sn);
+    unsigned bloom_mask_bits = sizeof(Elf_Addr) * 8;
+    Elf_Addr bloom_word;
     Elf_Sym *s;
-    Elf_Sym *symtab = si->symtab;
-    const char *strtab = si->strtab;
     unsigned n;
 
-    TRACE_TYPE(LOOKUP, "%5d SEARCH %s in %s@0x%08x %08x %d\n", pid,
-               name, si->name, si->base, hash, hash % si->nbucket);
-    n = hash % si->nbucket;
+    TRACE_TYPE(LOOKUP, "%5d SEARCH %s in %s@0x%08x %08x (gnu)\n", pid,
+               sn->name, si->name, si->base, hash);
 
-    for(n = si->bucket[hash % si->nbucket]; n != 0; n = si->chain[n]){
-        s = symtab + n;
-        if(strcmp(strtab + s->st_name, name)) continue;
+    /* most lookups miss, the bloom filter rejects nearly all of them
+     * without touching the buckets and chains */
+    bloom_word = si->gnu_bloom_filter[(hash / bloom_mask_bits) & si->gnu_maskwords];
+    if ((1 & (bloom_word >> (hash % bloom_mask_bits)) &
+         (bloom_word >> ((hash >> si->gnu_shift2) % bloom_mask_bits))) == 0)
+        return NULL;
 
-            /* only concern ourselves with global and weak symbol definitions */
-        switch(ELF32_ST_BIND(s->st_info)){
-        case STB_GLOBAL:
-        case STB_WEAK:
-                /* no section == undefined */
-            if(s->st_shndx == 0) continue;
+    n = si->gnu_bucket[hash % si->gnu_nbucket];
+    if (n == 0)
+        return NULL;
 
+    do {
+        s = si->symtab + n;
+        if (((si->gnu_chain[n] ^ hash) >> 1) == 0 &&
+            strcmp(si->strtab + s->st_name, sn->name) == 0 &&
+            is_symbol_definition(s)) {
             TRACE_TYPE(LOOKUP, "%5d FOUND %s in %s (%08x) %d\n", pid,
-                       name, si->name, s->st_value, s->st_size);
+                       sn->name, si->name, s->st_value, s->st_size);
             return s;
         }
-    }
+    } while ((si->gnu_chain[n++] & 1) == 0);
 
     return NULL;
 }
 
-static unsigned elfhash(const char *_name)
+static Elf_Sym *_elf_lookup(soinfo *si, struct symbol_name *sn)
 {
-    const unsigned char *name = (const unsigned char *) _name;
-    unsigned h = 0, g;
+    Elf_Sym *s;
+    Elf_Sym *symtab = si->symtab;
+    const char *strtab = si->strtab;
+    unsigned hash, n;
 
-    while(*name) {
-        h = (h << 4) + *name++;
-        g = h & 0xf0000000;
-        h ^= g;
-        h ^= g >> 24;
+    if (si->gnu_bucket != NULL)
+        return _gnu_lookup(si, sn);
+
+    hash = symbol_name_elf_hash(sn);
+
+    TRACE_TYPE(LOOKUP, "%5d SEARCH %s in %s@0x%08x %08x %d\n", pid,
+               sn->name, si->name, si->base, hash, hash % si->nbucket);
+
+    for(n = si->bucket[hash % si->nbucket]; n != 0; n = si->chain[n]){
+        s = symtab + n;
+        if(strcmp(strtab + s->st_name, sn->name)) continue;
+
+        if(is_symbol_definition(s)) {
+            TRACE_TYPE(LOOKUP, "%5d FOUND %s in %s (%08x) %d\n", pid,
+                       sn->name, si->name, s->st_value, s->st_size);
+            return s;
+        }
     }
-    return h;
+
+    return NULL;
 }
 
 static Elf_Sym *
 _do_lookup(soinfo *si, const char *name, unsigned *base)
 {
-    unsigned elf_hash = elfhash(name);
+    struct symbol_name sn;
     Elf_Sym *s;
     unsigned *d;
     soinfo *lsi = si;
@@ -447,14 +547,15 @@ _do_lookup(soinfo *si, const char *name, unsigned *base)
      * and some the first non-weak definition.   This is system dependent.
      * Here we return the first definition found for simplicity.  */
 
-    s = _elf_lookup(si, elf_hash, name);
+    symbol_name_init(&sn, name);
+    s = _elf_lookup(si, &sn);
     if(s != NULL)
         goto done;
 
     /* Next, look for it in the preloads list */
     for(i = 0; preloads[i] != NULL; i++) {
         lsi = preloads[i];
-        s = _elf_lookup(lsi, elf_hash, name);
+        s = _elf_lookup(lsi, &sn);
         if(s != NULL)
             goto done;
     }
@@ -470,7 +571,7 @@ _do_lookup(soinfo *si, const char *name, unsigned *base)
 
             DEBUG("%5d %s: looking up %s in %s\n",
                   pid, si->name, name, lsi->name);
-            s = _elf_lookup(lsi, elf_hash, name);
+            s = _elf_lookup(lsi, &sn);
             if ((s != NULL) && (s->st_shndx != SHN_UNDEF))
                 goto done;
         }
@@ -485,7 +586,7 @@ _do_lookup(soinfo *si, const char *name, unsigned *base)
         lsi = somain;
         DEBUG("%5d %s: looking up %s in executable %s\n",
               pid, si->name, name, lsi->name);
-        s = _elf_lookup(lsi, elf_hash, name);
+        s = _elf_lookup(lsi, &sn);
     }
 #endif
 
@@ -506,26 +607,49 @@ done:
  */
 Elf_Sym *lookup_in_library(soinfo *si, const char *name)
 {
-    return _elf_lookup(si, elfhash(name), name);
+    struct symbol_name sn;
+
+    symbol_name_init(&sn, name);
+    return _elf_lookup(si, &sn);
+}
+
+/* dlsym skips the libraries which other threads are still loading or
+ * which failed to load.
+ */
+static inline int is_linked(soinfo *si)
+{
+    return (__atomic_load_n(&si->flags, __ATOMIC_ACQUIRE) & FLAG_LINKED) != 0;
+}
+
+void solist_read_lock(void)
+{
+    pthread_rwlock_rdlock(&solist_lock);
+}
+
+void solist_read_unlock(void)
+{
+    pthread_rwlock_unlock(&solist_lock);
 }
 
 /* This is used by dl_sym().  It performs a global symbol lookup.
  */
 Elf_Sym *lookup(const char *name, soinfo **found, soinfo *start)
 {
-    unsigned elf_hash = elfhash(name);
+    struct symbol_name sn;
     Elf_Sym *s = NULL;
     soinfo *si;
 
+    symbol_name_init(&sn, name);
+
     if(start == NULL) {
         start = solist;
     }
 
     for(si = start; (s == NULL) && (si != NULL); si = si->next)
     {
-        if(si->flags & FLAG_ERROR)
+        if(!is_linked(si))
             continue;
-        s = _elf_lookup(si, elf_hash, name);
+        s = _elf_lookup(si, &sn);
         if (s != NULL) {
             *found = si;
             break;
@@ -547,7 +671,8 @@ soinfo *find_containing_library(const void *addr)
 
     for(si = solist; si != NULL; si = si->next)
     {
-        if((unsigned)addr >= si->base && (unsigned)addr - si->base < si->size) {
+        if(is_linked(si) &&
+           (unsigned)addr >= si->base && (unsigned)addr - si->base < si->size) {
             return si;
         }
     }
@@ -1179,7 +1304,11 @@ load_library(const char *name)
     return si;
 
 fail:
-    if (si) free_info(si);
+    if (si) {
+        pthread_rwlock_wrlock(&solist_lock);
+        free_info(si);
+        pthread_rwlock_unlock(&solist_lock);
+    }
     close(fd);
     return NULL;
 }
@@ -1299,10 +1428,12 @@ unsigned unload_library(soinfo *si)
             }
         }
 
+        pthread_rwlock_wrlock(&solist_lock);
         munmap((char *)si->base, si->size);
         notify_gdb_of_unload(si);
         free_info(si);
         si->refcount = 0;
+        pthread_rwlock_unlock(&solist_lock);
     }
     else {
         si->refcount--;
@@ -1526,6 +1657,61 @@ static int reloc_library(soinfo *si, Elf_Rel *rel, unsigned count)
     return 0;
 }
 
+/* Applies the DT_RELR table. An even entry is the address of a word to
+ * relocate, the odd entries after it are bitmaps of which of the
+ * following 31 words are to be relocated as well.
+ */
+static int reloc_relr(soinfo *si)
+{
+    Elf_Addr *where = NULL;
+    unsigned idx;
+
+    for (idx = 0; idx < si->relr_count; ++idx) {
+        Elf_Addr entry = si->relr[idx];
+
+        if ((entry & 1) == 0) {
+            where = (Elf_Addr *) (si->base + entry);
+            *where++ += si->base;
+            COUNT_RELOC(RELOC_RELATIVE);
+        } else {
+            Elf_Addr *p = where;
+
+            if (where == NULL) {
+                DL_ERR("%5d DT_RELR bitmap without address in '%s'", pid, si->name);
+                return -1;
+            }
+            while ((entry >>= 1) != 0) {
+                if (entry & 1) {
+                    *p += si->base;
+                    COUNT_RELOC(RELOC_RELATIVE);
+                }
+                p++;
+            }
+            where += 8 * sizeof(Elf_Addr) - 1;
+        }
+    }
+
+    return 0;
+}
+
+/* Linkers put the relative relocations first (DT_RELCOUNT says how many
+ * there are, but they are easily found by their type). Applies them
+ * without going through reloc_library and returns their number.
+ */
+static unsigned reloc_relative_prefix(soinfo *si, Elf_Rel *rel, unsigned count)
+{
+    unsigned idx;
+
+    for (idx = 0; idx < count; ++idx) {
+        if (rel[idx].r_info != R_GENERIC_RELATIVE)
+            break;
+        *((unsigned *) (rel[idx].r_offset + si->base)) += si->base;
+        COUNT_RELOC(RELOC_RELATIVE);
+    }
+
+    return idx;
+}
+
 /* Please read the "Initialization and Termination functions" functions.
  * of the linker design note in bionic/linker/README.TXT to understand
  * what the following code is doing.
@@ -1721,6 +1907,7 @@ static int nullify_closed_stdio (void)
 static int link_image(soinfo *si, unsigned wr_offset)
 {
     unsigned *d;
+    unsigned gnu_symndx = 0;
     Elf_Phdr *phdr = si->phdr;
     int phnum = si->phnum;
 
@@ -1827,6 +2014,23 @@ static int link_image(soinfo *si, unsigned wr_offset)
             si->bucket = (unsigned *) (si->base + *d + 8);
             si->chain = (unsigned *) (si->base + *d + 8 + si->nbucket * 4);
             break;
+        case DT_GNU_HASH:
+            si->gnu_nbucket = ((unsigned *) (si->base + *d))[0];
+            gnu_symndx = ((unsigned *) (si->base + *d))[1];
+            si->gnu_maskwords = ((unsigned *) (si->base + *d))[2];
+            si->gnu_shift2 = ((unsigned *) (si->base + *d))[3];
+            si->gnu_bloom_filter = (Elf_Addr *) (si->base + *d + 16);
+            si->gnu_bucket = (unsigned *) (si->gnu_bloom_filter + si->gnu_maskwords);
+            /* amend the chain for symndx */
+            si->gnu_chain = si->gnu_bucket + si->gnu_nbucket - gnu_symndx;
+
+            if (si->gnu_nbucket == 0 ||
+                (si->gnu_maskwords & (si->gnu_maskwords - 1)) != 0) {
+                DL_ERR("%5d invalid DT_GNU_HASH in '%s'", pid, si->name);
+                goto fail;
+            }
+            --si->gnu_maskwords;
+            break;
         case DT_STRTAB:
             si->strtab = (const char *) (si->base + *d);
             break;
@@ -1851,6 +2055,21 @@ static int link_image(soinfo *si, unsigned wr_offset)
         case DT_RELSZ:
             si->rel_count = *d / 8;
             break;
+        case DT_RELR:
+        case DT_ANDROID_RELR:
+            si->relr = (Elf_Addr *) (si->base + *d);
+            break;
+        case DT_RELRSZ:
+        case DT_ANDROID_RELRSZ:
+            si->relr_count = *d / sizeof(Elf_Addr);
+            break;
+        case DT_RELRENT:
+        case DT_ANDROID_RELRENT:
+            if (*d != sizeof(Elf_Addr)) {
+                DL_ERR("%5d invalid DT_RELRENT %d in '%s'", pid, *d, si->name);
+                goto fail;
+            }
+            break;
         case DT_PLTGOT:
             /* Save this in case we decide to do lazy binding. We don't yet. */
             si->plt_got = (unsigned *)(si->base + *d);
@@ -1916,6 +2135,32 @@ static int link_image(soinfo *si, unsigned wr_offset)
         goto fail;
     }
 
+    if((si->nbucket == 0) && (si->gnu_bucket == NULL)) {
+        DL_ERR("%5d empty/missing DT_HASH/DT_GNU_HASH in '%s'", pid, si->name);
+        goto fail;
+    }
+
+    /* Without DT_HASH, count the symbols for find_containing_symbol():
+     * the chain of the last bucket ends with the last symbol */
+    if((si->nchain == 0) && (si->gnu_bucket != NULL)) {
+        unsigned i, n = 0;
+
+        for(i = 0; i < si->gnu_nbucket; i++) {
+            if(si->gnu_bucket[i] > n)
+                n = si->gnu_bucket[i];
+        }
+
+        if(n == 0) {
+            n = gnu_symndx;
+        } else {
+            while((si->gnu_chain[n] & 1) == 0)
+                n++;
+            n++;
+        }
+
+        si->nchain = n;
+    }
+
     /* if this is the main executable, then load all of the preloads now */
     if(si->flags & FLAG_EXE) {
         int i;
@@ -1955,18 +2200,27 @@ static int link_image(soinfo *si, unsigned wr_offset)
         }
     }
 
+    if(si->relr) {
+        DEBUG("[ %5d relocating %s relr ]\n", pid, si->name );
+        if(reloc_relr(si))
+            goto fail;
+    }
     if(si->plt_rel) {
         DEBUG("[ %5d relocating %s plt ]\n", pid, si->name );
         if(reloc_library(si, si->plt_rel, si->plt_rel_count))
             goto fail;
     }
     if(si->rel) {
+        unsigned relative;
+
         DEBUG("[ %5d relocating %s ]\n", pid, si->name );
-        if(reloc_library(si, si->rel, si->rel_count))
+        relative = reloc_relative_prefix(si, si->rel, si->rel_count);
+        if(reloc_library(si, si->rel + relative, si->rel_count - relative))
             goto fail;
     }
 
-    si->flags |= FLAG_LINKED;
+    /* Atomic, dlsym reads the flags of libraries being linked */
+    __atomic_fetch_or(&si->flags, FLAG_LINKED, __ATOMIC_RELEASE);
     DEBUG("[ %5d finished linking %s ]\n", pid, si->name);
 
 #if 0
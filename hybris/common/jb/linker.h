@@ -167,6 +167,19 @@ struct soinfo
     Elf_Addr gnu_relro_start;
     unsigned gnu_relro_len;
 
+    /* DT_GNU_HASH, used instead of DT_HASH when present. gnu_chain is
+     * biased so that it can be indexed with symbol indices, and
+     * gnu_maskwords is the number of bloom filter words minus one. */
+    unsigned gnu_nbucket;
+    unsigned *gnu_bucket;
+    unsigned *gnu_chain;
+    unsigned gnu_maskwords;
+    unsigned gnu_shift2;
+    Elf_Addr *gnu_bloom_filter;
+
+    /* DT_RELR, relative relocations packed as addresses and bitmaps */
+    Elf_Addr *relr;
+    unsigned relr_count;
 };
 
 
@@ -196,6 +209,12 @@ extern soinfo libdl_info;
 
 #endif
 
+#if defined(ANDROID_ARM_LINKER)
+#define R_GENERIC_RELATIVE R_ARM_RELATIVE
+#elif defined(ANDROID_X86_LINKER)
+#define R_GENERIC_RELATIVE R_386_RELATIVE
+#endif
+
 #ifndef DT_INIT_ARRAY
 #define DT_INIT_ARRAY      25
 #endif
@@ -220,11 +239,46 @@ extern soinfo libdl_info;
 #define DT_PREINIT_ARRAYSZ 33
 #endif
 
+#ifndef DT_GNU_HASH
+#define DT_GNU_HASH        0x6ffffef5
+#endif
+
+#ifndef DT_RELRSZ
+#define DT_RELRSZ          35
+#endif
+
+#ifndef DT_RELR
+#define DT_RELR            36
+#endif
+
+#ifndef DT_RELRENT
+#define DT_RELRENT         37
+#endif
+
+/* Used by Android before DT_RELR was standardized */
+#ifndef DT_ANDROID_RELR
+#define DT_ANDROID_RELR    0x6fffe000
+#endif
+
+#ifndef DT_ANDROID_RELRSZ
+#define DT_ANDROID_RELRSZ  0x6fffe001
+#endif
+
+#ifndef DT_ANDROID_RELRENT
+#define DT_ANDROID_RELRENT 0x6fffe003
+#endif
+
 soinfo *find_library(const char *name);
 unsigned unload_library(soinfo *si);
 Elf_Sym *lookup_in_library(soinfo *si, const char *name);
 Elf_Sym *lookup(const char *name, soinfo **found, soinfo *start);
 soinfo *find_containing_library(const void *addr);
+
+/* Held by dlsym and dladdr around the functions above, which skip the
+ * libraries that aren't linked yet.
+ */
+void solist_read_lock(void);
+void solist_read_unlock(void);
 Elf_Sym *find_containing_symbol(const void *addr, soinfo *si);
 const char *linker_get_error(void);
 void call_constructors_recursive(soinfo *si);
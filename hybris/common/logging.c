@@ -83,6 +83,14 @@ hybris_logging_initialize()
                _hybris_should_trace = 1;
         }
     }
+
+    /* Record tracepoints in binary form to HYBRIS_TRACE_FILE.<pid>
+     * instead of printing them, see trace.h */
+    env = getenv("HYBRIS_TRACE_FILE");
+    if (env != NULL && _hybris_should_trace)
+    {
+        hybris_trace_init(env);
+    }
     pthread_mutex_init(&hybris_logging_mutex, NULL);
 }
 
@@ -124,6 +132,11 @@ hybris_get_thread_time()
 int
 hybris_should_trace(const char *module, const char *tracepoint)
 {
+    if (!hybris_logging_initialized) {
+        hybris_logging_initialized = 1;
+        hybris_logging_initialize();
+    }
+
     return _hybris_should_trace;
 }
 
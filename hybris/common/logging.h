@@ -24,6 +24,8 @@
 #include <unistd.h>
 #include <pthread.h>
 
+#include "trace.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -111,8 +113,35 @@ extern FILE *hybris_logging_target;
           } \
      } while(0)
 
+/* Helpers turning up to HYBRIS_TRACE_MAX_ARGS arguments of a tracepoint into a
+ * list of raw 64 bit values, which the binary backend records as they are.
+ * Arguments are sign extended, the converter cuts unsigned ones back to the
+ * word size of the traced process */
+#define HYBRIS_TRACE_CAT_(a, b) HYBRIS_TRACE_CAT__(a, b)
+#define HYBRIS_TRACE_CAT__(a, b) a##b
+#define HYBRIS_TRACE_NARGS_(message, ...) HYBRIS_TRACE_NARGS__(message, ##__VA_ARGS__, 4, 3, 2, 1, 0)
+#define HYBRIS_TRACE_NARGS__(message, a1, a2, a3, a4, n, ...) n
+#define HYBRIS_TRACE_ARG_(a) ((uint64_t) (int64_t) (intptr_t) (a))
+#define HYBRIS_TRACE_ARGS_0(message)
+#define HYBRIS_TRACE_ARGS_1(message, a1) , HYBRIS_TRACE_ARG_(a1)
+#define HYBRIS_TRACE_ARGS_2(message, a1, a2) , HYBRIS_TRACE_ARG_(a1), HYBRIS_TRACE_ARG_(a2)
+#define HYBRIS_TRACE_ARGS_3(message, a1, a2, a3) , HYBRIS_TRACE_ARG_(a1), HYBRIS_TRACE_ARG_(a2), \
+                                                 HYBRIS_TRACE_ARG_(a3)
+#define HYBRIS_TRACE_ARGS_4(message, a1, a2, a3, a4) , HYBRIS_TRACE_ARG_(a1), HYBRIS_TRACE_ARG_(a2), \
+                                                     HYBRIS_TRACE_ARG_(a3), HYBRIS_TRACE_ARG_(a4)
+#define HYBRIS_TRACE_ARGS_(message, ...) \
+          HYBRIS_TRACE_CAT_(HYBRIS_TRACE_ARGS_, HYBRIS_TRACE_NARGS_(message, ##__VA_ARGS__))(message, ##__VA_ARGS__)
+
+/* The binary backend only stores the address of the static description of
+ * the tracepoint and the raw arguments, without locking or formatting */
 #define HYBRIS_TRACE_RECORD(module, what, tracepoint, message, ...) do { \
           if (hybris_should_trace(module, tracepoint)) { \
+            if (hybris_trace_binary()) { \
+              static const struct hybris_tracepoint hybris_tracepoint_ = { module, tracepoint, message, what }; \
+              const uint64_t hybris_trace_args_[] = { 0 HYBRIS_TRACE_ARGS_(message, ##__VA_ARGS__) }; \
+              hybris_trace_record(&hybris_tracepoint_, hybris_trace_args_ + 1, \
+                                  HYBRIS_TRACE_NARGS_(message, ##__VA_ARGS__)); \
+            } else { \
               pthread_mutex_lock(&hybris_logging_mutex); \
               if (hybris_logging_format() == HYBRIS_LOG_FORMAT_NORMAL) \
               { \
@@ -132,6 +161,7 @@ extern FILE *hybris_logging_target;
                 fflush(hybris_logging_target); \
               } \
              pthread_mutex_unlock(&hybris_logging_mutex); \
+            } \
           } \
       } while(0)
 #    define HYBRIS_TRACE_BEGIN(module, tracepoint, message, ...) HYBRIS_TRACE_RECORD(module, 'B', tracepoint, message, ##__VA_ARGS__)
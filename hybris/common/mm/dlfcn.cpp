@@ -30,13 +30,14 @@
 #include "private/ThreadLocalBuffer.h"
 
 #include "hybris_compat.h"
+#include "linker_dlsym_cache.h"
 
 /* This file hijacks the symbols stubbed out in libdl.so. */
 
 static pthread_mutex_t g_dl_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
 
-static char dl_err_buf[1024];
-static const char *dl_err_str;
+// Per thread, dlsym fails on several threads at once.
+static __thread char dl_err_buf[1024];
 
 static const char* __bionic_set_dlerror(char* new_value) {
 #ifdef DISABLED_FOR_HYBRIS_SUPPORT
@@ -102,8 +103,6 @@ extern "C" void* android_dlopen(const char* filename, int flags) {
 }
 
 extern "C" void* android_dlsym(void* handle, const char* symbol) {
-  ScopedPthreadMutexLocker locker(&g_dl_mutex);
-
 #if !defined(__LP64__)
   if (handle == nullptr) {
     __bionic_format_dlerror("dlsym library handle is null", nullptr);
@@ -116,52 +115,94 @@ extern "C" void* android_dlsym(void* handle, const char* symbol) {
     return nullptr;
   }
 
+  // hybris: neither the cache nor the lookup take g_dl_mutex, see
+  // ScopedSolistLock.
+  bool cacheable = handle != RTLD_DEFAULT && handle != RTLD_NEXT &&
+                   !reinterpret_cast<soinfo*>(handle)->is_main_executable();
+  void* cached;
+  if (cacheable && dlsym_cache_lookup(handle, symbol, &cached)) {
+    return cached;
+  }
+
   soinfo* found = nullptr;
   const ElfW(Sym)* sym = nullptr;
-  void* caller_addr = __builtin_return_address(0);
-  soinfo* caller = find_containing_library(caller_addr);
+  ElfW(Addr) address = 0;
+  bool is_ifunc = false;
+  uint32_t generation;
+  {
+    ScopedSolistLock lock(false);
+    generation = dlsym_cache_generation();
+
+    if (handle == RTLD_DEFAULT || handle == RTLD_NEXT) {
+      void* caller_addr = __builtin_return_address(0);
+      soinfo* caller = find_containing_library(caller_addr);
+      sym = dlsym_linear_lookup(symbol, &found, caller, handle);
+    } else {
+      sym = dlsym_handle_lookup(reinterpret_cast<soinfo*>(handle), &found, symbol);
+    }
 
-  if (handle == RTLD_DEFAULT || handle == RTLD_NEXT) {
-    sym = dlsym_linear_lookup(symbol, &found, caller, handle);
-  } else {
-    sym = dlsym_handle_lookup(reinterpret_cast<soinfo*>(handle), &found, symbol);
-  }
+    if (sym != nullptr) {
+      unsigned bind = ELF_ST_BIND(sym->st_info);
 
-  if (sym != nullptr) {
-    unsigned bind = ELF_ST_BIND(sym->st_info);
+      if ((bind != STB_GLOBAL && bind != STB_WEAK) || sym->st_shndx == 0) {
+        __bionic_format_dlerror("symbol found but not global", symbol);
+        return nullptr;
+      }
 
-    if ((bind == STB_GLOBAL || bind == STB_WEAK) && sym->st_shndx != 0) {
-      return reinterpret_cast<void*>(found->resolve_symbol_address(sym));
+      address = sym->st_value + found->load_bias;
+      is_ifunc = ELFW(ST_TYPE)(sym->st_info) == STT_GNU_IFUNC;
     }
+  }
 
-    __bionic_format_dlerror("symbol found but not global", symbol);
-    return nullptr;
-  } else {
+  if (sym == nullptr) {
     __bionic_format_dlerror("undefined symbol", symbol);
     return nullptr;
   }
+
+  // Resolvers run without the lock, they may call dlsym themselves.
+  if (is_ifunc) {
+    address = call_ifunc_resolver(address);
+  }
+
+  void* result = reinterpret_cast<void*>(address);
+  if (cacheable) {
+    dlsym_cache_store(handle, symbol, generation, result);
+  }
+  return result;
 }
 
 extern "C" int android_dladdr(const void* addr, Dl_info* info) {
-  ScopedPthreadMutexLocker locker(&g_dl_mutex);
+  ElfW(Addr) address = 0;
+  bool is_ifunc = false;
+  {
+    ScopedSolistLock lock(false);
+
+    // Determine if this address can be found in any library currently mapped.
+    soinfo* si = find_containing_library(addr);
+    if (si == nullptr) {
+      return 0;
+    }
 
-  // Determine if this address can be found in any library currently mapped.
-  soinfo* si = find_containing_library(addr);
-  if (si == nullptr) {
-    return 0;
-  }
+    memset(info, 0, sizeof(Dl_info));
 
-  memset(info, 0, sizeof(Dl_info));
+    info->dli_fname = si->get_realpath();
+    // Address at which the shared object is loaded.
+    info->dli_fbase = reinterpret_cast<void*>(si->base);
 
-  info->dli_fname = si->get_realpath();
-  // Address at which the shared object is loaded.
-  info->dli_fbase = reinterpret_cast<void*>(si->base);
+    // Determine if any symbol in the library contains the specified address.
+    ElfW(Sym)* sym = si->find_symbol_by_address(addr);
+    if (sym != nullptr) {
+      info->dli_sname = si->get_string(sym->st_name);
+      address = sym->st_value + si->load_bias;
+      is_ifunc = ELFW(ST_TYPE)(sym->st_info) == STT_GNU_IFUNC;
+    }
+  }
 
-  // Determine if any symbol in the library contains the specified address.
-  ElfW(Sym)* sym = si->find_symbol_by_address(addr);
-  if (sym != nullptr) {
-    info->dli_sname = si->get_string(sym->st_name);
-    info->dli_saddr = reinterpret_cast<void*>(si->resolve_symbol_address(sym));
+  if (is_ifunc) {
+    address = call_ifunc_resolver(address);
+  }
+  if (info->dli_sname != nullptr) {
+    info->dli_saddr = reinterpret_cast<void*>(address);
   }
 
   return 1;
@@ -39,6 +39,9 @@
 #include <sys/param.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <new>
 #include <string>
 #include <vector>
@@ -53,12 +56,20 @@
 #include "linker.h"
 #include "linker_block_allocator.h"
 #include "linker_debug.h"
+#include "linker_dir_cache.h"
+#include "linker_dlsym_cache.h"
+#include "linker_library_index.h"
 #include "linker_sleb128.h"
 #include "linker_phdr.h"
+#include "linker_profile.h"
 #include "linker_relocs.h"
 #include "linker_reloc_iterators.h"
+#include "linker_lazy_bind.h"
+#include "linker_reloc_cache.h"
+#include "linker_relro_share.h"
 
 #include "hybris_compat.h"
+#include "hook_table.h"
 
 #ifdef DISABLED_FOR_HYBRIS_SUPPORT
 extern void __libc_init_AT_SECURE(KernelArgumentBlock&);
@@ -75,6 +86,23 @@ static LinkerTypeAllocator<LinkedListEntry<soinfo>> g_soinfo_links_allocator;
 
 static soinfo* solist = get_libdl_info();
 static soinfo* sonext = get_libdl_info();
+static LibraryIndex g_library_index;
+
+// See ScopedSolistLock. Writers are preferred, a steady stream of dlsym
+// calls must not keep dlopen waiting; readers never nest.
+static pthread_rwlock_t g_solist_rwlock = PTHREAD_RWLOCK_WRITER_NONRECURSIVE_INITIALIZER_NP;
+
+ScopedSolistLock::ScopedSolistLock(bool write) {
+  if (write) {
+    pthread_rwlock_wrlock(&g_solist_rwlock);
+  } else {
+    pthread_rwlock_rdlock(&g_solist_rwlock);
+  }
+}
+
+ScopedSolistLock::~ScopedSolistLock() {
+  pthread_rwlock_unlock(&g_solist_rwlock);
+}
 static soinfo* somain; // main process, always the one after libdl_info
 
 static const char* const kDefaultLdPaths[] = {
@@ -103,6 +131,8 @@ abort_msg_t* g_abort_message = nullptr; // For debuggerd.
 #if STATS
 struct linker_stats_t {
   int count[kRelocMax];
+  size_t lookup_memo_hits;
+  size_t lookup_memo_misses;
 };
 
 static linker_stats_t linker_stats;
@@ -110,9 +140,20 @@ static linker_stats_t linker_stats;
 void count_relocation(RelocationKind kind) {
   ++linker_stats.count[kind];
 }
+
+void count_symbol_lookup(bool memo_hit) {
+  if (memo_hit) {
+    ++linker_stats.lookup_memo_hits;
+  } else {
+    ++linker_stats.lookup_memo_misses;
+  }
+}
 #else
 void count_relocation(RelocationKind) {
 }
+
+void count_symbol_lookup(bool) {
+}
 #endif
 
 #if COUNT_PAGES
@@ -141,6 +182,22 @@ static r_debug _r_debug =
 static link_map* r_debug_tail = 0;
 
 static void* (*_get_hooked_symbol)(const char *sym, const char *requester);
+static const hybris_hook_table* g_hook_table = nullptr;
+
+// hybris: looks sym up in the hook table of libhybris if it was handed
+// over, and only calls back into libhybris if the table can't answer.
+static inline void* find_hooked_symbol(const char* sym, const char* requester) {
+  const hybris_hook_table* table = g_hook_table;
+  if (table == nullptr || __atomic_load_n(&table->use_callback, __ATOMIC_RELAXED)) {
+    return _get_hooked_symbol(sym, requester);
+  }
+
+  const hybris_hook_slot* slot = hybris_hook_table_find(table, sym, hybris_hook_hash(sym));
+  if (slot != nullptr) {
+    return slot->func;
+  }
+  return hybris_hook_table_miss_needs_callback(sym) ? _get_hooked_symbol(sym, requester) : nullptr;
+}
 
 static void insert_soinfo_into_debug_map(soinfo* info) {
   // Copy the necessary fields into the debug structure.
@@ -239,8 +296,10 @@ static soinfo* soinfo_alloc(const char* name, struct stat* file_stat,
 
   soinfo* si = new (g_soinfo_allocator.alloc()) soinfo(name, file_stat, file_offset, rtld_flags);
 
+  ScopedSolistLock lock(true);
   sonext->next = si;
   sonext = si;
+  g_library_index.add_file(si);
 
   TRACE("name %s: allocated soinfo @ %p", name, si);
   return si;
@@ -251,6 +310,11 @@ static void soinfo_free(soinfo* si) {
     return;
   }
 
+  ScopedSolistLock lock(true);
+
+  g_library_index.remove(si);
+  dlsym_cache_invalidate();
+
   if (si->base != 0 && si->size != 0) {
     munmap(reinterpret_cast<void*>(si->base), si->size);
   }
@@ -651,11 +715,17 @@ soinfo::soinfo(const char* realpath, const struct stat* file_stat,
     this->st_dev_ = file_stat->st_dev;
     this->st_ino_ = file_stat->st_ino;
     this->file_offset_ = file_offset;
+    this->file_size_ = file_stat->st_size;
+    this->file_mtime_ = file_stat->st_mtim;
   }
 
   this->rtld_flags_ = rtld_flags;
 }
 
+soinfo::~soinfo() {
+  delete lazy_binding_;
+}
+
 
 uint32_t SymbolName::elf_hash() {
   if (!has_elf_hash_) {
@@ -691,12 +761,97 @@ uint32_t SymbolName::gnu_hash() {
   return gnu_hash_;
 }
 
+uint32_t SymbolLookupMemo::hash_of(SymbolName& symbol_name, const version_info* vi) {
+  uint32_t hash = symbol_name.gnu_hash();
+  if (vi != nullptr) {
+    hash ^= vi->elf_hash * 0x9e3779b1;
+  }
+  return hash;
+}
+
+bool SymbolLookupMemo::find(SymbolName& symbol_name, const version_info* vi,
+                            soinfo** si_found_in, const ElfW(Sym)** symbol) const {
+  if (count_ == 0) {
+    return false;
+  }
+
+  uint32_t hash = hash_of(symbol_name, vi);
+  size_t mask = entries_.size() - 1;
+
+  for (size_t i = hash & mask; entries_[i].name != nullptr; i = (i + 1) & mask) {
+    const Entry& entry = entries_[i];
+    if (entry.hash != hash || strcmp(entry.name, symbol_name.get_name()) != 0) {
+      continue;
+    }
+
+    if (vi == nullptr ? entry.version != nullptr :
+        (entry.version == nullptr || strcmp(entry.version, vi->name) != 0)) {
+      continue;
+    }
+
+    *si_found_in = entry.si_found_in;
+    *symbol = entry.symbol;
+    return true;
+  }
+
+  return false;
+}
+
+void SymbolLookupMemo::insert(SymbolName& symbol_name, const version_info* vi,
+                              soinfo* si_found_in, const ElfW(Sym)* symbol) {
+  // keep the table at most half full
+  if ((count_ + 1) * 2 > entries_.size()) {
+    std::vector<Entry> old_entries(entries_.size() == 0 ? 512 : entries_.size() * 2);
+    old_entries.swap(entries_);
+
+    size_t mask = entries_.size() - 1;
+    for (const Entry& entry : old_entries) {
+      if (entry.name == nullptr) {
+        continue;
+      }
+
+      size_t i = entry.hash & mask;
+      while (entries_[i].name != nullptr) {
+        i = (i + 1) & mask;
+      }
+      entries_[i] = entry;
+    }
+  }
+
+  uint32_t hash = hash_of(symbol_name, vi);
+  size_t mask = entries_.size() - 1;
+  size_t i = hash & mask;
+  while (entries_[i].name != nullptr) {
+    i = (i + 1) & mask;
+  }
+
+  Entry& entry = entries_[i];
+  entry.name = symbol_name.get_name();
+  entry.version = vi != nullptr ? vi->name : nullptr;
+  entry.hash = hash;
+  entry.si_found_in = si_found_in;
+  entry.symbol = symbol;
+  ++count_;
+}
+
 bool soinfo_do_lookup(soinfo* si_from, const char* name, const version_info* vi,
                       soinfo** si_found_in, const soinfo::soinfo_list_t& global_group,
-                      const soinfo::soinfo_list_t& local_group, const ElfW(Sym)** symbol) {
+                      const soinfo::soinfo_list_t& local_group, const ElfW(Sym)** symbol,
+                      SymbolLookupMemo* lookup_memo) {
   SymbolName symbol_name(name);
   const ElfW(Sym)* s = nullptr;
 
+  // The groups are the same for every library of a link pass, so is the
+  // result, except for DT_SYMBOLIC libraries which look in themselves first.
+  if (si_from->has_DT_SYMBOLIC) {
+    lookup_memo = nullptr;
+  }
+
+  if (lookup_memo != nullptr && lookup_memo->find(symbol_name, vi, si_found_in, symbol)) {
+    count_symbol_lookup(true);
+    return true;
+  }
+
   /* "This element's presence in a shared object library alters the dynamic linker's
    * symbol resolution algorithm for references within the library. Instead of starting
    * a symbol search with the executable file, the dynamic linker starts from the shared
@@ -780,6 +935,11 @@ bool soinfo_do_lookup(soinfo* si_from, const char* name, const version_info* vi,
                reinterpret_cast<void*>((*si_found_in)->load_bias));
   }
 
+  if (lookup_memo != nullptr) {
+    lookup_memo->insert(symbol_name, vi, s != nullptr ? *si_found_in : nullptr, s);
+    count_symbol_lookup(false);
+  }
+
   *symbol = s;
   return true;
 }
@@ -894,18 +1054,17 @@ typedef linked_list_t<LoadTask> LoadTaskList;
 //
 // walk_dependencies_tree returns false if walk was terminated
 // by the action and true otherwise.
+//
+// hybris: the lists are vectors, not linked lists from the linker's block
+// allocators, because dlsym walks the tree without holding the dl mutex.
 template<typename F>
 static bool walk_dependencies_tree(soinfo* root_soinfos[], size_t root_soinfos_size, F action) {
-  SoinfoLinkedList visit_list;
-  SoinfoLinkedList visited;
+  std::vector<soinfo*> visit_list(root_soinfos, root_soinfos + root_soinfos_size);
+  std::vector<soinfo*> visited;
 
-  for (size_t i = 0; i < root_soinfos_size; ++i) {
-    visit_list.push_back(root_soinfos[i]);
-  }
-
-  soinfo* si;
-  while ((si = visit_list.pop_front()) != nullptr) {
-    if (visited.contains(si)) {
+  for (size_t i = 0; i < visit_list.size(); ++i) {
+    soinfo* si = visit_list[i];
+    if (std::find(visited.begin(), visited.end(), si) != visited.end()) {
       continue;
     }
 
@@ -992,6 +1151,10 @@ const ElfW(Sym)* dlsym_linear_lookup(const char* name,
 
   const ElfW(Sym)* s = nullptr;
   for (soinfo* si = start; si != nullptr; si = si->next) {
+    if (!si->is_linked()) {
+      continue;
+    }
+
     // Do not skip RTLD_LOCAL libraries in dlsym(RTLD_DEFAULT, ...)
     // if the library is opened by application with target api level <= 22
     // See http://b/21565766
@@ -1029,7 +1192,7 @@ const ElfW(Sym)* dlsym_linear_lookup(const char* name,
 soinfo* find_containing_library(const void* p) {
   ElfW(Addr) address = reinterpret_cast<ElfW(Addr)>(p);
   for (soinfo* si = solist; si != nullptr; si = si->next) {
-    if (address >= si->base && address - si->base < si->size) {
+    if (si->is_linked() && address >= si->base && address - si->base < si->size) {
       return si;
     }
   }
@@ -1095,6 +1258,10 @@ static bool format_path(char* buf, size_t buf_size, const char* path, const char
 static int open_library_on_default_path(const char* name, off64_t* file_offset) {
   for (size_t i = 0; kDefaultLdPaths[i] != nullptr; ++i) {
     char buf[512];
+    if (!dir_cache_may_contain(kDefaultLdPaths[i], name)) {
+      continue;
+    }
+
     if (!format_path(buf, sizeof(buf), kDefaultLdPaths[i], name)) {
       continue;
     }
@@ -1113,6 +1280,10 @@ static int open_library_on_ld_library_path(const char* name, off64_t* file_offse
   for (const auto& path_str : g_ld_library_paths) {
     char buf[512];
     const char* const path = path_str.c_str();
+    if (!dir_cache_may_contain(path, name)) {
+      continue;
+    }
+
     if (!format_path(buf, sizeof(buf), path, name)) {
       continue;
     }
@@ -1178,6 +1349,40 @@ static void for_each_dt_needed(const soinfo* si, F action) {
   }
 }
 
+// Library with the same file already loaded under a different name/path?
+static soinfo* find_loaded_library_by_inode(const struct stat& file_stat, off64_t file_offset) {
+  return g_library_index.find_file(file_stat.st_dev, file_stat.st_ino, file_offset);
+}
+
+// Creates the soinfo for a library whose segments elf_reader has mapped
+// and queues its DT_NEEDED entries.
+static soinfo* load_library(ElfReader& elf_reader, LoadTaskList& load_tasks,
+                            const char* realpath, struct stat* file_stat,
+                            off64_t file_offset, int rtld_flags) {
+  soinfo* si = soinfo_alloc(realpath, file_stat, file_offset, rtld_flags);
+  if (si == nullptr) {
+    return nullptr;
+  }
+  si->base = elf_reader.load_start();
+  si->size = elf_reader.load_size();
+  si->load_bias = elf_reader.load_bias();
+  si->phnum = elf_reader.phdr_count();
+  si->phdr = elf_reader.loaded_phdr();
+
+  uint64_t profile_start = linker_profile_begin();
+  if (!si->prelink_image()) {
+    soinfo_free(si);
+    return nullptr;
+  }
+  linker_profile_end(realpath, kProfilePrelink, profile_start);
+
+  for_each_dt_needed(si, [&] (const char* name) {
+    load_tasks.push_back(LoadTask::create(name, si));
+  });
+
+  return si;
+}
+
 static soinfo* load_library(int fd, off64_t file_offset,
                             LoadTaskList& load_tasks,
                             const char* name, int rtld_flags,
@@ -1205,16 +1410,11 @@ static soinfo* load_library(int fd, off64_t file_offset,
   // Check for symlink and other situations where
   // file can have different names, unless ANDROID_DLEXT_FORCE_LOAD is set
   if (extinfo == nullptr || (extinfo->flags & ANDROID_DLEXT_FORCE_LOAD) == 0) {
-    for (soinfo* si = solist; si != nullptr; si = si->next) {
-      if (si->get_st_dev() != 0 &&
-          si->get_st_ino() != 0 &&
-          si->get_st_dev() == file_stat.st_dev &&
-          si->get_st_ino() == file_stat.st_ino &&
-          si->get_file_offset() == file_offset) {
-        TRACE("library \"%s\" is already loaded under different name/path \"%s\" - "
-            "will return existing soinfo", name, si->get_realpath());
-        return si;
-      }
+    soinfo* si = find_loaded_library_by_inode(file_stat, file_offset);
+    if (si != nullptr) {
+      TRACE("library \"%s\" is already loaded under different name/path \"%s\" - "
+          "will return existing soinfo", name, si->get_realpath());
+      return si;
     }
   }
 
@@ -1230,36 +1430,225 @@ static soinfo* load_library(int fd, off64_t file_offset,
   }
 
   // Read the ELF header and load the segments.
+  uint64_t profile_start = linker_profile_begin();
   ElfReader elf_reader(realpath.c_str(), fd, file_offset, file_stat.st_size);
   if (!elf_reader.Load(extinfo)) {
     return nullptr;
   }
+  linker_profile_end(realpath.c_str(), kProfileMap, profile_start);
 
-  soinfo* si = soinfo_alloc(realpath.c_str(), &file_stat, file_offset, rtld_flags);
-  if (si == nullptr) {
-    return nullptr;
+  return load_library(elf_reader, load_tasks, realpath.c_str(), &file_stat, file_offset, rtld_flags);
+}
+
+// Returns true if library was found and false in 2 cases
+// 1. The library was found but loaded under different target_sdk_version
+//    (*candidate != nullptr)
+// 2. The library was not found by soname (*candidate is nullptr)
+static bool find_loaded_library_by_soname(const char* name, soinfo** candidate) {
+  *candidate = nullptr;
+
+  // Ignore filename with path.
+  if (strchr(name, '/') != nullptr) {
+    return false;
   }
-  si->base = elf_reader.load_start();
-  si->size = elf_reader.load_size();
-  si->load_bias = elf_reader.load_bias();
-  si->phnum = elf_reader.phdr_count();
-  si->phdr = elf_reader.loaded_phdr();
 
-  if (!si->prelink_image()) {
-    soinfo_free(si);
-    return nullptr;
+  uint32_t target_sdk_version = get_application_target_sdk_version();
+
+  // hybris: libdl comes first in solist and isn't indexed, the others are
+  // found in g_library_index in solist order.
+  if (strcmp(name, solist->get_soname()) == 0) {
+    *candidate = solist;
+    return true;
   }
 
-  for_each_dt_needed(si, [&] (const char* name) {
-    load_tasks.push_back(LoadTask::create(name, si));
-  });
+  const LibraryIndex::soinfo_vector_t* libraries = g_library_index.find_soname(name);
+  if (libraries == nullptr) {
+    return false;
+  }
 
-  return si;
+  for (soinfo* si : *libraries) {
+    // If the library was opened under different target sdk version
+    // skip this step and try to reopen it. The exception is the global
+    // group. There is no point in skipping it because relocation
+    // process is going to use it in any case.
+    if ((si->get_dt_flags_1() & DF_1_GLOBAL) != 0 ||
+        !si->is_linked() || si->get_target_sdk_version() == target_sdk_version) {
+      *candidate = si;
+      return true;
+    } else if (*candidate == nullptr) {
+      // for the different sdk version - remember the first library.
+      *candidate = si;
+    }
+  }
+
+  return false;
+}
+
+// hybris: opening a library, reading its headers and mapping its segments
+// touches no linker state, so find_libraries does that part for a whole
+// breadth-first level of the dependency tree on a few worker threads
+// before creating and linking the soinfos one by one, in the usual order.
+class PrefetchedLibrary {
+ public:
+  enum State {
+    kNotFound,  // let load_library search (and complain) as usual
+    kFailed,    // found but not loadable, the error is already reported
+    kLoaded,    // segments are mapped
+    kUsed,      // handed over to a soinfo
+  };
+
+  explicit PrefetchedLibrary(const char* name)
+      : name_(name), state_(kNotFound), fd_(-1) {}
+
+  ~PrefetchedLibrary() {
+    if (state_ == kLoaded) {
+      munmap(reinterpret_cast<void*>(elf_reader_->load_start()), elf_reader_->load_size());
+    }
+    elf_reader_.reset();
+    if (fd_ != -1) {
+      close(fd_);
+    }
+  }
+
+  const char* get_name() const {
+    return name_;
+  }
+
+  // Runs on a worker thread.
+  void load() {
+    off64_t file_offset;
+    uint64_t profile_start = linker_profile_begin();
+    fd_ = open_library(name_, &file_offset);
+    linker_profile_end(name_, kProfileOpen, profile_start);
+    if (fd_ == -1) {
+      return;
+    }
+
+    state_ = kFailed;
+    if (TEMP_FAILURE_RETRY(fstat(fd_, &file_stat_)) != 0) {
+      DL_ERR("unable to stat file for the library \"%s\": %s", name_, strerror(errno));
+      return;
+    }
+
+    if (!realpath_fd(fd_, &realpath_)) {
+      PRINT("warning: unable to get realpath for the library \"%s\". Will use given name.", name_);
+      realpath_ = name_;
+    }
+
+    profile_start = linker_profile_begin();
+    elf_reader_.reset(new ElfReader(realpath_.c_str(), fd_, 0, file_stat_.st_size));
+    if (elf_reader_->Load(nullptr)) {
+      state_ = kLoaded;
+      linker_profile_end(realpath_.c_str(), kProfileMap, profile_start);
+    }
+  }
+
+  // Runs on the main thread, does what load_library does after ElfReader::Load.
+  soinfo* to_soinfo(LoadTaskList& load_tasks, int rtld_flags) {
+    if (state_ != kLoaded) {
+      return nullptr;
+    }
+
+    soinfo* si = find_loaded_library_by_inode(file_stat_, 0);
+    if (si != nullptr) {
+      TRACE("library \"%s\" is already loaded under different name/path \"%s\" - "
+          "will return existing soinfo", name_, si->get_realpath());
+      return si;
+    }
+
+    state_ = kUsed;
+    return load_library(*elf_reader_, load_tasks, realpath_.c_str(), &file_stat_, 0, rtld_flags);
+  }
+
+  State get_state() const {
+    return state_;
+  }
+
+ private:
+  const char* name_;
+  State state_;
+  int fd_;
+  struct stat file_stat_;
+  std::string realpath_;
+  std::unique_ptr<ElfReader> elf_reader_;
+
+  DISALLOW_COPY_AND_ASSIGN(PrefetchedLibrary);
+};
+
+typedef std::vector<std::unique_ptr<PrefetchedLibrary>> PrefetchedLibraries;
+
+// Number of threads used to load a level of the dependency tree,
+// HYBRIS_LD_LOAD_THREADS=1 turns parallel loading off.
+static size_t g_ld_load_threads = 0;
+
+struct prefetch_work_t {
+  PrefetchedLibraries* libraries;
+  std::atomic<size_t> next;
+};
+
+static void* prefetch_worker(void* arg) {
+  prefetch_work_t* work = reinterpret_cast<prefetch_work_t*>(arg);
+  size_t i;
+  while ((i = work->next.fetch_add(1)) < work->libraries->size()) {
+    (*work->libraries)[i]->load();
+  }
+  return nullptr;
+}
+
+static bool is_prefetched(const PrefetchedLibraries& prefetched, const char* name) {
+  for (const auto& p : prefetched) {
+    if (strcmp(p->get_name(), name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void prefetch_libraries(const std::vector<const char*>& names,
+                               PrefetchedLibraries* prefetched) {
+  prefetched->clear();
+
+  for (const char* name : names) {
+    soinfo* candidate;
+    if (!find_loaded_library_by_soname(name, &candidate) && !is_prefetched(*prefetched, name)) {
+      prefetched->push_back(std::unique_ptr<PrefetchedLibrary>(new PrefetchedLibrary(name)));
+    }
+  }
+
+  // A single library is loaded directly, not worth a thread.
+  if (prefetched->size() < 2 || g_ld_load_threads < 2) {
+    prefetched->clear();
+    return;
+  }
+
+  prefetch_work_t work;
+  work.libraries = prefetched;
+  work.next = 0;
+
+  size_t thread_count = MIN(g_ld_load_threads, prefetched->size()) - 1;
+  std::vector<pthread_t> threads;
+  for (size_t i = 0; i < thread_count; ++i) {
+    pthread_t thread;
+    if (pthread_create(&thread, nullptr, prefetch_worker, &work) != 0) {
+      break;
+    }
+    threads.push_back(thread);
+  }
+
+  // The calling thread helps, which also covers pthread_create failures.
+  prefetch_worker(&work);
+
+  for (pthread_t thread : threads) {
+    pthread_join(thread, nullptr);
+  }
+
+  TRACE("[ loaded %zu libraries on %zu threads ]", prefetched->size(), threads.size() + 1);
 }
 
 static soinfo* load_library(LoadTaskList& load_tasks,
                             const char* name, int rtld_flags,
-                            const android_dlextinfo* extinfo) {
+                            const android_dlextinfo* extinfo,
+                            PrefetchedLibraries& prefetched) {
   if (extinfo != nullptr && (extinfo->flags & ANDROID_DLEXT_USE_LIBRARY_FD) != 0) {
     off64_t file_offset = 0;
     if ((extinfo->flags & ANDROID_DLEXT_USE_LIBRARY_FD_OFFSET) != 0) {
@@ -1268,9 +1657,17 @@ static soinfo* load_library(LoadTaskList& load_tasks,
     return load_library(extinfo->library_fd, file_offset, load_tasks, name, rtld_flags, extinfo);
   }
 
+  for (const auto& p : prefetched) {
+    if (strcmp(p->get_name(), name) == 0 && p->get_state() != PrefetchedLibrary::kNotFound) {
+      return p->to_soinfo(load_tasks, rtld_flags);
+    }
+  }
+
   // Open the file.
   off64_t file_offset;
+  uint64_t profile_start = linker_profile_begin();
   int fd = open_library(name, &file_offset);
+  linker_profile_end(name, kProfileOpen, profile_start);
   if (fd == -1) {
     DL_ERR("library \"%s\" not found", name);
     return nullptr;
@@ -1280,57 +1677,33 @@ static soinfo* load_library(LoadTaskList& load_tasks,
   return result;
 }
 
-// Returns true if library was found and false in 2 cases
-// 1. The library was found but loaded under different target_sdk_version
-//    (*candidate != nullptr)
-// 2. The library was not found by soname (*candidate is nullptr)
-static bool find_loaded_library_by_soname(const char* name, soinfo** candidate) {
-  *candidate = nullptr;
-
-  // Ignore filename with path.
-  if (strchr(name, '/') != nullptr) {
-    return false;
-  }
-
-  uint32_t target_sdk_version = get_application_target_sdk_version();
-
-  for (soinfo* si = solist; si != nullptr; si = si->next) {
-    const char* soname = si->get_soname();
-    if (soname != nullptr && (strcmp(name, soname) == 0)) {
-      // If the library was opened under different target sdk version
-      // skip this step and try to reopen it. The exceptions are
-      // "libdl.so" and global group. There is no point in skipping
-      // them because relocation process is going to use them
-      // in any case.
-      bool is_libdl = si == solist;
-      if (is_libdl || (si->get_dt_flags_1() & DF_1_GLOBAL) != 0 ||
-          !si->is_linked() || si->get_target_sdk_version() == target_sdk_version) {
-        *candidate = si;
-        return true;
-      } else if (*candidate == nullptr) {
-        // for the different sdk version - remember the first library.
-        *candidate = si;
-      }
-    }
-  }
-
-  return false;
-}
-
 static soinfo* find_library_internal(LoadTaskList& load_tasks, const char* name,
-                                     int rtld_flags, const android_dlextinfo* extinfo) {
+                                     int rtld_flags, const android_dlextinfo* extinfo,
+                                     PrefetchedLibraries& prefetched) {
   soinfo* candidate;
 
   if (find_loaded_library_by_soname(name, &candidate)) {
     return candidate;
   }
 
+  // hybris: a path a library was loaded from, with a stat instead of
+  // opening it again. A file replaced since then is loaded anew.
+  if (extinfo == nullptr && strchr(name, '/') != nullptr) {
+    soinfo* si = g_library_index.find_realpath(name);
+    struct stat file_stat;
+    if (si != nullptr && si->get_file_offset() == 0 && stat(name, &file_stat) == 0 &&
+        si->get_st_dev() == file_stat.st_dev && si->get_st_ino() == file_stat.st_ino) {
+      TRACE("[ '%s' is already loaded ]", name);
+      return si;
+    }
+  }
+
   // Library might still be loaded, the accurate detection
   // of this fact is done by load_library.
   TRACE("[ '%s' find_loaded_library_by_soname returned false (*candidate=%s@%p). Trying harder...]",
       name, candidate == nullptr ? "n/a" : candidate->get_realpath(), candidate);
 
-  soinfo* si = load_library(load_tasks, name, rtld_flags, extinfo);
+  soinfo* si = load_library(load_tasks, name, rtld_flags, extinfo, prefetched);
 
   // In case we were unable to load the library but there
   // is a candidate loaded under the same soname but different
@@ -1403,9 +1776,30 @@ static bool find_libraries(soinfo* start_with, const char* const library_names[]
   });
 
   // Step 1: load and pre-link all DT_NEEDED libraries in breadth first order.
+  // Whenever a level of the tree starts, the tasks in the queue are
+  // exactly that level, which gets mapped in parallel first.
+  bool prefetch = extinfo == nullptr && (rtld_flags & RTLD_NOLOAD) == 0;
+  PrefetchedLibraries prefetched;
+  size_t level_remaining = 0;
+
   for (LoadTask::unique_ptr task(load_tasks.pop_front());
       task.get() != nullptr; task.reset(load_tasks.pop_front())) {
-    soinfo* si = find_library_internal(load_tasks, task->get_name(), rtld_flags, extinfo);
+    if (level_remaining == 0) {
+      std::vector<const char*> level;
+      level.push_back(task->get_name());
+      load_tasks.for_each([&] (LoadTask* t) {
+        level.push_back(t->get_name());
+      });
+
+      level_remaining = level.size();
+      if (prefetch) {
+        prefetch_libraries(level, &prefetched);
+      }
+    }
+    level_remaining--;
+
+    soinfo* si = find_library_internal(load_tasks, task->get_name(), rtld_flags, extinfo,
+                                       prefetched);
     if (si == nullptr) {
       return false;
     }
@@ -1450,9 +1844,10 @@ static bool find_libraries(soinfo* start_with, const char* const library_names[]
   // the root of the local group was not linked.
   bool was_local_group_root_linked = local_group.front()->is_linked();
 
+  SymbolLookupMemo lookup_memo;
   bool linked = local_group.visit([&](soinfo* si) {
     if (!si->is_linked()) {
-      if (!si->link_image(global_group, local_group, extinfo)) {
+      if (!si->link_image(global_group, local_group, extinfo, &lookup_memo)) {
         return false;
       }
       si->set_linked();
@@ -1461,6 +1856,11 @@ static bool find_libraries(soinfo* start_with, const char* const library_names[]
     return true;
   });
 
+#if STATS
+  PRINT("LOOKUP STATS: %s: %zu memo hits, %zu misses", local_group.front()->get_realpath(),
+        linker_stats.lookup_memo_hits, linker_stats.lookup_memo_misses);
+#endif
+
   if (linked) {
     failure_guard.disable();
   }
@@ -1620,10 +2020,12 @@ soinfo* do_dlopen(const char* name, int flags, const android_dlextinfo* extinfo)
   }
 
   ProtectedDataGuard guard;
+  linker_profile_dlopen_begin(name);
   soinfo* si = find_library(name, flags, extinfo);
   if (si != nullptr) {
     si->call_constructors();
   }
+  linker_profile_dlopen_end();
   return si;
 }
 
@@ -1632,7 +2034,7 @@ void do_dlclose(soinfo* si) {
   soinfo_unload(si);
 }
 
-static ElfW(Addr) call_ifunc_resolver(ElfW(Addr) resolver_addr) {
+ElfW(Addr) call_ifunc_resolver(ElfW(Addr) resolver_addr) {
   typedef ElfW(Addr) (*ifunc_resolver_t)(void);
   ifunc_resolver_t ifunc_resolver = reinterpret_cast<ifunc_resolver_t>(resolver_addr);
   ElfW(Addr) ifunc_addr = ifunc_resolver();
@@ -1750,6 +2152,60 @@ bool soinfo::lookup_version_info(const VersionTracker& version_tracker, ElfW(Wor
   return true;
 }
 
+static inline void apply_relative(const ElfW(Rela)* rela, ElfW(Addr) load_bias) {
+  *reinterpret_cast<ElfW(Addr)*>(rela->r_offset + load_bias) = load_bias + rela->r_addend;
+}
+
+static inline void apply_relative(const ElfW(Rel)* rel, ElfW(Addr) load_bias) {
+  *reinterpret_cast<ElfW(Addr)*>(rel->r_offset + load_bias) += load_bias;
+}
+
+// Linkers sort the relative relocations of a table first. Applies them
+// without going through relocate(), and returns how many there were.
+template<typename ElfRelT>
+static size_t relocate_relative_prefix(const ElfRelT* rel, size_t count, ElfW(Addr) load_bias) {
+  size_t idx = 0;
+  for (; idx < count && rel[idx].r_info == R_GENERIC_RELATIVE; ++idx) {
+    count_relocation(kRelocRelative);
+    apply_relative(&rel[idx], load_bias);
+  }
+  return idx;
+}
+
+// DT_RELR: an even entry is the address of a word to relocate, the odd
+// entries following it are bitmaps of which of the next 63 (31 on 32-bit)
+// words are to be relocated as well. The addends are in place.
+bool soinfo::relocate_relr() {
+  const size_t bitmap_words = 8 * sizeof(ElfW(Addr)) - 1;
+  ElfW(Addr)* where = nullptr;
+
+  for (size_t idx = 0; idx < relr_count_; ++idx) {
+    ElfW(Addr) entry = relr_[idx];
+
+    if ((entry & 1) == 0) {
+      where = reinterpret_cast<ElfW(Addr)*>(load_bias + entry);
+      *where++ += load_bias;
+      count_relocation(kRelocRelative);
+      continue;
+    }
+
+    if (where == nullptr) {
+      DL_ERR("\"%s\": DT_RELR bitmap without an address", get_realpath());
+      return false;
+    }
+
+    for (ElfW(Addr)* p = where; (entry >>= 1) != 0; ++p) {
+      if ((entry & 1) != 0) {
+        *p += load_bias;
+        count_relocation(kRelocRelative);
+      }
+    }
+    where += bitmap_words;
+  }
+
+  return true;
+}
+
 #if !defined(__mips__)
 #if defined(USE_RELA)
 static ElfW(Addr) get_addend(ElfW(Rela)* rela, ElfW(Addr) reloc_addr ) {
@@ -1767,7 +2223,8 @@ static ElfW(Addr) get_addend(ElfW(Rel)* rel, ElfW(Addr) reloc_addr) {
 
 template<typename ElfRelIteratorT>
 bool soinfo::relocate(const VersionTracker& version_tracker, ElfRelIteratorT&& rel_iterator,
-                      const soinfo_list_t& global_group, const soinfo_list_t& local_group) {
+                      const soinfo_list_t& global_group, const soinfo_list_t& local_group,
+                      RelocCache* reloc_cache, SymbolLookupMemo* lookup_memo) {
   for (size_t idx = 0; rel_iterator.has_next(); ++idx) {
     const auto rel = rel_iterator.next();
     if (rel == nullptr) {
@@ -1777,6 +2234,14 @@ bool soinfo::relocate(const VersionTracker& version_tracker, ElfRelIteratorT&& r
     ElfW(Word) type = ELFW(R_TYPE)(rel->r_info);
     ElfW(Word) sym = ELFW(R_SYM)(rel->r_info);
 
+    // Most of a packed table, and whatever did not sort first in a plain one
+    if (type == R_GENERIC_RELATIVE && sym == 0) {
+      count_relocation(kRelocRelative);
+      MARK(rel->r_offset);
+      apply_relative(rel, load_bias);
+      continue;
+    }
+
     ElfW(Addr) reloc = static_cast<ElfW(Addr)>(rel->r_offset + load_bias);
     ElfW(Addr) sym_addr = 0;
     const char* sym_name = nullptr;
@@ -1794,18 +2259,60 @@ bool soinfo::relocate(const VersionTracker& version_tracker, ElfRelIteratorT&& r
       sym_name = get_string(symtab_[sym].st_name);
       const version_info* vi = nullptr;
 
-      sym_addr = reinterpret_cast<ElfW(Addr)>(_get_hooked_symbol(sym_name, get_realpath()));
-      if (!sym_addr) {
-        if (!lookup_version_info(version_tracker, sym, sym_name, &vi)) {
-          return false;
+      RelocCache::Kind cached = RelocCache::kMiss;
+      if (reloc_cache != nullptr) {
+        cached = reloc_cache->lookup(sym, &sym_addr);
+      }
+
+      // Hooks win over the libraries and may have been added since the
+      // cache was written (hybris_set_hook_callback), so they are looked
+      // up for every cached symbol. A kUndefinedWeak symbol which isn't
+      // hooked is handled as an unsatisfied weak reference below.
+      if (cached == RelocCache::kHooked || cached == RelocCache::kResolved ||
+          cached == RelocCache::kUndefinedWeak) {
+        uint64_t profile_start = linker_profile_begin_lookup(kProfileHookLookup);
+        ElfW(Addr) hooked = reinterpret_cast<ElfW(Addr)>(find_hooked_symbol(sym_name, get_realpath()));
+        linker_profile_end_lookup(kProfileHookLookup, profile_start);
+        if (hooked) {
+          sym_addr = hooked;
+          if (cached != RelocCache::kHooked) {
+            reloc_cache->record_hooked(sym);
+            cached = RelocCache::kHooked;
+          }
+        } else if (cached == RelocCache::kHooked) {
+          cached = RelocCache::kMiss;
         }
+      } else if (cached == RelocCache::kNoCache) {
+        cached = RelocCache::kMiss;
+      }
 
-        if (!soinfo_do_lookup(this, sym_name, vi, &lsi, global_group, local_group, &s)) {
-          return false;
+      if (cached == RelocCache::kMiss) {
+        uint64_t profile_start = linker_profile_begin_lookup(kProfileHookLookup);
+        sym_addr = reinterpret_cast<ElfW(Addr)>(find_hooked_symbol(sym_name, get_realpath()));
+        linker_profile_end_lookup(kProfileHookLookup, profile_start);
+        if (!sym_addr) {
+          if (!lookup_version_info(version_tracker, sym, sym_name, &vi)) {
+            return false;
+          }
+
+          profile_start = linker_profile_begin_lookup(kProfileSymbolLookup);
+          if (!soinfo_do_lookup(this, sym_name, vi, &lsi, global_group, local_group, &s,
+                                lookup_memo)) {
+            return false;
+          }
+          linker_profile_end_lookup(kProfileSymbolLookup, profile_start);
+        } else if (reloc_cache != nullptr) {
+          reloc_cache->record_hooked(sym);
+        }
+
+        if (reloc_cache != nullptr && sym_addr == 0 && s == nullptr) {
+          reloc_cache->record_undefined_weak(sym);
         }
       }
 
-      if (sym_addr == 0 && s == nullptr) {
+      if (cached == RelocCache::kResolved || cached == RelocCache::kHooked) {
+        // sym_addr was taken from the relocation cache
+      } else if (sym_addr == 0 && s == nullptr) {
         // We only allow an undefined symbol if this is a weak reference...
         s = &symtab_[sym];
         if (ELF_ST_BIND(s->st_info) != STB_WEAK) {
@@ -1887,6 +2394,9 @@ bool soinfo::relocate(const VersionTracker& version_tracker, ElfRelIteratorT&& r
           }
         }
 #endif
+        if (reloc_cache != nullptr) {
+          reloc_cache->record(sym, lsi, s, sym_addr);
+        }
       }
       count_relocation(kRelocSymbol);
     }
@@ -2134,6 +2644,109 @@ bool soinfo::relocate(const VersionTracker& version_tracker, ElfRelIteratorT&& r
   }
   return true;
 }
+
+bool soinfo::can_bind_lazily() const {
+  if (!lazy_bind_enabled() || plt_got_ == nullptr || bind_now_ ||
+      (get_dt_flags_1() & DF_1_NOW) != 0 || (get_rtld_flags() & RTLD_LAZY) == 0) {
+    return false;
+  }
+
+  // The slots are written on the first call, after GNU RELRO made them
+  // read-only if they are covered by it. The three reserved words before
+  // them may be, they are set up while linking.
+  ElfW(Addr) slots = reinterpret_cast<ElfW(Addr)>(plt_got_ + 3);
+  for (size_t i = 0; i < phnum; ++i) {
+    if (phdr[i].p_type == PT_GNU_RELRO &&
+        slots >= phdr[i].p_vaddr + load_bias &&
+        slots < phdr[i].p_vaddr + load_bias + phdr[i].p_memsz) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+template<typename ElfRelT>
+bool soinfo::relocate_plt_lazily(const VersionTracker& version_tracker, ElfRelT* plt_rel,
+                                 size_t plt_rel_count, const soinfo_list_t& global_group,
+                                 const soinfo_list_t& local_group, RelocCache* reloc_cache,
+                                 SymbolLookupMemo* lookup_memo) {
+  for (size_t idx = 0; idx < plt_rel_count; ++idx) {
+    ElfRelT* rel = plt_rel + idx;
+
+    if (ELFW(R_TYPE)(rel->r_info) == R_GENERIC_JUMP_SLOT) {
+      // The slot points back into the PLT, to the code which calls the
+      // resolver; it only needs to be relocated itself.
+      ElfW(Addr) reloc = static_cast<ElfW(Addr)>(rel->r_offset + load_bias);
+      count_relocation(kRelocRelative);
+      MARK(rel->r_offset);
+      TRACE_TYPE(RELO, "RELO JMP_SLOT %16p <- +%16p (lazy)",
+                 reinterpret_cast<void*>(reloc), reinterpret_cast<void*>(load_bias));
+      *reinterpret_cast<ElfW(Addr)*>(reloc) += load_bias;
+    } else if (!relocate(version_tracker, plain_reloc_iterator(rel, 1), global_group,
+                         local_group, reloc_cache, lookup_memo)) {
+      // R_GENERIC_IRELATIVE and friends are applied right away
+      return false;
+    }
+  }
+
+  lazy_binding_ = new LazyBinding(global_group, local_group);
+  if (!lazy_binding_->version_tracker().init(this)) {
+    return false;
+  }
+
+  lazy_bind_setup_got(this, reinterpret_cast<ElfW(Addr)*>(plt_got_));
+  return true;
+}
+
+ElfW(Addr) soinfo::bind_lazy_slot(size_t index) {
+#if defined(USE_RELA)
+  ElfW(Rela)* rel = index < plt_rela_count_ ? plt_rela_ + index : nullptr;
+#else
+  ElfW(Rel)* rel = index < plt_rel_count_ ? plt_rel_ + index : nullptr;
+#endif
+  if (lazy_binding_ == nullptr || rel == nullptr ||
+      ELFW(R_TYPE)(rel->r_info) != R_GENERIC_JUMP_SLOT) {
+    DL_ERR("%s: bad lazy binding request for PLT relocation %zu", get_realpath(), index);
+    abort();
+  }
+
+  ElfW(Word) sym = ELFW(R_SYM)(rel->r_info);
+  const char* sym_name = get_string(symtab_[sym].st_name);
+  ElfW(Addr) sym_addr = reinterpret_cast<ElfW(Addr)>(find_hooked_symbol(sym_name, get_realpath()));
+
+  if (sym_addr == 0) {
+    const version_info* vi = nullptr;
+    const ElfW(Sym)* s = nullptr;
+    soinfo* lsi = nullptr;
+
+    if (!lookup_version_info(lazy_binding_->version_tracker(), sym, sym_name, &vi) ||
+        !soinfo_do_lookup(this, sym_name, vi, &lsi, lazy_binding_->global_group(),
+                          lazy_binding_->local_group(), &s, nullptr)) {
+      abort();
+    }
+
+    if (s != nullptr) {
+      sym_addr = lsi->resolve_symbol_address(s);
+    } else if (ELF_ST_BIND(symtab_[sym].st_info) != STB_WEAK) {
+      // too late to fail dlopen
+      DL_ERR("cannot locate symbol \"%s\" referenced by \"%s\"...", sym_name, get_realpath());
+      abort();
+    }
+  }
+
+#if defined(USE_RELA)
+  sym_addr += rel->r_addend;
+#endif
+
+  ElfW(Addr) reloc = static_cast<ElfW(Addr)>(rel->r_offset + load_bias);
+  TRACE_TYPE(RELO, "RELO JMP_SLOT %16p <- %16p %s (lazy)",
+             reinterpret_cast<void*>(reloc), reinterpret_cast<void*>(sym_addr), sym_name);
+
+  // Other threads may be calling through the slot already
+  __atomic_store_n(reinterpret_cast<ElfW(Addr)*>(reloc), sym_addr, __ATOMIC_RELEASE);
+  return sym_addr;
+}
 #endif  // !defined(__mips__)
 
 void soinfo::call_array(const char* array_name , linker_function_t* functions,
@@ -2207,8 +2820,10 @@ void soinfo::call_constructors() {
   TRACE("\"%s\": calling constructors", get_realpath());
 
   // DT_INIT should be called before DT_INIT_ARRAY if both are present.
+  uint64_t profile_start = linker_profile_begin();
   call_function("DT_INIT", init_func_);
   call_array("DT_INIT_ARRAY", init_array_, init_array_count_, false);
+  linker_profile_end(get_realpath(), kProfileConstructors, profile_start);
 }
 
 void soinfo::call_destructors() {
@@ -2282,6 +2897,14 @@ off64_t soinfo::get_file_offset() const {
   return 0;
 }
 
+off64_t soinfo::get_file_size() const {
+  return file_size_;
+}
+
+const timespec& soinfo::get_file_mtime() const {
+  return file_mtime_;
+}
+
 uint32_t soinfo::get_rtld_flags() const {
   if (has_min_version(1)) {
     return rtld_flags_;
@@ -2389,8 +3012,9 @@ bool soinfo::can_unload() const {
   return (get_rtld_flags() & (RTLD_NODELETE | RTLD_GLOBAL)) == 0;
 }
 
+// Atomic, dlsym reads the flag of libraries other threads are linking.
 bool soinfo::is_linked() const {
-  return (flags_ & FLAG_LINKED) != 0;
+  return (__atomic_load_n(&flags_, __ATOMIC_ACQUIRE) & FLAG_LINKED) != 0;
 }
 
 bool soinfo::is_main_executable() const {
@@ -2398,7 +3022,7 @@ bool soinfo::is_main_executable() const {
 }
 
 void soinfo::set_linked() {
-  flags_ |= FLAG_LINKED;
+  __atomic_fetch_or(&flags_, FLAG_LINKED, __ATOMIC_RELEASE);
 }
 
 void soinfo::set_linker_flag() {
@@ -2554,11 +3178,8 @@ bool soinfo::prelink_image() {
         break;
 
       case DT_PLTGOT:
-#if defined(__mips__)
-        // Used by mips and mips64.
+        // Used by mips and mips64, and for lazy binding.
         plt_got_ = reinterpret_cast<ElfW(Addr)**>(load_bias + d->d_un.d_ptr);
-#endif
-        // Ignore for other platforms... (because RTLD_LAZY is not supported)
         break;
 
       case DT_DEBUG:
@@ -2574,6 +3195,24 @@ bool soinfo::prelink_image() {
         }
 #endif
         break;
+
+      case DT_RELR:
+      case DT_ANDROID_RELR:
+        relr_ = reinterpret_cast<ElfW(Addr)*>(load_bias + d->d_un.d_ptr);
+        break;
+
+      case DT_RELRSZ:
+      case DT_ANDROID_RELRSZ:
+        relr_count_ = d->d_un.d_val / sizeof(ElfW(Addr));
+        break;
+
+      case DT_RELRENT:
+      case DT_ANDROID_RELRENT:
+        if (d->d_un.d_val != sizeof(ElfW(Addr))) {
+          DL_ERR("invalid DT_RELRENT: %zd", static_cast<size_t>(d->d_un.d_val));
+          return false;
+        }
+        break;
 #if defined(USE_RELA)
       case DT_RELA:
         rela_ = reinterpret_cast<ElfW(Rela)*>(load_bias + d->d_un.d_ptr);
@@ -2653,8 +3292,8 @@ bool soinfo::prelink_image() {
       // "Indicates that all RELATIVE relocations have been concatenated together,
       // and specifies the RELATIVE relocation count."
       //
-      // TODO: Spec also mentions that this can be used to optimize relocation process;
-      // Not currently used by bionic linker - ignored.
+      // Ignored: relocate_relative_prefix finds them by their type, which it
+      // has to check anyway.
       case DT_RELCOUNT:
         break;
 
@@ -2733,6 +3372,9 @@ bool soinfo::prelink_image() {
         if (d->d_un.d_val & DF_SYMBOLIC) {
           has_DT_SYMBOLIC = true;
         }
+        if (d->d_un.d_val & DF_BIND_NOW) {
+          bind_now_ = true;
+        }
         break;
 
       case DT_FLAGS_1:
@@ -2777,8 +3419,9 @@ bool soinfo::prelink_image() {
         mips_gotsym_ = d->d_un.d_val;
         break;
 #endif
-      // Ignored: "Its use has been superseded by the DF_BIND_NOW flag"
+      // "Its use has been superseded by the DF_BIND_NOW flag"
       case DT_BIND_NOW:
+        bind_now_ = true;
         break;
 
       case DT_VERSYM:
@@ -2854,11 +3497,15 @@ bool soinfo::prelink_image() {
     DL_WARN("%s: is missing DT_SONAME will use basename as a replacement: \"%s\"",
         get_realpath(), soname_);
   }
+
+  if ((flags_ & FLAG_LINKER) == 0) {
+    g_library_index.add_soname(this);
+  }
   return true;
 }
 
 bool soinfo::link_image(const soinfo_list_t& global_group, const soinfo_list_t& local_group,
-                        const android_dlextinfo* extinfo) {
+                        const android_dlextinfo* extinfo, SymbolLookupMemo* lookup_memo) {
 
   local_group_root_ = local_group.front();
   if (local_group_root_ == nullptr) {
@@ -2871,10 +3518,14 @@ bool soinfo::link_image(const soinfo_list_t& global_group, const soinfo_list_t&
 
   VersionTracker version_tracker;
 
+  uint64_t profile_start = linker_profile_begin();
   if (!version_tracker.init(this)) {
     return false;
   }
 
+  RelocCache cache(this, global_group, local_group);
+  RelocCache* reloc_cache = cache.enabled() ? &cache : nullptr;
+
 #if !defined(__LP64__)
   if (has_text_relocations) {
     // Fail if app is targeting sdk version > 22
@@ -2896,6 +3547,13 @@ bool soinfo::link_image(const soinfo_list_t& global_group, const soinfo_list_t&
   }
 #endif
 
+  if (relr_ != nullptr) {
+    DEBUG("[ relocating %s relr ]", get_realpath());
+    if (!relocate_relr()) {
+      return false;
+    }
+  }
+
   if (android_relocs_ != nullptr) {
     // check signature
     if (android_relocs_size_ > 3 &&
@@ -2913,7 +3571,7 @@ bool soinfo::link_image(const soinfo_list_t& global_group, const soinfo_list_t&
           version_tracker,
           packed_reloc_iterator<sleb128_decoder>(
             sleb128_decoder(packed_relocs, packed_relocs_size)),
-          global_group, local_group);
+          global_group, local_group, reloc_cache, lookup_memo);
 
       if (!relocated) {
         return false;
@@ -2927,30 +3585,48 @@ bool soinfo::link_image(const soinfo_list_t& global_group, const soinfo_list_t&
 #if defined(USE_RELA)
   if (rela_ != nullptr) {
     DEBUG("[ relocating %s ]", get_realpath());
+    size_t relative = relocate_relative_prefix(rela_, rela_count_, load_bias);
     if (!relocate(version_tracker,
-            plain_reloc_iterator(rela_, rela_count_), global_group, local_group)) {
+            plain_reloc_iterator(rela_ + relative, rela_count_ - relative), global_group,
+            local_group, reloc_cache, lookup_memo)) {
       return false;
     }
   }
-  if (plt_rela_ != nullptr) {
+  if (plt_rela_ != nullptr && can_bind_lazily()) {
+    DEBUG("[ relocating %s plt lazily ]", get_realpath());
+    if (!relocate_plt_lazily(version_tracker, plt_rela_, plt_rela_count_, global_group,
+            local_group, reloc_cache, lookup_memo)) {
+      return false;
+    }
+  } else if (plt_rela_ != nullptr) {
     DEBUG("[ relocating %s plt ]", get_realpath());
     if (!relocate(version_tracker,
-            plain_reloc_iterator(plt_rela_, plt_rela_count_), global_group, local_group)) {
+            plain_reloc_iterator(plt_rela_, plt_rela_count_), global_group, local_group,
+            reloc_cache, lookup_memo)) {
       return false;
     }
   }
 #else
   if (rel_ != nullptr) {
     DEBUG("[ relocating %s ]", get_realpath());
+    size_t relative = relocate_relative_prefix(rel_, rel_count_, load_bias);
     if (!relocate(version_tracker,
-            plain_reloc_iterator(rel_, rel_count_), global_group, local_group)) {
+            plain_reloc_iterator(rel_ + relative, rel_count_ - relative), global_group,
+            local_group, reloc_cache, lookup_memo)) {
       return false;
     }
   }
-  if (plt_rel_ != nullptr) {
+  if (plt_rel_ != nullptr && can_bind_lazily()) {
+    DEBUG("[ relocating %s plt lazily ]", get_realpath());
+    if (!relocate_plt_lazily(version_tracker, plt_rel_, plt_rel_count_, global_group,
+            local_group, reloc_cache, lookup_memo)) {
+      return false;
+    }
+  } else if (plt_rel_ != nullptr) {
     DEBUG("[ relocating %s plt ]", get_realpath());
     if (!relocate(version_tracker,
-            plain_reloc_iterator(plt_rel_, plt_rel_count_), global_group, local_group)) {
+            plain_reloc_iterator(plt_rel_, plt_rel_count_), global_group, local_group,
+            reloc_cache, lookup_memo)) {
       return false;
     }
   }
@@ -2963,6 +3639,11 @@ bool soinfo::link_image(const soinfo_list_t& global_group, const soinfo_list_t&
 #endif
 
   DEBUG("[ finished linking %s ]", get_realpath());
+  linker_profile_end(get_realpath(), kProfileRelocate, profile_start);
+
+  if (reloc_cache != nullptr) {
+    reloc_cache->save();
+  }
 
 #if !defined(__LP64__)
   if (has_text_relocations) {
@@ -2997,6 +3678,9 @@ bool soinfo::link_image(const soinfo_list_t& global_group, const soinfo_list_t&
              get_realpath(), strerror(errno));
       return false;
     }
+  } else if (extinfo == nullptr) {
+    // hybris: opt-in sharing between processes, see linker_relro_share.h
+    relro_share_apply(this);
   }
 
   notify_gdb_of_load(this);
@@ -3024,7 +3708,7 @@ static void add_vdso(KernelArgumentBlock& args) {
   si->load_bias = get_elf_exec_load_bias(ehdr_vdso);
 
   si->prelink_image();
-  si->link_image(g_empty_list, soinfo::soinfo_list_t::make_list(si), nullptr);
+  si->link_image(g_empty_list, soinfo::soinfo_list_t::make_list(si), nullptr, nullptr);
 #endif
 }
 
@@ -3200,7 +3884,7 @@ static ElfW(Addr) __linker_init_post_relocation(KernelArgumentBlock& args, ElfW(
     fprintf(stderr, "CANNOT LINK EXECUTABLE: %s\n", linker_get_error_buffer());
     exit(EXIT_FAILURE);
   } else if (needed_libraries_count == 0) {
-    if (!si->link_image(g_empty_list, soinfo::soinfo_list_t::make_list(si), nullptr)) {
+    if (!si->link_image(g_empty_list, soinfo::soinfo_list_t::make_list(si), nullptr, nullptr)) {
       fprintf(stderr, "CANNOT LINK EXECUTABLE: %s\n", linker_get_error_buffer());
       exit(EXIT_FAILURE);
     }
@@ -3292,6 +3976,11 @@ static ElfW(Addr) get_elf_exec_load_bias(const ElfW(Ehdr)* elf) {
   return 0;
 }
 
+// hybris: called by libhybris after android_linker_init, see hook_table.h
+extern "C" void android_linker_set_hook_table(const hybris_hook_table* table) {
+  g_hook_table = table;
+}
+
 extern "C" void android_linker_init(int sdk_version, void* (*get_hooked_symbol)(const char*, const char*)) {
   // Get a few environment variables.
   const char* LD_DEBUG = getenv("HYBRIS_LD_DEBUG");
@@ -3312,10 +4001,33 @@ extern "C" void android_linker_init(int sdk_version, void* (*get_hooked_symbol)(
     parse_LD_LIBRARY_PATH(ldpath_env);
   parse_LD_PRELOAD(ldpreload_env);
 
+  const char* load_threads_env = getenv("HYBRIS_LD_LOAD_THREADS");
+  if (load_threads_env != nullptr) {
+    g_ld_load_threads = atoi(load_threads_env);
+  } else {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    g_ld_load_threads = cpus > 4 ? 4 : (cpus > 0 ? cpus : 1);
+  }
+
   if (sdk_version > 0)
     set_application_target_sdk_version(sdk_version);
 
   _get_hooked_symbol = get_hooked_symbol;
+
+  // Cache of the search directories, see linker_dir_cache.h
+  dir_cache_init(getenv("HYBRIS_LD_DIR_CACHE"));
+
+  // Opt-in lazy binding of the PLT, see linker_lazy_bind.h
+  lazy_bind_init(getenv("HYBRIS_LD_BIND_LAZY"));
+
+  // Opt-in persistent cache of symbol lookups, see linker_reloc_cache.h
+  reloc_cache_init(getenv("HYBRIS_RELOC_CACHE_DIR"), reinterpret_cast<void*>(get_hooked_symbol));
+
+  // Opt-in sharing of RELRO segments between processes, see linker_relro_share.h
+  relro_share_init(getenv("HYBRIS_RELRO_SHARE_DIR"));
+
+  // Opt-in profiler of the loading phases, see linker_profile.h
+  linker_profile_init(getenv("HYBRIS_LINKER_PROFILE"));
 }
 
 #ifdef DISABLED_FOR_HYBRIS_SUPPORT
@@ -3364,7 +4076,8 @@ extern "C" ElfW(Addr) __linker_init(void* raw_args) {
   // itself without having to look into local_group and (2) allocators
   // are not yet initialized, and therefore we cannot use linked_list.push_*
   // functions at this point.
-  if (!(linker_so.prelink_image() && linker_so.link_image(g_empty_list, g_empty_list, nullptr))) {
+  if (!(linker_so.prelink_image() &&
+        linker_so.link_image(g_empty_list, g_empty_list, nullptr, nullptr))) {
     // It would be nice to print an error message, but if the linker
     // can't link itself, there's no guarantee that we'll be able to
     // call write() (because it involves a GOT reference). We may as
@@ -108,6 +108,9 @@ typedef void (*linker_function_t)();
 #endif
 
 struct soinfo;
+class LazyBinding;
+class RelocCache;
+class SymbolLookupMemo;
 
 class SoinfoListAllocator {
  public:
@@ -205,11 +208,8 @@ struct soinfo {
   uint32_t* bucket_;
   uint32_t* chain_;
 
-#if defined(__mips__) || !defined(__LP64__)
-  // This is only used by mips and mips64, but needs to be here for
-  // all 32-bit architectures to preserve binary compatibility.
+  // Used by mips and mips64, and for lazy binding (hybris).
   ElfW(Addr)** plt_got_;
-#endif
 
 #if defined(USE_RELA)
   ElfW(Rela)* plt_rela_;
@@ -268,13 +268,14 @@ struct soinfo {
 
  public:
   soinfo(const char* name, const struct stat* file_stat, off64_t file_offset, int rtld_flags);
+  ~soinfo();
 
   void call_constructors();
   void call_destructors();
   void call_pre_init_constructors();
   bool prelink_image();
   bool link_image(const soinfo_list_t& global_group, const soinfo_list_t& local_group,
-                  const android_dlextinfo* extinfo);
+                  const android_dlextinfo* extinfo, SymbolLookupMemo* lookup_memo);
 
   void add_child(soinfo* child);
   void remove_all_links();
@@ -282,6 +283,8 @@ struct soinfo {
   ino_t get_st_ino() const;
   dev_t get_st_dev() const;
   off64_t get_file_offset() const;
+  off64_t get_file_size() const;
+  const timespec& get_file_mtime() const;
 
   uint32_t get_rtld_flags() const;
   uint32_t get_dt_flags_1() const;
@@ -336,6 +339,10 @@ struct soinfo {
 
   uint32_t get_target_sdk_version() const;
 
+  // Resolves and writes the PLT slot of JUMP_SLOT relocation index, see
+  // linker_lazy_bind.h. Returns the address the slot now points to.
+  ElfW(Addr) bind_lazy_slot(size_t index);
+
  private:
   bool elf_lookup(SymbolName& symbol_name, const version_info* vi, uint32_t* symbol_index) const;
   ElfW(Sym)* elf_addr_lookup(const void* addr);
@@ -349,7 +356,15 @@ struct soinfo {
   void call_function(const char* function_name, linker_function_t function);
   template<typename ElfRelIteratorT>
   bool relocate(const VersionTracker& version_tracker, ElfRelIteratorT&& rel_iterator,
-                const soinfo_list_t& global_group, const soinfo_list_t& local_group);
+                const soinfo_list_t& global_group, const soinfo_list_t& local_group,
+                RelocCache* reloc_cache, SymbolLookupMemo* lookup_memo);
+  bool relocate_relr();
+  bool can_bind_lazily() const;
+  template<typename ElfRelT>
+  bool relocate_plt_lazily(const VersionTracker& version_tracker, ElfRelT* plt_rel,
+                           size_t plt_rel_count, const soinfo_list_t& global_group,
+                           const soinfo_list_t& local_group, RelocCache* reloc_cache,
+                           SymbolLookupMemo* lookup_memo);
 
  private:
   // This part of the structure is only available
@@ -397,12 +412,54 @@ struct soinfo {
 
   uint32_t target_sdk_version_;
 
+  // hybris: used to validate the relocation cache
+  off64_t file_size_;
+  timespec file_mtime_;
+
+  // hybris: lazy binding, see linker_lazy_bind.h
+  bool bind_now_;
+  LazyBinding* lazy_binding_;
+
+  // hybris: DT_RELR
+  ElfW(Addr)* relr_;
+  size_t relr_count_;
+
   friend soinfo* get_libdl_info();
 };
 
+// Results of soinfo_do_lookup during one link pass of find_libraries, in
+// which the global and local groups do not change. Keyed by the symbol
+// name and the requested version; misses are remembered as well.
+class SymbolLookupMemo {
+ public:
+  SymbolLookupMemo() : count_(0) {}
+
+  bool find(SymbolName& symbol_name, const version_info* vi,
+            soinfo** si_found_in, const ElfW(Sym)** symbol) const;
+  void insert(SymbolName& symbol_name, const version_info* vi,
+              soinfo* si_found_in, const ElfW(Sym)* symbol);
+
+ private:
+  struct Entry {
+    const char* name;
+    const char* version;
+    uint32_t hash;
+    soinfo* si_found_in;
+    const ElfW(Sym)* symbol;
+  };
+
+  static uint32_t hash_of(SymbolName& symbol_name, const version_info* vi);
+
+  std::vector<Entry> entries_;
+  size_t count_;
+
+  DISALLOW_COPY_AND_ASSIGN(SymbolLookupMemo);
+};
+
 bool soinfo_do_lookup(soinfo* si_from, const char* name, const version_info* vi,
                       soinfo** si_found_in, const soinfo::soinfo_list_t& global_group,
-                      const soinfo::soinfo_list_t& local_group, const ElfW(Sym)** symbol);
+                      const soinfo::soinfo_list_t& local_group, const ElfW(Sym)** symbol,
+                      SymbolLookupMemo* lookup_memo);
 
 enum RelocationKind {
   kRelocAbsolute = 0,
@@ -413,6 +470,7 @@ enum RelocationKind {
 };
 
 void count_relocation(RelocationKind kind);
+void count_symbol_lookup(bool memo_hit);
 
 soinfo* get_libdl_info();
 
@@ -423,8 +481,23 @@ void do_dlclose(soinfo* si);
 
 int do_dl_iterate_phdr(int (*cb)(dl_phdr_info* info, size_t size, void* data), void* data);
 
+// hybris: dlsym and dladdr don't take the dl mutex. They hold this lock
+// for reading while they walk solist and the dependencies of linked
+// libraries, soinfo_alloc and soinfo_free hold it for writing. The
+// lookups below skip libraries which aren't linked yet, whose soinfos are
+// still being filled in by a dlopen on another thread.
+class ScopedSolistLock {
+ public:
+  explicit ScopedSolistLock(bool write);
+  ~ScopedSolistLock();
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ScopedSolistLock);
+};
+
 const ElfW(Sym)* dlsym_linear_lookup(const char* name, soinfo** found, soinfo* caller, void* handle);
 soinfo* find_containing_library(const void* addr);
+ElfW(Addr) call_ifunc_resolver(ElfW(Addr) resolver_addr);
 
 const ElfW(Sym)* dlsym_handle_lookup(soinfo* si, soinfo** found, const char* name);
 
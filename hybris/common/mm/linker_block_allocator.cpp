@@ -24,10 +24,9 @@
 
 #include "hybris_compat.h"
 
-struct LinkerBlockAllocatorPage {
-  LinkerBlockAllocatorPage* next;
-  uint8_t bytes[PAGE_SIZE-sizeof(LinkerBlockAllocatorPage*)];
-};
+// Size of the first arena. Only committed pages use memory, so it can be
+// generous; it is the upper bound for one mprotect per allocator.
+static const size_t kFirstArenaSize = 1024 * PAGE_SIZE;
 
 struct FreeBlockInfo {
   void* next_block;
@@ -36,7 +35,7 @@ struct FreeBlockInfo {
 
 LinkerBlockAllocator::LinkerBlockAllocator(size_t block_size)
   : block_size_(block_size < sizeof(FreeBlockInfo) ? sizeof(FreeBlockInfo) : block_size),
-    page_list_(nullptr),
+    arena_count_(0),
     free_block_list_(nullptr)
 {}
 
@@ -66,13 +65,13 @@ void LinkerBlockAllocator::free(void* block) {
     return;
   }
 
-  LinkerBlockAllocatorPage* page = find_page(block);
+  uint8_t* page = find_page(block);
 
   if (page == nullptr) {
     abort();
   }
 
-  ssize_t offset = reinterpret_cast<uint8_t*>(block) - page->bytes;
+  ssize_t offset = reinterpret_cast<uint8_t*>(block) - page;
 
   if (offset % block_size_ != 0) {
     abort();
@@ -89,48 +88,64 @@ void LinkerBlockAllocator::free(void* block) {
 }
 
 void LinkerBlockAllocator::protect_all(int prot) {
-  for (LinkerBlockAllocatorPage* page = page_list_; page != nullptr; page = page->next) {
-    if (mprotect(page, PAGE_SIZE, prot) == -1) {
+  for (size_t i = 0; i < arena_count_; ++i) {
+    if (arenas_[i].committed != 0 &&
+        mprotect(arenas_[i].base, arenas_[i].committed, prot) == -1) {
       abort();
     }
   }
 }
 
 void LinkerBlockAllocator::create_new_page() {
-  LinkerBlockAllocatorPage* page = reinterpret_cast<LinkerBlockAllocatorPage*>(
-      mmap(nullptr, PAGE_SIZE, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, 0, 0));
+  Arena* arena = arena_count_ > 0 ? &arenas_[arena_count_ - 1] : nullptr;
 
-  if (page == MAP_FAILED) {
-    abort(); // oom
-  }
+  if (arena == nullptr || arena->committed == arena->reserved) {
+    if (arena_count_ == kMaxArenas) {
+      abort(); // oom
+    }
 
-  prctl(PR_SET_VMA, PR_SET_VMA_ANON_NAME, page, PAGE_SIZE, "linker_alloc");
+    size_t size = arena == nullptr ? kFirstArenaSize : 2 * arena->reserved;
+    void* base = mmap(nullptr, size, PROT_NONE,
+                      MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE, -1, 0);
 
-  memset(page, 0, PAGE_SIZE);
+    if (base == MAP_FAILED) {
+      abort(); // oom
+    }
+
+    prctl(PR_SET_VMA, PR_SET_VMA_ANON_NAME, base, size, "linker_alloc");
 
-  FreeBlockInfo* first_block = reinterpret_cast<FreeBlockInfo*>(page->bytes);
+    arena = &arenas_[arena_count_++];
+    arena->base = reinterpret_cast<uint8_t*>(base);
+    arena->reserved = size;
+    arena->committed = 0;
+  }
+
+  // Pages are only added while the allocator is writable, see
+  // ProtectedDataGuard.
+  uint8_t* page = arena->base + arena->committed;
+  if (mprotect(page, PAGE_SIZE, PROT_READ|PROT_WRITE) == -1) {
+    abort(); // oom
+  }
+  arena->committed += PAGE_SIZE;
+
+  FreeBlockInfo* first_block = reinterpret_cast<FreeBlockInfo*>(page);
   first_block->next_block = free_block_list_;
-  first_block->num_free_blocks = (PAGE_SIZE - sizeof(LinkerBlockAllocatorPage*))/block_size_;
+  first_block->num_free_blocks = PAGE_SIZE/block_size_;
 
   free_block_list_ = first_block;
-
-  page->next = page_list_;
-  page_list_ = page;
 }
 
-LinkerBlockAllocatorPage* LinkerBlockAllocator::find_page(void* block) {
+uint8_t* LinkerBlockAllocator::find_page(void* block) {
   if (block == nullptr) {
     abort();
   }
 
-  LinkerBlockAllocatorPage* page = page_list_;
-  while (page != nullptr) {
-    const uint8_t* page_ptr = reinterpret_cast<const uint8_t*>(page);
-    if (block >= (page_ptr + sizeof(page->next)) && block < (page_ptr + PAGE_SIZE)) {
-      return page;
+  uint8_t* ptr = reinterpret_cast<uint8_t*>(block);
+  for (size_t i = 0; i < arena_count_; ++i) {
+    const Arena& arena = arenas_[i];
+    if (ptr >= arena.base && ptr < arena.base + arena.committed) {
+      return arena.base + ((ptr - arena.base) & ~(PAGE_SIZE - 1));
     }
-
-    page = page->next;
   }
 
   abort();
@@ -17,12 +17,11 @@
 #ifndef __LINKER_BLOCK_ALLOCATOR_H
 #define __LINKER_BLOCK_ALLOCATOR_H
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <limits.h>
 #include "private/bionic_macros.h"
 
-struct LinkerBlockAllocatorPage;
-
 /*
  * This class is a non-template version of the LinkerTypeAllocator
  * It keeps code inside .cpp file by keeping the interface
@@ -39,11 +38,23 @@ class LinkerBlockAllocator {
   void protect_all(int prot);
 
  private:
+  // A reserved range of address space, of which the first committed
+  // bytes are pages in use. Each arena is twice as large as the one
+  // before, so there are only a few of them.
+  struct Arena {
+    uint8_t* base;
+    size_t reserved;
+    size_t committed;
+  };
+
+  static const size_t kMaxArenas = 16;
+
   void create_new_page();
-  LinkerBlockAllocatorPage* find_page(void* block);
+  uint8_t* find_page(void* block);
 
   size_t block_size_;
-  LinkerBlockAllocatorPage* page_list_;
+  Arena arenas_[kMaxArenas];
+  size_t arena_count_;
   void* free_block_list_;
 
   DISALLOW_COPY_AND_ASSIGN(LinkerBlockAllocator);
@@ -51,8 +62,9 @@ class LinkerBlockAllocator {
 
 /*
  * A simple allocator for the dynamic linker. An allocator allocates instances
- * of a single fixed-size type. Allocations are backed by page-sized private
- * anonymous mmaps.
+ * of a single fixed-size type. Allocations are backed by pages committed one
+ * by one from a large reserved private anonymous mapping (hybris), so that
+ * protect_all needs one mprotect instead of one per page.
  *
  * The differences between this allocator and LinkerMemoryAllocator are:
  * 1. This allocator manages space more efficiently. LinkerMemoryAllocator
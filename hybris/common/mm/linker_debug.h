@@ -44,7 +44,10 @@
 #define DO_TRACE_RELO        1
 #define DO_TRACE_IFUNC       1
 #define TIMING               0
+// Relocation and symbol lookup counts, build with -DSTATS=1 to print them
+#ifndef STATS
 #define STATS                0
+#endif
 #define COUNT_PAGES          0
 
 /*********************************************************************
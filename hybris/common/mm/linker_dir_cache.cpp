@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "linker_dir_cache.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "private/ScopedPthreadMutexLocker.h"
+
+#include "linker_debug.h"
+
+struct DirListing {
+  std::unordered_set<std::string> names;
+  time_t read_at;
+  bool listed;  // false if the directory exists but can't be read
+};
+
+static bool g_dir_cache_enabled = false;
+static time_t g_dir_cache_lifetime = 0;  // 0: listings don't expire
+
+static pthread_mutex_t g_dir_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static std::unordered_map<std::string, DirListing>* g_dir_cache = nullptr;
+
+static time_t monotonic_seconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec;
+}
+
+// Reads the names in dir into listing. A directory which doesn't exist
+// has no names.
+static void read_listing(const char* dir, DirListing* listing) {
+  listing->names.clear();
+  listing->read_at = monotonic_seconds();
+
+  DIR* d = opendir(dir);
+  if (d == nullptr) {
+    listing->listed = errno == ENOENT || errno == ENOTDIR;
+    return;
+  }
+
+  struct dirent* entry;
+  while ((entry = readdir(d)) != nullptr) {
+    listing->names.insert(entry->d_name);
+  }
+  closedir(d);
+  listing->listed = true;
+
+  TRACE("[ listed %zu entries of %s ]", listing->names.size(), dir);
+}
+
+void dir_cache_init(const char* value) {
+  if (value == nullptr) {
+    return;
+  }
+
+  if (strcmp(value, "forever") == 0) {
+    g_dir_cache_enabled = true;
+    g_dir_cache_lifetime = 0;
+    return;
+  }
+
+  long seconds = atol(value);
+  g_dir_cache_enabled = seconds > 0;
+  g_dir_cache_lifetime = seconds;
+}
+
+bool dir_cache_may_contain(const char* dir, const char* name) {
+  if (!g_dir_cache_enabled || dir[0] != '/') {
+    return true;
+  }
+
+  ScopedPthreadMutexLocker locker(&g_dir_cache_mutex);
+
+  if (g_dir_cache == nullptr) {
+    g_dir_cache = new std::unordered_map<std::string, DirListing>();
+  }
+
+  auto it = g_dir_cache->find(dir);
+  if (it != g_dir_cache->end() && g_dir_cache_lifetime != 0 &&
+      monotonic_seconds() - it->second.read_at >= g_dir_cache_lifetime) {
+    g_dir_cache->erase(it);
+    it = g_dir_cache->end();
+  }
+
+  if (it == g_dir_cache->end()) {
+    DirListing listing;
+    read_listing(dir, &listing);
+    it = g_dir_cache->insert(std::make_pair(std::string(dir), std::move(listing))).first;
+  }
+
+  return !it->second.listed || it->second.names.count(name) != 0;
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LINKER_DIR_CACHE_H
+#define __LINKER_DIR_CACHE_H
+
+// Cache of the listings of the library search directories.
+//
+// A library is searched for by trying to open it in every directory of
+// the library path and then of the default paths, and most of
+// these opens fail. With the cache every directory is read once, and a
+// name is only opened in the directories which list it, so a library
+// which isn't there costs no system calls after the first scan.
+//
+// A library installed after its directory was read is not found until
+// the listing is read again, so the cache is off by default.
+// HYBRIS_LD_DIR_CACHE=<seconds> turns it on with listings which expire
+// after that many seconds, HYBRIS_LD_DIR_CACHE=forever keeps them for the
+// life of the process, for processes which don't load libraries
+// installed while they run.
+//
+// Relative directories are not cached, and directories which can be
+// searched but not read are always tried.
+
+// Called from android_linker_init with the value of HYBRIS_LD_DIR_CACHE.
+void dir_cache_init(const char* value);
+
+// False if dir is known not to have an entry called name. Thread safe,
+// libraries are opened on several threads.
+bool dir_cache_may_contain(const char* dir, const char* name);
+
+#endif  // __LINKER_DIR_CACHE_H
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "linker_dlsym_cache.h"
+
+#include <string.h>
+
+static const size_t kSlotCount = 256;  // a power of two
+static const size_t kNameSize = 48;    // names up to 47 characters
+static const size_t kNameWords = kNameSize / sizeof(uintptr_t);
+
+// All fields are accessed atomically: a slot may be read while another
+// thread writes it, the sequence counter tells the reader to ignore what
+// it read then.
+struct DlsymCacheSlot {
+  uint32_t sequence;  // odd while the slot is written
+  uint32_t generation;
+  uintptr_t handle;
+  uintptr_t result;
+  uintptr_t name[kNameWords];
+};
+
+static DlsymCacheSlot g_slots[kSlotCount];
+static uint32_t g_generation = 1;  // never matches an unused slot
+
+// Copies name into words, zero padded, and hashes it.
+static bool pack_name(const char* name, uintptr_t* words, uint32_t* hash) {
+  size_t length = strlen(name);
+  if (length >= kNameSize) {
+    return false;
+  }
+
+  memset(words, 0, kNameSize);
+  memcpy(words, name, length);
+
+  uint32_t h = 2166136261u;  // FNV-1a
+  for (size_t i = 0; i < length; ++i) {
+    h = (h ^ static_cast<uint8_t>(name[i])) * 16777619u;
+  }
+  *hash = h;
+  return true;
+}
+
+static DlsymCacheSlot& get_slot(void* handle, uint32_t hash) {
+  uintptr_t h = reinterpret_cast<uintptr_t>(handle);
+  return g_slots[(hash ^ static_cast<uint32_t>((h >> 4) * 2654435761u)) & (kSlotCount - 1)];
+}
+
+uint32_t dlsym_cache_generation() {
+  return __atomic_load_n(&g_generation, __ATOMIC_ACQUIRE);
+}
+
+bool dlsym_cache_lookup(void* handle, const char* name, void** result) {
+  uintptr_t words[kNameWords];
+  uint32_t hash;
+  if (!pack_name(name, words, &hash)) {
+    return false;
+  }
+
+  DlsymCacheSlot& slot = get_slot(handle, hash);
+  uint32_t sequence = __atomic_load_n(&slot.sequence, __ATOMIC_ACQUIRE);
+  if ((sequence & 1) != 0) {
+    return false;
+  }
+
+  bool match = __atomic_load_n(&slot.handle, __ATOMIC_RELAXED) == reinterpret_cast<uintptr_t>(handle) &&
+               __atomic_load_n(&slot.generation, __ATOMIC_RELAXED) == dlsym_cache_generation();
+  for (size_t i = 0; i < kNameWords; ++i) {
+    match = match && __atomic_load_n(&slot.name[i], __ATOMIC_RELAXED) == words[i];
+  }
+  uintptr_t value = __atomic_load_n(&slot.result, __ATOMIC_RELAXED);
+
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  if (!match || __atomic_load_n(&slot.sequence, __ATOMIC_RELAXED) != sequence) {
+    return false;
+  }
+
+  *result = reinterpret_cast<void*>(value);
+  return true;
+}
+
+void dlsym_cache_store(void* handle, const char* name, uint32_t generation, void* result) {
+  uintptr_t words[kNameWords];
+  uint32_t hash;
+  if (!pack_name(name, words, &hash)) {
+    return;
+  }
+
+  // Another thread writing the slot wins.
+  DlsymCacheSlot& slot = get_slot(handle, hash);
+  uint32_t sequence = __atomic_load_n(&slot.sequence, __ATOMIC_RELAXED);
+  if ((sequence & 1) != 0 ||
+      !__atomic_compare_exchange_n(&slot.sequence, &sequence, sequence + 1, false,
+                                   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+    return;
+  }
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  __atomic_store_n(&slot.generation, generation, __ATOMIC_RELAXED);
+  __atomic_store_n(&slot.handle, reinterpret_cast<uintptr_t>(handle), __ATOMIC_RELAXED);
+  __atomic_store_n(&slot.result, reinterpret_cast<uintptr_t>(result), __ATOMIC_RELAXED);
+  for (size_t i = 0; i < kNameWords; ++i) {
+    __atomic_store_n(&slot.name[i], words[i], __ATOMIC_RELAXED);
+  }
+
+  __atomic_store_n(&slot.sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+void dlsym_cache_invalidate() {
+  __atomic_fetch_add(&g_generation, 1, __ATOMIC_RELEASE);
+}
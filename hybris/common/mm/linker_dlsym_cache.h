@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LINKER_DLSYM_CACHE_H
+#define __LINKER_DLSYM_CACHE_H
+
+#include <stdint.h>
+
+// Cache of recent dlsym results, keyed by library handle and symbol name.
+//
+// The result of dlsym on a library handle only depends on the library
+// and its dependencies, so it stays valid until a library is unloaded.
+// Lookups in RTLD_DEFAULT and RTLD_NEXT depend on the caller and on the
+// other libraries loaded, and aren't cached.
+//
+// The cache is a small direct-mapped table whose slots are guarded by
+// sequence counters: hits take no lock and write no shared memory, and
+// a slot which is being written counts as a miss. Names longer than a
+// slot holds are not cached. Freeing a soinfo bumps the generation of
+// the cache, which invalidates all slots, so a handle which is reused
+// for another library never finds old results.
+
+// The generation to pass to dlsym_cache_store, read while the lookup
+// holds the solist lock.
+uint32_t dlsym_cache_generation();
+
+bool dlsym_cache_lookup(void* handle, const char* name, void** result);
+void dlsym_cache_store(void* handle, const char* name, uint32_t generation, void* result);
+
+// Called by soinfo_free, with the solist lock held for writing.
+void dlsym_cache_invalidate();
+
+#endif  // __LINKER_DLSYM_CACHE_H
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "linker_lazy_bind.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "private/ScopedPthreadMutexLocker.h"
+
+#include "linker_debug.h"
+
+// The PLT of a library pushes the data needed to find the relocation and
+// jumps to the resolver. The resolver saves the argument registers,
+// passes the soinfo (from the second word of the GOT) and the index of
+// the JUMP_SLOT relocation to lazy_bind_fixup, restores the registers and
+// jumps to the address it returned, with the stack as it was at the call
+// of the PLT entry.
+#if defined(__x86_64__)
+
+// The PLT entry pushed the relocation index, the first PLT entry the
+// second word of the GOT. rsp is 8 off 16 byte alignment, rax holds the
+// number of vector registers used by variadic calls.
+__asm__(
+    ".text\n"
+    ".balign 16\n"
+    "lazy_bind_entry:\n"
+    "    push %rax\n"
+    "    push %rdi\n"
+    "    push %rsi\n"
+    "    push %rdx\n"
+    "    push %rcx\n"
+    "    push %r8\n"
+    "    push %r9\n"
+    "    sub $128, %rsp\n"
+    "    movaps %xmm0, 0(%rsp)\n"
+    "    movaps %xmm1, 16(%rsp)\n"
+    "    movaps %xmm2, 32(%rsp)\n"
+    "    movaps %xmm3, 48(%rsp)\n"
+    "    movaps %xmm4, 64(%rsp)\n"
+    "    movaps %xmm5, 80(%rsp)\n"
+    "    movaps %xmm6, 96(%rsp)\n"
+    "    movaps %xmm7, 112(%rsp)\n"
+    "    mov 184(%rsp), %rdi\n"
+    "    mov 192(%rsp), %rsi\n"
+    "    call lazy_bind_fixup\n"
+    "    mov %rax, %r11\n"
+    "    movaps 0(%rsp), %xmm0\n"
+    "    movaps 16(%rsp), %xmm1\n"
+    "    movaps 32(%rsp), %xmm2\n"
+    "    movaps 48(%rsp), %xmm3\n"
+    "    movaps 64(%rsp), %xmm4\n"
+    "    movaps 80(%rsp), %xmm5\n"
+    "    movaps 96(%rsp), %xmm6\n"
+    "    movaps 112(%rsp), %xmm7\n"
+    "    add $128, %rsp\n"
+    "    pop %r9\n"
+    "    pop %r8\n"
+    "    pop %rcx\n"
+    "    pop %rdx\n"
+    "    pop %rsi\n"
+    "    pop %rdi\n"
+    "    pop %rax\n"
+    "    add $16, %rsp\n"
+    "    jmp *%r11\n"
+);
+
+#define HAVE_LAZY_BIND_ENTRY 1
+
+#elif defined(__aarch64__)
+
+// The first PLT entry pushed x16, the address of the GOT slot, and x30.
+// x16 now points to the third word of the GOT, x8 holds the address of
+// returned structures.
+__asm__(
+    ".text\n"
+    ".balign 8\n"
+    "lazy_bind_entry:\n"
+    "    sub sp, sp, #208\n"
+    "    stp x0, x1, [sp, #0]\n"
+    "    stp x2, x3, [sp, #16]\n"
+    "    stp x4, x5, [sp, #32]\n"
+    "    stp x6, x7, [sp, #48]\n"
+    "    str x8, [sp, #64]\n"
+    "    stp q0, q1, [sp, #80]\n"
+    "    stp q2, q3, [sp, #112]\n"
+    "    stp q4, q5, [sp, #144]\n"
+    "    stp q6, q7, [sp, #176]\n"
+    "    ldur x0, [x16, #-8]\n"
+    "    ldr x1, [sp, #208]\n"
+    "    sub x1, x1, x16\n"
+    "    lsr x1, x1, #3\n"
+    "    sub x1, x1, #1\n"
+    "    bl lazy_bind_fixup\n"
+    "    mov x16, x0\n"
+    "    ldp q6, q7, [sp, #176]\n"
+    "    ldp q4, q5, [sp, #144]\n"
+    "    ldp q2, q3, [sp, #112]\n"
+    "    ldp q0, q1, [sp, #80]\n"
+    "    ldr x8, [sp, #64]\n"
+    "    ldp x6, x7, [sp, #48]\n"
+    "    ldp x4, x5, [sp, #32]\n"
+    "    ldp x2, x3, [sp, #16]\n"
+    "    ldp x0, x1, [sp, #0]\n"
+    "    add sp, sp, #208\n"
+    "    ldp x17, x30, [sp], #16\n"
+    "    br x16\n"
+);
+
+#define HAVE_LAZY_BIND_ENTRY 1
+
+#elif defined(__arm__)
+
+#ifdef __ARM_PCS_VFP
+#define LAZY_BIND_VPUSH_ARGS "    vpush {d0-d7}\n"
+#define LAZY_BIND_VPOP_ARGS "    vpop {d0-d7}\n"
+#else
+#define LAZY_BIND_VPUSH_ARGS ""
+#define LAZY_BIND_VPOP_ARGS ""
+#endif
+
+// The first PLT entry pushed lr. ip holds the address of the GOT slot,
+// lr the address of the third word of the GOT. With the pushed lr, five
+// registers keep the stack 8 byte aligned.
+__asm__(
+    ".text\n"
+    ".arm\n"
+    ".balign 8\n"
+    "lazy_bind_entry:\n"
+    "    push {r0-r4}\n"
+    LAZY_BIND_VPUSH_ARGS
+    "    ldr r0, [lr, #-4]\n"
+    "    sub r1, ip, lr\n"
+    "    lsr r1, r1, #2\n"
+    "    sub r1, r1, #1\n"
+    "    bl lazy_bind_fixup\n"
+    "    mov ip, r0\n"
+    LAZY_BIND_VPOP_ARGS
+    "    pop {r0-r4}\n"
+    "    pop {lr}\n"
+    "    bx ip\n"
+);
+
+#define HAVE_LAZY_BIND_ENTRY 1
+
+#endif
+
+#ifdef HAVE_LAZY_BIND_ENTRY
+extern "C" char lazy_bind_entry[] __attribute__((visibility("hidden")));
+
+extern "C" ElfW(Addr) lazy_bind_fixup(soinfo* si, size_t index)
+    __attribute__((visibility("hidden"), used));
+
+// Recursive, an ifunc resolver run by a lookup may call through the PLT
+// of another lazily bound library. Not g_dl_mutex, which would make the
+// first calls of all threads wait for dlopen calls to finish.
+static pthread_mutex_t g_lazy_bind_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+ElfW(Addr) lazy_bind_fixup(soinfo* si, size_t index) {
+  ScopedPthreadMutexLocker locker(&g_lazy_bind_mutex);
+  return si->bind_lazy_slot(index);
+}
+#endif
+
+static bool g_lazy_bind_enabled = false;
+
+LazyBinding::LazyBinding(const soinfo::soinfo_list_t& global_group,
+                         const soinfo::soinfo_list_t& local_group) {
+  global_group.for_each([&](soinfo* si) {
+    global_group_.push_back(si);
+  });
+  local_group.for_each([&](soinfo* si) {
+    local_group_.push_back(si);
+  });
+}
+
+void lazy_bind_init(const char* value) {
+#ifdef HAVE_LAZY_BIND_ENTRY
+  g_lazy_bind_enabled = value != nullptr && atoi(value) != 0;
+#else
+  if (value != nullptr && atoi(value) != 0) {
+    PRINT("warning: lazy binding is not supported on this architecture");
+  }
+#endif
+}
+
+bool lazy_bind_enabled() {
+  return g_lazy_bind_enabled;
+}
+
+void lazy_bind_setup_got(soinfo* si, ElfW(Addr)* got) {
+#ifdef HAVE_LAZY_BIND_ENTRY
+  got[1] = reinterpret_cast<ElfW(Addr)>(si);
+  got[2] = reinterpret_cast<ElfW(Addr)>(lazy_bind_entry);
+#else
+  (void) si;
+  (void) got;
+#endif
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LINKER_LAZY_BIND_H
+#define __LINKER_LAZY_BIND_H
+
+#include "linker.h"
+
+// Lazy binding of PLT slots, enabled with HYBRIS_LD_BIND_LAZY=1.
+//
+// Libraries loaded by a dlopen with RTLD_LAZY, which don't ask for
+// immediate binding themselves (DT_BIND_NOW, DF_BIND_NOW, DF_1_NOW), only
+// get their JUMP_SLOT relocations adjusted by the load bias. The slots
+// then point back into the PLT of the library, whose first entry jumps to
+// the resolver stored in the third word of the GOT. The resolver looks up
+// the symbol, hooks first, writes the slot and continues into the
+// function; later calls go straight to it.
+//
+// Symbols are looked up in the global and local group the library was
+// linked with, so they resolve to the same functions as with immediate
+// binding. A missing symbol is only noticed on the first call though,
+// and aborts the process instead of failing dlopen.
+//
+// Only x86_64, arm and aarch64 have a resolver. Elsewhere, and for
+// libraries whose GOT is covered by GNU RELRO, all slots are bound
+// immediately.
+class LazyBinding {
+ public:
+  LazyBinding(const soinfo::soinfo_list_t& global_group,
+              const soinfo::soinfo_list_t& local_group);
+
+  const soinfo::soinfo_list_t& global_group() const {
+    return global_group_;
+  }
+
+  const soinfo::soinfo_list_t& local_group() const {
+    return local_group_;
+  }
+
+  VersionTracker& version_tracker() {
+    return version_tracker_;
+  }
+
+ private:
+  // Copies of the lists link_image was called with. They share the
+  // links allocator with the soinfos, so they have to be created and
+  // destroyed while its pages are writable.
+  soinfo::soinfo_list_t global_group_;
+  soinfo::soinfo_list_t local_group_;
+  VersionTracker version_tracker_;
+
+  DISALLOW_COPY_AND_ASSIGN(LazyBinding);
+};
+
+// Called from android_linker_init with the value of HYBRIS_LD_BIND_LAZY.
+void lazy_bind_init(const char* value);
+
+// True if lazy binding is enabled and implemented for this architecture.
+bool lazy_bind_enabled();
+
+// Stores si and the resolver in the reserved words of the GOT.
+void lazy_bind_setup_got(soinfo* si, ElfW(Addr)* got);
+
+#endif  // __LINKER_LAZY_BIND_H
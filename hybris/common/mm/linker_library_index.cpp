@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "linker_library_index.h"
+
+#include <algorithm>
+
+template<typename Map, typename Key>
+static void remove_from(Map& map, const Key& key, soinfo* si) {
+  auto it = map.find(key);
+  if (it == map.end()) {
+    return;
+  }
+
+  LibraryIndex::soinfo_vector_t& libraries = it->second;
+  libraries.erase(std::remove(libraries.begin(), libraries.end(), si), libraries.end());
+  if (libraries.empty()) {
+    map.erase(it);
+  }
+}
+
+size_t LibraryIndex::FileKeyHash::operator()(const FileKey& key) const {
+  size_t h = std::hash<uint64_t>()(static_cast<uint64_t>(key.ino));
+  h = h * 31 + std::hash<uint64_t>()(static_cast<uint64_t>(key.dev));
+  return h * 31 + std::hash<uint64_t>()(static_cast<uint64_t>(key.offset));
+}
+
+void LibraryIndex::add_file(soinfo* si) {
+  by_realpath_[si->get_realpath()].push_back(si);
+
+  if (si->get_st_dev() != 0 && si->get_st_ino() != 0) {
+    FileKey key = { si->get_st_dev(), si->get_st_ino(), si->get_file_offset() };
+    by_file_[key].push_back(si);
+  }
+}
+
+void LibraryIndex::add_soname(soinfo* si) {
+  if (si->get_soname() != nullptr) {
+    by_soname_[si->get_soname()].push_back(si);
+  }
+}
+
+void LibraryIndex::remove(soinfo* si) {
+  if (si->get_soname() != nullptr) {
+    remove_from(by_soname_, std::string(si->get_soname()), si);
+  }
+
+  remove_from(by_realpath_, std::string(si->get_realpath()), si);
+
+  if (si->get_st_dev() != 0 && si->get_st_ino() != 0) {
+    FileKey key = { si->get_st_dev(), si->get_st_ino(), si->get_file_offset() };
+    remove_from(by_file_, key, si);
+  }
+}
+
+const LibraryIndex::soinfo_vector_t* LibraryIndex::find_soname(const char* soname) const {
+  auto it = by_soname_.find(soname);
+  return it != by_soname_.end() ? &it->second : nullptr;
+}
+
+soinfo* LibraryIndex::find_realpath(const char* realpath) const {
+  auto it = by_realpath_.find(realpath);
+  return it != by_realpath_.end() ? it->second.front() : nullptr;
+}
+
+soinfo* LibraryIndex::find_file(dev_t dev, ino_t ino, off64_t offset) const {
+  if (dev == 0 || ino == 0) {
+    return nullptr;
+  }
+
+  FileKey key = { dev, ino, offset };
+  auto it = by_file_.find(key);
+  return it != by_file_.end() ? it->second.front() : nullptr;
+}
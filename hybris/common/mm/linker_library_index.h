@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LINKER_LIBRARY_INDEX_H
+#define __LINKER_LIBRARY_INDEX_H
+
+#include "linker.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Hash indexes of the loaded libraries by soname, by realpath and by
+// file (device, inode and offset), which replace walks of solist with a
+// string compare per library.
+//
+// Libraries are added by realpath and file when their soinfo is
+// allocated and by soname at the end of prelink_image, which follows the
+// allocation directly, so every key keeps its libraries in solist order
+// and a lookup finds the library the walk would have found first. The
+// static libdl soinfo at the head of solist is not indexed.
+class LibraryIndex {
+ public:
+  typedef std::vector<soinfo*> soinfo_vector_t;
+
+  void add_file(soinfo* si);
+  void add_soname(soinfo* si);
+  void remove(soinfo* si);
+
+  // The libraries with this soname in solist order, nullptr if none.
+  const soinfo_vector_t* find_soname(const char* soname) const;
+  soinfo* find_realpath(const char* realpath) const;
+  soinfo* find_file(dev_t dev, ino_t ino, off64_t offset) const;
+
+ private:
+  struct FileKey {
+    dev_t dev;
+    ino_t ino;
+    off64_t offset;
+
+    bool operator==(const FileKey& that) const {
+      return dev == that.dev && ino == that.ino && offset == that.offset;
+    }
+  };
+
+  struct FileKeyHash {
+    size_t operator()(const FileKey& key) const;
+  };
+
+  std::unordered_map<std::string, soinfo_vector_t> by_soname_;
+  std::unordered_map<std::string, soinfo_vector_t> by_realpath_;
+  std::unordered_map<FileKey, soinfo_vector_t, FileKeyHash> by_file_;
+};
+
+#endif  // __LINKER_LIBRARY_INDEX_H
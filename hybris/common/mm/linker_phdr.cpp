@@ -37,6 +37,7 @@
 
 #include "linker.h"
 #include "linker_debug.h"
+#include "linker_relro_share.h"
 
 #include "hybris_compat.h"
 
@@ -332,6 +333,11 @@ bool ElfReader::ReserveAddressSpace(const android_dlextinfo* extinfo) {
     if ((extinfo->flags & ANDROID_DLEXT_FORCE_FIXED_VADDR) != 0) {
       mmap_hint = addr;
     }
+  } else {
+    // hybris: the address assigned for RELRO sharing, if any. If it is
+    // taken the kernel picks another one and nothing is shared.
+    mmap_hint = reinterpret_cast<uint8_t*>(
+        relro_share_get_address(name_, fd_, file_offset_, phdr_table_, phdr_num_, load_size_));
   }
 
   if (load_size_ > reserved_size) {
@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "linker_profile.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "private/ScopedPthreadMutexLocker.h"
+
+#include "linker_debug.h"
+
+#include "hybris_compat.h"
+
+static const char* const kPhaseNames[kProfilePhaseCount] = {
+  "open", "map", "prelink", "relocate", "symbol lookups", "hook lookups", "constructors",
+};
+
+struct LibraryProfile {
+  uint64_t ns[kProfilePhaseCount];
+  uint32_t loads;
+};
+
+static bool g_profile_enabled = false;
+static std::string g_profile_path;
+
+static pthread_mutex_t g_profile_mutex = PTHREAD_MUTEX_INITIALIZER;
+static std::map<std::string, LibraryProfile>* g_profile_libraries = nullptr;
+static std::map<std::string, uint64_t>* g_profile_stacks = nullptr;
+static std::string g_profile_root;  // the dlopen stack, for g_profile_stacks
+static int g_profile_depth = 0;
+
+static const uint32_t kLookupInterval = 8;  // a power of two
+
+// Lookups of the link in progress on this thread.
+static __thread uint64_t g_lookup_ns[kProfilePhaseCount];
+static __thread uint32_t g_lookup_count[kProfilePhaseCount];
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+static const char* base_name(const char* path) {
+  const char* slash = strrchr(path, '/');
+  return slash != nullptr ? slash + 1 : path;
+}
+
+void linker_profile_init(const char* path) {
+  if (path == nullptr || *path == '\0') {
+    return;
+  }
+
+  g_profile_path = path;
+  g_profile_libraries = new std::map<std::string, LibraryProfile>();
+  g_profile_stacks = new std::map<std::string, uint64_t>();
+  g_profile_enabled = true;
+}
+
+uint64_t linker_profile_begin() {
+  return g_profile_enabled ? now_ns() : 0;
+}
+
+// Called with g_profile_mutex held.
+static std::string stack_root() {
+  return g_profile_root.empty() ? std::string("dlopen(?)") : g_profile_root;
+}
+
+// Called with g_profile_mutex held.
+static void add_locked(const std::string& library, LinkerProfilePhase phase, uint64_t ns) {
+  auto it = g_profile_libraries->find(library);
+  if (it == g_profile_libraries->end()) {
+    LibraryProfile profile;
+    memset(&profile, 0, sizeof(profile));
+    it = g_profile_libraries->insert(std::make_pair(library, profile)).first;
+  }
+  it->second.ns[phase] += ns;
+  if (phase == kProfileMap) {
+    ++it->second.loads;
+  }
+
+  std::string stack = stack_root();
+  stack += ';';
+  stack += library;
+  stack += ';';
+  if (phase == kProfileSymbolLookup || phase == kProfileHookLookup) {
+    stack += kPhaseNames[kProfileRelocate];
+    stack += ';';
+  }
+  stack += kPhaseNames[phase];
+  (*g_profile_stacks)[stack] += ns;
+}
+
+void linker_profile_end(const char* library, LinkerProfilePhase phase, uint64_t start) {
+  if (start == 0) {
+    return;
+  }
+
+  uint64_t ns = now_ns() - start;
+  std::string name = base_name(library);
+
+  ScopedPthreadMutexLocker locker(&g_profile_mutex);
+  if (phase != kProfileRelocate) {
+    add_locked(name, phase, ns);
+    return;
+  }
+
+  // The relocate stack only gets the time not spent in lookups, so that
+  // the stacks add up.
+  uint64_t lookups = 0;
+  for (LinkerProfilePhase lookup : { kProfileSymbolLookup, kProfileHookLookup }) {
+    add_locked(name, lookup, g_lookup_ns[lookup]);
+    lookups += g_lookup_ns[lookup];
+    g_lookup_ns[lookup] = 0;
+  }
+
+  add_locked(name, kProfileRelocate, ns);
+  std::string stack = stack_root() + ';' + name + ';' + kPhaseNames[kProfileRelocate];
+  (*g_profile_stacks)[stack] -= std::min(lookups, ns);
+}
+
+uint64_t linker_profile_begin_lookup(LinkerProfilePhase phase) {
+  // Counted by phase: a relocation may do a hook and a symbol lookup.
+  if (!g_profile_enabled || (++g_lookup_count[phase] & (kLookupInterval - 1)) != 0) {
+    return 0;
+  }
+  return now_ns();
+}
+
+void linker_profile_end_lookup(LinkerProfilePhase phase, uint64_t start) {
+  if (start != 0) {
+    g_lookup_ns[phase] += (now_ns() - start) * kLookupInterval;
+  }
+}
+
+static void append(std::string* out, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+static void append(std::string* out, const char* fmt, ...) {
+  char buf[PATH_MAX + 256];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  *out += buf;
+}
+
+static void write_file(const std::string& path, const std::string& contents) {
+  char tmp_path[PATH_MAX];
+  snprintf(tmp_path, sizeof(tmp_path), "%s.%d", path.c_str(), getpid());
+
+  int fd = TEMP_FAILURE_RETRY(open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+  if (fd == -1) {
+    PRINT("warning: can't write linker profile %s: %s", tmp_path, strerror(errno));
+    return;
+  }
+
+  bool written = TEMP_FAILURE_RETRY(write(fd, contents.data(), contents.size())) ==
+                 static_cast<ssize_t>(contents.size());
+  close(fd);
+
+  if (!written || rename(tmp_path, path.c_str()) != 0) {
+    PRINT("warning: can't write linker profile %s: %s", path.c_str(), strerror(errno));
+    unlink(tmp_path);
+  }
+}
+
+// Called with g_profile_mutex held.
+static void write_profile_locked() {
+  auto total = [](const LibraryProfile& p) {
+    return p.ns[kProfileOpen] + p.ns[kProfileMap] + p.ns[kProfilePrelink] +
+           p.ns[kProfileRelocate] + p.ns[kProfileConstructors];
+  };
+
+  typedef std::pair<const std::string*, const LibraryProfile*> entry_t;
+  std::vector<entry_t> libraries;
+  for (const auto& entry : *g_profile_libraries) {
+    libraries.push_back(std::make_pair(&entry.first, &entry.second));
+  }
+  std::sort(libraries.begin(), libraries.end(), [&](const entry_t& a, const entry_t& b) {
+    return total(*a.second) > total(*b.second);
+  });
+
+  std::string report = "library\tloads";
+  for (size_t phase = 0; phase < kProfilePhaseCount; ++phase) {
+    report += '\t';
+    report += kPhaseNames[phase];
+  }
+  report += "\ttotal\n";
+  for (const auto& library : libraries) {
+    append(&report, "%s\t%" PRIu32, library.first->c_str(), library.second->loads);
+    for (size_t phase = 0; phase < kProfilePhaseCount; ++phase) {
+      append(&report, "\t%" PRIu64, library.second->ns[phase] / 1000);
+    }
+    append(&report, "\t%" PRIu64 "\n", total(*library.second) / 1000);
+  }
+  write_file(g_profile_path, report);
+
+  std::string folded;
+  for (const auto& stack : *g_profile_stacks) {
+    if (stack.second >= 1000) {
+      append(&folded, "%s %" PRIu64 "\n", stack.first.c_str(), stack.second / 1000);
+    }
+  }
+  write_file(g_profile_path + ".folded", folded);
+}
+
+void linker_profile_dlopen_begin(const char* name) {
+  if (!g_profile_enabled) {
+    return;
+  }
+
+  ScopedPthreadMutexLocker locker(&g_profile_mutex);
+  if (g_profile_depth++ == 0) {
+    g_lookup_ns[kProfileSymbolLookup] = 0;
+    g_lookup_ns[kProfileHookLookup] = 0;
+  } else {
+    g_profile_root += ';';
+  }
+  g_profile_root += "dlopen(";
+  g_profile_root += base_name(name);
+  g_profile_root += ')';
+}
+
+void linker_profile_dlopen_end() {
+  if (!g_profile_enabled) {
+    return;
+  }
+
+  ScopedPthreadMutexLocker locker(&g_profile_mutex);
+  size_t separator = g_profile_root.rfind(';');
+  g_profile_root.resize(separator == std::string::npos ? 0 : separator);
+  if (--g_profile_depth == 0) {
+    write_profile_locked();
+  }
+}
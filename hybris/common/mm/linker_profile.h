@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LINKER_PROFILE_H
+#define __LINKER_PROFILE_H
+
+#include <stdint.h>
+
+// Profiler of the phases of loading a library.
+//
+// When HYBRIS_LINKER_PROFILE=<path> is set, the linker times for every
+// library how long it spent opening it (including probing the search
+// path), mapping its segments, in prelink_image, relocating it and in its
+// constructors. The relocation time is split further into the symbol
+// lookups in the loaded libraries and the lookups in the hook table.
+// Libraries are named by the base name of their path.
+//
+// After each dlopen which isn't nested in another one, two files are
+// rewritten:
+//
+//   <path>         a tab separated table with a line per library, in
+//                  microseconds summed over all loads, slowest first
+//                  (relocate includes the lookups)
+//   <path>.folded  the same times as stacks for flamegraph.pl, rooted at
+//                  the library passed to dlopen, e.g.
+//                  "dlopen(libEGL.so);libGLESv2_vendor.so;relocate;hook lookups 1234"
+//
+// Opening and mapping happen on the loader threads for wide dependency
+// levels (see HYBRIS_LD_LOAD_THREADS), so their times can add up to more
+// than the dlopen took.
+
+enum LinkerProfilePhase {
+  kProfileOpen = 0,
+  kProfileMap,
+  kProfilePrelink,
+  kProfileRelocate,
+  kProfileSymbolLookup,
+  kProfileHookLookup,
+  kProfileConstructors,
+  kProfilePhaseCount
+};
+
+// Called from android_linker_init, path may be null to disable profiling.
+void linker_profile_init(const char* path);
+
+// Returns the start time of a phase, or 0 if profiling is disabled.
+uint64_t linker_profile_begin();
+
+// Adds the time since start to phase of library (a path or a name).
+void linker_profile_end(const char* library, LinkerProfilePhase phase, uint64_t start);
+
+// The same for a symbol or hook lookup. There are too many lookups to
+// time them all, so only every 8th one is timed and counted 8 times. The
+// times add up on the calling thread until the next linker_profile_end
+// for kProfileRelocate assigns them to its library.
+uint64_t linker_profile_begin_lookup(LinkerProfilePhase phase);
+void linker_profile_end_lookup(LinkerProfilePhase phase, uint64_t start);
+
+// Called by do_dlopen around loading and initializing name.
+void linker_profile_dlopen_begin(const char* name);
+void linker_profile_dlopen_end();
+
+#endif  // __LINKER_PROFILE_H
@@ -0,0 +1,392 @@
+/*
+ * Copyright (C) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "linker_reloc_cache.h"
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "linker_debug.h"
+
+#include "hybris_compat.h"
+
+static const char kRelocCacheMagic[4] = { 'H', 'R', 'C', '1' };
+static const uint32_t kRelocCacheVersion = 1;
+
+struct reloc_cache_file_id {
+  uint64_t dev;
+  uint64_t ino;
+  uint64_t size;
+  int64_t mtime_sec;
+  int64_t mtime_nsec;
+};
+
+struct reloc_cache_header {
+  char magic[4];
+  uint32_t version;
+  uint32_t addr_size;
+  uint32_t sdk_version;
+  reloc_cache_file_id hooks;
+  uint32_t member_count;
+  uint32_t entry_count;
+};
+
+static std::string g_reloc_cache_dir;
+static reloc_cache_file_id g_hooks_id;
+
+static uint64_t fnv1a(const void* data, size_t size, uint64_t h = 0xcbf29ce484222325ULL) {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    h ^= p[i];
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+static void file_id_from_stat(const struct stat& st, reloc_cache_file_id* id) {
+  memset(id, 0, sizeof(*id));
+  id->dev = st.st_dev;
+  id->ino = st.st_ino;
+  id->size = st.st_size;
+  id->mtime_sec = st.st_mtim.tv_sec;
+  id->mtime_nsec = st.st_mtim.tv_nsec;
+}
+
+static bool file_id_from_soinfo(const soinfo* si, reloc_cache_file_id* id) {
+  memset(id, 0, sizeof(*id));
+  if (si->get_st_ino() == 0) {
+    // libdl, vdso and friends: their symbols do not live in a file we
+    // could check, so they can't be part of a cache key.
+    return false;
+  }
+
+  id->dev = si->get_st_dev();
+  id->ino = si->get_st_ino();
+  id->size = si->get_file_size();
+  id->mtime_sec = si->get_file_mtime().tv_sec;
+  id->mtime_nsec = si->get_file_mtime().tv_nsec;
+  return true;
+}
+
+// The entries are applied as relocation targets, so only files nobody
+// else can have written are used.
+static bool is_trusted_file(int fd) {
+  struct stat st;
+  if (TEMP_FAILURE_RETRY(fstat(fd, &st)) != 0 || !S_ISREG(st.st_mode)) {
+    return false;
+  }
+  if (st.st_uid != 0 && st.st_uid != geteuid()) {
+    return false;
+  }
+  return (st.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+void reloc_cache_init(const char* dir, const void* hook_provider) {
+  g_reloc_cache_dir.clear();
+  if (dir == nullptr || *dir == '\0') {
+    return;
+  }
+
+  // The hooks are part of the key: a rebuilt libhybris may hook
+  // different symbols than the one the cache was written with.
+  Dl_info info;
+  struct stat st;
+  if (dladdr(hook_provider, &info) == 0 || info.dli_fname == nullptr ||
+      stat(info.dli_fname, &st) != 0) {
+    PRINT("warning: can't identify the hook provider, relocation cache disabled");
+    return;
+  }
+
+  file_id_from_stat(st, &g_hooks_id);
+  g_reloc_cache_dir = dir;
+}
+
+RelocCache::RelocCache(const soinfo* si, const soinfo::soinfo_list_t& global_group,
+                       const soinfo::soinfo_list_t& local_group)
+    : si_(si), enabled_(false), dirty_(false) {
+  reloc_cache_file_id id;
+  if (g_reloc_cache_dir.empty() || !file_id_from_soinfo(si, &id)) {
+    return;
+  }
+
+  global_group.for_each([&](const soinfo* member) {
+    members_.push_back(member);
+  });
+  local_group.for_each([&](const soinfo* member) {
+    members_.push_back(member);
+  });
+
+  enabled_ = true;
+  if (!load()) {
+    entries_.clear();
+  }
+}
+
+bool RelocCache::get_path(std::string* path) const {
+  const char* realpath = si_->get_realpath();
+  char name[32];
+  snprintf(name, sizeof(name), "/%016" PRIx64 ".relocs", fnv1a(realpath, strlen(realpath)));
+  *path = g_reloc_cache_dir + name;
+  return true;
+}
+
+// The file layout is: header, then for every member of the load group
+// its file id, path length and path, then the entries and finally a
+// checksum over everything before it.
+bool RelocCache::load() {
+  std::string path;
+  get_path(&path);
+
+  int fd = TEMP_FAILURE_RETRY(open(path.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC));
+  if (fd == -1) {
+    dirty_ = true;
+    return false;
+  }
+  if (!is_trusted_file(fd)) {
+    DEBUG("reloc cache %s may be changed by other users, not using it", path.c_str());
+    close(fd);
+    dirty_ = true;
+    return false;
+  }
+
+  std::vector<uint8_t> buf;
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size > 0) {
+    buf.resize(st.st_size);
+    if (TEMP_FAILURE_RETRY(read(fd, &buf[0], buf.size())) != static_cast<ssize_t>(buf.size())) {
+      buf.clear();
+    }
+  }
+  close(fd);
+
+  dirty_ = true;
+
+  size_t pos = 0;
+  auto take = [&](void* dst, size_t size) {
+    if (buf.size() - pos < size) {
+      return false;
+    }
+    memcpy(dst, &buf[pos], size);
+    pos += size;
+    return true;
+  };
+
+  uint64_t checksum;
+  if (buf.size() < sizeof(reloc_cache_header) + sizeof(checksum)) {
+    return false;
+  }
+
+  memcpy(&checksum, &buf[buf.size() - sizeof(checksum)], sizeof(checksum));
+  buf.resize(buf.size() - sizeof(checksum));
+  if (fnv1a(&buf[0], buf.size()) != checksum) {
+    DEBUG("reloc cache %s for %s is corrupt", path.c_str(), si_->get_realpath());
+    return false;
+  }
+
+  reloc_cache_header header;
+  take(&header, sizeof(header));
+  if (memcmp(header.magic, kRelocCacheMagic, sizeof(kRelocCacheMagic)) != 0 ||
+      header.version != kRelocCacheVersion ||
+      header.addr_size != sizeof(ElfW(Addr)) ||
+      header.sdk_version != get_application_target_sdk_version() ||
+      memcmp(&header.hooks, &g_hooks_id, sizeof(g_hooks_id)) != 0 ||
+      header.member_count != members_.size()) {
+    DEBUG("reloc cache %s for %s is stale", path.c_str(), si_->get_realpath());
+    return false;
+  }
+
+  for (size_t i = 0; i < members_.size(); ++i) {
+    reloc_cache_file_id cached_id, id;
+    uint32_t path_len;
+    if (!take(&cached_id, sizeof(cached_id)) || !take(&path_len, sizeof(path_len))) {
+      return false;
+    }
+
+    const char* realpath = members_[i]->get_realpath();
+    file_id_from_soinfo(members_[i], &id);
+    if (buf.size() - pos < path_len ||
+        path_len != strlen(realpath) ||
+        memcmp(&buf[pos], realpath, path_len) != 0 ||
+        memcmp(&cached_id, &id, sizeof(id)) != 0) {
+      DEBUG("reloc cache %s for %s is stale: %s changed", path.c_str(),
+            si_->get_realpath(), realpath);
+      return false;
+    }
+    pos += path_len;
+  }
+
+  entries_.resize(header.entry_count);
+  if (header.entry_count > 0 && !take(&entries_[0], header.entry_count * sizeof(Entry))) {
+    return false;
+  }
+
+  // A resolved symbol has to be inside the mapping of its provider.
+  for (const Entry& entry : entries_) {
+    if (entry.kind != kResolved) {
+      continue;
+    }
+    if (entry.provider >= members_.size()) {
+      return false;
+    }
+
+    const soinfo* provider = members_[entry.provider];
+    ElfW(Addr) start = provider->base - provider->load_bias;
+    if (entry.offset < start || entry.offset - start >= provider->size) {
+      DEBUG("reloc cache %s for %s is corrupt", path.c_str(), si_->get_realpath());
+      return false;
+    }
+  }
+
+  TRACE("[ using reloc cache %s for %s ]", path.c_str(), si_->get_realpath());
+  dirty_ = false;
+  return true;
+}
+
+void RelocCache::save() {
+  if (!enabled_ || !dirty_) {
+    return;
+  }
+
+  std::vector<uint8_t> buf;
+  auto put = [&](const void* src, size_t size) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(src);
+    buf.insert(buf.end(), p, p + size);
+  };
+
+  reloc_cache_header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kRelocCacheMagic, sizeof(kRelocCacheMagic));
+  header.version = kRelocCacheVersion;
+  header.addr_size = sizeof(ElfW(Addr));
+  header.sdk_version = get_application_target_sdk_version();
+  header.hooks = g_hooks_id;
+  header.member_count = members_.size();
+  header.entry_count = entries_.size();
+  put(&header, sizeof(header));
+
+  for (const soinfo* member : members_) {
+    reloc_cache_file_id id;
+    file_id_from_soinfo(member, &id);
+    const char* realpath = member->get_realpath();
+    uint32_t path_len = strlen(realpath);
+    put(&id, sizeof(id));
+    put(&path_len, sizeof(path_len));
+    put(realpath, path_len);
+  }
+
+  if (!entries_.empty()) {
+    put(&entries_[0], entries_.size() * sizeof(Entry));
+  }
+
+  uint64_t checksum = fnv1a(&buf[0], buf.size());
+  put(&checksum, sizeof(checksum));
+
+  // Write to a private file and rename it into place so concurrent
+  // processes never see a partially written cache.
+  std::string path;
+  get_path(&path);
+  char tmp_path[PATH_MAX];
+  snprintf(tmp_path, sizeof(tmp_path), "%s.%d", path.c_str(), getpid());
+
+  // A stale file of a process which had our pid is ours too.
+  unlink(tmp_path);
+  int fd = TEMP_FAILURE_RETRY(open(tmp_path, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0644));
+  if (fd == -1) {
+    DEBUG("can't write reloc cache %s: %s", tmp_path, strerror(errno));
+    return;
+  }
+
+  bool written = TEMP_FAILURE_RETRY(write(fd, &buf[0], buf.size())) ==
+                 static_cast<ssize_t>(buf.size());
+  close(fd);
+
+  if (!written || rename(tmp_path, path.c_str()) != 0) {
+    DEBUG("can't write reloc cache %s: %s", path.c_str(), strerror(errno));
+    unlink(tmp_path);
+    return;
+  }
+
+  dirty_ = false;
+}
+
+RelocCache::Kind RelocCache::lookup(ElfW(Word) sym, ElfW(Addr)* sym_addr) const {
+  if (sym >= entries_.size()) {
+    return kMiss;
+  }
+
+  const Entry& entry = entries_[sym];
+  if (entry.kind == kResolved) {
+    *sym_addr = members_[entry.provider]->load_bias + entry.offset;
+  }
+
+  return static_cast<Kind>(entry.kind);
+}
+
+void RelocCache::set(ElfW(Word) sym, Kind kind, uint32_t provider, uint64_t offset) {
+  if (!enabled_) {
+    return;
+  }
+
+  if (sym >= entries_.size()) {
+    entries_.resize(sym + 1);
+  }
+
+  Entry& entry = entries_[sym];
+  if (entry.kind == kind && entry.provider == provider && entry.offset == offset) {
+    return;
+  }
+
+  entry.kind = kind;
+  entry.provider = provider;
+  entry.offset = offset;
+  dirty_ = true;
+}
+
+void RelocCache::record_hooked(ElfW(Word) sym) {
+  set(sym, kHooked, 0, 0);
+}
+
+void RelocCache::record_undefined_weak(ElfW(Word) sym) {
+  set(sym, kUndefinedWeak, 0, 0);
+}
+
+void RelocCache::record(ElfW(Word) sym, const soinfo* provider, const ElfW(Sym)* s,
+                        ElfW(Addr) sym_addr) {
+  reloc_cache_file_id id;
+
+  // ifunc resolvers may return anything, so those are resolved every time.
+  if (ELFW(ST_TYPE)(s->st_info) == STT_GNU_IFUNC || !file_id_from_soinfo(provider, &id)) {
+    set(sym, kNoCache, 0, 0);
+    return;
+  }
+
+  for (size_t i = 0; i < members_.size(); ++i) {
+    if (members_[i] == provider) {
+      set(sym, kResolved, i, sym_addr - provider->load_bias);
+      return;
+    }
+  }
+
+  set(sym, kNoCache, 0, 0);
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LINKER_RELOC_CACHE_H
+#define __LINKER_RELOC_CACHE_H
+
+#include "linker.h"
+
+#include <vector>
+
+// Persistent cache of symbol resolutions done while relocating a library.
+//
+// When HYBRIS_RELOC_CACHE_DIR is set, the linker stores for every library
+// where each of its imported symbols was found: either in the hook table,
+// or in a library of the load group (stored as an offset from that
+// library's load bias). On the next link of the same library the cached
+// results are used instead of walking the global and local groups again.
+// The hook table is still consulted for every symbol, hooks may have been
+// added since.
+//
+// A cache file is only used if the library itself, every library in the
+// global and local group (in the same order), the object providing the
+// hooks and the SDK version are identical to when it was written.
+// Anything else makes the linker silently fall back to normal lookups and
+// rewrite the file. Files which aren't owned by root or the user, which
+// other users can write or which point outside of the providers'
+// mappings are ignored too.
+class RelocCache {
+ public:
+  enum Kind {
+    kMiss = 0,       // not cached, do a normal lookup
+    kHooked,         // resolve through the hook table
+    kResolved,       // found in a library of the load group
+    kUndefinedWeak,  // weak reference without definition
+    kNoCache,        // not cacheable (ifunc, provider without a file)
+  };
+
+  RelocCache(const soinfo* si, const soinfo::soinfo_list_t& global_group,
+             const soinfo::soinfo_list_t& local_group);
+
+  bool enabled() const {
+    return enabled_;
+  }
+
+  Kind lookup(ElfW(Word) sym, ElfW(Addr)* sym_addr) const;
+
+  void record_hooked(ElfW(Word) sym);
+  void record_undefined_weak(ElfW(Word) sym);
+  void record(ElfW(Word) sym, const soinfo* provider, const ElfW(Sym)* s, ElfW(Addr) sym_addr);
+
+  // Writes the cache file if anything new was recorded.
+  void save();
+
+ private:
+  struct Entry {
+    uint32_t kind;
+    uint32_t provider;
+    uint64_t offset;
+  };
+
+  void set(ElfW(Word) sym, Kind kind, uint32_t provider, uint64_t offset);
+  bool load();
+  bool get_path(std::string* path) const;
+
+  const soinfo* si_;
+  std::vector<const soinfo*> members_;
+  std::vector<Entry> entries_;
+  bool enabled_;
+  bool dirty_;
+
+  DISALLOW_COPY_AND_ASSIGN(RelocCache);
+};
+
+// Called from android_linker_init, dir may be null to disable the cache.
+void reloc_cache_init(const char* dir, const void* hook_provider);
+
+#endif  // __LINKER_RELOC_CACHE_H
@@ -0,0 +1,342 @@
+/*
+ * Copyright (C) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "linker_relro_share.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "linker_debug.h"
+#include "linker_phdr.h"
+
+#include "hybris_compat.h"
+
+// The window must be free in the processes which load the libraries:
+// above the heap of a non-PIE executable and below PIE executables and
+// the mmap area, also with a 39 bit address space.
+#if defined(__LP64__)
+static const uint64_t kWindowStart = 0x2000000000ULL;  // 128 GiB
+static const uint64_t kWindowSize = 0x1000000000ULL;   // 64 GiB
+#else
+static const uint64_t kWindowStart = 0x40000000ULL;    // 1 GiB
+static const uint64_t kWindowSize = 0x10000000ULL;     // 256 MiB
+#endif
+
+static const char kLayoutMagic[4] = { 'H', 'R', 'L', '1' };
+static const char kRelroMagic[4] = { 'H', 'R', 'S', '1' };
+
+struct relro_share_file_id {
+  uint64_t dev;
+  uint64_t ino;
+  uint64_t size;
+  int64_t mtime_sec;
+  int64_t mtime_nsec;
+};
+
+struct relro_share_layout_header {
+  char magic[4];
+  uint32_t entry_count;
+  uint64_t window_start;
+  uint64_t window_size;
+  uint64_t next;  // offset of the first unassigned byte in the window
+};
+
+struct relro_share_layout_entry {
+  uint64_t path_hash;
+  relro_share_file_id id;
+  uint64_t start;
+  uint64_t size;
+};
+
+// Follows the RELRO pages in a .relro file, so that the pages start at
+// offset 0 as phdr_table_map_gnu_relro expects.
+struct relro_share_trailer {
+  char magic[4];
+  uint32_t unused;
+  relro_share_file_id id;
+  uint64_t load_start;
+  uint64_t load_size;
+};
+
+static std::string g_relro_share_dir;
+
+static uint64_t fnv1a(const char* s) {
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for (; *s != '\0'; ++s) {
+    h ^= static_cast<uint8_t>(*s);
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+static bool has_gnu_relro(const ElfW(Phdr)* phdr_table, size_t phdr_count) {
+  for (size_t i = 0; i < phdr_count; ++i) {
+    if (phdr_table[i].p_type == PT_GNU_RELRO) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// The files of the directory end up as pages of every process which maps
+// them, so only files nobody but root and we can change are used.
+static bool is_trusted_file(int fd) {
+  struct stat st;
+  if (TEMP_FAILURE_RETRY(fstat(fd, &st)) != 0 || !S_ISREG(st.st_mode)) {
+    return false;
+  }
+  if (st.st_uid != 0 && st.st_uid != geteuid()) {
+    return false;
+  }
+  return (st.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+static std::string get_relro_path(const char* realpath) {
+  char name[32];
+  snprintf(name, sizeof(name), "/%016" PRIx64 ".relro", fnv1a(realpath));
+  return g_relro_share_dir + name;
+}
+
+void relro_share_init(const char* dir) {
+  g_relro_share_dir.clear();
+  if (dir != nullptr && *dir != '\0') {
+    g_relro_share_dir = dir;
+  }
+}
+
+// Looks up the range assigned to the library in the layout file, or
+// assigns one, with the file locked. A rebuilt library keeps its range
+// if it still fits.
+static uint64_t assign_range(uint64_t path_hash, const relro_share_file_id& id, size_t load_size) {
+  char name[32];
+  snprintf(name, sizeof(name), "/layout%zu", sizeof(void*) * 8);
+  std::string path = g_relro_share_dir + name;
+
+  int fd = TEMP_FAILURE_RETRY(open(path.c_str(), O_RDWR | O_CREAT | O_NOFOLLOW | O_CLOEXEC, 0644));
+  if (fd == -1) {
+    DEBUG("can't open RELRO layout %s: %s", path.c_str(), strerror(errno));
+    return 0;
+  }
+  if (!is_trusted_file(fd)) {
+    DEBUG("RELRO layout %s may be changed by other users, not sharing", path.c_str());
+    close(fd);
+    return 0;
+  }
+  if (TEMP_FAILURE_RETRY(flock(fd, LOCK_EX)) != 0) {
+    close(fd);
+    return 0;
+  }
+
+  relro_share_layout_header header;
+  std::vector<relro_share_layout_entry> entries;
+  struct stat st;
+  bool valid = fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(header) &&
+               TEMP_FAILURE_RETRY(pread(fd, &header, sizeof(header), 0)) ==
+                   static_cast<ssize_t>(sizeof(header)) &&
+               memcmp(header.magic, kLayoutMagic, sizeof(kLayoutMagic)) == 0 &&
+               header.window_start == kWindowStart && header.window_size == kWindowSize &&
+               static_cast<size_t>(st.st_size) == sizeof(header) + header.entry_count * sizeof(relro_share_layout_entry);
+  if (valid && header.entry_count > 0) {
+    entries.resize(header.entry_count);
+    size_t size = entries.size() * sizeof(relro_share_layout_entry);
+    valid = TEMP_FAILURE_RETRY(pread(fd, &entries[0], size, sizeof(header))) ==
+            static_cast<ssize_t>(size);
+  }
+  if (!valid) {
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kLayoutMagic, sizeof(kLayoutMagic));
+    header.window_start = kWindowStart;
+    header.window_size = kWindowSize;
+    entries.clear();
+  }
+
+  uint64_t start = 0;
+  bool changed = !valid;
+  relro_share_layout_entry* entry = nullptr;
+  for (relro_share_layout_entry& e : entries) {
+    if (e.path_hash == path_hash) {
+      entry = &e;
+      break;
+    }
+  }
+
+  if (entry != nullptr && entry->size >= load_size) {
+    if (memcmp(&entry->id, &id, sizeof(id)) != 0) {
+      entry->id = id;
+      changed = true;
+    }
+    start = entry->start;
+  } else {
+    // Leave a guard page between the libraries.
+    uint64_t size = PAGE_END(load_size) + PAGE_SIZE;
+    if (header.next + size <= kWindowSize) {
+      if (entry == nullptr) {
+        entries.resize(entries.size() + 1);
+        entry = &entries.back();
+        entry->path_hash = path_hash;
+      }
+      entry->id = id;
+      entry->start = kWindowStart + header.next;
+      entry->size = PAGE_END(load_size);
+      header.next += size;
+      changed = true;
+      start = entry->start;
+    } else {
+      DEBUG("RELRO sharing window is full");
+    }
+  }
+
+  if (changed) {
+    header.entry_count = entries.size();
+    std::vector<uint8_t> buf(sizeof(header) + entries.size() * sizeof(relro_share_layout_entry));
+    memcpy(&buf[0], &header, sizeof(header));
+    if (!entries.empty()) {
+      memcpy(&buf[sizeof(header)], &entries[0], entries.size() * sizeof(relro_share_layout_entry));
+    }
+    if (TEMP_FAILURE_RETRY(pwrite(fd, &buf[0], buf.size(), 0)) != static_cast<ssize_t>(buf.size()) ||
+        ftruncate(fd, buf.size()) != 0) {
+      DEBUG("can't write RELRO layout %s: %s", path.c_str(), strerror(errno));
+      start = 0;
+    }
+  }
+
+  close(fd);  // drops the lock
+  return start;
+}
+
+void* relro_share_get_address(const char* realpath, int fd, off64_t file_offset,
+                              const ElfW(Phdr)* phdr_table, size_t phdr_count,
+                              size_t load_size) {
+  if (g_relro_share_dir.empty() || file_offset != 0 ||
+      !has_gnu_relro(phdr_table, phdr_count)) {
+    return nullptr;
+  }
+
+  struct stat st;
+  if (TEMP_FAILURE_RETRY(fstat(fd, &st)) != 0) {
+    return nullptr;
+  }
+
+  relro_share_file_id id;
+  memset(&id, 0, sizeof(id));
+  id.dev = st.st_dev;
+  id.ino = st.st_ino;
+  id.size = st.st_size;
+  id.mtime_sec = st.st_mtim.tv_sec;
+  id.mtime_nsec = st.st_mtim.tv_nsec;
+
+  uint64_t start = assign_range(fnv1a(realpath), id, load_size);
+  return reinterpret_cast<void*>(static_cast<uintptr_t>(start));
+}
+
+// Writes the RELRO segment of si to path, which makes si use the file's
+// pages too.
+static void write_relro(const soinfo* si, const std::string& path, const relro_share_file_id& id) {
+  char tmp_path[PATH_MAX];
+  snprintf(tmp_path, sizeof(tmp_path), "%s.%d", path.c_str(), getpid());
+
+  // A stale file of a process which had our pid is ours too.
+  unlink(tmp_path);
+  int fd = TEMP_FAILURE_RETRY(open(tmp_path, O_RDWR | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0644));
+  if (fd == -1) {
+    DEBUG("can't write RELRO %s: %s", tmp_path, strerror(errno));
+    return;
+  }
+
+  relro_share_trailer trailer;
+  memset(&trailer, 0, sizeof(trailer));
+  memcpy(trailer.magic, kRelroMagic, sizeof(kRelroMagic));
+  trailer.id = id;
+  trailer.load_start = si->base;
+  trailer.load_size = si->size;
+
+  bool written = phdr_table_serialize_gnu_relro(si->phdr, si->phnum, si->load_bias, fd) == 0 &&
+                 TEMP_FAILURE_RETRY(write(fd, &trailer, sizeof(trailer))) ==
+                     static_cast<ssize_t>(sizeof(trailer));
+  close(fd);
+
+  // Concurrent writers each rename their own file, the last one wins.
+  if (!written || rename(tmp_path, path.c_str()) != 0) {
+    DEBUG("can't write RELRO %s: %s", path.c_str(), strerror(errno));
+    unlink(tmp_path);
+    return;
+  }
+
+  TRACE("[ wrote RELRO of \"%s\" to %s ]", si->get_realpath(), path.c_str());
+}
+
+void relro_share_apply(const soinfo* si) {
+  if (g_relro_share_dir.empty() || si->get_file_offset() != 0 || si->get_st_ino() == 0 ||
+      !has_gnu_relro(si->phdr, si->phnum)) {
+    return;
+  }
+
+  // Only libraries which got their assigned range take part.
+  if (si->base < kWindowStart || si->base >= kWindowStart + kWindowSize) {
+    return;
+  }
+
+  relro_share_file_id id;
+  memset(&id, 0, sizeof(id));
+  id.dev = si->get_st_dev();
+  id.ino = si->get_st_ino();
+  id.size = si->get_file_size();
+  id.mtime_sec = si->get_file_mtime().tv_sec;
+  id.mtime_nsec = si->get_file_mtime().tv_nsec;
+
+  std::string path = get_relro_path(si->get_realpath());
+  int fd = TEMP_FAILURE_RETRY(open(path.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC));
+  if (fd == -1) {
+    if (errno == ENOENT) {
+      write_relro(si, path, id);
+    }
+    return;
+  }
+  if (!is_trusted_file(fd)) {
+    DEBUG("RELRO %s may be changed by other users, not sharing", path.c_str());
+    close(fd);
+    return;
+  }
+
+  relro_share_trailer trailer;
+  struct stat st;
+  bool valid = fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(trailer) &&
+               TEMP_FAILURE_RETRY(pread(fd, &trailer, sizeof(trailer), st.st_size - sizeof(trailer))) ==
+                   static_cast<ssize_t>(sizeof(trailer)) &&
+               memcmp(trailer.magic, kRelroMagic, sizeof(kRelroMagic)) == 0 &&
+               memcmp(&trailer.id, &id, sizeof(id)) == 0 &&
+               trailer.load_start == si->base && trailer.load_size == si->size;
+
+  if (!valid) {
+    close(fd);
+    write_relro(si, path, id);
+    return;
+  }
+
+  if (phdr_table_map_gnu_relro(si->phdr, si->phnum, si->load_bias, fd) != 0) {
+    DEBUG("can't map RELRO %s for \"%s\": %s", path.c_str(), si->get_realpath(), strerror(errno));
+  }
+  close(fd);
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LINKER_RELRO_SHARE_H
+#define __LINKER_RELRO_SHARE_H
+
+#include "linker.h"
+
+// Sharing of relocated GNU RELRO segments between processes.
+//
+// Every process which loads the vendor graphics stack relocates the same
+// libraries and ends up with private dirty copies of their RELRO pages.
+// Most of those pages only hold pointers into the vendor libraries
+// themselves, so they would be identical if the libraries were loaded at
+// the same addresses everywhere.
+//
+// When HYBRIS_RELRO_SHARE_DIR is set, every library with a PT_GNU_RELRO
+// segment gets an address of its own in a window of the address space
+// which is normally unused. The assignments are kept in the file
+// layout<bits> of the directory, so all processes agree on them. The
+// first process to link a library at its address writes the RELRO
+// segment to <hash of path>.relro; later processes which got the same
+// address map the pages of that file which are identical to what they
+// relocated themselves (see phdr_table_map_gnu_relro), and so share
+// them. Pages with pointers into libraries outside the window, like the
+// hooks of libhybris, stay private.
+//
+// Nothing is shared if the address is already taken in a process, or the
+// library or any of its dependencies was rebuilt: the library is then
+// loaded wherever the kernel puts it, or its pages don't match the file.
+// Deleting the directory starts over with an empty window.
+//
+// Files of the directory which users other than root and ourselves could
+// write to are ignored, the libraries then stay private.
+
+// Called from android_linker_init, dir may be null to disable sharing.
+void relro_share_init(const char* dir);
+
+// Returns the address a library should be loaded at, or nullptr to let
+// the kernel choose. Called by ElfReader::ReserveAddressSpace for
+// libraries loaded without android_dlextinfo.
+void* relro_share_get_address(const char* realpath, int fd, off64_t file_offset,
+                              const ElfW(Phdr)* phdr_table, size_t phdr_count,
+                              size_t load_size);
+
+// Called by soinfo::link_image after the RELRO segment is protected:
+// maps the shared copy of the segment, or writes it if there is none.
+void relro_share_apply(const soinfo* si);
+
+#endif  // __LINKER_RELRO_SHARE_H
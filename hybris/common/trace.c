@@ -0,0 +1,406 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "trace.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+
+/* Events per thread, a power of two */
+#define TRACE_BUFFER_EVENTS 2048
+
+/* How often the drainer empties the buffers */
+#define TRACE_DRAIN_INTERVAL_NS (10 * 1000 * 1000)
+
+/*
+ * Single producer, single consumer ring buffer of a thread. Only the
+ * thread writes events and advances head, only the drainer advances
+ * tail. Buffers of threads which exited are reused once they are empty.
+ */
+struct trace_buffer {
+    struct trace_buffer *next;
+    uint32_t tid;
+    int in_use;
+    /* events lost because the buffer was full, and how many of them
+     * the drainer reported */
+    uint32_t dropped;
+    uint32_t dropped_reported;
+
+    uint32_t head __attribute__((aligned(64)));
+    uint32_t tail __attribute__((aligned(64)));
+
+    struct hybris_trace_event events[TRACE_BUFFER_EVENTS] __attribute__((aligned(64)));
+};
+
+static const char *trace_path;
+static int trace_enabled;
+static int trace_started;
+static int trace_fd = -1;
+
+/* changes in forked children, which start over with their own file */
+static unsigned int trace_generation;
+
+/* all buffers, new ones are pushed at the head */
+static struct trace_buffer *trace_buffers;
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* serializes draining, the drainer thread races with the atexit handler */
+static pthread_mutex_t drain_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_key_t trace_key;
+static pthread_once_t trace_key_once = PTHREAD_ONCE_INIT;
+
+static __thread struct trace_buffer *thread_buffer;
+static __thread unsigned int thread_buffer_generation;
+
+/* ids of the tracepoints which were written to the file, as an open
+ * addressed hash set only used by the drainer */
+static uint64_t *written_tracepoints;
+static size_t written_tracepoints_size;
+static size_t written_tracepoints_count;
+
+/* output buffer of the drainer */
+static char drain_out[65536];
+static size_t drain_out_len;
+
+static void trace_flush_out()
+{
+    size_t done = 0;
+
+    while (done < drain_out_len && trace_fd >= 0) {
+        ssize_t r = write(trace_fd, drain_out + done, drain_out_len - done);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r <= 0)
+            break;
+        done += r;
+    }
+
+    drain_out_len = 0;
+}
+
+static void trace_out(const void *data, size_t len)
+{
+    if (drain_out_len + len > sizeof(drain_out))
+        trace_flush_out();
+
+    memcpy(drain_out + drain_out_len, data, len);
+    drain_out_len += len;
+}
+
+static int trace_tracepoint_written(uint64_t id)
+{
+    size_t n;
+
+    if (written_tracepoints_count * 2 >= written_tracepoints_size) {
+        size_t size = written_tracepoints_size ? 2 * written_tracepoints_size : 256;
+        uint64_t *set = calloc(size, sizeof(uint64_t));
+        size_t i;
+
+        if (!set)
+            return 1;
+
+        for (i = 0; i < written_tracepoints_size; i++) {
+            uint64_t key = written_tracepoints[i];
+
+            if (!key)
+                continue;
+
+            for (n = (key >> 3) & (size - 1); set[n]; n = (n + 1) & (size - 1))
+                ;
+            set[n] = key;
+        }
+
+        free(written_tracepoints);
+        written_tracepoints = set;
+        written_tracepoints_size = size;
+    }
+
+    for (n = (id >> 3) & (written_tracepoints_size - 1); written_tracepoints[n];
+         n = (n + 1) & (written_tracepoints_size - 1)) {
+        if (written_tracepoints[n] == id)
+            return 1;
+    }
+
+    written_tracepoints[n] = id;
+    written_tracepoints_count++;
+    return 0;
+}
+
+static void trace_write_tracepoint(uint64_t id)
+{
+    const struct hybris_tracepoint *tracepoint = (const struct hybris_tracepoint *) (uintptr_t) id;
+    const char *strings[3] = { tracepoint->module, tracepoint->name, tracepoint->format };
+    struct hybris_trace_record_header header;
+    static const char padding[8];
+    size_t len[3], size;
+    char what = tracepoint->what;
+    int i;
+
+    size = sizeof(header) + sizeof(id) + 1;
+    for (i = 0; i < 3; i++) {
+        len[i] = strlen(strings[i]) + 1;
+        size += len[i];
+    }
+
+    header.type = HYBRIS_TRACE_RECORD_TRACEPOINT;
+    header.size = (size + 7) & ~7;
+
+    trace_out(&header, sizeof(header));
+    trace_out(&id, sizeof(id));
+    trace_out(&what, 1);
+    for (i = 0; i < 3; i++)
+        trace_out(strings[i], len[i]);
+    trace_out(padding, header.size - size);
+}
+
+static void trace_drain_buffer(struct trace_buffer *buffer)
+{
+    uint32_t head = __atomic_load_n(&buffer->head, __ATOMIC_ACQUIRE);
+    uint32_t tail = buffer->tail;
+    uint32_t dropped;
+
+    for (; tail != head; tail++) {
+        const struct hybris_trace_event *event = &buffer->events[tail & (TRACE_BUFFER_EVENTS - 1)];
+
+        if (!trace_tracepoint_written(event->tracepoint))
+            trace_write_tracepoint(event->tracepoint);
+
+        trace_out(event, sizeof(*event));
+    }
+
+    /* hand the slots back to the thread */
+    __atomic_store_n(&buffer->tail, tail, __ATOMIC_RELEASE);
+
+    dropped = __atomic_load_n(&buffer->dropped, __ATOMIC_RELAXED);
+    if (dropped != buffer->dropped_reported) {
+        struct {
+            struct hybris_trace_record_header header;
+            uint32_t tid;
+            uint32_t count;
+        } record = {
+            { HYBRIS_TRACE_RECORD_DROPPED, sizeof(record) },
+            buffer->tid, dropped - buffer->dropped_reported
+        };
+
+        trace_out(&record, sizeof(record));
+        buffer->dropped_reported = dropped;
+    }
+}
+
+static void trace_drain()
+{
+    struct trace_buffer *buffer;
+
+    pthread_mutex_lock(&drain_mutex);
+
+    for (buffer = __atomic_load_n(&trace_buffers, __ATOMIC_ACQUIRE); buffer; buffer = buffer->next)
+        trace_drain_buffer(buffer);
+
+    trace_flush_out();
+
+    pthread_mutex_unlock(&drain_mutex);
+}
+
+static void *trace_drainer(void *arg)
+{
+    unsigned int generation = (uintptr_t) arg;
+    struct timespec interval = { 0, TRACE_DRAIN_INTERVAL_NS };
+
+    while (generation == __atomic_load_n(&trace_generation, __ATOMIC_RELAXED)) {
+        nanosleep(&interval, NULL);
+        trace_drain();
+    }
+
+    return NULL;
+}
+
+static void trace_atexit()
+{
+    trace_drain();
+}
+
+static void trace_thread_exit(void *data)
+{
+    struct trace_buffer *buffer = data;
+
+    __atomic_store_n(&buffer->in_use, 0, __ATOMIC_RELEASE);
+}
+
+static void trace_atfork_child()
+{
+    /* the drainer is gone, start over with a file of our own on the
+     * next event. The buffers of the parent are leaked */
+    pthread_mutex_init(&trace_mutex, NULL);
+    pthread_mutex_init(&drain_mutex, NULL);
+
+    if (trace_fd >= 0)
+        close(trace_fd);
+    trace_fd = -1;
+    trace_buffers = NULL;
+    trace_started = 0;
+    drain_out_len = 0;
+    written_tracepoints_count = 0;
+    if (written_tracepoints)
+        memset(written_tracepoints, 0, written_tracepoints_size * sizeof(uint64_t));
+    __atomic_add_fetch(&trace_generation, 1, __ATOMIC_RELAXED);
+}
+
+static void trace_key_init()
+{
+    pthread_key_create(&trace_key, trace_thread_exit);
+    pthread_atfork(NULL, NULL, trace_atfork_child);
+    atexit(trace_atexit);
+}
+
+/* Opens the trace file and starts the drainer, with trace_mutex held */
+static int trace_start()
+{
+    struct hybris_trace_file_header header;
+    pthread_attr_t attr;
+    pthread_t drainer;
+    char path[4096];
+
+    if (trace_started)
+        return trace_fd >= 0 ? 0 : -1;
+
+    trace_started = 1;
+
+    snprintf(path, sizeof(path), "%s.%d", trace_path, (int) getpid());
+    trace_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (trace_fd < 0) {
+        fprintf(stderr, "libhybris: can't open trace file %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, HYBRIS_TRACE_MAGIC, sizeof(header.magic));
+    header.pid = getpid();
+    header.word_size = sizeof(void *);
+    if (write(trace_fd, &header, sizeof(header)) != sizeof(header)) {
+        close(trace_fd);
+        trace_fd = -1;
+        return -1;
+    }
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    pthread_create(&drainer, &attr, trace_drainer, (void *) (uintptr_t) trace_generation);
+    pthread_attr_destroy(&attr);
+
+    return 0;
+}
+
+/* Slow path of hybris_trace_record: sets up the buffer of the thread */
+static struct trace_buffer *trace_register()
+{
+    struct trace_buffer *buffer;
+
+    pthread_once(&trace_key_once, trace_key_init);
+    pthread_mutex_lock(&trace_mutex);
+
+    if (trace_start() < 0) {
+        pthread_mutex_unlock(&trace_mutex);
+        return NULL;
+    }
+
+    /* reuse the drained buffer of a thread which exited */
+    for (buffer = trace_buffers; buffer; buffer = buffer->next) {
+        if (!__atomic_load_n(&buffer->in_use, __ATOMIC_ACQUIRE) &&
+            buffer->head == __atomic_load_n(&buffer->tail, __ATOMIC_ACQUIRE))
+            break;
+    }
+
+    if (!buffer) {
+        buffer = calloc(1, sizeof(*buffer));
+        if (!buffer) {
+            pthread_mutex_unlock(&trace_mutex);
+            return NULL;
+        }
+        buffer->next = trace_buffers;
+        __atomic_store_n(&trace_buffers, buffer, __ATOMIC_RELEASE);
+    }
+
+    buffer->tid = syscall(SYS_gettid);
+    __atomic_store_n(&buffer->in_use, 1, __ATOMIC_RELEASE);
+
+    pthread_mutex_unlock(&trace_mutex);
+
+    pthread_setspecific(trace_key, buffer);
+    thread_buffer = buffer;
+    thread_buffer_generation = trace_generation;
+
+    return buffer;
+}
+
+void hybris_trace_record(const struct hybris_tracepoint *tracepoint,
+                         const uint64_t *args, unsigned int nargs)
+{
+    struct trace_buffer *buffer = thread_buffer;
+    struct hybris_trace_event *event;
+    struct timespec now;
+    uint32_t head;
+
+    if (!buffer || thread_buffer_generation != __atomic_load_n(&trace_generation, __ATOMIC_RELAXED)) {
+        buffer = trace_register();
+        if (!buffer)
+            return;
+    }
+
+    head = buffer->head;
+    if (head - __atomic_load_n(&buffer->tail, __ATOMIC_ACQUIRE) >= TRACE_BUFFER_EVENTS) {
+        __atomic_store_n(&buffer->dropped, buffer->dropped + 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    if (nargs > HYBRIS_TRACE_MAX_ARGS)
+        nargs = HYBRIS_TRACE_MAX_ARGS;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    event = &buffer->events[head & (TRACE_BUFFER_EVENTS - 1)];
+    event->header.type = HYBRIS_TRACE_RECORD_EVENT;
+    event->header.size = sizeof(*event);
+    event->timestamp = (uint64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+    event->tracepoint = (uintptr_t) tracepoint;
+    event->tid = buffer->tid;
+    event->nargs = nargs;
+    memcpy(event->args, args, nargs * sizeof(uint64_t));
+
+    /* publish the event to the drainer */
+    __atomic_store_n(&buffer->head, head + 1, __ATOMIC_RELEASE);
+}
+
+int hybris_trace_binary()
+{
+    return trace_enabled;
+}
+
+void hybris_trace_init(const char *path)
+{
+    trace_path = strdup(path);
+    trace_enabled = trace_path != NULL;
+}
+
+// vim: noai:ts=4:sw=4:ss=4:expandtab
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef HYBRIS_TRACE_H
+#define HYBRIS_TRACE_H
+
+/*
+ * Binary tracing backend, used by the HYBRIS_TRACE_* macros in logging.h
+ * when HYBRIS_TRACE=1 and HYBRIS_TRACE_FILE is set.
+ *
+ * Every tracepoint has a static descriptor, so its strings are interned
+ * at compile time and an event only records the address of the
+ * descriptor, the time, the thread and the raw arguments. Events go to a
+ * ring buffer of the thread which records them, without any locking or
+ * formatting, and a background thread drains the buffers to
+ * $HYBRIS_TRACE_FILE.<pid>. hybris-trace2json converts such a file to
+ * the Chrome trace event format, which Perfetto reads as well.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maximum number of arguments of an event, the rest is dropped */
+#define HYBRIS_TRACE_MAX_ARGS 4
+
+struct hybris_tracepoint {
+    const char *module;
+    const char *name;
+    /* printf format of the arguments, applied by the converter */
+    const char *format;
+    /* 'B'egin, 'E'nd or 'C'ounter */
+    char what;
+};
+
+/* Records an event, only called by the HYBRIS_TRACE_* macros */
+void hybris_trace_record(const struct hybris_tracepoint *tracepoint,
+                         const uint64_t *args, unsigned int nargs);
+
+/* Returns nonzero if events go to the binary backend */
+int hybris_trace_binary();
+
+/* Enables the binary backend, called while setting up logging */
+void hybris_trace_init(const char *path);
+
+/*
+ * File format: a struct hybris_trace_file_header, followed by records
+ * which start with a struct hybris_trace_record_header. All values are
+ * in the byte order of the traced process.
+ */
+#define HYBRIS_TRACE_MAGIC "HYBRTRC1"
+
+struct hybris_trace_file_header {
+    char magic[8];
+    uint32_t pid;
+    /* sizeof(void *) of the traced process, 0 in older traces */
+    uint32_t word_size;
+};
+
+enum hybris_trace_record_type {
+    /* struct hybris_trace_record_header, then the id of the tracepoint
+     * as uint64_t, the what character and the module, name and format
+     * as NUL terminated strings, padded to a multiple of 8 bytes */
+    HYBRIS_TRACE_RECORD_TRACEPOINT = 1,
+    /* struct hybris_trace_event */
+    HYBRIS_TRACE_RECORD_EVENT = 2,
+    /* struct hybris_trace_record_header, then the tid and the number of
+     * events the thread could not record because its buffer was full,
+     * as uint32_t */
+    HYBRIS_TRACE_RECORD_DROPPED = 3,
+};
+
+struct hybris_trace_record_header {
+    uint32_t type;
+    /* size of the whole record in bytes */
+    uint32_t size;
+};
+
+struct hybris_trace_event {
+    struct hybris_trace_record_header header;
+    /* CLOCK_MONOTONIC, in nanoseconds */
+    uint64_t timestamp;
+    uint64_t tracepoint;
+    uint32_t tid;
+    uint32_t nargs;
+    uint64_t args[HYBRIS_TRACE_MAX_ARGS];
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HYBRIS_TRACE_H */
+// vim: noai:ts=4:sw=4:ss=4:expandtab
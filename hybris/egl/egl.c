@@ -24,11 +24,13 @@
 #include <GLES2/gl2.h>
 #include <GLES2/gl2ext.h>
 #include <dlfcn.h>
+#include <link.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <malloc.h>
 #include "ws.h"
 #include "helper.h"
+#include "proc_cache.h"
 #include <assert.h>
 
 
@@ -42,6 +44,7 @@ static void *egl_handle = NULL;
 static void *glesv2_handle = NULL;
 static void *_hybris_libgles1 = NULL;
 static void *_hybris_libgles2 = NULL;
+static void *_hybris_libgles3 = NULL;
 static int _egl_context_client_version = 1;
 
 static EGLint  (*_eglGetError)(void) = NULL;
@@ -119,6 +122,135 @@ static void (*_glEGLImageTargetTexture2DOES) (GLenum target, GLeglImageOES image
 
 static __eglMustCastToProperFunctionPointerType (*_eglGetProcAddress)(const char *procname) = NULL;
 
+/* The wrapper libraries which want to know about contexts, see _gles_library() */
+static struct gles_library {
+	const char *env;
+	const char *name;
+	const char *prefix;
+	int resolved;
+	/* objects loaded by the process when it was last looked up in vain */
+	unsigned long long missed_adds;
+	void (*make_current)(void *context);
+	void (*destroy_context)(void *context);
+	void (*terminate)(void);
+	void (*swap_buffers)(void);
+} _hybris_gles_libraries[] = {
+	{ "HYBRIS_LIBGLESV2", "libGLESv2.so.2", "hybris_glesv2_" },
+	{ "HYBRIS_LIBGLESV3", "libGLESv3.so.3", "hybris_glesv3_" },
+};
+
+#define GLES_LIBRARIES (sizeof(_hybris_gles_libraries) / sizeof(_hybris_gles_libraries[0]))
+
+/* Stores the number of objects the process loaded so far, 0 if unknown */
+static int _dl_adds_callback(struct dl_phdr_info *info, size_t size, void *data)
+{
+	unsigned long long *adds = data;
+
+	if (size >= offsetof(struct dl_phdr_info, dlpi_adds) + sizeof(info->dlpi_adds))
+		*adds = info->dlpi_adds;
+	/* the counters are the same for all objects */
+	return 1;
+}
+
+/*
+ * libGLESv2 and libGLESv3 load the vendor library when a context is
+ * first made current (see hybris_glesv2_make_current), and libGLESv2
+ * may shadow the state of the contexts (see glesv2/glesv2_filter.h).
+ * They are only looked up, not loaded: processes which don't use them
+ * shouldn't load them for nothing. Only making a context current looks
+ * them up (resolve), the other notifications go to the libraries found
+ * by then. Returns NULL if library i isn't there (yet).
+ *
+ * Toolkits make a context current every frame, so a library which isn't
+ * there is only looked up again once the process loaded more objects.
+ */
+static struct gles_library *_gles_library(size_t i, int resolve)
+{
+	struct gles_library *library = &_hybris_gles_libraries[i];
+	unsigned long long adds = 0;
+	char symbol[64];
+	void *handle;
+
+	if (__atomic_load_n(&library->resolved, __ATOMIC_ACQUIRE))
+		return library;
+	if (!resolve)
+		return NULL;
+
+	/* 0 if the count isn't known, then look it up every time */
+	dl_iterate_phdr(_dl_adds_callback, &adds);
+	if (adds != 0 && __atomic_load_n(&library->missed_adds, __ATOMIC_RELAXED) == adds)
+		return NULL;
+
+	handle = dlopen(getenv(library->env) ?: library->name, RTLD_LAZY | RTLD_NOLOAD);
+	if (handle == NULL) {
+		__atomic_store_n(&library->missed_adds, adds, __ATOMIC_RELAXED);
+		return NULL;
+	}
+
+	snprintf(symbol, sizeof(symbol), "%smake_current", library->prefix);
+	library->make_current = dlsym(handle, symbol);
+	if (library->make_current == NULL) {
+		/* not ours */
+		dlclose(handle);
+		__atomic_store_n(&library->missed_adds, adds, __ATOMIC_RELAXED);
+		return NULL;
+	}
+	snprintf(symbol, sizeof(symbol), "%sdestroy_context", library->prefix);
+	library->destroy_context = dlsym(handle, symbol);
+	snprintf(symbol, sizeof(symbol), "%sterminate", library->prefix);
+	library->terminate = dlsym(handle, symbol);
+	snprintf(symbol, sizeof(symbol), "%sswap_buffers", library->prefix);
+	library->swap_buffers = dlsym(handle, symbol);
+
+	/* the handle keeps it loaded */
+	__atomic_store_n(&library->resolved, 1, __ATOMIC_RELEASE);
+	return library;
+}
+
+static void _notify_gles_make_current(EGLContext ctx)
+{
+	struct gles_library *library;
+	size_t i;
+
+	for (i = 0; i < GLES_LIBRARIES; i++) {
+		if ((library = _gles_library(i, 1)))
+			library->make_current(ctx);
+	}
+}
+
+static void _notify_gles_destroy_context(EGLContext ctx)
+{
+	struct gles_library *library;
+	size_t i;
+
+	for (i = 0; i < GLES_LIBRARIES; i++) {
+		if ((library = _gles_library(i, 0)) && library->destroy_context)
+			library->destroy_context(ctx);
+	}
+}
+
+static void _notify_gles_terminate()
+{
+	struct gles_library *library;
+	size_t i;
+
+	for (i = 0; i < GLES_LIBRARIES; i++) {
+		if ((library = _gles_library(i, 0)) && library->terminate)
+			library->terminate();
+	}
+}
+
+static void _notify_gles_swap_buffers()
+{
+	struct gles_library *library;
+	size_t i;
+
+	for (i = 0; i < GLES_LIBRARIES; i++) {
+		if ((library = _gles_library(i, 0)) && library->swap_buffers)
+			library->swap_buffers();
+	}
+}
+
 static void _init_androidegl()
 {
 	egl_handle = (void *) android_dlopen(getenv("LIBEGL") ? getenv("LIBEGL") : "libEGL.so", RTLD_LAZY);
@@ -217,7 +349,12 @@ EGLBoolean eglTerminate(EGLDisplay dpy)
 
 	struct _EGLDisplay *display = hybris_egl_display_get_mapping(dpy);
 	ws_Terminate(display);
-	return (*_eglTerminate)(dpy);
+	EGLBoolean ret = (*_eglTerminate)(dpy);
+
+	if (ret == EGL_TRUE)
+		_notify_gles_terminate();
+
+	return ret;
 }
 
 const char * eglQueryString(EGLDisplay dpy, EGLint name)
@@ -277,7 +414,18 @@ HYBRIS_IMPLEMENT_FUNCTION4(egl, EGLBoolean, eglQuerySurface, EGLDisplay, EGLSurf
 HYBRIS_IMPLEMENT_FUNCTION1(egl, EGLBoolean, eglBindAPI, EGLenum);
 HYBRIS_IMPLEMENT_FUNCTION0(egl, EGLenum, eglQueryAPI);
 HYBRIS_IMPLEMENT_FUNCTION0(egl, EGLBoolean, eglWaitClient);
-HYBRIS_IMPLEMENT_FUNCTION0(egl, EGLBoolean, eglReleaseThread);
+
+EGLBoolean eglReleaseThread(void)
+{
+	HYBRIS_DLSYSM(egl, &_eglReleaseThread, "eglReleaseThread");
+	EGLBoolean ret = (*_eglReleaseThread)();
+
+	if (ret == EGL_TRUE)
+		_notify_gles_make_current(EGL_NO_CONTEXT);
+
+	return ret;
+}
+
 HYBRIS_IMPLEMENT_FUNCTION5(egl, EGLSurface, eglCreatePbufferFromClientBuffer, EGLDisplay, EGLenum, EGLClientBuffer, EGLConfig, const EGLint *);
 HYBRIS_IMPLEMENT_FUNCTION4(egl, EGLBoolean, eglSurfaceAttrib, EGLDisplay, EGLSurface, EGLint, EGLint);
 HYBRIS_IMPLEMENT_FUNCTION3(egl, EGLBoolean, eglBindTexImage, EGLDisplay, EGLSurface, EGLint);
@@ -323,8 +471,28 @@ EGLContext eglCreateContext(EGLDisplay dpy, EGLConfig config,
 	return (*_eglCreateContext)(dpy, config, share_context, attrib_list);
 }
 
-HYBRIS_IMPLEMENT_FUNCTION2(egl, EGLBoolean, eglDestroyContext, EGLDisplay, EGLContext);
-HYBRIS_IMPLEMENT_FUNCTION4(egl, EGLBoolean, eglMakeCurrent, EGLDisplay, EGLSurface, EGLSurface, EGLContext);
+EGLBoolean eglDestroyContext(EGLDisplay dpy, EGLContext ctx)
+{
+	HYBRIS_DLSYSM(egl, &_eglDestroyContext, "eglDestroyContext");
+	EGLBoolean ret = (*_eglDestroyContext)(dpy, ctx);
+
+	if (ret == EGL_TRUE)
+		_notify_gles_destroy_context(ctx);
+
+	return ret;
+}
+
+EGLBoolean eglMakeCurrent(EGLDisplay dpy, EGLSurface draw, EGLSurface read, EGLContext ctx)
+{
+	HYBRIS_DLSYSM(egl, &_eglMakeCurrent, "eglMakeCurrent");
+	EGLBoolean ret = (*_eglMakeCurrent)(dpy, draw, read, ctx);
+
+	if (ret == EGL_TRUE)
+		_notify_gles_make_current(ctx);
+
+	return ret;
+}
+
 HYBRIS_IMPLEMENT_FUNCTION0(egl, EGLContext, eglGetCurrentContext);
 HYBRIS_IMPLEMENT_FUNCTION1(egl, EGLSurface, eglGetCurrentSurface, EGLint);
 HYBRIS_IMPLEMENT_FUNCTION0(egl, EGLDisplay, eglGetCurrentDisplay);
@@ -347,6 +515,8 @@ EGLBoolean _my_eglSwapBuffersWithDamageEXT(EGLDisplay dpy, EGLSurface surface, E
 	} else {
 		ret = (*_eglSwapBuffers)(dpy, surface);
 	}
+	if (ret == EGL_TRUE)
+		_notify_gles_swap_buffers();
 	HYBRIS_TRACE_END("hybris-egl", "eglSwapBuffersWithDamageEXT", "");
 	return ret;
 }
@@ -395,7 +565,12 @@ static void _my_glEGLImageTargetTexture2DOES(GLenum target, GLeglImageOES image)
 	(*_glEGLImageTargetTexture2DOES)(target, img ? img->egl_image : NULL);
 }
 
-__eglMustCastToProperFunctionPointerType eglGetProcAddress(const char *procname)
+/*
+ * Resolves procname for contexts of the given client version: our own
+ * replacements first, then the wrapper library of the version, the
+ * window system and the driver.
+ */
+static __eglMustCastToProperFunctionPointerType _egl_resolve_proc_address(const char *procname, int version)
 {
 	HYBRIS_DLSYSM(egl, &_eglGetProcAddress, "eglGetProcAddress");
 	if (strcmp(procname, "eglCreateImageKHR") == 0)
@@ -417,7 +592,7 @@ __eglMustCastToProperFunctionPointerType eglGetProcAddress(const char *procname)
 
 	__eglMustCastToProperFunctionPointerType ret = NULL;
 
-	switch (_egl_context_client_version) {
+	switch (version) {
 		case 1:  // OpenGL ES 1.x API
 			if (_hybris_libgles1 == NULL) {
 				_hybris_libgles1 = (void *) dlopen(getenv("HYBRIS_LIBGLESV1") ?: "libGLESv1_CM.so.1", RTLD_LAZY);
@@ -431,10 +606,13 @@ __eglMustCastToProperFunctionPointerType eglGetProcAddress(const char *procname)
 			ret = _hybris_libgles2 ? dlsym(_hybris_libgles2, procname) : NULL;
 			break;
 		case 3:  // OpenGL ES 3.x API
-			// TODO: Load from libGLESv3.so once we have OpenGL ES 3.0/3.1 support
+			if (_hybris_libgles3 == NULL) {
+				_hybris_libgles3 = (void *) dlopen(getenv("HYBRIS_LIBGLESV3") ?: "libGLESv3.so.3", RTLD_LAZY);
+			}
+			ret = _hybris_libgles3 ? dlsym(_hybris_libgles3, procname) : NULL;
 			break;
 		default:
-			HYBRIS_WARN("Unknown EGL context client version: %d", _egl_context_client_version);
+			HYBRIS_WARN("Unknown EGL context client version: %d", version);
 			break;
 	}
 
@@ -449,6 +627,26 @@ __eglMustCastToProperFunctionPointerType eglGetProcAddress(const char *procname)
 	return ret;
 }
 
+/*
+ * Engines look up hundreds of functions at startup, some every frame, so
+ * the resolved addresses are cached (see proc_cache.h). Names which don't
+ * resolve aren't: the window system or driver may know them later.
+ */
+__eglMustCastToProperFunctionPointerType eglGetProcAddress(const char *procname)
+{
+	int version = _egl_context_client_version;
+	__eglMustCastToProperFunctionPointerType ret;
+
+	ret = (__eglMustCastToProperFunctionPointerType) egl_proc_cache_lookup(procname, version);
+	if (ret == NULL) {
+		ret = _egl_resolve_proc_address(procname, version);
+		if (ret != NULL)
+			egl_proc_cache_insert(procname, version, (void *) ret);
+	}
+
+	return ret;
+}
+
 EGLBoolean eglDestroyImageKHR(EGLDisplay dpy, EGLImageKHR image)
 {
 	HYBRIS_DLSYSM(egl, &_eglDestroyImageKHR, "eglDestroyImageKHR");
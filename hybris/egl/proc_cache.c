@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "proc_cache.h"
+
+#define PROC_CACHE_MIN_SIZE 256
+
+/* An entry never changes once it's in a table */
+struct proc_entry {
+	uint32_t hash;
+	int version;
+	void *address;
+	char name[];
+};
+
+/* Open addressing with linear probing, at most half full so that a miss
+ * ends at an empty slot soon */
+struct proc_table {
+	size_t mask;
+	size_t used;
+	struct proc_entry *slots[];
+};
+
+/*
+ * Readers load the table and its slots with acquire, writers fill in an
+ * entry or table before they store it with release. A table which was
+ * outgrown isn't freed, readers may still be looking at it: they add up
+ * to less than the current table.
+ */
+static struct proc_table *_proc_table = NULL;
+static pthread_mutex_t _proc_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* FNV-1a of the name, then the version */
+static uint32_t proc_hash(const char *name, int version)
+{
+	uint32_t hash = 2166136261u;
+
+	while (*name) {
+		hash ^= (unsigned char) *name++;
+		hash *= 16777619u;
+	}
+	hash ^= (uint32_t) version;
+	hash *= 16777619u;
+
+	return hash;
+}
+
+static struct proc_entry *proc_find(struct proc_table *table, const char *name, int version, uint32_t hash)
+{
+	size_t i;
+
+	for (i = hash & table->mask; ; i = (i + 1) & table->mask) {
+		struct proc_entry *entry = __atomic_load_n(&table->slots[i], __ATOMIC_ACQUIRE);
+
+		if (entry == NULL)
+			return NULL;
+		if (entry->hash == hash && entry->version == version && strcmp(entry->name, name) == 0)
+			return entry;
+	}
+}
+
+static void proc_put(struct proc_table *table, struct proc_entry *entry)
+{
+	size_t i;
+
+	for (i = entry->hash & table->mask; table->slots[i]; i = (i + 1) & table->mask)
+		;
+	__atomic_store_n(&table->slots[i], entry, __ATOMIC_RELEASE);
+	table->used++;
+}
+
+/* Called with _proc_mutex held, returns NULL if out of memory */
+static struct proc_table *proc_grow(struct proc_table *table)
+{
+	size_t size = table ? (table->mask + 1) * 2 : PROC_CACHE_MIN_SIZE;
+	struct proc_table *grown;
+	size_t i;
+
+	grown = calloc(1, sizeof(*grown) + size * sizeof(grown->slots[0]));
+	if (grown == NULL)
+		return NULL;
+	grown->mask = size - 1;
+
+	for (i = 0; table && i <= table->mask; i++) {
+		if (table->slots[i])
+			proc_put(grown, table->slots[i]);
+	}
+
+	__atomic_store_n(&_proc_table, grown, __ATOMIC_RELEASE);
+	return grown;
+}
+
+void *egl_proc_cache_lookup(const char *procname, int version)
+{
+	struct proc_table *table = __atomic_load_n(&_proc_table, __ATOMIC_ACQUIRE);
+	struct proc_entry *entry;
+
+	if (table == NULL)
+		return NULL;
+
+	entry = proc_find(table, procname, version, proc_hash(procname, version));
+	return entry ? entry->address : NULL;
+}
+
+void egl_proc_cache_insert(const char *procname, int version, void *address)
+{
+	uint32_t hash = proc_hash(procname, version);
+	size_t length = strlen(procname);
+	struct proc_table *table;
+	struct proc_entry *entry;
+
+	pthread_mutex_lock(&_proc_mutex);
+
+	table = _proc_table;
+	/* another thread may have resolved it as well */
+	if (table && proc_find(table, procname, version, hash))
+		goto out;
+
+	if (table == NULL || (table->used + 1) * 2 > table->mask + 1) {
+		table = proc_grow(table);
+		if (table == NULL)
+			goto out;
+	}
+
+	entry = malloc(sizeof(*entry) + length + 1);
+	if (entry == NULL)
+		goto out;
+	entry->hash = hash;
+	entry->version = version;
+	entry->address = address;
+	memcpy(entry->name, procname, length + 1);
+	proc_put(table, entry);
+
+out:
+	pthread_mutex_unlock(&_proc_mutex);
+}
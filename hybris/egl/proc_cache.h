@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef EGL_PROC_CACHE_H
+#define EGL_PROC_CACHE_H
+
+/*
+ * Cache of the addresses eglGetProcAddress resolved, keyed by the name
+ * and the client API version it was resolved for: the same name can
+ * resolve differently for OpenGL ES 1 and 2 contexts.
+ *
+ * The cache is a hash table which readers look up without taking a
+ * lock, any number of threads at once. Insertions are serialized.
+ */
+
+/* Returns the address of procname for version, or NULL if it's not cached */
+void *egl_proc_cache_lookup(const char *procname, int version);
+
+/* Caches the address of procname for version, unless it's there already */
+void egl_proc_cache_insert(const char *procname, int version, void *address);
+
+#endif /* EGL_PROC_CACHE_H */
@@ -0,0 +1,275 @@
+/* Generated by utils/generate_gl_dispatch/generate_dispatch.py from glesv1_cm_symbols, do not edit */
+
+HYBRIS_GL_FUNCTION(glAlphaFunc, void, (GLenum func, GLclampf ref), (func, ref), , 1)
+HYBRIS_GL_FUNCTION(glClearColor, void, (GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha), (red, green, blue, alpha), , 1)
+HYBRIS_GL_FUNCTION(glClearDepthf, void, (GLclampf depth), (depth), , 1)
+HYBRIS_GL_FUNCTION(glClipPlanef, void, (GLenum plane, const GLfloat *equation), (plane, equation), , 0)
+HYBRIS_GL_FUNCTION(glColor4f, void, (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha), (red, green, blue, alpha), , 1)
+HYBRIS_GL_FUNCTION(glDepthRangef, void, (GLclampf zNear, GLclampf zFar), (zNear, zFar), , 1)
+HYBRIS_GL_FUNCTION(glFogf, void, (GLenum pname, GLfloat param), (pname, param), , 1)
+HYBRIS_GL_FUNCTION(glFogfv, void, (GLenum pname, const GLfloat *params), (pname, params), , 0)
+HYBRIS_GL_FUNCTION(glFrustumf, void, (GLfloat left, GLfloat right, GLfloat bottom, GLfloat top, GLfloat zNear, GLfloat zFar), (left, right, bottom, top, zNear, zFar), , 1)
+HYBRIS_GL_FUNCTION(glGetClipPlanef, void, (GLenum pname, GLfloat eqn[4]), (pname, eqn), , 0)
+HYBRIS_GL_FUNCTION(glGetFloatv, void, (GLenum pname, GLfloat *params), (pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetLightfv, void, (GLenum light, GLenum pname, GLfloat *params), (light, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetMaterialfv, void, (GLenum face, GLenum pname, GLfloat *params), (face, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetTexEnvfv, void, (GLenum env, GLenum pname, GLfloat *params), (env, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetTexParameterfv, void, (GLenum target, GLenum pname, GLfloat *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glLightModelf, void, (GLenum pname, GLfloat param), (pname, param), , 1)
+HYBRIS_GL_FUNCTION(glLightModelfv, void, (GLenum pname, const GLfloat *params), (pname, params), , 0)
+HYBRIS_GL_FUNCTION(glLightf, void, (GLenum light, GLenum pname, GLfloat param), (light, pname, param), , 1)
+HYBRIS_GL_FUNCTION(glLightfv, void, (GLenum light, GLenum pname, const GLfloat *params), (light, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glLineWidth, void, (GLfloat width), (width), , 1)
+HYBRIS_GL_FUNCTION(glLoadMatrixf, void, (const GLfloat *m), (m), , 0)
+HYBRIS_GL_FUNCTION(glMaterialf, void, (GLenum face, GLenum pname, GLfloat param), (face, pname, param), , 1)
+HYBRIS_GL_FUNCTION(glMaterialfv, void, (GLenum face, GLenum pname, const GLfloat *params), (face, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glMultMatrixf, void, (const GLfloat *m), (m), , 0)
+HYBRIS_GL_FUNCTION(glMultiTexCoord4f, void, (GLenum target, GLfloat s, GLfloat t, GLfloat r, GLfloat q), (target, s, t, r, q), , 1)
+HYBRIS_GL_FUNCTION(glNormal3f, void, (GLfloat nx, GLfloat ny, GLfloat nz), (nx, ny, nz), , 1)
+HYBRIS_GL_FUNCTION(glOrthof, void, (GLfloat left, GLfloat right, GLfloat bottom, GLfloat top, GLfloat zNear, GLfloat zFar), (left, right, bottom, top, zNear, zFar), , 1)
+HYBRIS_GL_FUNCTION(glPointParameterf, void, (GLenum pname, GLfloat param), (pname, param), , 1)
+HYBRIS_GL_FUNCTION(glPointParameterfv, void, (GLenum pname, const GLfloat *params), (pname, params), , 0)
+HYBRIS_GL_FUNCTION(glPointSize, void, (GLfloat size), (size), , 1)
+HYBRIS_GL_FUNCTION(glPolygonOffset, void, (GLfloat factor, GLfloat units), (factor, units), , 1)
+HYBRIS_GL_FUNCTION(glRotatef, void, (GLfloat angle, GLfloat x, GLfloat y, GLfloat z), (angle, x, y, z), , 1)
+HYBRIS_GL_FUNCTION(glScalef, void, (GLfloat x, GLfloat y, GLfloat z), (x, y, z), , 1)
+HYBRIS_GL_FUNCTION(glTexEnvf, void, (GLenum target, GLenum pname, GLfloat param), (target, pname, param), , 1)
+HYBRIS_GL_FUNCTION(glTexEnvfv, void, (GLenum target, GLenum pname, const GLfloat *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glTexParameterf, void, (GLenum target, GLenum pname, GLfloat param), (target, pname, param), , 1)
+HYBRIS_GL_FUNCTION(glTexParameterfv, void, (GLenum target, GLenum pname, const GLfloat *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glTranslatef, void, (GLfloat x, GLfloat y, GLfloat z), (x, y, z), , 1)
+HYBRIS_GL_FUNCTION(glActiveTexture, void, (GLenum texture), (texture), , 0)
+HYBRIS_GL_FUNCTION(glAlphaFuncx, void, (GLenum func, GLclampx ref), (func, ref), , 0)
+HYBRIS_GL_FUNCTION(glBindBuffer, void, (GLenum target, GLuint buffer), (target, buffer), , 0)
+HYBRIS_GL_FUNCTION(glBindTexture, void, (GLenum target, GLuint texture), (target, texture), , 0)
+HYBRIS_GL_FUNCTION(glBlendFunc, void, (GLenum sfactor, GLenum dfactor), (sfactor, dfactor), , 0)
+HYBRIS_GL_FUNCTION(glBufferData, void, (GLenum target, GLsizeiptr size, const GLvoid *data, GLenum usage), (target, size, data, usage), , 0)
+HYBRIS_GL_FUNCTION(glBufferSubData, void, (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid *data), (target, offset, size, data), , 0)
+HYBRIS_GL_FUNCTION(glClear, void, (GLbitfield mask), (mask), , 0)
+HYBRIS_GL_FUNCTION(glClearColorx, void, (GLclampx red, GLclampx green, GLclampx blue, GLclampx alpha), (red, green, blue, alpha), , 0)
+HYBRIS_GL_FUNCTION(glClearDepthx, void, (GLclampx depth), (depth), , 0)
+HYBRIS_GL_FUNCTION(glClearStencil, void, (GLint s), (s), , 0)
+HYBRIS_GL_FUNCTION(glClientActiveTexture, void, (GLenum texture), (texture), , 0)
+HYBRIS_GL_FUNCTION(glClipPlanex, void, (GLenum plane, const GLfixed *equation), (plane, equation), , 0)
+HYBRIS_GL_FUNCTION(glColor4ub, void, (GLubyte red, GLubyte green, GLubyte blue, GLubyte alpha), (red, green, blue, alpha), , 0)
+HYBRIS_GL_FUNCTION(glColor4x, void, (GLfixed red, GLfixed green, GLfixed blue, GLfixed alpha), (red, green, blue, alpha), , 0)
+HYBRIS_GL_FUNCTION(glColorMask, void, (GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha), (red, green, blue, alpha), , 0)
+HYBRIS_GL_FUNCTION(glColorPointer, void, (GLint size, GLenum type, GLsizei stride, const GLvoid *pointer), (size, type, stride, pointer), , 0)
+HYBRIS_GL_FUNCTION(glCompressedTexImage2D, void, (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const GLvoid *data), (target, level, internalformat, width, height, border, imageSize, data), , 0)
+HYBRIS_GL_FUNCTION(glCompressedTexSubImage2D, void, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const GLvoid *data), (target, level, xoffset, yoffset, width, height, format, imageSize, data), , 0)
+HYBRIS_GL_FUNCTION(glCopyTexImage2D, void, (GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border), (target, level, internalformat, x, y, width, height, border), , 0)
+HYBRIS_GL_FUNCTION(glCopyTexSubImage2D, void, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height), (target, level, xoffset, yoffset, x, y, width, height), , 0)
+HYBRIS_GL_FUNCTION(glCullFace, void, (GLenum mode), (mode), , 0)
+HYBRIS_GL_FUNCTION(glDeleteBuffers, void, (GLsizei n, const GLuint *buffers), (n, buffers), , 0)
+HYBRIS_GL_FUNCTION(glDeleteTextures, void, (GLsizei n, const GLuint *textures), (n, textures), , 0)
+HYBRIS_GL_FUNCTION(glDepthFunc, void, (GLenum func), (func), , 0)
+HYBRIS_GL_FUNCTION(glDepthMask, void, (GLboolean flag), (flag), , 0)
+HYBRIS_GL_FUNCTION(glDepthRangex, void, (GLclampx zNear, GLclampx zFar), (zNear, zFar), , 0)
+HYBRIS_GL_FUNCTION(glDisable, void, (GLenum cap), (cap), , 0)
+HYBRIS_GL_FUNCTION(glDisableClientState, void, (GLenum array), (array), , 0)
+HYBRIS_GL_FUNCTION(glDrawArrays, void, (GLenum mode, GLint first, GLsizei count), (mode, first, count), , 0)
+HYBRIS_GL_FUNCTION(glDrawElements, void, (GLenum mode, GLsizei count, GLenum type, const GLvoid *indices), (mode, count, type, indices), , 0)
+HYBRIS_GL_FUNCTION(glEnable, void, (GLenum cap), (cap), , 0)
+HYBRIS_GL_FUNCTION(glEnableClientState, void, (GLenum array), (array), , 0)
+HYBRIS_GL_FUNCTION(glFinish, void, (void), (), , 0)
+HYBRIS_GL_FUNCTION(glFlush, void, (void), (), , 0)
+HYBRIS_GL_FUNCTION(glFogx, void, (GLenum pname, GLfixed param), (pname, param), , 0)
+HYBRIS_GL_FUNCTION(glFogxv, void, (GLenum pname, const GLfixed *params), (pname, params), , 0)
+HYBRIS_GL_FUNCTION(glFrontFace, void, (GLenum mode), (mode), , 0)
+HYBRIS_GL_FUNCTION(glFrustumx, void, (GLfixed left, GLfixed right, GLfixed bottom, GLfixed top, GLfixed zNear, GLfixed zFar), (left, right, bottom, top, zNear, zFar), , 0)
+HYBRIS_GL_FUNCTION(glGetBooleanv, void, (GLenum pname, GLboolean *params), (pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetBufferParameteriv, void, (GLenum target, GLenum pname, GLint *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetClipPlanex, void, (GLenum pname, GLfixed eqn[4]), (pname, eqn), , 0)
+HYBRIS_GL_FUNCTION(glGenBuffers, void, (GLsizei n, GLuint *buffers), (n, buffers), , 0)
+HYBRIS_GL_FUNCTION(glGenTextures, void, (GLsizei n, GLuint *textures), (n, textures), , 0)
+HYBRIS_GL_FUNCTION(glGetError, GLenum, (void), (), return, 0)
+HYBRIS_GL_FUNCTION(glGetFixedv, void, (GLenum pname, GLfixed *params), (pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetIntegerv, void, (GLenum pname, GLint *params), (pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetLightxv, void, (GLenum light, GLenum pname, GLfixed *params), (light, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetMaterialxv, void, (GLenum face, GLenum pname, GLfixed *params), (face, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetPointerv, void, (GLenum pname, GLvoid **params), (pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetString, const GLubyte *, (GLenum name), (name), return, 0)
+HYBRIS_GL_FUNCTION(glGetTexEnviv, void, (GLenum env, GLenum pname, GLint *params), (env, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetTexEnvxv, void, (GLenum env, GLenum pname, GLfixed *params), (env, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetTexParameteriv, void, (GLenum target, GLenum pname, GLint *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetTexParameterxv, void, (GLenum target, GLenum pname, GLfixed *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glHint, void, (GLenum target, GLenum mode), (target, mode), , 0)
+HYBRIS_GL_FUNCTION(glIsBuffer, GLboolean, (GLuint buffer), (buffer), return, 0)
+HYBRIS_GL_FUNCTION(glIsEnabled, GLboolean, (GLenum cap), (cap), return, 0)
+HYBRIS_GL_FUNCTION(glIsTexture, GLboolean, (GLuint texture), (texture), return, 0)
+HYBRIS_GL_FUNCTION(glLightModelx, void, (GLenum pname, GLfixed param), (pname, param), , 0)
+HYBRIS_GL_FUNCTION(glLightModelxv, void, (GLenum pname, const GLfixed *params), (pname, params), , 0)
+HYBRIS_GL_FUNCTION(glLightx, void, (GLenum light, GLenum pname, GLfixed param), (light, pname, param), , 0)
+HYBRIS_GL_FUNCTION(glLightxv, void, (GLenum light, GLenum pname, const GLfixed *params), (light, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glLineWidthx, void, (GLfixed width), (width), , 0)
+HYBRIS_GL_FUNCTION(glLoadIdentity, void, (void), (), , 0)
+HYBRIS_GL_FUNCTION(glLoadMatrixx, void, (const GLfixed *m), (m), , 0)
+HYBRIS_GL_FUNCTION(glLogicOp, void, (GLenum opcode), (opcode), , 0)
+HYBRIS_GL_FUNCTION(glMaterialx, void, (GLenum face, GLenum pname, GLfixed param), (face, pname, param), , 0)
+HYBRIS_GL_FUNCTION(glMaterialxv, void, (GLenum face, GLenum pname, const GLfixed *params), (face, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glMatrixMode, void, (GLenum mode), (mode), , 0)
+HYBRIS_GL_FUNCTION(glMultMatrixx, void, (const GLfixed *m), (m), , 0)
+HYBRIS_GL_FUNCTION(glMultiTexCoord4x, void, (GLenum target, GLfixed s, GLfixed t, GLfixed r, GLfixed q), (target, s, t, r, q), , 0)
+HYBRIS_GL_FUNCTION(glNormal3x, void, (GLfixed nx, GLfixed ny, GLfixed nz), (nx, ny, nz), , 0)
+HYBRIS_GL_FUNCTION(glNormalPointer, void, (GLenum type, GLsizei stride, const GLvoid *pointer), (type, stride, pointer), , 0)
+HYBRIS_GL_FUNCTION(glOrthox, void, (GLfixed left, GLfixed right, GLfixed bottom, GLfixed top, GLfixed zNear, GLfixed zFar), (left, right, bottom, top, zNear, zFar), , 0)
+HYBRIS_GL_FUNCTION(glPixelStorei, void, (GLenum pname, GLint param), (pname, param), , 0)
+HYBRIS_GL_FUNCTION(glPointParameterx, void, (GLenum pname, GLfixed param), (pname, param), , 0)
+HYBRIS_GL_FUNCTION(glPointParameterxv, void, (GLenum pname, const GLfixed *params), (pname, params), , 0)
+HYBRIS_GL_FUNCTION(glPointSizex, void, (GLfixed size), (size), , 0)
+HYBRIS_GL_FUNCTION(glPolygonOffsetx, void, (GLfixed factor, GLfixed units), (factor, units), , 0)
+HYBRIS_GL_FUNCTION(glPopMatrix, void, (void), (), , 0)
+HYBRIS_GL_FUNCTION(glPushMatrix, void, (void), (), , 0)
+HYBRIS_GL_FUNCTION(glReadPixels, void, (GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid *pixels), (x, y, width, height, format, type, pixels), , 0)
+HYBRIS_GL_FUNCTION(glRotatex, void, (GLfixed angle, GLfixed x, GLfixed y, GLfixed z), (angle, x, y, z), , 0)
+HYBRIS_GL_FUNCTION(glSampleCoverage, void, (GLclampf value, GLboolean invert), (value, invert), , 1)
+HYBRIS_GL_FUNCTION(glSampleCoveragex, void, (GLclampx value, GLboolean invert), (value, invert), , 0)
+HYBRIS_GL_FUNCTION(glScalex, void, (GLfixed x, GLfixed y, GLfixed z), (x, y, z), , 0)
+HYBRIS_GL_FUNCTION(glScissor, void, (GLint x, GLint y, GLsizei width, GLsizei height), (x, y, width, height), , 0)
+HYBRIS_GL_FUNCTION(glShadeModel, void, (GLenum mode), (mode), , 0)
+HYBRIS_GL_FUNCTION(glStencilFunc, void, (GLenum func, GLint ref, GLuint mask), (func, ref, mask), , 0)
+HYBRIS_GL_FUNCTION(glStencilMask, void, (GLuint mask), (mask), , 0)
+HYBRIS_GL_FUNCTION(glStencilOp, void, (GLenum fail, GLenum zfail, GLenum zpass), (fail, zfail, zpass), , 0)
+HYBRIS_GL_FUNCTION(glTexCoordPointer, void, (GLint size, GLenum type, GLsizei stride, const GLvoid *pointer), (size, type, stride, pointer), , 0)
+HYBRIS_GL_FUNCTION(glTexEnvi, void, (GLenum target, GLenum pname, GLint param), (target, pname, param), , 0)
+HYBRIS_GL_FUNCTION(glTexEnvx, void, (GLenum target, GLenum pname, GLfixed param), (target, pname, param), , 0)
+HYBRIS_GL_FUNCTION(glTexEnviv, void, (GLenum target, GLenum pname, const GLint *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glTexEnvxv, void, (GLenum target, GLenum pname, const GLfixed *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glTexImage2D, void, (GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels), (target, level, internalformat, width, height, border, format, type, pixels), , 0)
+HYBRIS_GL_FUNCTION(glTexParameteri, void, (GLenum target, GLenum pname, GLint param), (target, pname, param), , 0)
+HYBRIS_GL_FUNCTION(glTexParameterx, void, (GLenum target, GLenum pname, GLfixed param), (target, pname, param), , 0)
+HYBRIS_GL_FUNCTION(glTexParameteriv, void, (GLenum target, GLenum pname, const GLint *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glTexParameterxv, void, (GLenum target, GLenum pname, const GLfixed *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glTexSubImage2D, void, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid *pixels), (target, level, xoffset, yoffset, width, height, format, type, pixels), , 0)
+HYBRIS_GL_FUNCTION(glTranslatex, void, (GLfixed x, GLfixed y, GLfixed z), (x, y, z), , 0)
+HYBRIS_GL_FUNCTION(glVertexPointer, void, (GLint size, GLenum type, GLsizei stride, const GLvoid *pointer), (size, type, stride, pointer), , 0)
+HYBRIS_GL_FUNCTION(glViewport, void, (GLint x, GLint y, GLsizei width, GLsizei height), (x, y, width, height), , 0)
+HYBRIS_GL_FUNCTION(glPointSizePointerOES, void, (GLenum type, GLsizei stride, const GLvoid *pointer), (type, stride, pointer), , 0)
+HYBRIS_GL_FUNCTION(glBlendEquationSeparateOES, void, (GLenum modeRGB, GLenum modeAlpha), (modeRGB, modeAlpha), , 0)
+HYBRIS_GL_FUNCTION(glBlendFuncSeparateOES, void, (GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha), (srcRGB, dstRGB, srcAlpha, dstAlpha), , 0)
+HYBRIS_GL_FUNCTION(glBlendEquationOES, void, (GLenum mode), (mode), , 0)
+HYBRIS_GL_FUNCTION(glDrawTexsOES, void, (GLshort x, GLshort y, GLshort z, GLshort width, GLshort height), (x, y, z, width, height), , 0)
+HYBRIS_GL_FUNCTION(glDrawTexiOES, void, (GLint x, GLint y, GLint z, GLint width, GLint height), (x, y, z, width, height), , 0)
+HYBRIS_GL_FUNCTION(glDrawTexxOES, void, (GLfixed x, GLfixed y, GLfixed z, GLfixed width, GLfixed height), (x, y, z, width, height), , 0)
+HYBRIS_GL_FUNCTION(glDrawTexsvOES, void, (const GLshort *coords), (coords), , 0)
+HYBRIS_GL_FUNCTION(glDrawTexivOES, void, (const GLint *coords), (coords), , 0)
+HYBRIS_GL_FUNCTION(glDrawTexxvOES, void, (const GLfixed *coords), (coords), , 0)
+HYBRIS_GL_FUNCTION(glDrawTexfOES, void, (GLfloat x, GLfloat y, GLfloat z, GLfloat width, GLfloat height), (x, y, z, width, height), , 1)
+HYBRIS_GL_FUNCTION(glDrawTexfvOES, void, (const GLfloat *coords), (coords), , 0)
+HYBRIS_GL_FUNCTION(glEGLImageTargetTexture2DOES, void, (GLenum target, GLeglImageOES image), (target, image), , 0)
+HYBRIS_GL_FUNCTION(glEGLImageTargetRenderbufferStorageOES, void, (GLenum target, GLeglImageOES image), (target, image), , 0)
+HYBRIS_GL_FUNCTION(glAlphaFuncxOES, void, (GLenum func, GLclampx ref), (func, ref), , 0)
+HYBRIS_GL_FUNCTION(glClearColorxOES, void, (GLclampx red, GLclampx green, GLclampx blue, GLclampx alpha), (red, green, blue, alpha), , 0)
+HYBRIS_GL_FUNCTION(glClearDepthxOES, void, (GLclampx depth), (depth), , 0)
+HYBRIS_GL_FUNCTION(glClipPlanexOES, void, (GLenum plane, const GLfixed *equation), (plane, equation), , 0)
+HYBRIS_GL_FUNCTION(glColor4xOES, void, (GLfixed red, GLfixed green, GLfixed blue, GLfixed alpha), (red, green, blue, alpha), , 0)
+HYBRIS_GL_FUNCTION(glDepthRangexOES, void, (GLclampx zNear, GLclampx zFar), (zNear, zFar), , 0)
+HYBRIS_GL_FUNCTION(glFogxOES, void, (GLenum pname, GLfixed param), (pname, param), , 0)
+HYBRIS_GL_FUNCTION(glFogxvOES, void, (GLenum pname, const GLfixed *params), (pname, params), , 0)
+HYBRIS_GL_FUNCTION(glFrustumxOES, void, (GLfixed left, GLfixed right, GLfixed bottom, GLfixed top, GLfixed zNear, GLfixed zFar), (left, right, bottom, top, zNear, zFar), , 0)
+HYBRIS_GL_FUNCTION(glGetClipPlanexOES, void, (GLenum pname, GLfixed eqn[4]), (pname, eqn), , 0)
+HYBRIS_GL_FUNCTION(glGetFixedvOES, void, (GLenum pname, GLfixed *params), (pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetLightxvOES, void, (GLenum light, GLenum pname, GLfixed *params), (light, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetMaterialxvOES, void, (GLenum face, GLenum pname, GLfixed *params), (face, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetTexEnvxvOES, void, (GLenum env, GLenum pname, GLfixed *params), (env, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetTexParameterxvOES, void, (GLenum target, GLenum pname, GLfixed *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glLightModelxOES, void, (GLenum pname, GLfixed param), (pname, param), , 0)
+HYBRIS_GL_FUNCTION(glLightModelxvOES, void, (GLenum pname, const GLfixed *params), (pname, params), , 0)
+HYBRIS_GL_FUNCTION(glLightxOES, void, (GLenum light, GLenum pname, GLfixed param), (light, pname, param), , 0)
+HYBRIS_GL_FUNCTION(glLightxvOES, void, (GLenum light, GLenum pname, const GLfixed *params), (light, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glLineWidthxOES, void, (GLfixed width), (width), , 0)
+HYBRIS_GL_FUNCTION(glLoadMatrixxOES, void, (const GLfixed *m), (m), , 0)
+HYBRIS_GL_FUNCTION(glMaterialxOES, void, (GLenum face, GLenum pname, GLfixed param), (face, pname, param), , 0)
+HYBRIS_GL_FUNCTION(glMaterialxvOES, void, (GLenum face, GLenum pname, const GLfixed *params), (face, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glMultMatrixxOES, void, (const GLfixed *m), (m), , 0)
+HYBRIS_GL_FUNCTION(glMultiTexCoord4xOES, void, (GLenum target, GLfixed s, GLfixed t, GLfixed r, GLfixed q), (target, s, t, r, q), , 0)
+HYBRIS_GL_FUNCTION(glNormal3xOES, void, (GLfixed nx, GLfixed ny, GLfixed nz), (nx, ny, nz), , 0)
+HYBRIS_GL_FUNCTION(glOrthoxOES, void, (GLfixed left, GLfixed right, GLfixed bottom, GLfixed top, GLfixed zNear, GLfixed zFar), (left, right, bottom, top, zNear, zFar), , 0)
+HYBRIS_GL_FUNCTION(glPointParameterxOES, void, (GLenum pname, GLfixed param), (pname, param), , 0)
+HYBRIS_GL_FUNCTION(glPointParameterxvOES, void, (GLenum pname, const GLfixed *params), (pname, params), , 0)
+HYBRIS_GL_FUNCTION(glPointSizexOES, void, (GLfixed size), (size), , 0)
+HYBRIS_GL_FUNCTION(glPolygonOffsetxOES, void, (GLfixed factor, GLfixed units), (factor, units), , 0)
+HYBRIS_GL_FUNCTION(glRotatexOES, void, (GLfixed angle, GLfixed x, GLfixed y, GLfixed z), (angle, x, y, z), , 0)
+HYBRIS_GL_FUNCTION(glSampleCoveragexOES, void, (GLclampx value, GLboolean invert), (value, invert), , 0)
+HYBRIS_GL_FUNCTION(glScalexOES, void, (GLfixed x, GLfixed y, GLfixed z), (x, y, z), , 0)
+HYBRIS_GL_FUNCTION(glTexEnvxOES, void, (GLenum target, GLenum pname, GLfixed param), (target, pname, param), , 0)
+HYBRIS_GL_FUNCTION(glTexEnvxvOES, void, (GLenum target, GLenum pname, const GLfixed *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glTexParameterxOES, void, (GLenum target, GLenum pname, GLfixed param), (target, pname, param), , 0)
+HYBRIS_GL_FUNCTION(glTexParameterxvOES, void, (GLenum target, GLenum pname, const GLfixed *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glTranslatexOES, void, (GLfixed x, GLfixed y, GLfixed z), (x, y, z), , 0)
+HYBRIS_GL_FUNCTION(glIsRenderbufferOES, GLboolean, (GLuint renderbuffer), (renderbuffer), return, 0)
+HYBRIS_GL_FUNCTION(glBindRenderbufferOES, void, (GLenum target, GLuint renderbuffer), (target, renderbuffer), , 0)
+HYBRIS_GL_FUNCTION(glDeleteRenderbuffersOES, void, (GLsizei n, const GLuint *renderbuffers), (n, renderbuffers), , 0)
+HYBRIS_GL_FUNCTION(glGenRenderbuffersOES, void, (GLsizei n, GLuint *renderbuffers), (n, renderbuffers), , 0)
+HYBRIS_GL_FUNCTION(glRenderbufferStorageOES, void, (GLenum target, GLenum internalformat, GLsizei width, GLsizei height), (target, internalformat, width, height), , 0)
+HYBRIS_GL_FUNCTION(glGetRenderbufferParameterivOES, void, (GLenum target, GLenum pname, GLint *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glIsFramebufferOES, GLboolean, (GLuint framebuffer), (framebuffer), return, 0)
+HYBRIS_GL_FUNCTION(glBindFramebufferOES, void, (GLenum target, GLuint framebuffer), (target, framebuffer), , 0)
+HYBRIS_GL_FUNCTION(glDeleteFramebuffersOES, void, (GLsizei n, const GLuint *framebuffers), (n, framebuffers), , 0)
+HYBRIS_GL_FUNCTION(glGenFramebuffersOES, void, (GLsizei n, GLuint *framebuffers), (n, framebuffers), , 0)
+HYBRIS_GL_FUNCTION(glCheckFramebufferStatusOES, GLenum, (GLenum target), (target), return, 0)
+HYBRIS_GL_FUNCTION(glFramebufferRenderbufferOES, void, (GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer), (target, attachment, renderbuffertarget, renderbuffer), , 0)
+HYBRIS_GL_FUNCTION(glFramebufferTexture2DOES, void, (GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level), (target, attachment, textarget, texture, level), , 0)
+HYBRIS_GL_FUNCTION(glGetFramebufferAttachmentParameterivOES, void, (GLenum target, GLenum attachment, GLenum pname, GLint *params), (target, attachment, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGenerateMipmapOES, void, (GLenum target), (target), , 0)
+HYBRIS_GL_FUNCTION(glMapBufferOES, void *, (GLenum target, GLenum access), (target, access), return, 0)
+HYBRIS_GL_FUNCTION(glUnmapBufferOES, GLboolean, (GLenum target), (target), return, 0)
+HYBRIS_GL_FUNCTION(glGetBufferPointervOES, void, (GLenum target, GLenum pname, GLvoid **params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glCurrentPaletteMatrixOES, void, (GLuint matrixpaletteindex), (matrixpaletteindex), , 0)
+HYBRIS_GL_FUNCTION(glLoadPaletteFromModelViewMatrixOES, void, (void), (), , 0)
+HYBRIS_GL_FUNCTION(glMatrixIndexPointerOES, void, (GLint size, GLenum type, GLsizei stride, const GLvoid *pointer), (size, type, stride, pointer), , 0)
+HYBRIS_GL_FUNCTION(glWeightPointerOES, void, (GLint size, GLenum type, GLsizei stride, const GLvoid *pointer), (size, type, stride, pointer), , 0)
+HYBRIS_GL_FUNCTION(glQueryMatrixxOES, GLbitfield, (GLfixed mantissa[16], GLint exponent[16]), (mantissa, exponent), return, 0)
+HYBRIS_GL_FUNCTION(glDepthRangefOES, void, (GLclampf zNear, GLclampf zFar), (zNear, zFar), , 1)
+HYBRIS_GL_FUNCTION(glFrustumfOES, void, (GLfloat left, GLfloat right, GLfloat bottom, GLfloat top, GLfloat zNear, GLfloat zFar), (left, right, bottom, top, zNear, zFar), , 1)
+HYBRIS_GL_FUNCTION(glOrthofOES, void, (GLfloat left, GLfloat right, GLfloat bottom, GLfloat top, GLfloat zNear, GLfloat zFar), (left, right, bottom, top, zNear, zFar), , 1)
+HYBRIS_GL_FUNCTION(glClipPlanefOES, void, (GLenum plane, const GLfloat *equation), (plane, equation), , 0)
+HYBRIS_GL_FUNCTION(glGetClipPlanefOES, void, (GLenum pname, GLfloat eqn[4]), (pname, eqn), , 0)
+HYBRIS_GL_FUNCTION(glClearDepthfOES, void, (GLclampf depth), (depth), , 1)
+HYBRIS_GL_FUNCTION(glTexGenfOES, void, (GLenum coord, GLenum pname, GLfloat param), (coord, pname, param), , 1)
+HYBRIS_GL_FUNCTION(glTexGenfvOES, void, (GLenum coord, GLenum pname, const GLfloat *params), (coord, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glTexGeniOES, void, (GLenum coord, GLenum pname, GLint param), (coord, pname, param), , 0)
+HYBRIS_GL_FUNCTION(glTexGenivOES, void, (GLenum coord, GLenum pname, const GLint *params), (coord, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glTexGenxOES, void, (GLenum coord, GLenum pname, GLfixed param), (coord, pname, param), , 0)
+HYBRIS_GL_FUNCTION(glTexGenxvOES, void, (GLenum coord, GLenum pname, const GLfixed *params), (coord, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetTexGenfvOES, void, (GLenum coord, GLenum pname, GLfloat *params), (coord, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetTexGenivOES, void, (GLenum coord, GLenum pname, GLint *params), (coord, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetTexGenxvOES, void, (GLenum coord, GLenum pname, GLfixed *params), (coord, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glBindVertexArrayOES, void, (GLuint array), (array), , 0)
+HYBRIS_GL_FUNCTION(glDeleteVertexArraysOES, void, (GLsizei n, const GLuint *arrays), (n, arrays), , 0)
+HYBRIS_GL_FUNCTION(glGenVertexArraysOES, void, (GLsizei n, GLuint *arrays), (n, arrays), , 0)
+HYBRIS_GL_FUNCTION(glIsVertexArrayOES, GLboolean, (GLuint array), (array), return, 0)
+HYBRIS_GL_FUNCTION(glRenderbufferStorageMultisampleAPPLE, void, (GLenum a1, GLsizei a2, GLenum a3, GLsizei a4, GLsizei a5), (a1, a2, a3, a4, a5), , 0)
+HYBRIS_GL_FUNCTION(glResolveMultisampleFramebufferAPPLE, void, (void), (), , 0)
+HYBRIS_GL_FUNCTION(glDiscardFramebufferEXT, void, (GLenum target, GLsizei numAttachments, const GLenum *attachments), (target, numAttachments, attachments), , 0)
+HYBRIS_GL_FUNCTION(glMultiDrawArraysEXT, void, (GLenum a1, GLint *a2, GLsizei *a3, GLsizei a4), (a1, a2, a3, a4), , 0)
+HYBRIS_GL_FUNCTION(glMultiDrawElementsEXT, void, (GLenum a1, const GLsizei *a2, GLenum a3, const GLvoid **a4, GLsizei a5), (a1, a2, a3, a4, a5), , 0)
+HYBRIS_GL_FUNCTION(glClipPlanefIMG, void, (GLenum a1, const GLfloat *a2), (a1, a2), , 0)
+HYBRIS_GL_FUNCTION(glClipPlanexIMG, void, (GLenum a1, const GLfixed *a2), (a1, a2), , 0)
+HYBRIS_GL_FUNCTION(glRenderbufferStorageMultisampleIMG, void, (GLenum a1, GLsizei a2, GLenum a3, GLsizei a4, GLsizei a5), (a1, a2, a3, a4, a5), , 0)
+HYBRIS_GL_FUNCTION(glFramebufferTexture2DMultisampleIMG, void, (GLenum a1, GLenum a2, GLenum a3, GLuint a4, GLint a5, GLsizei a6), (a1, a2, a3, a4, a5, a6), , 0)
+HYBRIS_GL_FUNCTION(glDeleteFencesNV, void, (GLsizei a1, const GLuint *a2), (a1, a2), , 0)
+HYBRIS_GL_FUNCTION(glGenFencesNV, void, (GLsizei a1, GLuint *a2), (a1, a2), , 0)
+HYBRIS_GL_FUNCTION(glIsFenceNV, GLboolean, (GLuint a1), (a1), return, 0)
+HYBRIS_GL_FUNCTION(glTestFenceNV, GLboolean, (GLuint a1), (a1), return, 0)
+HYBRIS_GL_FUNCTION(glGetFenceivNV, void, (GLuint a1, GLenum a2, GLint *a3), (a1, a2, a3), , 0)
+HYBRIS_GL_FUNCTION(glFinishFenceNV, void, (GLuint a1), (a1), , 0)
+HYBRIS_GL_FUNCTION(glSetFenceNV, void, (GLuint a1, GLenum a2), (a1, a2), , 0)
+HYBRIS_GL_FUNCTION(glGetDriverControlsQCOM, void, (GLint *num, GLsizei size, GLuint *driverControls), (num, size, driverControls), , 0)
+HYBRIS_GL_FUNCTION(glGetDriverControlStringQCOM, void, (GLuint driverControl, GLsizei bufSize, GLsizei *length, GLchar *driverControlString), (driverControl, bufSize, length, driverControlString), , 0)
+HYBRIS_GL_FUNCTION(glEnableDriverControlQCOM, void, (GLuint driverControl), (driverControl), , 0)
+HYBRIS_GL_FUNCTION(glDisableDriverControlQCOM, void, (GLuint driverControl), (driverControl), , 0)
+HYBRIS_GL_FUNCTION(glExtGetTexturesQCOM, void, (GLuint *textures, GLint maxTextures, GLint *numTextures), (textures, maxTextures, numTextures), , 0)
+HYBRIS_GL_FUNCTION(glExtGetBuffersQCOM, void, (GLuint *buffers, GLint maxBuffers, GLint *numBuffers), (buffers, maxBuffers, numBuffers), , 0)
+HYBRIS_GL_FUNCTION(glExtGetRenderbuffersQCOM, void, (GLuint *renderbuffers, GLint maxRenderbuffers, GLint *numRenderbuffers), (renderbuffers, maxRenderbuffers, numRenderbuffers), , 0)
+HYBRIS_GL_FUNCTION(glExtGetFramebuffersQCOM, void, (GLuint *framebuffers, GLint maxFramebuffers, GLint *numFramebuffers), (framebuffers, maxFramebuffers, numFramebuffers), , 0)
+HYBRIS_GL_FUNCTION(glExtGetTexLevelParameterivQCOM, void, (GLuint texture, GLenum face, GLint level, GLenum pname, GLint *params), (texture, face, level, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glExtTexObjectStateOverrideiQCOM, void, (GLenum target, GLenum pname, GLint param), (target, pname, param), , 0)
+HYBRIS_GL_FUNCTION(glExtGetTexSubImageQCOM, void, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, GLvoid *texels), (target, level, xoffset, yoffset, zoffset, width, height, depth, format, type, texels), , 0)
+HYBRIS_GL_FUNCTION(glExtGetBufferPointervQCOM, void, (GLenum target, GLvoid **params), (target, params), , 0)
+HYBRIS_GL_FUNCTION(glExtGetShadersQCOM, void, (GLuint *shaders, GLint maxShaders, GLint *numShaders), (shaders, maxShaders, numShaders), , 0)
+HYBRIS_GL_FUNCTION(glExtGetProgramsQCOM, void, (GLuint *programs, GLint maxPrograms, GLint *numPrograms), (programs, maxPrograms, numPrograms), , 0)
+HYBRIS_GL_FUNCTION(glExtIsProgramBinaryQCOM, GLboolean, (GLuint program), (program), return, 0)
+HYBRIS_GL_FUNCTION(glExtGetProgramBinarySourceQCOM, void, (GLuint program, GLenum shadertype, GLchar *source, GLint *length), (program, shadertype, source, length), , 0)
+HYBRIS_GL_FUNCTION(glStartTilingQCOM, void, (GLuint x, GLuint y, GLuint width, GLuint height, GLbitfield preserveMask), (x, y, width, height, preserveMask), , 0)
+HYBRIS_GL_FUNCTION(glEndTilingQCOM, void, (GLbitfield preserveMask), (preserveMask), , 0)
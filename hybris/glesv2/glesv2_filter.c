@@ -0,0 +1,560 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <GLES2/gl2.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <hybris/internal/gl_dispatch.h>
+
+#include "glesv2_filter.h"
+
+#define FILTER_TEXTURE_UNITS 32
+
+/* The filtered functions, indices of the counters */
+enum {
+	FILTER_ACTIVE_TEXTURE,
+	FILTER_BIND_TEXTURE,
+	FILTER_USE_PROGRAM,
+	FILTER_ENABLE,
+	FILTER_DISABLE,
+	FILTER_BLEND_FUNC,
+	FILTER_BLEND_FUNC_SEPARATE,
+	FILTER_BIND_BUFFER,
+	FILTER_FUNCTIONS
+};
+
+static const char *const _filter_names[FILTER_FUNCTIONS] = {
+	"glActiveTexture",
+	"glBindTexture",
+	"glUseProgram",
+	"glEnable",
+	"glDisable",
+	"glBlendFunc",
+	"glBlendFuncSeparate",
+	"glBindBuffer",
+};
+
+/* The shadow state of a context, -1 where it's unknown */
+struct filter_context {
+	void *context;
+	struct filter_context *next;
+	/* current on a thread, destroyed while it was */
+	int current;
+	int destroyed;
+
+	/* the deletions the bindings are up to date with */
+	unsigned textures_deleted;
+	unsigned buffers_deleted;
+	unsigned programs_deleted;
+
+	int64_t active_texture;
+	int64_t textures[FILTER_TEXTURE_UNITS][2];
+	int64_t program;
+	int64_t array_buffer;
+	int64_t blend[4];
+	unsigned capabilities_known;
+	unsigned capabilities_enabled;
+
+	unsigned frame;
+	unsigned filtered[FILTER_FUNCTIONS];
+	unsigned forwarded[FILTER_FUNCTIONS];
+};
+
+static int _filter_enabled = 0;
+static FILE *_filter_stats = NULL;
+
+/* The contexts libEGL told about, protected by _filter_mutex */
+static struct filter_context *_filter_contexts = NULL;
+static pthread_mutex_t _filter_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Read by every filtered call: initial-exec avoids a __tls_get_addr call
+ * for each, the pointer fits in what glibc keeps for dlopened libraries */
+static __thread struct filter_context *_filter_current __attribute__((tls_model("initial-exec"))) = NULL;
+
+/* Bumped by every deletion of objects of the kind, in any context */
+static unsigned _filter_textures_deleted = 0;
+static unsigned _filter_buffers_deleted = 0;
+static unsigned _filter_programs_deleted = 0;
+
+/* The vendor functions */
+static void (*_glActiveTexture)(GLenum texture) FP_ATTRIB;
+static void (*_glBindTexture)(GLenum target, GLuint texture) FP_ATTRIB;
+static void (*_glUseProgram)(GLuint program) FP_ATTRIB;
+static void (*_glEnable)(GLenum cap) FP_ATTRIB;
+static void (*_glDisable)(GLenum cap) FP_ATTRIB;
+static void (*_glBlendFunc)(GLenum sfactor, GLenum dfactor) FP_ATTRIB;
+static void (*_glBlendFuncSeparate)(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha) FP_ATTRIB;
+static void (*_glBindBuffer)(GLenum target, GLuint buffer) FP_ATTRIB;
+static void (*_glDeleteTextures)(GLsizei n, const GLuint *textures) FP_ATTRIB;
+static void (*_glDeleteBuffers)(GLsizei n, const GLuint *buffers) FP_ATTRIB;
+static void (*_glDeleteProgram)(GLuint program) FP_ATTRIB;
+
+static void filter_reset(struct filter_context *c)
+{
+	int unit;
+
+	c->textures_deleted = __atomic_load_n(&_filter_textures_deleted, __ATOMIC_ACQUIRE);
+	c->buffers_deleted = __atomic_load_n(&_filter_buffers_deleted, __ATOMIC_ACQUIRE);
+	c->programs_deleted = __atomic_load_n(&_filter_programs_deleted, __ATOMIC_ACQUIRE);
+
+	c->active_texture = -1;
+	for (unit = 0; unit < FILTER_TEXTURE_UNITS; unit++)
+		c->textures[unit][0] = c->textures[unit][1] = -1;
+	c->program = -1;
+	c->array_buffer = -1;
+	c->blend[0] = c->blend[1] = c->blend[2] = c->blend[3] = -1;
+	c->capabilities_known = 0;
+	c->capabilities_enabled = 0;
+}
+
+/* Forgets the bindings of a kind of objects deleted since they were set */
+static void filter_sync_textures(struct filter_context *c)
+{
+	unsigned deleted = __atomic_load_n(&_filter_textures_deleted, __ATOMIC_ACQUIRE);
+	int unit;
+
+	if (c->textures_deleted == deleted)
+		return;
+	c->textures_deleted = deleted;
+	for (unit = 0; unit < FILTER_TEXTURE_UNITS; unit++)
+		c->textures[unit][0] = c->textures[unit][1] = -1;
+}
+
+static void filter_sync_buffers(struct filter_context *c)
+{
+	unsigned deleted = __atomic_load_n(&_filter_buffers_deleted, __ATOMIC_ACQUIRE);
+
+	if (c->buffers_deleted == deleted)
+		return;
+	c->buffers_deleted = deleted;
+	c->array_buffer = -1;
+}
+
+static void filter_sync_programs(struct filter_context *c)
+{
+	unsigned deleted = __atomic_load_n(&_filter_programs_deleted, __ATOMIC_ACQUIRE);
+
+	if (c->programs_deleted == deleted)
+		return;
+	c->programs_deleted = deleted;
+	c->program = -1;
+}
+
+/* The bit of cap in the capability masks, -1 if it isn't shadowed */
+static int filter_capability(GLenum cap)
+{
+	switch (cap) {
+	case GL_BLEND: return 0;
+	case GL_CULL_FACE: return 1;
+	case GL_DEPTH_TEST: return 2;
+	case GL_DITHER: return 3;
+	case GL_POLYGON_OFFSET_FILL: return 4;
+	case GL_SAMPLE_ALPHA_TO_COVERAGE: return 5;
+	case GL_SAMPLE_COVERAGE: return 6;
+	case GL_SCISSOR_TEST: return 7;
+	case GL_STENCIL_TEST: return 8;
+	default: return -1;
+	}
+}
+
+#define FILTERED(c, function) \
+	do { \
+		(c)->filtered[function]++; \
+		return; \
+	} while (0)
+
+#define FORWARDED(c, function) \
+	do { \
+		if (c) \
+			(c)->forwarded[function]++; \
+	} while (0)
+
+static void filter_glActiveTexture(GLenum texture) FP_ATTRIB;
+static void filter_glActiveTexture(GLenum texture)
+{
+	struct filter_context *c = _filter_current;
+	int64_t unit = (int64_t) texture - GL_TEXTURE0;
+	int known = unit >= 0 && unit < FILTER_TEXTURE_UNITS;
+
+	if (c && known && c->active_texture == unit)
+		FILTERED(c, FILTER_ACTIVE_TEXTURE);
+
+	_glActiveTexture(texture);
+	FORWARDED(c, FILTER_ACTIVE_TEXTURE);
+	if (c)
+		c->active_texture = known ? unit : -1;
+}
+
+static void filter_glBindTexture(GLenum target, GLuint texture) FP_ATTRIB;
+static void filter_glBindTexture(GLenum target, GLuint texture)
+{
+	struct filter_context *c = _filter_current;
+	int index = target == GL_TEXTURE_2D ? 0 : target == GL_TEXTURE_CUBE_MAP ? 1 : -1;
+	int64_t *bound = NULL;
+
+	if (c && index >= 0 && c->active_texture >= 0) {
+		filter_sync_textures(c);
+		bound = &c->textures[c->active_texture][index];
+		if (*bound == texture)
+			FILTERED(c, FILTER_BIND_TEXTURE);
+	}
+
+	_glBindTexture(target, texture);
+	FORWARDED(c, FILTER_BIND_TEXTURE);
+	if (bound)
+		*bound = texture;
+}
+
+static void filter_glUseProgram(GLuint program) FP_ATTRIB;
+static void filter_glUseProgram(GLuint program)
+{
+	struct filter_context *c = _filter_current;
+
+	if (c) {
+		filter_sync_programs(c);
+		if (c->program == program)
+			FILTERED(c, FILTER_USE_PROGRAM);
+	}
+
+	_glUseProgram(program);
+	FORWARDED(c, FILTER_USE_PROGRAM);
+	if (c)
+		c->program = program;
+}
+
+static void filter_glEnable(GLenum cap) FP_ATTRIB;
+static void filter_glEnable(GLenum cap)
+{
+	struct filter_context *c = _filter_current;
+	int bit = filter_capability(cap);
+
+	if (c && bit >= 0 && (c->capabilities_known & c->capabilities_enabled & (1u << bit)))
+		FILTERED(c, FILTER_ENABLE);
+
+	_glEnable(cap);
+	FORWARDED(c, FILTER_ENABLE);
+	if (c && bit >= 0) {
+		c->capabilities_known |= 1u << bit;
+		c->capabilities_enabled |= 1u << bit;
+	}
+}
+
+static void filter_glDisable(GLenum cap) FP_ATTRIB;
+static void filter_glDisable(GLenum cap)
+{
+	struct filter_context *c = _filter_current;
+	int bit = filter_capability(cap);
+
+	if (c && bit >= 0 && (c->capabilities_known & ~c->capabilities_enabled & (1u << bit)))
+		FILTERED(c, FILTER_DISABLE);
+
+	_glDisable(cap);
+	FORWARDED(c, FILTER_DISABLE);
+	if (c && bit >= 0) {
+		c->capabilities_known |= 1u << bit;
+		c->capabilities_enabled &= ~(1u << bit);
+	}
+}
+
+static void filter_glBlendFunc(GLenum sfactor, GLenum dfactor) FP_ATTRIB;
+static void filter_glBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+	struct filter_context *c = _filter_current;
+
+	if (c && c->blend[0] == sfactor && c->blend[1] == dfactor &&
+			c->blend[2] == sfactor && c->blend[3] == dfactor)
+		FILTERED(c, FILTER_BLEND_FUNC);
+
+	_glBlendFunc(sfactor, dfactor);
+	FORWARDED(c, FILTER_BLEND_FUNC);
+	if (c) {
+		c->blend[0] = c->blend[2] = sfactor;
+		c->blend[1] = c->blend[3] = dfactor;
+	}
+}
+
+static void filter_glBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha) FP_ATTRIB;
+static void filter_glBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+{
+	struct filter_context *c = _filter_current;
+
+	if (c && c->blend[0] == srcRGB && c->blend[1] == dstRGB &&
+			c->blend[2] == srcAlpha && c->blend[3] == dstAlpha)
+		FILTERED(c, FILTER_BLEND_FUNC_SEPARATE);
+
+	_glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+	FORWARDED(c, FILTER_BLEND_FUNC_SEPARATE);
+	if (c) {
+		c->blend[0] = srcRGB;
+		c->blend[1] = dstRGB;
+		c->blend[2] = srcAlpha;
+		c->blend[3] = dstAlpha;
+	}
+}
+
+static void filter_glBindBuffer(GLenum target, GLuint buffer) FP_ATTRIB;
+static void filter_glBindBuffer(GLenum target, GLuint buffer)
+{
+	struct filter_context *c = _filter_current;
+
+	if (c && target == GL_ARRAY_BUFFER) {
+		filter_sync_buffers(c);
+		if (c->array_buffer == buffer)
+			FILTERED(c, FILTER_BIND_BUFFER);
+	}
+
+	_glBindBuffer(target, buffer);
+	FORWARDED(c, FILTER_BIND_BUFFER);
+	if (c && target == GL_ARRAY_BUFFER)
+		c->array_buffer = buffer;
+}
+
+static void filter_glDeleteTextures(GLsizei n, const GLuint *textures) FP_ATTRIB;
+static void filter_glDeleteTextures(GLsizei n, const GLuint *textures)
+{
+	_glDeleteTextures(n, textures);
+	__atomic_add_fetch(&_filter_textures_deleted, 1, __ATOMIC_RELEASE);
+}
+
+static void filter_glDeleteBuffers(GLsizei n, const GLuint *buffers) FP_ATTRIB;
+static void filter_glDeleteBuffers(GLsizei n, const GLuint *buffers)
+{
+	_glDeleteBuffers(n, buffers);
+	__atomic_add_fetch(&_filter_buffers_deleted, 1, __ATOMIC_RELEASE);
+}
+
+static void filter_glDeleteProgram(GLuint program) FP_ATTRIB;
+static void filter_glDeleteProgram(GLuint program)
+{
+	_glDeleteProgram(program);
+	__atomic_add_fetch(&_filter_programs_deleted, 1, __ATOMIC_RELEASE);
+}
+
+HYBRIS_GL_DECLARE_SLOT(glesv2, glActiveTexture)
+HYBRIS_GL_DECLARE_SLOT(glesv2, glBindTexture)
+HYBRIS_GL_DECLARE_SLOT(glesv2, glUseProgram)
+HYBRIS_GL_DECLARE_SLOT(glesv2, glEnable)
+HYBRIS_GL_DECLARE_SLOT(glesv2, glDisable)
+HYBRIS_GL_DECLARE_SLOT(glesv2, glBlendFunc)
+HYBRIS_GL_DECLARE_SLOT(glesv2, glBlendFuncSeparate)
+HYBRIS_GL_DECLARE_SLOT(glesv2, glBindBuffer)
+HYBRIS_GL_DECLARE_SLOT(glesv2, glDeleteTextures)
+HYBRIS_GL_DECLARE_SLOT(glesv2, glDeleteBuffers)
+HYBRIS_GL_DECLARE_SLOT(glesv2, glDeleteProgram)
+
+/* Moves the vendor function from the slot of name to _name and puts the
+ * filter in its place */
+#define FILTER_INSTALL(name) \
+	do { \
+		*(void **) &_##name = HYBRIS_GL_SLOT(glesv2, name); \
+		if (_##name) \
+			__atomic_store_n(&HYBRIS_GL_SLOT(glesv2, name), (void *) filter_##name, __ATOMIC_RELEASE); \
+	} while (0)
+
+void glesv2_filter_install(void)
+{
+	const char *env = getenv("HYBRIS_GLES_STATE_FILTER");
+	int i;
+
+	if (!env || strcmp(env, "1") != 0)
+		return;
+
+	env = getenv("HYBRIS_GLES_STATE_FILTER_STATS");
+	if (env) {
+		_filter_stats = fopen(env, "w");
+		if (_filter_stats) {
+			setvbuf(_filter_stats, NULL, _IOLBF, 0);
+			fprintf(_filter_stats, "# context\tframe\tfiltered\tforwarded");
+			for (i = 0; i < FILTER_FUNCTIONS; i++)
+				fprintf(_filter_stats, "\t%s", _filter_names[i]);
+			fprintf(_filter_stats, "\n# per function: filtered/calls\n");
+		} else {
+			fprintf(stderr, "libhybris: can't write the state filter statistics to %s\n", env);
+		}
+	}
+
+	FILTER_INSTALL(glActiveTexture);
+	FILTER_INSTALL(glBindTexture);
+	FILTER_INSTALL(glUseProgram);
+	FILTER_INSTALL(glEnable);
+	FILTER_INSTALL(glDisable);
+	FILTER_INSTALL(glBlendFunc);
+	FILTER_INSTALL(glBlendFuncSeparate);
+	FILTER_INSTALL(glBindBuffer);
+	FILTER_INSTALL(glDeleteTextures);
+	FILTER_INSTALL(glDeleteBuffers);
+	FILTER_INSTALL(glDeleteProgram);
+
+	_filter_enabled = 1;
+}
+
+/* Returns the filter of name if it's in front of the vendor function */
+#define FILTER_FUNCTION(function) \
+	do { \
+		if (strcmp(name, #function) == 0) \
+			return _##function ? (void *) filter_##function : NULL; \
+	} while (0)
+
+void *glesv2_filter_function(const char *name)
+{
+	if (!_filter_enabled)
+		return NULL;
+
+	FILTER_FUNCTION(glActiveTexture);
+	FILTER_FUNCTION(glBindTexture);
+	FILTER_FUNCTION(glUseProgram);
+	FILTER_FUNCTION(glEnable);
+	FILTER_FUNCTION(glDisable);
+	FILTER_FUNCTION(glBlendFunc);
+	FILTER_FUNCTION(glBlendFuncSeparate);
+	FILTER_FUNCTION(glBindBuffer);
+	FILTER_FUNCTION(glDeleteTextures);
+	FILTER_FUNCTION(glDeleteBuffers);
+	FILTER_FUNCTION(glDeleteProgram);
+	return NULL;
+}
+
+/* Called with _filter_mutex held */
+static struct filter_context *filter_find(void *context, struct filter_context ***link)
+{
+	struct filter_context **p;
+
+	for (p = &_filter_contexts; *p; p = &(*p)->next) {
+		if ((*p)->context == context)
+			break;
+	}
+	if (link)
+		*link = p;
+	return *p;
+}
+
+static void filter_remove(struct filter_context *c)
+{
+	struct filter_context **link;
+
+	if (filter_find(c->context, &link) == c) {
+		*link = c->next;
+		free(c);
+	}
+}
+
+void glesv2_filter_make_current(void *context)
+{
+	struct filter_context *previous = _filter_current, *c = NULL;
+
+	if (!_filter_enabled)
+		return;
+
+	pthread_mutex_lock(&_filter_mutex);
+	if (previous && previous->context != context) {
+		/* released by this thread */
+		previous->current = 0;
+		if (previous->destroyed)
+			filter_remove(previous);
+	}
+	if (context) {
+		c = filter_find(context, NULL);
+		if (!c) {
+			/* a context we don't know yet, all its state is unknown */
+			c = calloc(1, sizeof(*c));
+			if (c) {
+				c->context = context;
+				filter_reset(c);
+				c->next = _filter_contexts;
+				_filter_contexts = c;
+			}
+		}
+		if (c)
+			c->current = 1;
+	}
+	pthread_mutex_unlock(&_filter_mutex);
+
+	_filter_current = c;
+}
+
+void glesv2_filter_destroy_context(void *context)
+{
+	struct filter_context *c;
+
+	if (!_filter_enabled)
+		return;
+
+	/* A new context may get the same handle: forget the state. A current
+	 * context lives on until it's released. */
+	pthread_mutex_lock(&_filter_mutex);
+	c = filter_find(context, NULL);
+	if (c && c->current)
+		c->destroyed = 1;
+	else if (c)
+		filter_remove(c);
+	pthread_mutex_unlock(&_filter_mutex);
+}
+
+void glesv2_filter_terminate(void)
+{
+	struct filter_context *c, *next;
+
+	if (!_filter_enabled)
+		return;
+
+	/* The contexts of the display are gone, and we don't know which those
+	 * are: forgetting the state of all of them is always safe */
+	pthread_mutex_lock(&_filter_mutex);
+	for (c = _filter_contexts; c; c = next) {
+		next = c->next;
+		if (c->current)
+			c->destroyed = 1;
+		else
+			filter_remove(c);
+	}
+	pthread_mutex_unlock(&_filter_mutex);
+}
+
+void glesv2_filter_frame(void)
+{
+	struct filter_context *c = _filter_current;
+	unsigned filtered = 0, forwarded = 0;
+	int i;
+
+	if (!c)
+		return;
+
+	if (_filter_stats) {
+		char line[512];
+		int length = 0;
+
+		for (i = 0; i < FILTER_FUNCTIONS; i++) {
+			filtered += c->filtered[i];
+			forwarded += c->forwarded[i];
+		}
+		length += snprintf(line + length, sizeof(line) - length, "%p\t%u\t%u\t%u",
+			c->context, c->frame, filtered, forwarded);
+		for (i = 0; i < FILTER_FUNCTIONS; i++)
+			length += snprintf(line + length, sizeof(line) - length, "\t%u/%u",
+				c->filtered[i], c->filtered[i] + c->forwarded[i]);
+		/* one write per line, the frames of several threads don't mix */
+		fprintf(_filter_stats, "%s\n", line);
+	}
+
+	c->frame++;
+	memset(c->filtered, 0, sizeof(c->filtered));
+	memset(c->forwarded, 0, sizeof(c->forwarded));
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GLESV2_FILTER_H
+#define GLESV2_FILTER_H
+
+/*
+ * Filter of redundant state changes, enabled with
+ * HYBRIS_GLES_STATE_FILTER=1.
+ *
+ * Toolkits set the same state over and over, e.g. bind the texture which
+ * is already bound before every quad, and some drivers validate every
+ * such call at a cost. The filter keeps a shadow copy of a few bind
+ * points and capabilities of every context:
+ *
+ *   glActiveTexture, glBindTexture (GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAP
+ *   of the first 32 units), glUseProgram, glEnable and glDisable (the
+ *   capabilities of OpenGL ES 2.0), glBlendFunc, glBlendFuncSeparate and
+ *   glBindBuffer (GL_ARRAY_BUFFER)
+ *
+ * and drops the calls which wouldn't change it. Everything starts out
+ * unknown: the first call for a bind point or capability in a context
+ * goes to the driver. Deleting textures, buffers or programs in any
+ * context forgets the bindings of that kind in all contexts, so that
+ * contexts sharing objects with it never keep a stale one.
+ *
+ * GL_ELEMENT_ARRAY_BUFFER is not filtered, it's vertex array object
+ * state and glBindVertexArrayOES goes to the driver directly. libGLESv3
+ * puts the same filter in front of its functions (see
+ * hybris_glesv2_filter_function in glesv2.c), so both libraries share
+ * the state of the contexts. The filter doesn't see the calls made
+ * through functions from the driver's eglGetProcAddress: a process which
+ * changes the same state through those shouldn't enable it.
+ *
+ * With HYBRIS_GLES_STATE_FILTER_STATS=<path>, a tab separated line is
+ * written to path at every eglSwapBuffers, with the number of calls the
+ * current context filtered and forwarded to the driver in the frame, in
+ * total and per function.
+ */
+
+/* Puts the filter in front of the vendor functions bound to the slots,
+ * if it's enabled */
+void glesv2_filter_install(void);
+
+/* Returns the filter of the function name, NULL if name isn't filtered
+ * or the filter isn't enabled */
+void *glesv2_filter_function(const char *name);
+
+/* Called when context (or none) was made current on this thread, when
+ * it was destroyed, when a display was terminated and at the end of a
+ * frame of the current context */
+void glesv2_filter_make_current(void *context);
+void glesv2_filter_destroy_context(void *context);
+void glesv2_filter_terminate(void);
+void glesv2_filter_frame(void);
+
+#endif /* GLESV2_FILTER_H */
@@ -0,0 +1,145 @@
+/* Generated by utils/generate_gl_dispatch/generate_dispatch.py from glesv2_symbols, do not edit */
+
+HYBRIS_GL_FUNCTION(glActiveTexture, void, (GLenum texture), (texture), , 0)
+HYBRIS_GL_FUNCTION(glAttachShader, void, (GLuint program, GLuint shader), (program, shader), , 0)
+HYBRIS_GL_FUNCTION(glBindAttribLocation, void, (GLuint program, GLuint index, const GLchar *name), (program, index, name), , 0)
+HYBRIS_GL_FUNCTION(glBindBuffer, void, (GLenum target, GLuint buffer), (target, buffer), , 0)
+HYBRIS_GL_FUNCTION(glBindFramebuffer, void, (GLenum target, GLuint framebuffer), (target, framebuffer), , 0)
+HYBRIS_GL_FUNCTION(glBindRenderbuffer, void, (GLenum target, GLuint renderbuffer), (target, renderbuffer), , 0)
+HYBRIS_GL_FUNCTION(glBindTexture, void, (GLenum target, GLuint texture), (target, texture), , 0)
+HYBRIS_GL_FUNCTION(glBlendColor, void, (GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha), (red, green, blue, alpha), , 1)
+HYBRIS_GL_FUNCTION(glBlendEquation, void, (GLenum mode), (mode), , 0)
+HYBRIS_GL_FUNCTION(glBlendEquationSeparate, void, (GLenum modeRGB, GLenum modeAlpha), (modeRGB, modeAlpha), , 0)
+HYBRIS_GL_FUNCTION(glBlendFunc, void, (GLenum sfactor, GLenum dfactor), (sfactor, dfactor), , 0)
+HYBRIS_GL_FUNCTION(glBlendFuncSeparate, void, (GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha), (srcRGB, dstRGB, srcAlpha, dstAlpha), , 0)
+HYBRIS_GL_FUNCTION(glBufferData, void, (GLenum target, GLsizeiptr size, const GLvoid *data, GLenum usage), (target, size, data, usage), , 0)
+HYBRIS_GL_FUNCTION(glBufferSubData, void, (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid *data), (target, offset, size, data), , 0)
+HYBRIS_GL_FUNCTION(glCheckFramebufferStatus, GLenum, (GLenum target), (target), return, 0)
+HYBRIS_GL_FUNCTION(glClear, void, (GLbitfield mask), (mask), , 0)
+HYBRIS_GL_FUNCTION(glClearColor, void, (GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha), (red, green, blue, alpha), , 1)
+HYBRIS_GL_FUNCTION(glClearDepthf, void, (GLclampf depth), (depth), , 1)
+HYBRIS_GL_FUNCTION(glClearStencil, void, (GLint s), (s), , 0)
+HYBRIS_GL_FUNCTION(glColorMask, void, (GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha), (red, green, blue, alpha), , 0)
+HYBRIS_GL_FUNCTION(glCompileShader, void, (GLuint shader), (shader), , 0)
+HYBRIS_GL_FUNCTION(glCompressedTexImage2D, void, (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const GLvoid *data), (target, level, internalformat, width, height, border, imageSize, data), , 0)
+HYBRIS_GL_FUNCTION(glCompressedTexSubImage2D, void, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const GLvoid *data), (target, level, xoffset, yoffset, width, height, format, imageSize, data), , 0)
+HYBRIS_GL_FUNCTION(glCopyTexImage2D, void, (GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border), (target, level, internalformat, x, y, width, height, border), , 0)
+HYBRIS_GL_FUNCTION(glCopyTexSubImage2D, void, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height), (target, level, xoffset, yoffset, x, y, width, height), , 0)
+HYBRIS_GL_FUNCTION(glCreateProgram, GLuint, (void), (), return, 0)
+HYBRIS_GL_FUNCTION(glCreateShader, GLuint, (GLenum type), (type), return, 0)
+HYBRIS_GL_FUNCTION(glCullFace, void, (GLenum mode), (mode), , 0)
+HYBRIS_GL_FUNCTION(glDeleteBuffers, void, (GLsizei n, const GLuint *buffers), (n, buffers), , 0)
+HYBRIS_GL_FUNCTION(glDeleteFramebuffers, void, (GLsizei n, const GLuint *framebuffers), (n, framebuffers), , 0)
+HYBRIS_GL_FUNCTION(glDeleteProgram, void, (GLuint program), (program), , 0)
+HYBRIS_GL_FUNCTION(glDeleteRenderbuffers, void, (GLsizei n, const GLuint *renderbuffers), (n, renderbuffers), , 0)
+HYBRIS_GL_FUNCTION(glDeleteShader, void, (GLuint shader), (shader), , 0)
+HYBRIS_GL_FUNCTION(glDeleteTextures, void, (GLsizei n, const GLuint *textures), (n, textures), , 0)
+HYBRIS_GL_FUNCTION(glDepthFunc, void, (GLenum func), (func), , 0)
+HYBRIS_GL_FUNCTION(glDepthMask, void, (GLboolean flag), (flag), , 0)
+HYBRIS_GL_FUNCTION(glDepthRangef, void, (GLclampf zNear, GLclampf zFar), (zNear, zFar), , 1)
+HYBRIS_GL_FUNCTION(glDetachShader, void, (GLuint program, GLuint shader), (program, shader), , 0)
+HYBRIS_GL_FUNCTION(glDisable, void, (GLenum cap), (cap), , 0)
+HYBRIS_GL_FUNCTION(glDisableVertexAttribArray, void, (GLuint index), (index), , 0)
+HYBRIS_GL_FUNCTION(glDrawArrays, void, (GLenum mode, GLint first, GLsizei count), (mode, first, count), , 0)
+HYBRIS_GL_FUNCTION(glDrawElements, void, (GLenum mode, GLsizei count, GLenum type, const GLvoid *indices), (mode, count, type, indices), , 0)
+HYBRIS_GL_FUNCTION(glEnable, void, (GLenum cap), (cap), , 0)
+HYBRIS_GL_FUNCTION(glEnableVertexAttribArray, void, (GLuint index), (index), , 0)
+HYBRIS_GL_FUNCTION(glFinish, void, (void), (), , 0)
+HYBRIS_GL_FUNCTION(glFlush, void, (void), (), , 0)
+HYBRIS_GL_FUNCTION(glFramebufferRenderbuffer, void, (GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer), (target, attachment, renderbuffertarget, renderbuffer), , 0)
+HYBRIS_GL_FUNCTION(glFramebufferTexture2D, void, (GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level), (target, attachment, textarget, texture, level), , 0)
+HYBRIS_GL_FUNCTION(glFrontFace, void, (GLenum mode), (mode), , 0)
+HYBRIS_GL_FUNCTION(glGenBuffers, void, (GLsizei n, GLuint *buffers), (n, buffers), , 0)
+HYBRIS_GL_FUNCTION(glGenerateMipmap, void, (GLenum target), (target), , 0)
+HYBRIS_GL_FUNCTION(glGenFramebuffers, void, (GLsizei n, GLuint *framebuffers), (n, framebuffers), , 0)
+HYBRIS_GL_FUNCTION(glGenRenderbuffers, void, (GLsizei n, GLuint *renderbuffers), (n, renderbuffers), , 0)
+HYBRIS_GL_FUNCTION(glGenTextures, void, (GLsizei n, GLuint *textures), (n, textures), , 0)
+HYBRIS_GL_FUNCTION(glGetActiveAttrib, void, (GLuint program, GLuint index, GLsizei bufsize, GLsizei *length, GLint *size, GLenum *type, GLchar *name), (program, index, bufsize, length, size, type, name), , 0)
+HYBRIS_GL_FUNCTION(glGetActiveUniform, void, (GLuint program, GLuint index, GLsizei bufsize, GLsizei *length, GLint *size, GLenum *type, GLchar *name), (program, index, bufsize, length, size, type, name), , 0)
+HYBRIS_GL_FUNCTION(glGetAttachedShaders, void, (GLuint program, GLsizei maxcount, GLsizei *count, GLuint *shaders), (program, maxcount, count, shaders), , 0)
+HYBRIS_GL_FUNCTION(glGetAttribLocation, int, (GLuint program, const GLchar *name), (program, name), return, 0)
+HYBRIS_GL_FUNCTION(glGetBooleanv, void, (GLenum pname, GLboolean *params), (pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetBufferParameteriv, void, (GLenum target, GLenum pname, GLint *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetError, GLenum, (void), (), return, 0)
+HYBRIS_GL_FUNCTION(glGetFloatv, void, (GLenum pname, GLfloat *params), (pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetFramebufferAttachmentParameteriv, void, (GLenum target, GLenum attachment, GLenum pname, GLint *params), (target, attachment, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetIntegerv, void, (GLenum pname, GLint *params), (pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetProgramiv, void, (GLuint program, GLenum pname, GLint *params), (program, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetProgramInfoLog, void, (GLuint program, GLsizei bufsize, GLsizei *length, GLchar *infolog), (program, bufsize, length, infolog), , 0)
+HYBRIS_GL_FUNCTION(glGetRenderbufferParameteriv, void, (GLenum target, GLenum pname, GLint *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetShaderiv, void, (GLuint shader, GLenum pname, GLint *params), (shader, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetShaderInfoLog, void, (GLuint shader, GLsizei bufsize, GLsizei *length, GLchar *infolog), (shader, bufsize, length, infolog), , 0)
+HYBRIS_GL_FUNCTION(glGetShaderPrecisionFormat, void, (GLenum shadertype, GLenum precisiontype, GLint *range, GLint *precision), (shadertype, precisiontype, range, precision), , 0)
+HYBRIS_GL_FUNCTION(glGetShaderSource, void, (GLuint shader, GLsizei bufsize, GLsizei *length, GLchar *source), (shader, bufsize, length, source), , 0)
+HYBRIS_GL_FUNCTION(glGetString, const GLubyte *, (GLenum name), (name), return, own)
+HYBRIS_GL_FUNCTION(glGetTexParameterfv, void, (GLenum target, GLenum pname, GLfloat *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetTexParameteriv, void, (GLenum target, GLenum pname, GLint *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetUniformfv, void, (GLuint program, GLint location, GLfloat *params), (program, location, params), , 0)
+HYBRIS_GL_FUNCTION(glGetUniformiv, void, (GLuint program, GLint location, GLint *params), (program, location, params), , 0)
+HYBRIS_GL_FUNCTION(glGetUniformLocation, int, (GLuint program, const GLchar *name), (program, name), return, 0)
+HYBRIS_GL_FUNCTION(glGetVertexAttribfv, void, (GLuint index, GLenum pname, GLfloat *params), (index, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetVertexAttribiv, void, (GLuint index, GLenum pname, GLint *params), (index, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetVertexAttribPointerv, void, (GLuint index, GLenum pname, GLvoid **pointer), (index, pname, pointer), , 0)
+HYBRIS_GL_FUNCTION(glHint, void, (GLenum target, GLenum mode), (target, mode), , 0)
+HYBRIS_GL_FUNCTION(glIsBuffer, GLboolean, (GLuint buffer), (buffer), return, 0)
+HYBRIS_GL_FUNCTION(glIsEnabled, GLboolean, (GLenum cap), (cap), return, 0)
+HYBRIS_GL_FUNCTION(glIsFramebuffer, GLboolean, (GLuint framebuffer), (framebuffer), return, 0)
+HYBRIS_GL_FUNCTION(glIsProgram, GLboolean, (GLuint program), (program), return, 0)
+HYBRIS_GL_FUNCTION(glIsRenderbuffer, GLboolean, (GLuint renderbuffer), (renderbuffer), return, 0)
+HYBRIS_GL_FUNCTION(glIsShader, GLboolean, (GLuint shader), (shader), return, 0)
+HYBRIS_GL_FUNCTION(glIsTexture, GLboolean, (GLuint texture), (texture), return, 0)
+HYBRIS_GL_FUNCTION(glLineWidth, void, (GLfloat width), (width), , 1)
+HYBRIS_GL_FUNCTION(glLinkProgram, void, (GLuint program), (program), , 0)
+HYBRIS_GL_FUNCTION(glPixelStorei, void, (GLenum pname, GLint param), (pname, param), , 0)
+HYBRIS_GL_FUNCTION(glPolygonOffset, void, (GLfloat factor, GLfloat units), (factor, units), , 1)
+HYBRIS_GL_FUNCTION(glReadPixels, void, (GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid *pixels), (x, y, width, height, format, type, pixels), , 0)
+HYBRIS_GL_FUNCTION(glReleaseShaderCompiler, void, (void), (), , 0)
+HYBRIS_GL_FUNCTION(glRenderbufferStorage, void, (GLenum target, GLenum internalformat, GLsizei width, GLsizei height), (target, internalformat, width, height), , 0)
+HYBRIS_GL_FUNCTION(glSampleCoverage, void, (GLclampf value, GLboolean invert), (value, invert), , 1)
+HYBRIS_GL_FUNCTION(glScissor, void, (GLint x, GLint y, GLsizei width, GLsizei height), (x, y, width, height), , 0)
+HYBRIS_GL_FUNCTION(glShaderBinary, void, (GLsizei n, const GLuint *shaders, GLenum binaryformat, const GLvoid *binary, GLsizei length), (n, shaders, binaryformat, binary, length), , 0)
+HYBRIS_GL_FUNCTION(glShaderSource, void, (GLuint shader, GLsizei count, const GLchar **string, const GLint *length), (shader, count, string, length), , 0)
+HYBRIS_GL_FUNCTION(glStencilFunc, void, (GLenum func, GLint ref, GLuint mask), (func, ref, mask), , 0)
+HYBRIS_GL_FUNCTION(glStencilFuncSeparate, void, (GLenum face, GLenum func, GLint ref, GLuint mask), (face, func, ref, mask), , 0)
+HYBRIS_GL_FUNCTION(glStencilMask, void, (GLuint mask), (mask), , 0)
+HYBRIS_GL_FUNCTION(glStencilMaskSeparate, void, (GLenum face, GLuint mask), (face, mask), , 0)
+HYBRIS_GL_FUNCTION(glStencilOp, void, (GLenum fail, GLenum zfail, GLenum zpass), (fail, zfail, zpass), , 0)
+HYBRIS_GL_FUNCTION(glStencilOpSeparate, void, (GLenum face, GLenum fail, GLenum zfail, GLenum zpass), (face, fail, zfail, zpass), , 0)
+HYBRIS_GL_FUNCTION(glTexImage2D, void, (GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels), (target, level, internalformat, width, height, border, format, type, pixels), , 0)
+HYBRIS_GL_FUNCTION(glTexParameterf, void, (GLenum target, GLenum pname, GLfloat param), (target, pname, param), , 1)
+HYBRIS_GL_FUNCTION(glTexParameterfv, void, (GLenum target, GLenum pname, const GLfloat *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glTexParameteri, void, (GLenum target, GLenum pname, GLint param), (target, pname, param), , 0)
+HYBRIS_GL_FUNCTION(glTexParameteriv, void, (GLenum target, GLenum pname, const GLint *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glTexSubImage2D, void, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid *pixels), (target, level, xoffset, yoffset, width, height, format, type, pixels), , 0)
+HYBRIS_GL_FUNCTION(glUniform1f, void, (GLint location, GLfloat x), (location, x), , 1)
+HYBRIS_GL_FUNCTION(glUniform1fv, void, (GLint location, GLsizei count, const GLfloat *v), (location, count, v), , 0)
+HYBRIS_GL_FUNCTION(glUniform1i, void, (GLint location, GLint x), (location, x), , 0)
+HYBRIS_GL_FUNCTION(glUniform1iv, void, (GLint location, GLsizei count, const GLint *v), (location, count, v), , 0)
+HYBRIS_GL_FUNCTION(glUniform2f, void, (GLint location, GLfloat x, GLfloat y), (location, x, y), , 1)
+HYBRIS_GL_FUNCTION(glUniform2fv, void, (GLint location, GLsizei count, const GLfloat *v), (location, count, v), , 0)
+HYBRIS_GL_FUNCTION(glUniform2i, void, (GLint location, GLint x, GLint y), (location, x, y), , 0)
+HYBRIS_GL_FUNCTION(glUniform2iv, void, (GLint location, GLsizei count, const GLint *v), (location, count, v), , 0)
+HYBRIS_GL_FUNCTION(glUniform3f, void, (GLint location, GLfloat x, GLfloat y, GLfloat z), (location, x, y, z), , 1)
+HYBRIS_GL_FUNCTION(glUniform3fv, void, (GLint location, GLsizei count, const GLfloat *v), (location, count, v), , 0)
+HYBRIS_GL_FUNCTION(glUniform3i, void, (GLint location, GLint x, GLint y, GLint z), (location, x, y, z), , 0)
+HYBRIS_GL_FUNCTION(glUniform3iv, void, (GLint location, GLsizei count, const GLint *v), (location, count, v), , 0)
+HYBRIS_GL_FUNCTION(glUniform4f, void, (GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w), (location, x, y, z, w), , 1)
+HYBRIS_GL_FUNCTION(glUniform4fv, void, (GLint location, GLsizei count, const GLfloat *v), (location, count, v), , 0)
+HYBRIS_GL_FUNCTION(glUniform4i, void, (GLint location, GLint x, GLint y, GLint z, GLint w), (location, x, y, z, w), , 0)
+HYBRIS_GL_FUNCTION(glUniform4iv, void, (GLint location, GLsizei count, const GLint *v), (location, count, v), , 0)
+HYBRIS_GL_FUNCTION(glUniformMatrix2fv, void, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glUniformMatrix3fv, void, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glUniformMatrix4fv, void, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glUseProgram, void, (GLuint program), (program), , 0)
+HYBRIS_GL_FUNCTION(glValidateProgram, void, (GLuint program), (program), , 0)
+HYBRIS_GL_FUNCTION(glVertexAttrib1f, void, (GLuint indx, GLfloat x), (indx, x), , 1)
+HYBRIS_GL_FUNCTION(glVertexAttrib1fv, void, (GLuint indx, const GLfloat *values), (indx, values), , 0)
+HYBRIS_GL_FUNCTION(glVertexAttrib2f, void, (GLuint indx, GLfloat x, GLfloat y), (indx, x, y), , 1)
+HYBRIS_GL_FUNCTION(glVertexAttrib2fv, void, (GLuint indx, const GLfloat *values), (indx, values), , 0)
+HYBRIS_GL_FUNCTION(glVertexAttrib3f, void, (GLuint indx, GLfloat x, GLfloat y, GLfloat z), (indx, x, y, z), , 1)
+HYBRIS_GL_FUNCTION(glVertexAttrib3fv, void, (GLuint indx, const GLfloat *values), (indx, values), , 0)
+HYBRIS_GL_FUNCTION(glVertexAttrib4f, void, (GLuint indx, GLfloat x, GLfloat y, GLfloat z, GLfloat w), (indx, x, y, z, w), , 1)
+HYBRIS_GL_FUNCTION(glVertexAttrib4fv, void, (GLuint indx, const GLfloat *values), (indx, values), , 0)
+HYBRIS_GL_FUNCTION(glVertexAttribPointer, void, (GLuint indx, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid *ptr), (indx, size, type, normalized, stride, ptr), , 0)
+HYBRIS_GL_FUNCTION(glViewport, void, (GLint x, GLint y, GLsizei width, GLsizei height), (x, y, width, height), , 0)
+HYBRIS_GL_FUNCTION(glEGLImageTargetTexture2DOES, void, (GLenum target, GLeglImageOES image), (target, image), , 0)
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#define GL_GLEXT_PROTOTYPES
+#include <GLES3/gl31.h>
+#include <GLES2/gl2ext.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <hybris/common/binding.h>
+#include <hybris/internal/gl_dispatch.h>
+
+static void *_libglesv3 = NULL;
+static pthread_once_t _glesv3_once = PTHREAD_ONCE_INIT;
+
+static void _glesv3_bind();
+
+/*
+ * The OpenGL ES 3.1 library, with the 2.0 functions as well. It's bound
+ * the same way as libGLESv2 (see glesv2.c): when a context is first made
+ * current or on the first call.
+ */
+#define HYBRIS_GL_FUNCTION(name, ret, params, args, return_, fp) \
+	HYBRIS_GL_LAZY_STUB(glesv3, name, ret, params, args, return_, _glesv3_bind) \
+	HYBRIS_GL_DEFINE_SLOT(glesv3, name, HYBRIS_GL_LAZY_STUB_NAME(glesv3, name))
+#include "glesv3_functions.h"
+#undef HYBRIS_GL_FUNCTION
+
+static const struct hybris_gl_entry _glesv3_entries[] = {
+#define HYBRIS_GL_FUNCTION(name, ret, params, args, return_, fp) \
+	HYBRIS_GL_ENTRY(glesv3, name)
+#include "glesv3_functions.h"
+#undef HYBRIS_GL_FUNCTION
+};
+
+/*
+ * With HYBRIS_GLES_STATE_FILTER=1, libGLESv2 filters redundant state
+ * changes against a shadow copy of the state of every context (see
+ * glesv2/glesv2_filter.h). The state is the same whichever library
+ * changes it, so the functions it filters go through libGLESv2's filter
+ * from here too: a texture deleted or bound through libGLESv3 would
+ * otherwise leave the shadow copy stale. Returns libGLESv2's function
+ * which gives the filter of a function name, NULL if there's no filter.
+ */
+typedef void *(*_glesv3_filter_fn)(const char *name);
+
+static _glesv3_filter_fn _glesv3_filter()
+{
+	const char *env = getenv("HYBRIS_GLES_STATE_FILTER");
+	void *libglesv2;
+
+	if (!env || strcmp(env, "1") != 0)
+		return NULL;
+
+	/* stays loaded: the slots point into it, and libEGL tells it about
+	 * the contexts made current */
+	libglesv2 = dlopen(getenv("HYBRIS_LIBGLESV2") ?: "libGLESv2.so.2", RTLD_LAZY);
+	return libglesv2 ? dlsym(libglesv2, "hybris_glesv2_filter_function") : NULL;
+}
+
+static void _glesv3_load()
+{
+	const char *name = getenv("LIBGLESV3");
+	_glesv3_filter_fn filter = _glesv3_filter();
+	size_t i;
+
+	_libglesv3 = (void *) android_dlopen(name ? name : "libGLESv3.so", RTLD_NOW);
+	/* Before Android 4.3 added libGLESv3.so, the 3.0 functions of drivers
+	 * which had them were in libGLESv2.so */
+	if (!_libglesv3 && !name)
+		_libglesv3 = (void *) android_dlopen("libGLESv2.so", RTLD_NOW);
+	hybris_gl_bind(_libglesv3, _glesv3_entries, sizeof(_glesv3_entries) / sizeof(_glesv3_entries[0]));
+
+	for (i = 0; filter && i < sizeof(_glesv3_entries) / sizeof(_glesv3_entries[0]); i++) {
+		void *function = filter(_glesv3_entries[i].name);
+
+		if (function)
+			__atomic_store_n(_glesv3_entries[i].slot, function, __ATOMIC_RELEASE);
+	}
+}
+
+static void _glesv3_bind()
+{
+	pthread_once(&_glesv3_once, _glesv3_load);
+}
+
+/* Called by libEGL when context (or none) was made current on this thread */
+void hybris_glesv3_make_current(void *context)
+{
+	if (context)
+		_glesv3_bind();
+}
+
+/* The entry points which can't be trampolines, the others are in glesv3_trampolines.S */
+#define HYBRIS_GL_FUNCTION(name, ret, params, args, return_, fp) \
+	HYBRIS_GL_ENTRY_POINT(glesv3, name, ret, params, args, return_, fp)
+#include "glesv3_functions.h"
+#undef HYBRIS_GL_FUNCTION
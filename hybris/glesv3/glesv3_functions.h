@@ -0,0 +1,317 @@
+/* Generated by utils/generate_gl_dispatch/generate_dispatch.py from glesv3_symbols, do not edit */
+
+HYBRIS_GL_FUNCTION(glActiveTexture, void, (GLenum texture), (texture), , 0)
+HYBRIS_GL_FUNCTION(glAttachShader, void, (GLuint program, GLuint shader), (program, shader), , 0)
+HYBRIS_GL_FUNCTION(glBindAttribLocation, void, (GLuint program, GLuint index, const GLchar *name), (program, index, name), , 0)
+HYBRIS_GL_FUNCTION(glBindBuffer, void, (GLenum target, GLuint buffer), (target, buffer), , 0)
+HYBRIS_GL_FUNCTION(glBindFramebuffer, void, (GLenum target, GLuint framebuffer), (target, framebuffer), , 0)
+HYBRIS_GL_FUNCTION(glBindRenderbuffer, void, (GLenum target, GLuint renderbuffer), (target, renderbuffer), , 0)
+HYBRIS_GL_FUNCTION(glBindTexture, void, (GLenum target, GLuint texture), (target, texture), , 0)
+HYBRIS_GL_FUNCTION(glBlendColor, void, (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha), (red, green, blue, alpha), , 1)
+HYBRIS_GL_FUNCTION(glBlendEquation, void, (GLenum mode), (mode), , 0)
+HYBRIS_GL_FUNCTION(glBlendEquationSeparate, void, (GLenum modeRGB, GLenum modeAlpha), (modeRGB, modeAlpha), , 0)
+HYBRIS_GL_FUNCTION(glBlendFunc, void, (GLenum sfactor, GLenum dfactor), (sfactor, dfactor), , 0)
+HYBRIS_GL_FUNCTION(glBlendFuncSeparate, void, (GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha), (sfactorRGB, dfactorRGB, sfactorAlpha, dfactorAlpha), , 0)
+HYBRIS_GL_FUNCTION(glBufferData, void, (GLenum target, GLsizeiptr size, const void *data, GLenum usage), (target, size, data, usage), , 0)
+HYBRIS_GL_FUNCTION(glBufferSubData, void, (GLenum target, GLintptr offset, GLsizeiptr size, const void *data), (target, offset, size, data), , 0)
+HYBRIS_GL_FUNCTION(glCheckFramebufferStatus, GLenum, (GLenum target), (target), return, 0)
+HYBRIS_GL_FUNCTION(glClear, void, (GLbitfield mask), (mask), , 0)
+HYBRIS_GL_FUNCTION(glClearColor, void, (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha), (red, green, blue, alpha), , 1)
+HYBRIS_GL_FUNCTION(glClearDepthf, void, (GLfloat d), (d), , 1)
+HYBRIS_GL_FUNCTION(glClearStencil, void, (GLint s), (s), , 0)
+HYBRIS_GL_FUNCTION(glColorMask, void, (GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha), (red, green, blue, alpha), , 0)
+HYBRIS_GL_FUNCTION(glCompileShader, void, (GLuint shader), (shader), , 0)
+HYBRIS_GL_FUNCTION(glCompressedTexImage2D, void, (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void *data), (target, level, internalformat, width, height, border, imageSize, data), , 0)
+HYBRIS_GL_FUNCTION(glCompressedTexSubImage2D, void, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void *data), (target, level, xoffset, yoffset, width, height, format, imageSize, data), , 0)
+HYBRIS_GL_FUNCTION(glCopyTexImage2D, void, (GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border), (target, level, internalformat, x, y, width, height, border), , 0)
+HYBRIS_GL_FUNCTION(glCopyTexSubImage2D, void, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height), (target, level, xoffset, yoffset, x, y, width, height), , 0)
+HYBRIS_GL_FUNCTION(glCreateProgram, GLuint, (void), (), return, 0)
+HYBRIS_GL_FUNCTION(glCreateShader, GLuint, (GLenum type), (type), return, 0)
+HYBRIS_GL_FUNCTION(glCullFace, void, (GLenum mode), (mode), , 0)
+HYBRIS_GL_FUNCTION(glDeleteBuffers, void, (GLsizei n, const GLuint *buffers), (n, buffers), , 0)
+HYBRIS_GL_FUNCTION(glDeleteFramebuffers, void, (GLsizei n, const GLuint *framebuffers), (n, framebuffers), , 0)
+HYBRIS_GL_FUNCTION(glDeleteProgram, void, (GLuint program), (program), , 0)
+HYBRIS_GL_FUNCTION(glDeleteRenderbuffers, void, (GLsizei n, const GLuint *renderbuffers), (n, renderbuffers), , 0)
+HYBRIS_GL_FUNCTION(glDeleteShader, void, (GLuint shader), (shader), , 0)
+HYBRIS_GL_FUNCTION(glDeleteTextures, void, (GLsizei n, const GLuint *textures), (n, textures), , 0)
+HYBRIS_GL_FUNCTION(glDepthFunc, void, (GLenum func), (func), , 0)
+HYBRIS_GL_FUNCTION(glDepthMask, void, (GLboolean flag), (flag), , 0)
+HYBRIS_GL_FUNCTION(glDepthRangef, void, (GLfloat n, GLfloat f), (n, f), , 1)
+HYBRIS_GL_FUNCTION(glDetachShader, void, (GLuint program, GLuint shader), (program, shader), , 0)
+HYBRIS_GL_FUNCTION(glDisable, void, (GLenum cap), (cap), , 0)
+HYBRIS_GL_FUNCTION(glDisableVertexAttribArray, void, (GLuint index), (index), , 0)
+HYBRIS_GL_FUNCTION(glDrawArrays, void, (GLenum mode, GLint first, GLsizei count), (mode, first, count), , 0)
+HYBRIS_GL_FUNCTION(glDrawElements, void, (GLenum mode, GLsizei count, GLenum type, const void *indices), (mode, count, type, indices), , 0)
+HYBRIS_GL_FUNCTION(glEnable, void, (GLenum cap), (cap), , 0)
+HYBRIS_GL_FUNCTION(glEnableVertexAttribArray, void, (GLuint index), (index), , 0)
+HYBRIS_GL_FUNCTION(glFinish, void, (void), (), , 0)
+HYBRIS_GL_FUNCTION(glFlush, void, (void), (), , 0)
+HYBRIS_GL_FUNCTION(glFramebufferRenderbuffer, void, (GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer), (target, attachment, renderbuffertarget, renderbuffer), , 0)
+HYBRIS_GL_FUNCTION(glFramebufferTexture2D, void, (GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level), (target, attachment, textarget, texture, level), , 0)
+HYBRIS_GL_FUNCTION(glFrontFace, void, (GLenum mode), (mode), , 0)
+HYBRIS_GL_FUNCTION(glGenBuffers, void, (GLsizei n, GLuint *buffers), (n, buffers), , 0)
+HYBRIS_GL_FUNCTION(glGenerateMipmap, void, (GLenum target), (target), , 0)
+HYBRIS_GL_FUNCTION(glGenFramebuffers, void, (GLsizei n, GLuint *framebuffers), (n, framebuffers), , 0)
+HYBRIS_GL_FUNCTION(glGenRenderbuffers, void, (GLsizei n, GLuint *renderbuffers), (n, renderbuffers), , 0)
+HYBRIS_GL_FUNCTION(glGenTextures, void, (GLsizei n, GLuint *textures), (n, textures), , 0)
+HYBRIS_GL_FUNCTION(glGetActiveAttrib, void, (GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name), (program, index, bufSize, length, size, type, name), , 0)
+HYBRIS_GL_FUNCTION(glGetActiveUniform, void, (GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name), (program, index, bufSize, length, size, type, name), , 0)
+HYBRIS_GL_FUNCTION(glGetAttachedShaders, void, (GLuint program, GLsizei maxCount, GLsizei *count, GLuint *shaders), (program, maxCount, count, shaders), , 0)
+HYBRIS_GL_FUNCTION(glGetAttribLocation, GLint, (GLuint program, const GLchar *name), (program, name), return, 0)
+HYBRIS_GL_FUNCTION(glGetBooleanv, void, (GLenum pname, GLboolean *data), (pname, data), , 0)
+HYBRIS_GL_FUNCTION(glGetBufferParameteriv, void, (GLenum target, GLenum pname, GLint *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetError, GLenum, (void), (), return, 0)
+HYBRIS_GL_FUNCTION(glGetFloatv, void, (GLenum pname, GLfloat *data), (pname, data), , 0)
+HYBRIS_GL_FUNCTION(glGetFramebufferAttachmentParameteriv, void, (GLenum target, GLenum attachment, GLenum pname, GLint *params), (target, attachment, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetIntegerv, void, (GLenum pname, GLint *data), (pname, data), , 0)
+HYBRIS_GL_FUNCTION(glGetProgramiv, void, (GLuint program, GLenum pname, GLint *params), (program, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetProgramInfoLog, void, (GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog), (program, bufSize, length, infoLog), , 0)
+HYBRIS_GL_FUNCTION(glGetRenderbufferParameteriv, void, (GLenum target, GLenum pname, GLint *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetShaderiv, void, (GLuint shader, GLenum pname, GLint *params), (shader, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetShaderInfoLog, void, (GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog), (shader, bufSize, length, infoLog), , 0)
+HYBRIS_GL_FUNCTION(glGetShaderPrecisionFormat, void, (GLenum shadertype, GLenum precisiontype, GLint *range, GLint *precision), (shadertype, precisiontype, range, precision), , 0)
+HYBRIS_GL_FUNCTION(glGetShaderSource, void, (GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *source), (shader, bufSize, length, source), , 0)
+HYBRIS_GL_FUNCTION(glGetString, const GLubyte *, (GLenum name), (name), return, 0)
+HYBRIS_GL_FUNCTION(glGetTexParameterfv, void, (GLenum target, GLenum pname, GLfloat *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetTexParameteriv, void, (GLenum target, GLenum pname, GLint *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetUniformfv, void, (GLuint program, GLint location, GLfloat *params), (program, location, params), , 0)
+HYBRIS_GL_FUNCTION(glGetUniformiv, void, (GLuint program, GLint location, GLint *params), (program, location, params), , 0)
+HYBRIS_GL_FUNCTION(glGetUniformLocation, GLint, (GLuint program, const GLchar *name), (program, name), return, 0)
+HYBRIS_GL_FUNCTION(glGetVertexAttribfv, void, (GLuint index, GLenum pname, GLfloat *params), (index, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetVertexAttribiv, void, (GLuint index, GLenum pname, GLint *params), (index, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetVertexAttribPointerv, void, (GLuint index, GLenum pname, void **pointer), (index, pname, pointer), , 0)
+HYBRIS_GL_FUNCTION(glHint, void, (GLenum target, GLenum mode), (target, mode), , 0)
+HYBRIS_GL_FUNCTION(glIsBuffer, GLboolean, (GLuint buffer), (buffer), return, 0)
+HYBRIS_GL_FUNCTION(glIsEnabled, GLboolean, (GLenum cap), (cap), return, 0)
+HYBRIS_GL_FUNCTION(glIsFramebuffer, GLboolean, (GLuint framebuffer), (framebuffer), return, 0)
+HYBRIS_GL_FUNCTION(glIsProgram, GLboolean, (GLuint program), (program), return, 0)
+HYBRIS_GL_FUNCTION(glIsRenderbuffer, GLboolean, (GLuint renderbuffer), (renderbuffer), return, 0)
+HYBRIS_GL_FUNCTION(glIsShader, GLboolean, (GLuint shader), (shader), return, 0)
+HYBRIS_GL_FUNCTION(glIsTexture, GLboolean, (GLuint texture), (texture), return, 0)
+HYBRIS_GL_FUNCTION(glLineWidth, void, (GLfloat width), (width), , 1)
+HYBRIS_GL_FUNCTION(glLinkProgram, void, (GLuint program), (program), , 0)
+HYBRIS_GL_FUNCTION(glPixelStorei, void, (GLenum pname, GLint param), (pname, param), , 0)
+HYBRIS_GL_FUNCTION(glPolygonOffset, void, (GLfloat factor, GLfloat units), (factor, units), , 1)
+HYBRIS_GL_FUNCTION(glReadPixels, void, (GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void *pixels), (x, y, width, height, format, type, pixels), , 0)
+HYBRIS_GL_FUNCTION(glReleaseShaderCompiler, void, (void), (), , 0)
+HYBRIS_GL_FUNCTION(glRenderbufferStorage, void, (GLenum target, GLenum internalformat, GLsizei width, GLsizei height), (target, internalformat, width, height), , 0)
+HYBRIS_GL_FUNCTION(glSampleCoverage, void, (GLfloat value, GLboolean invert), (value, invert), , 1)
+HYBRIS_GL_FUNCTION(glScissor, void, (GLint x, GLint y, GLsizei width, GLsizei height), (x, y, width, height), , 0)
+HYBRIS_GL_FUNCTION(glShaderBinary, void, (GLsizei count, const GLuint *shaders, GLenum binaryformat, const void *binary, GLsizei length), (count, shaders, binaryformat, binary, length), , 0)
+HYBRIS_GL_FUNCTION(glShaderSource, void, (GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length), (shader, count, string, length), , 0)
+HYBRIS_GL_FUNCTION(glStencilFunc, void, (GLenum func, GLint ref, GLuint mask), (func, ref, mask), , 0)
+HYBRIS_GL_FUNCTION(glStencilFuncSeparate, void, (GLenum face, GLenum func, GLint ref, GLuint mask), (face, func, ref, mask), , 0)
+HYBRIS_GL_FUNCTION(glStencilMask, void, (GLuint mask), (mask), , 0)
+HYBRIS_GL_FUNCTION(glStencilMaskSeparate, void, (GLenum face, GLuint mask), (face, mask), , 0)
+HYBRIS_GL_FUNCTION(glStencilOp, void, (GLenum fail, GLenum zfail, GLenum zpass), (fail, zfail, zpass), , 0)
+HYBRIS_GL_FUNCTION(glStencilOpSeparate, void, (GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass), (face, sfail, dpfail, dppass), , 0)
+HYBRIS_GL_FUNCTION(glTexImage2D, void, (GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels), (target, level, internalformat, width, height, border, format, type, pixels), , 0)
+HYBRIS_GL_FUNCTION(glTexParameterf, void, (GLenum target, GLenum pname, GLfloat param), (target, pname, param), , 1)
+HYBRIS_GL_FUNCTION(glTexParameterfv, void, (GLenum target, GLenum pname, const GLfloat *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glTexParameteri, void, (GLenum target, GLenum pname, GLint param), (target, pname, param), , 0)
+HYBRIS_GL_FUNCTION(glTexParameteriv, void, (GLenum target, GLenum pname, const GLint *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glTexSubImage2D, void, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels), (target, level, xoffset, yoffset, width, height, format, type, pixels), , 0)
+HYBRIS_GL_FUNCTION(glUniform1f, void, (GLint location, GLfloat v0), (location, v0), , 1)
+HYBRIS_GL_FUNCTION(glUniform1fv, void, (GLint location, GLsizei count, const GLfloat *value), (location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glUniform1i, void, (GLint location, GLint v0), (location, v0), , 0)
+HYBRIS_GL_FUNCTION(glUniform1iv, void, (GLint location, GLsizei count, const GLint *value), (location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glUniform2f, void, (GLint location, GLfloat v0, GLfloat v1), (location, v0, v1), , 1)
+HYBRIS_GL_FUNCTION(glUniform2fv, void, (GLint location, GLsizei count, const GLfloat *value), (location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glUniform2i, void, (GLint location, GLint v0, GLint v1), (location, v0, v1), , 0)
+HYBRIS_GL_FUNCTION(glUniform2iv, void, (GLint location, GLsizei count, const GLint *value), (location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glUniform3f, void, (GLint location, GLfloat v0, GLfloat v1, GLfloat v2), (location, v0, v1, v2), , 1)
+HYBRIS_GL_FUNCTION(glUniform3fv, void, (GLint location, GLsizei count, const GLfloat *value), (location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glUniform3i, void, (GLint location, GLint v0, GLint v1, GLint v2), (location, v0, v1, v2), , 0)
+HYBRIS_GL_FUNCTION(glUniform3iv, void, (GLint location, GLsizei count, const GLint *value), (location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glUniform4f, void, (GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3), (location, v0, v1, v2, v3), , 1)
+HYBRIS_GL_FUNCTION(glUniform4fv, void, (GLint location, GLsizei count, const GLfloat *value), (location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glUniform4i, void, (GLint location, GLint v0, GLint v1, GLint v2, GLint v3), (location, v0, v1, v2, v3), , 0)
+HYBRIS_GL_FUNCTION(glUniform4iv, void, (GLint location, GLsizei count, const GLint *value), (location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glUniformMatrix2fv, void, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glUniformMatrix3fv, void, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glUniformMatrix4fv, void, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glUseProgram, void, (GLuint program), (program), , 0)
+HYBRIS_GL_FUNCTION(glValidateProgram, void, (GLuint program), (program), , 0)
+HYBRIS_GL_FUNCTION(glVertexAttrib1f, void, (GLuint index, GLfloat x), (index, x), , 1)
+HYBRIS_GL_FUNCTION(glVertexAttrib1fv, void, (GLuint index, const GLfloat *v), (index, v), , 0)
+HYBRIS_GL_FUNCTION(glVertexAttrib2f, void, (GLuint index, GLfloat x, GLfloat y), (index, x, y), , 1)
+HYBRIS_GL_FUNCTION(glVertexAttrib2fv, void, (GLuint index, const GLfloat *v), (index, v), , 0)
+HYBRIS_GL_FUNCTION(glVertexAttrib3f, void, (GLuint index, GLfloat x, GLfloat y, GLfloat z), (index, x, y, z), , 1)
+HYBRIS_GL_FUNCTION(glVertexAttrib3fv, void, (GLuint index, const GLfloat *v), (index, v), , 0)
+HYBRIS_GL_FUNCTION(glVertexAttrib4f, void, (GLuint index, GLfloat x, GLfloat y, GLfloat z, GLfloat w), (index, x, y, z, w), , 1)
+HYBRIS_GL_FUNCTION(glVertexAttrib4fv, void, (GLuint index, const GLfloat *v), (index, v), , 0)
+HYBRIS_GL_FUNCTION(glVertexAttribPointer, void, (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer), (index, size, type, normalized, stride, pointer), , 0)
+HYBRIS_GL_FUNCTION(glViewport, void, (GLint x, GLint y, GLsizei width, GLsizei height), (x, y, width, height), , 0)
+HYBRIS_GL_FUNCTION(glReadBuffer, void, (GLenum src), (src), , 0)
+HYBRIS_GL_FUNCTION(glDrawRangeElements, void, (GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void *indices), (mode, start, end, count, type, indices), , 0)
+HYBRIS_GL_FUNCTION(glTexImage3D, void, (GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void *pixels), (target, level, internalformat, width, height, depth, border, format, type, pixels), , 0)
+HYBRIS_GL_FUNCTION(glTexSubImage3D, void, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels), (target, level, xoffset, yoffset, zoffset, width, height, depth, format, type, pixels), , 0)
+HYBRIS_GL_FUNCTION(glCopyTexSubImage3D, void, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLint x, GLint y, GLsizei width, GLsizei height), (target, level, xoffset, yoffset, zoffset, x, y, width, height), , 0)
+HYBRIS_GL_FUNCTION(glCompressedTexImage3D, void, (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLsizei imageSize, const void *data), (target, level, internalformat, width, height, depth, border, imageSize, data), , 0)
+HYBRIS_GL_FUNCTION(glCompressedTexSubImage3D, void, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLsizei imageSize, const void *data), (target, level, xoffset, yoffset, zoffset, width, height, depth, format, imageSize, data), , 0)
+HYBRIS_GL_FUNCTION(glGenQueries, void, (GLsizei n, GLuint *ids), (n, ids), , 0)
+HYBRIS_GL_FUNCTION(glDeleteQueries, void, (GLsizei n, const GLuint *ids), (n, ids), , 0)
+HYBRIS_GL_FUNCTION(glIsQuery, GLboolean, (GLuint id), (id), return, 0)
+HYBRIS_GL_FUNCTION(glBeginQuery, void, (GLenum target, GLuint id), (target, id), , 0)
+HYBRIS_GL_FUNCTION(glEndQuery, void, (GLenum target), (target), , 0)
+HYBRIS_GL_FUNCTION(glGetQueryiv, void, (GLenum target, GLenum pname, GLint *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetQueryObjectuiv, void, (GLuint id, GLenum pname, GLuint *params), (id, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glUnmapBuffer, GLboolean, (GLenum target), (target), return, 0)
+HYBRIS_GL_FUNCTION(glGetBufferPointerv, void, (GLenum target, GLenum pname, void **params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glDrawBuffers, void, (GLsizei n, const GLenum *bufs), (n, bufs), , 0)
+HYBRIS_GL_FUNCTION(glUniformMatrix2x3fv, void, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glUniformMatrix3x2fv, void, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glUniformMatrix2x4fv, void, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glUniformMatrix4x2fv, void, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glUniformMatrix3x4fv, void, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glUniformMatrix4x3fv, void, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glBlitFramebuffer, void, (GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter), (srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter), , 0)
+HYBRIS_GL_FUNCTION(glRenderbufferStorageMultisample, void, (GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height), (target, samples, internalformat, width, height), , 0)
+HYBRIS_GL_FUNCTION(glFramebufferTextureLayer, void, (GLenum target, GLenum attachment, GLuint texture, GLint level, GLint layer), (target, attachment, texture, level, layer), , 0)
+HYBRIS_GL_FUNCTION(glMapBufferRange, void *, (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access), (target, offset, length, access), return, 0)
+HYBRIS_GL_FUNCTION(glFlushMappedBufferRange, void, (GLenum target, GLintptr offset, GLsizeiptr length), (target, offset, length), , 0)
+HYBRIS_GL_FUNCTION(glBindVertexArray, void, (GLuint array), (array), , 0)
+HYBRIS_GL_FUNCTION(glDeleteVertexArrays, void, (GLsizei n, const GLuint *arrays), (n, arrays), , 0)
+HYBRIS_GL_FUNCTION(glGenVertexArrays, void, (GLsizei n, GLuint *arrays), (n, arrays), , 0)
+HYBRIS_GL_FUNCTION(glIsVertexArray, GLboolean, (GLuint array), (array), return, 0)
+HYBRIS_GL_FUNCTION(glGetIntegeri_v, void, (GLenum target, GLuint index, GLint *data), (target, index, data), , 0)
+HYBRIS_GL_FUNCTION(glBeginTransformFeedback, void, (GLenum primitiveMode), (primitiveMode), , 0)
+HYBRIS_GL_FUNCTION(glEndTransformFeedback, void, (void), (), , 0)
+HYBRIS_GL_FUNCTION(glBindBufferRange, void, (GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size), (target, index, buffer, offset, size), , 0)
+HYBRIS_GL_FUNCTION(glBindBufferBase, void, (GLenum target, GLuint index, GLuint buffer), (target, index, buffer), , 0)
+HYBRIS_GL_FUNCTION(glTransformFeedbackVaryings, void, (GLuint program, GLsizei count, const GLchar *const *varyings, GLenum bufferMode), (program, count, varyings, bufferMode), , 0)
+HYBRIS_GL_FUNCTION(glGetTransformFeedbackVarying, void, (GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLsizei *size, GLenum *type, GLchar *name), (program, index, bufSize, length, size, type, name), , 0)
+HYBRIS_GL_FUNCTION(glVertexAttribIPointer, void, (GLuint index, GLint size, GLenum type, GLsizei stride, const void *pointer), (index, size, type, stride, pointer), , 0)
+HYBRIS_GL_FUNCTION(glGetVertexAttribIiv, void, (GLuint index, GLenum pname, GLint *params), (index, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetVertexAttribIuiv, void, (GLuint index, GLenum pname, GLuint *params), (index, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glVertexAttribI4i, void, (GLuint index, GLint x, GLint y, GLint z, GLint w), (index, x, y, z, w), , 0)
+HYBRIS_GL_FUNCTION(glVertexAttribI4ui, void, (GLuint index, GLuint x, GLuint y, GLuint z, GLuint w), (index, x, y, z, w), , 0)
+HYBRIS_GL_FUNCTION(glVertexAttribI4iv, void, (GLuint index, const GLint *v), (index, v), , 0)
+HYBRIS_GL_FUNCTION(glVertexAttribI4uiv, void, (GLuint index, const GLuint *v), (index, v), , 0)
+HYBRIS_GL_FUNCTION(glGetUniformuiv, void, (GLuint program, GLint location, GLuint *params), (program, location, params), , 0)
+HYBRIS_GL_FUNCTION(glGetFragDataLocation, GLint, (GLuint program, const GLchar *name), (program, name), return, 0)
+HYBRIS_GL_FUNCTION(glUniform1ui, void, (GLint location, GLuint v0), (location, v0), , 0)
+HYBRIS_GL_FUNCTION(glUniform2ui, void, (GLint location, GLuint v0, GLuint v1), (location, v0, v1), , 0)
+HYBRIS_GL_FUNCTION(glUniform3ui, void, (GLint location, GLuint v0, GLuint v1, GLuint v2), (location, v0, v1, v2), , 0)
+HYBRIS_GL_FUNCTION(glUniform4ui, void, (GLint location, GLuint v0, GLuint v1, GLuint v2, GLuint v3), (location, v0, v1, v2, v3), , 0)
+HYBRIS_GL_FUNCTION(glUniform1uiv, void, (GLint location, GLsizei count, const GLuint *value), (location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glUniform2uiv, void, (GLint location, GLsizei count, const GLuint *value), (location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glUniform3uiv, void, (GLint location, GLsizei count, const GLuint *value), (location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glUniform4uiv, void, (GLint location, GLsizei count, const GLuint *value), (location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glClearBufferiv, void, (GLenum buffer, GLint drawbuffer, const GLint *value), (buffer, drawbuffer, value), , 0)
+HYBRIS_GL_FUNCTION(glClearBufferuiv, void, (GLenum buffer, GLint drawbuffer, const GLuint *value), (buffer, drawbuffer, value), , 0)
+HYBRIS_GL_FUNCTION(glClearBufferfv, void, (GLenum buffer, GLint drawbuffer, const GLfloat *value), (buffer, drawbuffer, value), , 0)
+HYBRIS_GL_FUNCTION(glClearBufferfi, void, (GLenum buffer, GLint drawbuffer, GLfloat depth, GLint stencil), (buffer, drawbuffer, depth, stencil), , 1)
+HYBRIS_GL_FUNCTION(glGetStringi, const GLubyte *, (GLenum name, GLuint index), (name, index), return, 0)
+HYBRIS_GL_FUNCTION(glCopyBufferSubData, void, (GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size), (readTarget, writeTarget, readOffset, writeOffset, size), , 0)
+HYBRIS_GL_FUNCTION(glGetUniformIndices, void, (GLuint program, GLsizei uniformCount, const GLchar *const *uniformNames, GLuint *uniformIndices), (program, uniformCount, uniformNames, uniformIndices), , 0)
+HYBRIS_GL_FUNCTION(glGetActiveUniformsiv, void, (GLuint program, GLsizei uniformCount, const GLuint *uniformIndices, GLenum pname, GLint *params), (program, uniformCount, uniformIndices, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetUniformBlockIndex, GLuint, (GLuint program, const GLchar *uniformBlockName), (program, uniformBlockName), return, 0)
+HYBRIS_GL_FUNCTION(glGetActiveUniformBlockiv, void, (GLuint program, GLuint uniformBlockIndex, GLenum pname, GLint *params), (program, uniformBlockIndex, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetActiveUniformBlockName, void, (GLuint program, GLuint uniformBlockIndex, GLsizei bufSize, GLsizei *length, GLchar *uniformBlockName), (program, uniformBlockIndex, bufSize, length, uniformBlockName), , 0)
+HYBRIS_GL_FUNCTION(glUniformBlockBinding, void, (GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding), (program, uniformBlockIndex, uniformBlockBinding), , 0)
+HYBRIS_GL_FUNCTION(glDrawArraysInstanced, void, (GLenum mode, GLint first, GLsizei count, GLsizei instancecount), (mode, first, count, instancecount), , 0)
+HYBRIS_GL_FUNCTION(glDrawElementsInstanced, void, (GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount), (mode, count, type, indices, instancecount), , 0)
+HYBRIS_GL_FUNCTION(glFenceSync, GLsync, (GLenum condition, GLbitfield flags), (condition, flags), return, 0)
+HYBRIS_GL_FUNCTION(glIsSync, GLboolean, (GLsync sync), (sync), return, 0)
+HYBRIS_GL_FUNCTION(glDeleteSync, void, (GLsync sync), (sync), , 0)
+HYBRIS_GL_FUNCTION(glClientWaitSync, GLenum, (GLsync sync, GLbitfield flags, GLuint64 timeout), (sync, flags, timeout), return, 0)
+HYBRIS_GL_FUNCTION(glWaitSync, void, (GLsync sync, GLbitfield flags, GLuint64 timeout), (sync, flags, timeout), , 0)
+HYBRIS_GL_FUNCTION(glGetInteger64v, void, (GLenum pname, GLint64 *data), (pname, data), , 0)
+HYBRIS_GL_FUNCTION(glGetSynciv, void, (GLsync sync, GLenum pname, GLsizei bufSize, GLsizei *length, GLint *values), (sync, pname, bufSize, length, values), , 0)
+HYBRIS_GL_FUNCTION(glGetInteger64i_v, void, (GLenum target, GLuint index, GLint64 *data), (target, index, data), , 0)
+HYBRIS_GL_FUNCTION(glGetBufferParameteri64v, void, (GLenum target, GLenum pname, GLint64 *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGenSamplers, void, (GLsizei count, GLuint *samplers), (count, samplers), , 0)
+HYBRIS_GL_FUNCTION(glDeleteSamplers, void, (GLsizei count, const GLuint *samplers), (count, samplers), , 0)
+HYBRIS_GL_FUNCTION(glIsSampler, GLboolean, (GLuint sampler), (sampler), return, 0)
+HYBRIS_GL_FUNCTION(glBindSampler, void, (GLuint unit, GLuint sampler), (unit, sampler), , 0)
+HYBRIS_GL_FUNCTION(glSamplerParameteri, void, (GLuint sampler, GLenum pname, GLint param), (sampler, pname, param), , 0)
+HYBRIS_GL_FUNCTION(glSamplerParameteriv, void, (GLuint sampler, GLenum pname, const GLint *param), (sampler, pname, param), , 0)
+HYBRIS_GL_FUNCTION(glSamplerParameterf, void, (GLuint sampler, GLenum pname, GLfloat param), (sampler, pname, param), , 1)
+HYBRIS_GL_FUNCTION(glSamplerParameterfv, void, (GLuint sampler, GLenum pname, const GLfloat *param), (sampler, pname, param), , 0)
+HYBRIS_GL_FUNCTION(glGetSamplerParameteriv, void, (GLuint sampler, GLenum pname, GLint *params), (sampler, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetSamplerParameterfv, void, (GLuint sampler, GLenum pname, GLfloat *params), (sampler, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glVertexAttribDivisor, void, (GLuint index, GLuint divisor), (index, divisor), , 0)
+HYBRIS_GL_FUNCTION(glBindTransformFeedback, void, (GLenum target, GLuint id), (target, id), , 0)
+HYBRIS_GL_FUNCTION(glDeleteTransformFeedbacks, void, (GLsizei n, const GLuint *ids), (n, ids), , 0)
+HYBRIS_GL_FUNCTION(glGenTransformFeedbacks, void, (GLsizei n, GLuint *ids), (n, ids), , 0)
+HYBRIS_GL_FUNCTION(glIsTransformFeedback, GLboolean, (GLuint id), (id), return, 0)
+HYBRIS_GL_FUNCTION(glPauseTransformFeedback, void, (void), (), , 0)
+HYBRIS_GL_FUNCTION(glResumeTransformFeedback, void, (void), (), , 0)
+HYBRIS_GL_FUNCTION(glGetProgramBinary, void, (GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary), (program, bufSize, length, binaryFormat, binary), , 0)
+HYBRIS_GL_FUNCTION(glProgramBinary, void, (GLuint program, GLenum binaryFormat, const void *binary, GLsizei length), (program, binaryFormat, binary, length), , 0)
+HYBRIS_GL_FUNCTION(glProgramParameteri, void, (GLuint program, GLenum pname, GLint value), (program, pname, value), , 0)
+HYBRIS_GL_FUNCTION(glInvalidateFramebuffer, void, (GLenum target, GLsizei numAttachments, const GLenum *attachments), (target, numAttachments, attachments), , 0)
+HYBRIS_GL_FUNCTION(glInvalidateSubFramebuffer, void, (GLenum target, GLsizei numAttachments, const GLenum *attachments, GLint x, GLint y, GLsizei width, GLsizei height), (target, numAttachments, attachments, x, y, width, height), , 0)
+HYBRIS_GL_FUNCTION(glTexStorage2D, void, (GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height), (target, levels, internalformat, width, height), , 0)
+HYBRIS_GL_FUNCTION(glTexStorage3D, void, (GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth), (target, levels, internalformat, width, height, depth), , 0)
+HYBRIS_GL_FUNCTION(glGetInternalformativ, void, (GLenum target, GLenum internalformat, GLenum pname, GLsizei bufSize, GLint *params), (target, internalformat, pname, bufSize, params), , 0)
+HYBRIS_GL_FUNCTION(glDispatchCompute, void, (GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z), (num_groups_x, num_groups_y, num_groups_z), , 0)
+HYBRIS_GL_FUNCTION(glDispatchComputeIndirect, void, (GLintptr indirect), (indirect), , 0)
+HYBRIS_GL_FUNCTION(glDrawArraysIndirect, void, (GLenum mode, const void *indirect), (mode, indirect), , 0)
+HYBRIS_GL_FUNCTION(glDrawElementsIndirect, void, (GLenum mode, GLenum type, const void *indirect), (mode, type, indirect), , 0)
+HYBRIS_GL_FUNCTION(glFramebufferParameteri, void, (GLenum target, GLenum pname, GLint param), (target, pname, param), , 0)
+HYBRIS_GL_FUNCTION(glGetFramebufferParameteriv, void, (GLenum target, GLenum pname, GLint *params), (target, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetProgramInterfaceiv, void, (GLuint program, GLenum programInterface, GLenum pname, GLint *params), (program, programInterface, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetProgramResourceIndex, GLuint, (GLuint program, GLenum programInterface, const GLchar *name), (program, programInterface, name), return, 0)
+HYBRIS_GL_FUNCTION(glGetProgramResourceName, void, (GLuint program, GLenum programInterface, GLuint index, GLsizei bufSize, GLsizei *length, GLchar *name), (program, programInterface, index, bufSize, length, name), , 0)
+HYBRIS_GL_FUNCTION(glGetProgramResourceiv, void, (GLuint program, GLenum programInterface, GLuint index, GLsizei propCount, const GLenum *props, GLsizei bufSize, GLsizei *length, GLint *params), (program, programInterface, index, propCount, props, bufSize, length, params), , 0)
+HYBRIS_GL_FUNCTION(glGetProgramResourceLocation, GLint, (GLuint program, GLenum programInterface, const GLchar *name), (program, programInterface, name), return, 0)
+HYBRIS_GL_FUNCTION(glUseProgramStages, void, (GLuint pipeline, GLbitfield stages, GLuint program), (pipeline, stages, program), , 0)
+HYBRIS_GL_FUNCTION(glActiveShaderProgram, void, (GLuint pipeline, GLuint program), (pipeline, program), , 0)
+HYBRIS_GL_FUNCTION(glCreateShaderProgramv, GLuint, (GLenum type, GLsizei count, const GLchar *const *strings), (type, count, strings), return, 0)
+HYBRIS_GL_FUNCTION(glBindProgramPipeline, void, (GLuint pipeline), (pipeline), , 0)
+HYBRIS_GL_FUNCTION(glDeleteProgramPipelines, void, (GLsizei n, const GLuint *pipelines), (n, pipelines), , 0)
+HYBRIS_GL_FUNCTION(glGenProgramPipelines, void, (GLsizei n, GLuint *pipelines), (n, pipelines), , 0)
+HYBRIS_GL_FUNCTION(glIsProgramPipeline, GLboolean, (GLuint pipeline), (pipeline), return, 0)
+HYBRIS_GL_FUNCTION(glGetProgramPipelineiv, void, (GLuint pipeline, GLenum pname, GLint *params), (pipeline, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform1i, void, (GLuint program, GLint location, GLint v0), (program, location, v0), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform2i, void, (GLuint program, GLint location, GLint v0, GLint v1), (program, location, v0, v1), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform3i, void, (GLuint program, GLint location, GLint v0, GLint v1, GLint v2), (program, location, v0, v1, v2), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform4i, void, (GLuint program, GLint location, GLint v0, GLint v1, GLint v2, GLint v3), (program, location, v0, v1, v2, v3), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform1ui, void, (GLuint program, GLint location, GLuint v0), (program, location, v0), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform2ui, void, (GLuint program, GLint location, GLuint v0, GLuint v1), (program, location, v0, v1), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform3ui, void, (GLuint program, GLint location, GLuint v0, GLuint v1, GLuint v2), (program, location, v0, v1, v2), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform4ui, void, (GLuint program, GLint location, GLuint v0, GLuint v1, GLuint v2, GLuint v3), (program, location, v0, v1, v2, v3), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform1f, void, (GLuint program, GLint location, GLfloat v0), (program, location, v0), , 1)
+HYBRIS_GL_FUNCTION(glProgramUniform2f, void, (GLuint program, GLint location, GLfloat v0, GLfloat v1), (program, location, v0, v1), , 1)
+HYBRIS_GL_FUNCTION(glProgramUniform3f, void, (GLuint program, GLint location, GLfloat v0, GLfloat v1, GLfloat v2), (program, location, v0, v1, v2), , 1)
+HYBRIS_GL_FUNCTION(glProgramUniform4f, void, (GLuint program, GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3), (program, location, v0, v1, v2, v3), , 1)
+HYBRIS_GL_FUNCTION(glProgramUniform1iv, void, (GLuint program, GLint location, GLsizei count, const GLint *value), (program, location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform2iv, void, (GLuint program, GLint location, GLsizei count, const GLint *value), (program, location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform3iv, void, (GLuint program, GLint location, GLsizei count, const GLint *value), (program, location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform4iv, void, (GLuint program, GLint location, GLsizei count, const GLint *value), (program, location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform1uiv, void, (GLuint program, GLint location, GLsizei count, const GLuint *value), (program, location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform2uiv, void, (GLuint program, GLint location, GLsizei count, const GLuint *value), (program, location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform3uiv, void, (GLuint program, GLint location, GLsizei count, const GLuint *value), (program, location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform4uiv, void, (GLuint program, GLint location, GLsizei count, const GLuint *value), (program, location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform1fv, void, (GLuint program, GLint location, GLsizei count, const GLfloat *value), (program, location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform2fv, void, (GLuint program, GLint location, GLsizei count, const GLfloat *value), (program, location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform3fv, void, (GLuint program, GLint location, GLsizei count, const GLfloat *value), (program, location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniform4fv, void, (GLuint program, GLint location, GLsizei count, const GLfloat *value), (program, location, count, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniformMatrix2fv, void, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (program, location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniformMatrix3fv, void, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (program, location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniformMatrix4fv, void, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (program, location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniformMatrix2x3fv, void, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (program, location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniformMatrix3x2fv, void, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (program, location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniformMatrix2x4fv, void, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (program, location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniformMatrix4x2fv, void, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (program, location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniformMatrix3x4fv, void, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (program, location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glProgramUniformMatrix4x3fv, void, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (program, location, count, transpose, value), , 0)
+HYBRIS_GL_FUNCTION(glValidateProgramPipeline, void, (GLuint pipeline), (pipeline), , 0)
+HYBRIS_GL_FUNCTION(glGetProgramPipelineInfoLog, void, (GLuint pipeline, GLsizei bufSize, GLsizei *length, GLchar *infoLog), (pipeline, bufSize, length, infoLog), , 0)
+HYBRIS_GL_FUNCTION(glBindImageTexture, void, (GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format), (unit, texture, level, layered, layer, access, format), , 0)
+HYBRIS_GL_FUNCTION(glGetBooleani_v, void, (GLenum target, GLuint index, GLboolean *data), (target, index, data), , 0)
+HYBRIS_GL_FUNCTION(glMemoryBarrier, void, (GLbitfield barriers), (barriers), , 0)
+HYBRIS_GL_FUNCTION(glMemoryBarrierByRegion, void, (GLbitfield barriers), (barriers), , 0)
+HYBRIS_GL_FUNCTION(glTexStorage2DMultisample, void, (GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height, GLboolean fixedsamplelocations), (target, samples, internalformat, width, height, fixedsamplelocations), , 0)
+HYBRIS_GL_FUNCTION(glGetMultisamplefv, void, (GLenum pname, GLuint index, GLfloat *val), (pname, index, val), , 0)
+HYBRIS_GL_FUNCTION(glSampleMaski, void, (GLuint maskNumber, GLbitfield mask), (maskNumber, mask), , 0)
+HYBRIS_GL_FUNCTION(glGetTexLevelParameteriv, void, (GLenum target, GLint level, GLenum pname, GLint *params), (target, level, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glGetTexLevelParameterfv, void, (GLenum target, GLint level, GLenum pname, GLfloat *params), (target, level, pname, params), , 0)
+HYBRIS_GL_FUNCTION(glBindVertexBuffer, void, (GLuint bindingindex, GLuint buffer, GLintptr offset, GLsizei stride), (bindingindex, buffer, offset, stride), , 0)
+HYBRIS_GL_FUNCTION(glVertexAttribFormat, void, (GLuint attribindex, GLint size, GLenum type, GLboolean normalized, GLuint relativeoffset), (attribindex, size, type, normalized, relativeoffset), , 0)
+HYBRIS_GL_FUNCTION(glVertexAttribIFormat, void, (GLuint attribindex, GLint size, GLenum type, GLuint relativeoffset), (attribindex, size, type, relativeoffset), , 0)
+HYBRIS_GL_FUNCTION(glVertexAttribBinding, void, (GLuint attribindex, GLuint bindingindex), (attribindex, bindingindex), , 0)
+HYBRIS_GL_FUNCTION(glVertexBindingDivisor, void, (GLuint bindingindex, GLuint divisor), (bindingindex, divisor), , 0)
+HYBRIS_GL_FUNCTION(glEGLImageTargetTexture2DOES, void, (GLenum target, GLeglImageOES image), (target, image), , 0)
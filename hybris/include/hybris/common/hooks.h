@@ -29,6 +29,15 @@ typedef void* (*hybris_hook_cb)(const char *symbol_name, const char *requester);
 
 void hybris_set_hook_callback(hybris_hook_cb callback);
 
+/**
+ * Resolves symbol_name the same way the linker does for symbols imported
+ * by Android libraries: a registered hook callback is asked first (with a
+ * NULL requester), then the builtin hook table. Returns NULL if the symbol
+ * is not hooked, including the unhooked pthread symbols which the linker
+ * binds to fake addresses to make calls to them easy to spot.
+ **/
+void *hybris_get_hooked_symbol(const char *symbol_name);
+
 #ifdef __cplusplus
 }
 #endif
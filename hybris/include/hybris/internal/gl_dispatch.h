@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef HYBRIS_GL_DISPATCH_H
+#define HYBRIS_GL_DISPATCH_H
+
+/*
+ * Dispatch of the GLES wrapper libraries to the vendor's libraries.
+ *
+ * A wrapper library lists its entry points in a header generated by
+ * utils/generate_gl_dispatch, with a line
+ *
+ *   HYBRIS_GL_FUNCTION(name, return type, (parameters), (arguments), return, float)
+ *
+ * per function, and includes it several times with HYBRIS_GL_FUNCTION
+ * defined to one of the macros below: every entry point has a pointer,
+ * the slot, to the function of the vendor library it forwards to.
+ *
+ * Where the architecture allows, the entry point is a trampoline which
+ * jumps through its slot with the arguments still in place, so the call
+ * costs the vendor function one indirect jump: no frame, no copying of
+ * the arguments. The trampolines are assembled from the same list in the
+ * library's *_trampolines.S. Elsewhere, and on armhf for functions which
+ * take floating point arguments (bionic expects those in the core
+ * registers, see floating_point_abi.h), the entry point is a C function
+ * which calls through the slot.
+ *
+ * Functions listed with "own" instead of the float flag only get a slot:
+ * the library defines their entry point itself, calling the vendor
+ * function through HYBRIS_GL_SLOT.
+ *
+ * The slots are hidden symbols so that the trampolines reach them PC
+ * relative, without a GOT entry.
+ */
+
+#if defined(__x86_64__) || defined(__aarch64__) || \
+    (defined(__arm__) && defined(__ARM_ARCH_ISA_ARM))
+#define HYBRIS_GL_HAVE_TRAMPOLINES 1
+#endif
+
+#define HYBRIS_GL_SLOT(lib, name) _hybris_##lib##_##name
+
+#ifdef __ASSEMBLER__
+
+#if defined(__x86_64__)
+#define HYBRIS_GL_TRAMPOLINE(lib, name) \
+    .globl name; .type name, @function; .hidden HYBRIS_GL_SLOT(lib, name); .p2align 3; \
+    name: jmp *HYBRIS_GL_SLOT(lib, name)(%rip); \
+    .size name, . - name
+#elif defined(__aarch64__)
+#define HYBRIS_GL_TRAMPOLINE(lib, name) \
+    .globl name; .type name, %function; .hidden HYBRIS_GL_SLOT(lib, name); .p2align 2; \
+    name: adrp x16, HYBRIS_GL_SLOT(lib, name); \
+    ldr x16, [x16, :lo12:HYBRIS_GL_SLOT(lib, name)]; \
+    br x16; \
+    .size name, . - name
+#elif defined(__arm__)
+/* ARM state: ldr pc interworks with Thumb vendor functions */
+#define HYBRIS_GL_TRAMPOLINE(lib, name) \
+    .globl name; .type name, %function; .hidden HYBRIS_GL_SLOT(lib, name); .p2align 2; .arm; \
+    name: ldr ip, 1f; \
+    0: add ip, pc, ip; \
+    ldr pc, [ip]; \
+    1: .word HYBRIS_GL_SLOT(lib, name) - (0b + 8); \
+    .size name, . - name
+#endif
+
+#if defined(HYBRIS_GL_HAVE_TRAMPOLINES)
+#define HYBRIS_GL_ENTRY_POINT_0(lib, name) HYBRIS_GL_TRAMPOLINE(lib, name)
+#if defined(__ARM_PCS_VFP)
+#define HYBRIS_GL_ENTRY_POINT_1(lib, name)
+#else
+#define HYBRIS_GL_ENTRY_POINT_1(lib, name) HYBRIS_GL_TRAMPOLINE(lib, name)
+#endif
+#else
+#define HYBRIS_GL_ENTRY_POINT_0(lib, name)
+#define HYBRIS_GL_ENTRY_POINT_1(lib, name)
+#endif
+#define HYBRIS_GL_ENTRY_POINT_own(lib, name)
+
+/* The trampoline for name, if it can have one */
+#define HYBRIS_GL_ENTRY_POINT(lib, name, ret, params, args, return_, fp) \
+    HYBRIS_GL_ENTRY_POINT_##fp(lib, name)
+
+#else /* __ASSEMBLER__ */
+
+#include <stddef.h>
+
+#include <hybris/common/binding.h>
+
+struct hybris_gl_entry {
+    const char *name;
+    void **slot;
+};
+
+#define HYBRIS_GL_DECLARE_SLOT(lib, name) \
+    extern void *HYBRIS_GL_SLOT(lib, name) __attribute__((visibility("hidden")));
+
+/* Defines the slot of name, pointing to init until the library is bound */
+#define HYBRIS_GL_DEFINE_SLOT(lib, name, init) \
+    void *HYBRIS_GL_SLOT(lib, name) __attribute__((visibility("hidden"))) = (void *) (init);
+
+/* An element of the hybris_gl_entry array passed to hybris_gl_bind */
+#define HYBRIS_GL_ENTRY(lib, name) \
+    { #name, &HYBRIS_GL_SLOT(lib, name) },
+
+#define HYBRIS_GL_WRAPPER(lib, name, ret, params, args, return_) \
+    ret name params \
+    { \
+        typedef ret (*name##_fn) params FP_ATTRIB; \
+        return_ ((name##_fn) HYBRIS_GL_SLOT(lib, name)) args; \
+    }
+
+/*
+ * The initial target of the slot of name for libraries which are bound
+ * on first use: binds the library with bind and calls the vendor
+ * function. It's FP_ATTRIB like the vendor function, so that it can be
+ * called the same way.
+ */
+#define HYBRIS_GL_LAZY_STUB(lib, name, ret, params, args, return_, bind) \
+    HYBRIS_GL_DECLARE_SLOT(lib, name) \
+    static ret _hybris_##lib##_lazy_##name params FP_ATTRIB; \
+    static ret _hybris_##lib##_lazy_##name params \
+    { \
+        typedef ret (*name##_fn) params FP_ATTRIB; \
+        bind(); \
+        return_ ((name##_fn) HYBRIS_GL_SLOT(lib, name)) args; \
+    }
+
+#define HYBRIS_GL_LAZY_STUB_NAME(lib, name) _hybris_##lib##_lazy_##name
+
+#if defined(HYBRIS_GL_HAVE_TRAMPOLINES)
+#define HYBRIS_GL_ENTRY_POINT_0(lib, name, ret, params, args, return_)
+#if defined(__ARM_PCS_VFP)
+#define HYBRIS_GL_ENTRY_POINT_1(lib, name, ret, params, args, return_) \
+    HYBRIS_GL_WRAPPER(lib, name, ret, params, args, return_)
+#else
+#define HYBRIS_GL_ENTRY_POINT_1(lib, name, ret, params, args, return_)
+#endif
+#else
+#define HYBRIS_GL_ENTRY_POINT_0(lib, name, ret, params, args, return_) \
+    HYBRIS_GL_WRAPPER(lib, name, ret, params, args, return_)
+#define HYBRIS_GL_ENTRY_POINT_1(lib, name, ret, params, args, return_) \
+    HYBRIS_GL_WRAPPER(lib, name, ret, params, args, return_)
+#endif
+#define HYBRIS_GL_ENTRY_POINT_own(lib, name, ret, params, args, return_)
+
+/* The C entry point for name, if it can't have a trampoline */
+#define HYBRIS_GL_ENTRY_POINT(lib, name, ret, params, args, return_, fp) \
+    HYBRIS_GL_ENTRY_POINT_##fp(lib, name, ret, params, args, return_)
+
+/*
+ * Points the slots at the functions of the vendor library handle. The
+ * slots of functions it doesn't have are cleared, calling them crashes
+ * as it always did.
+ */
+static inline void hybris_gl_bind(void *handle, const struct hybris_gl_entry *entries, size_t count)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++)
+        __atomic_store_n(entries[i].slot, android_dlsym(handle, entries[i].name), __ATOMIC_RELEASE);
+}
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* HYBRIS_GL_DISPATCH_H */
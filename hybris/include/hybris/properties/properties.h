@@ -37,6 +37,13 @@
 #define PROP_MSG_GETPROP 2
 #define PROP_MSG_LISTPROP 3
 
+/* Asks the property service to keep the connection open. A service which
+ * supports it replies with a PROP_MSG_SESSION message, and then answers
+ * every request sent on the connection with one message, in order: a
+ * GETPROP with the property, a SETPROP with itself once the property has
+ * been set. Other services just close the connection */
+#define PROP_MSG_SESSION 4
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -49,6 +56,11 @@ extern "C" {
 
 	int property_set(const char *key, const char *value);
 	int property_get(const char *key, char *value, const char *default_value);
+	/* Gets count properties in a single round trip to the property service
+	 * if possible. Each of values must have room for PROP_VALUE_MAX bytes,
+	 * default_values may be NULL. Returns 0 on success */
+	int property_get_batch(const char * const *keys, char **values,
+			const char * const *default_values, int count);
 	int property_list(void (*propfn)(const char *key, const char *value, void *cookie), void *cookie);
 
 #ifdef __cplusplus
@@ -21,186 +21,728 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <string.h>
+#include <errno.h>
+#include <limits.h>
 #include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/inotify.h>
 
 #include <hybris/properties/properties.h>
 #include "properties_p.h"
 
+/*
+ * The static properties (build.prop and the androidboot.* arguments of the
+ * kernel command line) are compiled into a snapshot: a hash table which
+ * holds all the strings and uses offsets instead of pointers, so it can be
+ * written to a file and mapped read-only by every process. The first
+ * process which finds the snapshot file missing or out of date compiles a
+ * new one and atomically replaces the file.
+ *
+ * The snapshot lives in a world-writable directory, so a snapshot file is
+ * only used if it's read-only and owned by root or by us: anyone else
+ * could rewrite it under the readers. Otherwise the snapshot is compiled
+ * privately, in memory.
+ *
+ * Lookups don't need any system calls. Changes to build.prop are noticed
+ * through inotify (or through stat if inotify is not available), which is
+ * polled at most once per second.
+ *
+ * The build.prop and snapshot paths can be changed with the
+ * HYBRIS_BUILD_PROP and HYBRIS_PROPCACHE_SNAPSHOT environment variables.
+ */
+
+#define BUILD_PROP_PATH "/system/build.prop"
+#define SNAPSHOT_PATH "/dev/shm/hybris_propcache_v1"
+
+#define SNAPSHOT_MAGIC 0x50435948 /* "HYCP" */
+#define SNAPSHOT_VERSION 1
+
+struct snapshot_header
+{
+	uint32_t magic;
+	uint32_t version;
+	/* size of the whole snapshot in bytes */
+	uint32_t size;
+	uint32_t count;
+	/* a power of two */
+	uint32_t nbuckets;
+	/* hash of the build.prop path and of the kernel command line */
+	uint32_t input_hash;
+	/* identity of the build.prop the snapshot was compiled from */
+	uint64_t source_dev;
+	uint64_t source_ino;
+	int64_t source_size;
+	int64_t source_mtime;
+	int64_t source_mtime_nsec;
+	/* followed by uint32_t buckets[nbuckets], struct snapshot_entry
+	 * entries[count] sorted by key, and the strings */
+};
+
+struct snapshot_entry
+{
+	uint32_t hash;
+	/* index + 1 of the next entry in the bucket, 0 at the end */
+	uint32_t next;
+	/* offsets of the strings from the start of the snapshot */
+	uint32_t key;
+	uint32_t value;
+};
+
+/* a property while compiling a snapshot */
 struct hybris_prop_value
 {
 	char *key;
 	char *value;
+	/* order of appearance, the first occurrence of a key wins */
+	unsigned int seq;
 };
 
-/* surely enough for anyone */
-#define MAX_PROPS 1000
+struct prop_list
+{
+	struct hybris_prop_value *props;
+	unsigned int count;
+	unsigned int alloc;
+};
 
-/* the sorted prop array */
-static struct hybris_prop_value prop_array[MAX_PROPS];
+/* the snapshot in use. Replaced snapshots are never unmapped, as
+ * hybris_propcache_find hands out pointers into them */
+static const struct snapshot_header *current_snapshot;
+
+/* the empty snapshot used until build.prop exists */
+static const struct {
+	struct snapshot_header header;
+	uint32_t buckets[1];
+} empty_snapshot = {
+	{ SNAPSHOT_MAGIC, SNAPSHOT_VERSION, sizeof(empty_snapshot), 0, 1 }, { 0 }
+};
 
-/* the current highest index in prop_array */
-static int max_prop;
+/* coarse monotonic time of the last check for changes */
+static time_t last_check;
+
+static pthread_mutex_t snapshot_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t snapshot_once = PTHREAD_ONCE_INIT;
+static const char *build_prop_path;
+static const char *snapshot_path;
+static int inotify_fd = -1;
+static int inotify_reinit;
 
 /* helpers */
-static void cache_update();
-static int prop_qcmp(const void *a, const void *b);
-static struct hybris_prop_value *cache_find_internal(const char *key);
-static void cache_add_internal(const char *key, const char *value);
-static void cache_repopulate_internal(FILE *f);
-static void cache_empty_internal();
-static void cache_repopulate_cmdline_internal();
+static const struct snapshot_header *cache_update(time_t now);
+static const struct snapshot_entry *cache_find_internal(const struct snapshot_header *snapshot,
+		const char *key);
+static void cache_add_internal(struct prop_list *list, const char *key, const char *value);
+static void cache_repopulate_internal(struct prop_list *list, FILE *f);
+static void cache_repopulate_cmdline_internal(struct prop_list *list, const char *cmdline);
+
+static uint32_t prop_hash(const char *s, uint32_t h)
+{
+	/* FNV-1a */
+	while (*s)
+		h = (h ^ (unsigned char) *s++) * 16777619u;
 
-/* the inode/mtime of the prop cache, used for invalidation */
-static ino_t static_prop_inode;
-static time_t static_prop_mtime;
+	return h;
+}
 
+#define PROP_HASH_INIT 2166136261u
+
+static const uint32_t *snapshot_buckets(const struct snapshot_header *snapshot)
+{
+	return (const uint32_t *) (snapshot + 1);
+}
+
+static const struct snapshot_entry *snapshot_entries(const struct snapshot_header *snapshot)
+{
+	return (const struct snapshot_entry *) (snapshot_buckets(snapshot) + snapshot->nbuckets);
+}
+
+static const char *snapshot_string(const struct snapshot_header *snapshot, uint32_t offset)
+{
+	return (const char *) snapshot + offset;
+}
+
+/* private:
+ * returns the current snapshot. This is the fast path of every lookup:
+ * it only checks for changes of build.prop once per second.
+ */
+static const struct snapshot_header *cache_get_snapshot()
+{
+	const struct snapshot_header *snapshot = __atomic_load_n(&current_snapshot, __ATOMIC_ACQUIRE);
+	struct timespec now;
+
+	/* served from the vDSO, no system call */
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+
+	if (snapshot && __atomic_load_n(&last_check, __ATOMIC_RELAXED) == now.tv_sec)
+		return snapshot;
+
+	return cache_update(now.tv_sec);
+}
 
 /* public:
  * find a prop value from the file cache.
  *
  * the return value is the value of the given property key, or NULL if the
- * property key is not found. the returned value is owned by the caller,
- * and must be freed.
+ * property key is not found. the returned value points into the read-only
+ * snapshot and must not be modified or freed.
  */
 char *hybris_propcache_find(const char *key)
 {
-	char *ret = NULL;
+	const struct snapshot_header *snapshot;
+	const struct snapshot_entry *entry;
 
-	cache_update();
+	if (!key)
+		return NULL;
 
-	/* then look up the key and do a copy if we get a result */
-	struct hybris_prop_value *prop = cache_find_internal(key);
-	if (prop)
-		return prop->value;
+	snapshot = cache_get_snapshot();
+	entry = cache_find_internal(snapshot, key);
+	if (entry)
+		return (char *) snapshot_string(snapshot, entry->value);
 
-	return ret;
+	return NULL;
 }
 
 void hybris_propcache_list(hybris_propcache_list_cb cb, void *cookie)
 {
-	int n;
-	struct hybris_prop_value *current;
+	const struct snapshot_header *snapshot;
+	const struct snapshot_entry *entries;
+	uint32_t n;
 
 	if (!cb)
 		return;
 
-	cache_update();
+	snapshot = cache_get_snapshot();
+	entries = snapshot_entries(snapshot);
 
-	for (n = 0; n < max_prop; n++) {
-		current = &prop_array[n];
-		cb(current->key, current->value, cookie);
+	for (n = 0; n < snapshot->count; n++) {
+		cb(snapshot_string(snapshot, entries[n].key),
+			snapshot_string(snapshot, entries[n].value), cookie);
 	}
 }
 
-static void cache_update()
+/* private:
+ * find a given key in a snapshot.
+ */
+static const struct snapshot_entry *cache_find_internal(const struct snapshot_header *snapshot,
+		const char *key)
 {
-	struct stat st;
-	FILE *f = fopen("/system/build.prop", "r");
+	const struct snapshot_entry *entries = snapshot_entries(snapshot);
+	uint32_t hash = prop_hash(key, PROP_HASH_INIT);
+	uint32_t n = snapshot_buckets(snapshot)[hash & (snapshot->nbuckets - 1)];
 
-	if (!f)
-		return;
+	while (n) {
+		const struct snapshot_entry *entry = &entries[n - 1];
 
-	/* before searching, we must first determine whether our cache is valid. if
-	 * it isn't, we must discard our results and re-create the cache.
-	 *
-	 * we use fstat here to avoid a race between stat and something else
-	 * touching the file.
-	 */
-	if (fstat(fileno(f), &st) != 0) {
-		perror("cache_find can't stat build.prop");
-		goto out;
+		if (entry->hash == hash && strcmp(snapshot_string(snapshot, entry->key), key) == 0)
+			return entry;
+
+		n = entry->next;
+	}
+
+	return NULL;
+}
+
+static void cache_atfork_child()
+{
+	/* the inotify instance is shared with the parent, which would
+	 * consume the events. Set up a new one on the next check */
+	if (inotify_fd >= 0) {
+		close(inotify_fd);
+		inotify_fd = -1;
+		inotify_reinit = 1;
 	}
+	pthread_mutex_init(&snapshot_mutex, NULL);
+}
+
+static void cache_watch_init()
+{
+	char dir[PATH_MAX];
+	char *slash;
+
+	strncpy(dir, build_prop_path, sizeof(dir) - 1);
+	dir[sizeof(dir) - 1] = '\0';
+
+	slash = strrchr(dir, '/');
+	if (!slash)
+		strcpy(dir, ".");
+	else if (slash == dir)
+		dir[1] = '\0';
+	else
+		*slash = '\0';
+
+	/* watch the directory, so replacing build.prop by rename is seen */
+	inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotify_fd >= 0 && inotify_add_watch(inotify_fd, dir,
+			IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |
+			IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF) < 0) {
+		close(inotify_fd);
+		inotify_fd = -1;
+	}
+}
+
+static void cache_init()
+{
+	build_prop_path = getenv("HYBRIS_BUILD_PROP");
+	if (!build_prop_path)
+		build_prop_path = BUILD_PROP_PATH;
 
-	/* TODO: is there any better way to detect changes? */
-	if (static_prop_inode != st.st_ino ||
-		static_prop_mtime != st.st_mtime) {
-		static_prop_inode = st.st_ino;
-		static_prop_mtime = st.st_mtime;
+	snapshot_path = getenv("HYBRIS_PROPCACHE_SNAPSHOT");
+	if (!snapshot_path)
+		snapshot_path = SNAPSHOT_PATH;
 
-		/* cache is stale. fill it back up with fresh data first. */
-		cache_empty_internal();
-		cache_repopulate_internal(f);
-		cache_repopulate_cmdline_internal();
+	cache_watch_init();
+	pthread_atfork(NULL, NULL, cache_atfork_child);
+}
 
-		/* sort by keys */
-		qsort(prop_array, max_prop, sizeof(struct hybris_prop_value), prop_qcmp);
+/* private:
+ * drains the inotify events, returns whether one of them may concern
+ * build.prop. Without inotify every check is a possible change.
+ */
+static int cache_build_prop_touched()
+{
+	char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	const char *name = strrchr(build_prop_path, '/');
+	int touched = 0;
+	ssize_t len;
+
+	if (inotify_reinit) {
+		/* changes before the new watch was added would be lost */
+		inotify_reinit = 0;
+		cache_watch_init();
+		return 1;
 	}
 
-out:
-	fclose(f);
+	if (inotify_fd < 0)
+		return 1;
+
+	name = name ? name + 1 : build_prop_path;
+
+	while ((len = read(inotify_fd, buf, sizeof(buf))) > 0) {
+		char *ptr = buf;
+
+		while (ptr < buf + len) {
+			struct inotify_event *event = (struct inotify_event *) ptr;
+
+			if ((event->mask & (IN_Q_OVERFLOW | IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF)) ||
+				(event->len && strcmp(event->name, name) == 0))
+				touched = 1;
+
+			ptr += sizeof(struct inotify_event) + event->len;
+		}
+	}
+
+	/* the watch is gone, e.g. the directory was replaced */
+	if (len < 0 && errno != EAGAIN && errno != EINTR)
+		touched = 1;
+
+	return touched;
+}
+
+static int cache_matches_source(const struct snapshot_header *snapshot, const struct stat *st)
+{
+	return snapshot->source_dev == (uint64_t) st->st_dev &&
+		snapshot->source_ino == (uint64_t) st->st_ino &&
+		snapshot->source_size == (int64_t) st->st_size &&
+		snapshot->source_mtime == (int64_t) st->st_mtim.tv_sec &&
+		snapshot->source_mtime_nsec == (int64_t) st->st_mtim.tv_nsec;
 }
 
 /* private:
- * empties the prop cache, ready for repopulation
+ * reads the kernel command line, which is parsed by Android at init
+ * (on an Android working system).
  */
-static void cache_empty_internal()
+static void cache_read_cmdline(char *cmdline, size_t size)
 {
-	int i;
-	for (i = 0; i < max_prop; ++i) {
-		free(prop_array[i].key);
-		free(prop_array[i].value);
+	int fd;
+
+	fd = open("/proc/cmdline", O_RDONLY | O_CLOEXEC);
+	if (fd >= 0) {
+		int n = read(fd, cmdline, size - 1);
+		if (n < 0) n = 0;
+
+		/* get rid of trailing newline, it happens */
+		if (n > 0 && cmdline[n-1] == '\n') n--;
+
+		cmdline[n] = 0;
+		close(fd);
+	} else {
+		cmdline[0] = 0;
+	}
+}
+
+/* private:
+ * checks that a mapped snapshot file is intact, so lookups can trust
+ * all the offsets in it.
+ */
+static int cache_validate_snapshot(const struct snapshot_header *snapshot, size_t size)
+{
+	const struct snapshot_entry *entries;
+	size_t strings;
+	uint32_t n;
+
+	if (size < sizeof(*snapshot) || snapshot->magic != SNAPSHOT_MAGIC ||
+		snapshot->version != SNAPSHOT_VERSION || snapshot->size != size ||
+		snapshot->nbuckets == 0 || (snapshot->nbuckets & (snapshot->nbuckets - 1)) ||
+		snapshot->nbuckets > size / sizeof(uint32_t) ||
+		snapshot->count > size / sizeof(struct snapshot_entry))
+		return 0;
+
+	strings = sizeof(*snapshot) + snapshot->nbuckets * sizeof(uint32_t) +
+		snapshot->count * sizeof(struct snapshot_entry);
+	if (strings > size || (strings < size && ((const char *) snapshot)[size - 1] != '\0'))
+		return 0;
+
+	for (n = 0; n < snapshot->nbuckets; n++) {
+		if (snapshot_buckets(snapshot)[n] > snapshot->count)
+			return 0;
 	}
 
-	max_prop = 0;
+	entries = snapshot_entries(snapshot);
+	for (n = 0; n < snapshot->count; n++) {
+		if (entries[n].next > snapshot->count || entries[n].key < strings ||
+			entries[n].key >= size || entries[n].value < strings || entries[n].value >= size)
+			return 0;
+	}
+
+	return 1;
+}
+
+/* private:
+ * checks that nobody but root and us can change a snapshot file.
+ */
+static int cache_snapshot_trusted(int fd, struct stat *st)
+{
+	if (fstat(fd, st) != 0 || !S_ISREG(st->st_mode))
+		return 0;
+
+	if (st->st_uid != 0 && st->st_uid != geteuid())
+		return 0;
+
+	return (st->st_mode & (S_IWUSR | S_IWGRP | S_IWOTH)) == 0;
 }
 
 /* private:
- * compares two hybris_prop_value by key, so as to maintain a qsorted array of
- * props, and search the array.
+ * maps the snapshot file if it was compiled from the given build.prop
+ */
+static const struct snapshot_header *cache_map_snapshot(const struct stat *source,
+		uint32_t input_hash)
+{
+	const struct snapshot_header *snapshot;
+	struct stat st;
+	int fd;
+
+	fd = open(snapshot_path, O_RDONLY | O_CLOEXEC | O_NOFOLLOW);
+	if (fd < 0)
+		return NULL;
+
+	if (!cache_snapshot_trusted(fd, &st) || st.st_size < (off_t) sizeof(*snapshot)) {
+		close(fd);
+		return NULL;
+	}
+
+	snapshot = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (snapshot == MAP_FAILED)
+		return NULL;
+
+	if (!cache_validate_snapshot(snapshot, st.st_size) ||
+		snapshot->input_hash != input_hash || !cache_matches_source(snapshot, source)) {
+		munmap((void *) snapshot, st.st_size);
+		return NULL;
+	}
+
+	return snapshot;
+}
+
+/* private:
+ * compares two hybris_prop_value by key, and by order of appearance
+ * for duplicate keys.
  */
 static int prop_qcmp(const void *a, const void *b)
 {
 	struct hybris_prop_value *aa = (struct hybris_prop_value *)a;
 	struct hybris_prop_value *bb = (struct hybris_prop_value *)b;
+	int ret = strcmp(aa->key, bb->key);
+
+	if (ret == 0)
+		ret = aa->seq < bb->seq ? -1 : aa->seq > bb->seq;
 
-	return strcmp(aa->key, bb->key);
+	return ret;
 }
 
 /* private:
- * find a given key in the in-memory prop cache.
- *
- * returns the value of the given property key, or NULL if the property is not
- * found. Note that this does not pass ownership of the hybris_prop_value or the
- * data inside it.
+ * lays out the properties in a list as a snapshot in a malloc()ed buffer.
  */
-static struct hybris_prop_value *cache_find_internal(const char *key)
+static struct snapshot_header *cache_compile(struct prop_list *list, const struct stat *source,
+		uint32_t input_hash)
 {
-	struct hybris_prop_value prop_key;
-	prop_key.key = (char*)key;
+	struct snapshot_header *snapshot;
+	struct snapshot_entry *entries;
+	uint32_t *buckets;
+	uint32_t nbuckets = 1, count = 0, n;
+	size_t size, strings;
+	char *ptr;
+
+	qsort(list->props, list->count, sizeof(struct hybris_prop_value), prop_qcmp);
+
+	/* preserve current behavior of first prop key => match */
+	strings = 0;
+	for (n = 0; n < list->count; n++) {
+		if (n > 0 && strcmp(list->props[n].key, list->props[n - 1].key) == 0)
+			continue;
+		list->props[count++] = list->props[n];
+		strings += strlen(list->props[n].key) + strlen(list->props[n].value) + 2;
+	}
+	list->count = count;
+
+	while (nbuckets < count)
+		nbuckets <<= 1;
+
+	size = sizeof(*snapshot) + nbuckets * sizeof(uint32_t) +
+		count * sizeof(struct snapshot_entry) + strings;
+	if (size > UINT32_MAX)
+		return NULL;
+
+	snapshot = calloc(1, size);
+	if (!snapshot)
+		return NULL;
+
+	snapshot->magic = SNAPSHOT_MAGIC;
+	snapshot->version = SNAPSHOT_VERSION;
+	snapshot->size = size;
+	snapshot->count = count;
+	snapshot->nbuckets = nbuckets;
+	snapshot->input_hash = input_hash;
+	snapshot->source_dev = source->st_dev;
+	snapshot->source_ino = source->st_ino;
+	snapshot->source_size = source->st_size;
+	snapshot->source_mtime = source->st_mtim.tv_sec;
+	snapshot->source_mtime_nsec = source->st_mtim.tv_nsec;
+
+	buckets = (uint32_t *) snapshot_buckets(snapshot);
+	entries = (struct snapshot_entry *) snapshot_entries(snapshot);
+	ptr = (char *) &entries[count];
+
+	/* link the entries in reverse, so that the chains are in key order */
+	for (n = count; n-- > 0;) {
+		struct snapshot_entry *entry = &entries[n];
+
+		entry->hash = prop_hash(list->props[n].key, PROP_HASH_INIT);
+		entry->next = buckets[entry->hash & (nbuckets - 1)];
+		buckets[entry->hash & (nbuckets - 1)] = n + 1;
+	}
+
+	for (n = 0; n < count; n++) {
+		size_t len;
+
+		len = strlen(list->props[n].key) + 1;
+		memcpy(ptr, list->props[n].key, len);
+		entries[n].key = ptr - (char *) snapshot;
+		ptr += len;
 
-	return bsearch(&prop_key, prop_array, max_prop, sizeof(struct hybris_prop_value), prop_qcmp);
+		len = strlen(list->props[n].value) + 1;
+		memcpy(ptr, list->props[n].value, len);
+		entries[n].value = ptr - (char *) snapshot;
+		ptr += len;
+	}
+
+	return snapshot;
+}
+
+/* private:
+ * replaces the snapshot file with a compiled snapshot and maps it. Returns
+ * NULL if the file can't be written, e.g. because it's owned by another
+ * user.
+ */
+static const struct snapshot_header *cache_store_snapshot(const struct snapshot_header *compiled)
+{
+	char tmp[PATH_MAX];
+	const struct snapshot_header *snapshot;
+	struct stat st;
+	size_t done = 0;
+	int fd;
+
+	if (snprintf(tmp, sizeof(tmp), "%s.XXXXXX", snapshot_path) >= (int) sizeof(tmp))
+		return NULL;
+
+	fd = mkstemp(tmp);
+	if (fd < 0)
+		return NULL;
+
+	fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+	while (done < compiled->size) {
+		ssize_t r = write(fd, (const char *) compiled + done, compiled->size - done);
+		if (r < 0 && errno == EINTR)
+			continue;
+		if (r <= 0)
+			goto fail;
+		done += r;
+	}
+
+	/* properties are world readable anyway, and nobody may change them
+	 * once the file is in place */
+	if (fchmod(fd, 0444) != 0 || !cache_snapshot_trusted(fd, &st) ||
+		st.st_size != (off_t) compiled->size)
+		goto fail;
+
+	snapshot = mmap(NULL, compiled->size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (snapshot == MAP_FAILED)
+		goto fail;
+
+	if (rename(tmp, snapshot_path) != 0) {
+		munmap((void *) snapshot, compiled->size);
+		goto fail;
+	}
+
+	close(fd);
+	return snapshot;
+
+fail:
+	close(fd);
+	unlink(tmp);
+	return NULL;
+}
+
+static void cache_free_list(struct prop_list *list)
+{
+	unsigned int n;
+
+	for (n = 0; n < list->count; n++) {
+		free(list->props[n].key);
+		free(list->props[n].value);
+	}
+	free(list->props);
 }
 
 /* private:
- * add a given property to the in-memory prop cache for later retrieval.
+ * makes the snapshot of the given build.prop current, mapping the
+ * snapshot file if it's up to date and compiling a new one otherwise.
+ */
+static void cache_refresh_internal(FILE *f, const struct stat *st)
+{
+	char cmdline[1024];
+	struct prop_list list = { NULL, 0, 0 };
+	struct snapshot_header *compiled;
+	const struct snapshot_header *snapshot;
+	uint32_t input_hash;
+
+	cache_read_cmdline(cmdline, sizeof(cmdline));
+	input_hash = prop_hash(cmdline, prop_hash(build_prop_path, PROP_HASH_INIT));
+
+	snapshot = cache_map_snapshot(st, input_hash);
+	if (!snapshot) {
+		cache_repopulate_internal(&list, f);
+		cache_repopulate_cmdline_internal(&list, cmdline);
+
+		compiled = cache_compile(&list, st, input_hash);
+		cache_free_list(&list);
+		if (!compiled)
+			return;
+
+		snapshot = cache_store_snapshot(compiled);
+		if (snapshot)
+			free(compiled);
+		else
+			snapshot = compiled;
+	}
+
+	__atomic_store_n(&current_snapshot, snapshot, __ATOMIC_RELEASE);
+}
+
+/* private:
+ * the slow path of cache_get_snapshot, checks whether build.prop changed
+ * and updates the snapshot.
+ */
+static const struct snapshot_header *cache_update(time_t now)
+{
+	const struct snapshot_header *snapshot;
+	struct stat st;
+	FILE *f;
+
+	pthread_once(&snapshot_once, cache_init);
+	pthread_mutex_lock(&snapshot_mutex);
+
+	snapshot = current_snapshot;
+	if (snapshot && last_check == now)
+		goto out;
+
+	__atomic_store_n(&last_check, now, __ATOMIC_RELAXED);
+
+	if (snapshot && !cache_build_prop_touched())
+		goto out;
+
+	f = fopen(build_prop_path, "re");
+	if (!f) {
+		/* keep what we have, if anything */
+		if (!snapshot)
+			__atomic_store_n(&current_snapshot, &empty_snapshot.header, __ATOMIC_RELEASE);
+		goto out;
+	}
+
+	/* we use fstat here to avoid a race between stat and something else
+	 * touching the file.
+	 */
+	if (fstat(fileno(f), &st) != 0) {
+		perror("cache_find can't stat build.prop");
+	} else if (!snapshot || !cache_matches_source(snapshot, &st)) {
+		/* cache is stale. fill it back up with fresh data. */
+		cache_refresh_internal(f, &st);
+	}
+
+	fclose(f);
+
+out:
+	snapshot = current_snapshot;
+	pthread_mutex_unlock(&snapshot_mutex);
+	return snapshot;
+}
+
+/* private:
+ * add a given property to the list of properties of a new snapshot.
  *
  * both `key' and `value' are copied from the caller.
  */
-static void cache_add_internal(const char *key, const char *value)
+static void cache_add_internal(struct prop_list *list, const char *key, const char *value)
 {
 	/* Skip values that can be bigger than value max */
 	if (strlen(value) >= PROP_VALUE_MAX -1)
 		return;
 
-	/* preserve current behavior of first prop key => match */
-	if (cache_find_internal(key))
-		return;
+	if (list->count == list->alloc) {
+		unsigned int alloc = list->alloc ? 2 * list->alloc : 256;
+		struct hybris_prop_value *props = realloc(list->props,
+				alloc * sizeof(struct hybris_prop_value));
+
+		if (!props)
+			return;
 
-	prop_array[max_prop].key = strdup(key);
-	prop_array[max_prop++].value = strdup(value);
+		list->props = props;
+		list->alloc = alloc;
+	}
+
+	list->props[list->count].key = strdup(key);
+	list->props[list->count].value = strdup(value);
+	list->props[list->count].seq = list->count;
 
-	if (max_prop >= MAX_PROPS) {
-		fprintf(stderr, "libhybris: ran out of props, increase MAX_PROPS");
-		exit(1);
+	if (!list->props[list->count].key || !list->props[list->count].value) {
+		free(list->props[list->count].key);
+		free(list->props[list->count].value);
+		return;
 	}
+
+	list->count++;
 }
 
 /* private:
- * repopulates the prop cache from a given file `f'.
+ * populates the prop list from a given file `f'.
  */
-static void cache_repopulate_internal(FILE *f)
+static void cache_repopulate_internal(struct prop_list *list, FILE *f)
 {
 	char buf[1024];
 	char *mkey, *value;
@@ -220,34 +762,20 @@ static void cache_repopulate_internal(FILE *f)
 		if (!value)
 			continue;
 
-		cache_add_internal(mkey, value);
+		cache_add_internal(list, mkey, value);
 	}
 }
 
 /* private:
- * repopulate the prop cache from /proc/cmdline
+ * populates the prop list from the kernel command line
  */
-static void cache_repopulate_cmdline_internal()
+static void cache_repopulate_cmdline_internal(struct prop_list *list, const char *kernel_cmdline)
 {
-	/* Find a key value from the kernel command line, which is parsed
-	 * by Android at init (on an Android working system) */
 	char cmdline[1024];
 	char *ptr;
-	int fd;
 
-	fd = open("/proc/cmdline", O_RDONLY);
-	if (fd >= 0) {
-		int n = read(fd, cmdline, 1023);
-		if (n < 0) n = 0;
-
-		/* get rid of trailing newline, it happens */
-		if (n > 0 && cmdline[n-1] == '\n') n--;
-
-		cmdline[n] = 0;
-		close(fd);
-	} else {
-		cmdline[0] = 0;
-	}
+	strncpy(cmdline, kernel_cmdline, sizeof(cmdline) - 1);
+	cmdline[sizeof(cmdline) - 1] = '\0';
 
 	ptr = cmdline;
 
@@ -270,7 +798,7 @@ static void cache_repopulate_cmdline_internal()
 			char prop[PROP_NAME_MAX];
 			snprintf(prop, sizeof(prop) -1, "ro.%s", boot_prop_name);
 
-			cache_add_internal(prop, value);
+			cache_add_internal(list, prop, value);
 		}
 	}
 }
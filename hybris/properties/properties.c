@@ -34,6 +34,7 @@
 #include <sys/types.h>
 #include <netinet/in.h>
 #include <poll.h>
+#include <pthread.h>
 
 #include <hybris/properties/properties.h>
 #include "properties_p.h"
@@ -42,10 +43,29 @@
 static const char property_service_socket[] = "/dev/socket/" PROP_SERVICE_NAME;
 static int send_prop_msg_no_reply = 0;
 
-/* Get/Set a property from the Android Init property socket */
-static int send_prop_msg(prop_msg_t *msg,
-		void (*propfn)(const char *, const char *, void *),
-		void *cookie)
+/* Maximum number of requests sent in one go by property_get_batch */
+#define PROP_BATCH_MAX 32
+
+/* A persistent connection to the property service, see PROP_MSG_SESSION.
+ * Every thread has its own, so lookups of different threads don't wait
+ * for each other.
+ */
+struct prop_session {
+	int fd;
+	unsigned int generation;
+};
+
+/* 0 while unknown, 1 if the property service keeps sessions open,
+ * -1 if it doesn't and every request needs its own connection */
+static int session_support = 0;
+/* changes in forked children, which must not use the connections
+ * they inherited */
+static unsigned int session_generation = 0;
+static pthread_key_t session_key;
+static pthread_once_t session_once = PTHREAD_ONCE_INIT;
+
+/* Connect to the Android Init property socket */
+static int prop_connect(void)
 {
 	union {
 		struct sockaddr_un addr;
@@ -53,6 +73,193 @@ static int send_prop_msg(prop_msg_t *msg,
 	} addr;
 	socklen_t alen;
 	size_t namelen;
+	const char *socket_path;
+	int s;
+
+	s = socket(AF_LOCAL, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (s < 0) {
+		return -1;
+	}
+
+	/* Allow tests to talk to a property service of their own */
+	socket_path = getenv("HYBRIS_PROPERTY_SERVICE_SOCKET");
+	if (!socket_path)
+		socket_path = property_service_socket;
+
+	memset(&addr, 0, sizeof(addr));
+	namelen = strlen(socket_path);
+	if (namelen >= sizeof(addr.addr.sun_path)) {
+		close(s);
+		return -1;
+	}
+	strncpy(addr.addr.sun_path, socket_path,
+			sizeof(addr.addr.sun_path));
+	addr.addr.sun_family = AF_LOCAL;
+	alen = namelen + offsetof(struct sockaddr_un, sun_path) + 1;
+
+	if (TEMP_FAILURE_RETRY(connect(s, &addr.addr_g, alen) < 0)) {
+		close(s);
+		return -1;
+	}
+
+	return s;
+}
+
+static int prop_send_all(int s, const void *buf, size_t len)
+{
+	while (len > 0) {
+		ssize_t r = TEMP_FAILURE_RETRY(send(s, buf, len, MSG_NOSIGNAL));
+		if (r <= 0)
+			return -1;
+		buf = (const char *) buf + r;
+		len -= r;
+	}
+
+	return 0;
+}
+
+static int prop_recv_all(int s, void *buf, size_t len)
+{
+	while (len > 0) {
+		ssize_t r = TEMP_FAILURE_RETRY(recv(s, buf, len, 0));
+		if (r <= 0)
+			return -1;
+		buf = (char *) buf + r;
+		len -= r;
+	}
+
+	return 0;
+}
+
+static void prop_session_destroy(void *data)
+{
+	struct prop_session *session = data;
+
+	if (session->fd >= 0)
+		close(session->fd);
+	free(session);
+}
+
+static void prop_session_atfork_child(void)
+{
+	session_generation++;
+}
+
+static void prop_session_init(void)
+{
+	if (pthread_key_create(&session_key, prop_session_destroy) != 0) {
+		session_support = -1;
+		return;
+	}
+
+	pthread_atfork(NULL, NULL, prop_session_atfork_child);
+}
+
+/* Returns the connected session of the calling thread, or NULL if the
+ * property service doesn't support sessions or can't be reached */
+static struct prop_session *prop_session_get(void)
+{
+	struct prop_session *session;
+	prop_msg_t msg;
+	int s;
+
+	if (__atomic_load_n(&session_support, __ATOMIC_RELAXED) < 0)
+		return NULL;
+
+	pthread_once(&session_once, prop_session_init);
+
+	session = pthread_getspecific(session_key);
+	if (!session) {
+		session = malloc(sizeof(*session));
+		if (!session)
+			return NULL;
+		session->fd = -1;
+		if (pthread_setspecific(session_key, session) != 0) {
+			free(session);
+			return NULL;
+		}
+	}
+
+	if (session->fd >= 0 && session->generation != session_generation) {
+		/* inherited from the parent process, leave it to the parent */
+		close(session->fd);
+		session->fd = -1;
+	}
+
+	if (session->fd >= 0)
+		return session;
+
+	s = prop_connect();
+	if (s < 0)
+		return NULL;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.cmd = PROP_MSG_SESSION;
+
+	if (prop_send_all(s, &msg, sizeof(msg)) < 0 ||
+			prop_recv_all(s, &msg, sizeof(msg)) < 0 ||
+			msg.cmd != PROP_MSG_SESSION) {
+		/* an init which doesn't know about sessions closes the
+		 * connection, stick to one connection per request */
+		__atomic_store_n(&session_support, -1, __ATOMIC_RELAXED);
+		close(s);
+		return NULL;
+	}
+
+	__atomic_store_n(&session_support, 1, __ATOMIC_RELAXED);
+	session->fd = s;
+	session->generation = session_generation;
+	return session;
+}
+
+/* Sends count requests in one go over the session of the calling thread,
+ * waits for their replies and replaces every GETPROP in msgs with its
+ * reply. A SETPROP is answered once the property has been set, so the
+ * new value is visible to everybody when this returns. */
+static int prop_session_request(prop_msg_t *msgs, int count)
+{
+	prop_msg_t replies[PROP_BATCH_MAX];
+	struct prop_session *session;
+	int attempt, n;
+
+	if (count > PROP_BATCH_MAX)
+		return -1;
+
+	for (attempt = 0; attempt < 2; attempt++) {
+		session = prop_session_get();
+		if (!session)
+			return -1;
+
+		if (prop_send_all(session->fd, msgs, count * sizeof(prop_msg_t)) == 0 &&
+				prop_recv_all(session->fd, replies, count * sizeof(prop_msg_t)) == 0) {
+			for (n = 0; n < count; n++) {
+				if (replies[n].cmd != msgs[n].cmd ||
+						strncmp(replies[n].name, msgs[n].name, PROP_NAME_MAX) != 0)
+					break;
+			}
+
+			if (n == count) {
+				for (n = 0; n < count; n++) {
+					if (msgs[n].cmd == PROP_MSG_GETPROP)
+						msgs[n] = replies[n];
+				}
+				return 0;
+			}
+		}
+
+		/* the service may have closed an idle session, reconnect once */
+		close(session->fd);
+		session->fd = -1;
+	}
+
+	return -1;
+}
+
+/* Get/Set a property from the Android Init property socket */
+static int send_prop_msg(prop_msg_t *msg,
+		void (*propfn)(const char *, const char *, void *),
+		void *cookie)
+{
 	int s;
 	int r;
 	int result = -1;
@@ -65,24 +272,12 @@ static int send_prop_msg(prop_msg_t *msg,
 	if (send_prop_msg_no_reply == 1)
 		return -EIO;
 
-	s = socket(AF_LOCAL, SOCK_STREAM, 0);
+	s = prop_connect();
 	if (s < 0) {
 		return result;
 	}
 
-	memset(&addr, 0, sizeof(addr));
-	namelen = strlen(property_service_socket);
-	strncpy(addr.addr.sun_path, property_service_socket,
-			sizeof(addr.addr.sun_path));
-	addr.addr.sun_family = AF_LOCAL;
-	alen = namelen + offsetof(struct sockaddr_un, sun_path) + 1;
-
-	if (TEMP_FAILURE_RETRY(connect(s, &addr.addr_g, alen) < 0)) {
-		close(s);
-		return result;
-	}
-
-	r = TEMP_FAILURE_RETRY(send(s, msg, sizeof(prop_msg_t), 0));
+	r = TEMP_FAILURE_RETRY(send(s, msg, sizeof(prop_msg_t), MSG_NOSIGNAL));
 
 	if (r == sizeof(prop_msg_t)) {
 		// We successfully wrote to the property server, so use recv
@@ -131,6 +326,19 @@ int property_list(void (*propfn)(const char *key, const char *value, void *cooki
 	return 0;
 }
 
+static int property_get_reply(prop_msg_t *msg, char *value, const char *default_value)
+{
+	/* In case it's null, just use the default */
+	if ((strlen(msg->value) == 0) && (default_value)) {
+		if (strlen(default_value) > PROP_VALUE_MAX -1)	return -1;
+		strcpy(msg->value, default_value);
+	}
+
+	strcpy(value, msg->value);
+
+	return 0;
+}
+
 static int property_get_socket(const char *key, char *value, const char *default_value)
 {
 	int err;
@@ -141,42 +349,37 @@ static int property_get_socket(const char *key, char *value, const char *default
 
 	if (key) {
 		strncpy(msg.name, key, sizeof(msg.name));
-		err = send_prop_msg(&msg, NULL, NULL);
+		err = prop_session_request(&msg, 1);
+		if (err < 0)
+			err = send_prop_msg(&msg, NULL, NULL);
 		if (err < 0)
 			return err;
 	}
 
-	/* In case it's null, just use the default */
-	if ((strlen(msg.value) == 0) && (default_value)) {
-		if (strlen(default_value) > PROP_VALUE_MAX -1)	return -1;
-		strcpy(msg.value, default_value);
-	}
-
-	strcpy(value, msg.value);
-
-	return 0;
+	return property_get_reply(&msg, value, default_value);
 }
 
 int property_get(const char *key, char *value, const char *default_value)
 {
 	char *ret = NULL;
+	unsigned int generation;
 
 	if ((key) && (strlen(key) > PROP_NAME_MAX -1)) return -1;
 	if (value == NULL) return -1;
 
 
-	// Runtime cache will serialize property lookups within the process.
-	// This will increase latency if multiple threads are doing many
-	// parallel lookups to new properties, but the overhead should
-	// be offset with the caching eventually.
-	runtime_cache_lock();
+	// Lookups in the runtime cache don't take any locks, and misses
+	// don't hold any lock while they talk to the property service,
+	// so threads looking up different properties don't wait for
+	// each other. A property_set invalidating the key meanwhile
+	// bumps its generation, and the fetched value isn't cached.
+	generation = runtime_cache_generation(key);
 	if (runtime_cache_get(key, value) == 0) {
 		ret = value;
 	} else if (property_get_socket(key, value, default_value) == 0) {
-		runtime_cache_insert(key, value);
+		runtime_cache_insert(key, value, generation);
 		ret = value;
 	}
-	runtime_cache_unlock();
 
 	if (ret)
 		return strlen(ret);
@@ -198,6 +401,59 @@ int property_get(const char *key, char *value, const char *default_value)
 	return 0;
 }
 
+int property_get_batch(const char * const *keys, char **values,
+		const char * const *default_values, int count)
+{
+	prop_msg_t msgs[PROP_BATCH_MAX];
+	unsigned int generations[PROP_BATCH_MAX];
+	int index[PROP_BATCH_MAX];
+	int i, n, pending;
+
+	if (count < 0 || (count > 0 && (!keys || !values)))
+		return -1;
+
+	for (i = 0; i < count; i++) {
+		if (!keys[i] || strlen(keys[i]) > PROP_NAME_MAX -1 || !values[i])
+			return -1;
+	}
+
+	for (i = 0; i < count; ) {
+		/* collect the misses of the runtime cache */
+		for (pending = 0; i < count && pending < PROP_BATCH_MAX; i++) {
+			generations[pending] = runtime_cache_generation(keys[i]);
+			if (runtime_cache_get(keys[i], values[i]) == 0)
+				continue;
+
+			memset(&msgs[pending], 0, sizeof(prop_msg_t));
+			msgs[pending].cmd = PROP_MSG_GETPROP;
+			strncpy(msgs[pending].name, keys[i], sizeof(msgs[pending].name));
+			index[pending++] = i;
+		}
+
+		if (pending == 0)
+			continue;
+
+		if (prop_session_request(msgs, pending) == 0) {
+			for (n = 0; n < pending; n++) {
+				const char *default_value = default_values ? default_values[index[n]] : NULL;
+
+				if (property_get_reply(&msgs[n], values[index[n]], default_value) == 0)
+					runtime_cache_insert(keys[index[n]], values[index[n]], generations[n]);
+				else
+					property_get(keys[index[n]], values[index[n]], default_value);
+			}
+		} else {
+			/* one request at a time, or the file cache */
+			for (n = 0; n < pending; n++) {
+				property_get(keys[index[n]], values[index[n]],
+						default_values ? default_values[index[n]] : NULL);
+			}
+		}
+	}
+
+	return 0;
+}
+
 int property_set(const char *key, const char *value)
 {
 	int err;
@@ -208,16 +464,20 @@ int property_set(const char *key, const char *value)
 	if (strlen(key) > PROP_NAME_MAX -1) return -1;
 	if (strlen(value) > PROP_VALUE_MAX -1) return -1;
 
-	runtime_cache_lock();
-	runtime_cache_remove(key);
-	runtime_cache_unlock();
-
 	memset(&msg, 0, sizeof(msg));
 	msg.cmd = PROP_MSG_SETPROP;
 	strncpy(msg.name, key, sizeof(msg.name));
 	strncpy(msg.value, value, sizeof(msg.value));
 
-	err = send_prop_msg(&msg, NULL, NULL);
+	/* both wait until the service has set the property */
+	err = prop_session_request(&msg, 1);
+	if (err < 0)
+		err = send_prop_msg(&msg, NULL, NULL);
+
+	/* only now, a lookup racing with the request may still have
+	 * fetched and cached the old value */
+	runtime_cache_remove(key);
+
 	if (err < 0) {
 		return err;
 	}
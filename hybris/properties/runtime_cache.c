@@ -21,12 +21,15 @@
  */
 
 #include <stdlib.h>
-#include <assert.h>
+#include <stdint.h>
 #include <errno.h>
 #include <string.h>
 #include <time.h>
 #include <pthread.h>
 
+#include <hybris/properties/properties.h>
+#include "properties_p.h"
+
 
 #define HYBRIS_PROPERTY_CACHE_DEFAULT_TIMEOUT_SECS 10
 
@@ -35,46 +38,51 @@
 */
 static time_t runtime_cache_timeout_secs = HYBRIS_PROPERTY_CACHE_DEFAULT_TIMEOUT_SECS;
 
+/** Number of hash buckets. The table never grows, a device has a few
+	hundred properties at most, so chains stay short.
+*/
+#define RUNTIME_CACHE_BUCKETS 512
+
+/** Key, value pair and the time (in seconds) after which the value is
+	considered stale. An expiry of 0 marks an invalidated entry.
 
-/** Key, value pair and the time of previous update (in seconds) */
+	Entries are never freed. Once an entry is linked into its bucket,
+	its key and next pointer never change, so readers can walk the
+	chains without any locking. The value and the expiry are protected
+	by the seqlock in seq: writers make it odd while they update them,
+	readers retry if it was odd or changed while they copied them.
+*/
 struct hybris_prop_value
 {
-	char *key;
-	char *value;
-	time_t last_update;
+	struct hybris_prop_value *next;
+	unsigned int seq;
+	time_t expires;
+	char key[PROP_NAME_MAX];
+	char value[PROP_VALUE_MAX];
 };
 
-static struct hybris_prop_value * prop_array = 0;
-static int num_prop = 0;
-static int num_alloc = 0;
-
-/** Protect access to statics */
-static pthread_mutex_t array_mutex = PTHREAD_MUTEX_INITIALIZER;
-
-/* private:
- * compares two hybris_prop_value by key, so as to maintain a qsorted array of
- * props, and search the array.
- */
-static int prop_qcmp(const void *a, const void *b)
-{
-	struct hybris_prop_value *aa = (struct hybris_prop_value *)a;
-	struct hybris_prop_value *bb = (struct hybris_prop_value *)b;
-
-	return strcmp(aa->key, bb->key);
-}
-
-static struct hybris_prop_value *cache_find_internal(const char *key)
+/** The generation of a bucket counts the invalidations of its keys.
+	Misses don't hold any lock while they fetch a property, so an
+	invalidation can happen in the meantime; the generation tells
+	runtime_cache_insert to drop a value fetched before it.
+*/
+struct hybris_prop_bucket
 {
-	struct hybris_prop_value prop_key;
-	prop_key.key = (char*)key;
+	struct hybris_prop_value *head;
+	unsigned int generation;
+	/** Serializes writers of the bucket, readers never take it */
+	pthread_mutex_t mutex;
+} __attribute__((aligned(64)));
 
-	return bsearch(&prop_key, prop_array, num_prop, sizeof(struct hybris_prop_value), prop_qcmp);
-}
+static struct hybris_prop_bucket buckets[RUNTIME_CACHE_BUCKETS];
+static pthread_once_t runtime_cache_once = PTHREAD_ONCE_INIT;
 
 static void runtime_cache_init()
 {
-	num_alloc = 8;
-	prop_array = malloc(num_alloc * sizeof(struct hybris_prop_value));
+	int i;
+
+	for (i = 0; i < RUNTIME_CACHE_BUCKETS; i++)
+		pthread_mutex_init(&buckets[i].mutex, NULL);
 
 	const char *timeout_str = getenv("HYBRIS_PROPERTY_CACHE_TIMEOUT_SECS");
 	if (timeout_str) {
@@ -84,97 +92,169 @@ static void runtime_cache_init()
 
 static void runtime_cache_ensure_initialized()
 {
-	if (!prop_array) {
-		runtime_cache_init();
-	}
+	pthread_once(&runtime_cache_once, runtime_cache_init);
 }
 
-/** Invalidate an entry in the cache
-  *
-  * Cache will never shrink. Instead, assume that the same key
-  * will be queried soon after invalidation and reuse the entry.
-  */
-static void runtime_cache_invalidate_entry(struct hybris_prop_value *entry)
+static struct hybris_prop_bucket *runtime_cache_bucket(const char *key)
 {
-	free(entry->value);
-	entry->value = NULL;
+	/* FNV-1a */
+	uint32_t h = 2166136261u;
+
+	while (*key)
+		h = (h ^ (unsigned char) *key++) * 16777619u;
+
+	return &buckets[h % RUNTIME_CACHE_BUCKETS];
 }
 
-static int runtime_cache_get_impl(const char *key, char *value)
+static struct hybris_prop_value *cache_find_internal(struct hybris_prop_bucket *bucket,
+		const char *key)
 {
-	int ret = -ENOENT;
-
-	struct hybris_prop_value *entry = cache_find_internal(key);
-	if (entry != NULL && entry->value != NULL) {
-		struct timespec now;
-		clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
-		time_t delta_secs = now.tv_sec - entry->last_update;
-		if (delta_secs > runtime_cache_timeout_secs) {
-			// assume the data in cache is stale, and force refresh
-			runtime_cache_invalidate_entry(entry);
-		} else {
-			// success, return value from cache
-			strcpy(value, entry->value);
-			ret = 0;
-		}
-	}
+	struct hybris_prop_value *entry = __atomic_load_n(&bucket->head, __ATOMIC_ACQUIRE);
+
+	while (entry && strcmp(entry->key, key) != 0)
+		entry = entry->next;
 
-	return ret;
+	return entry;
 }
 
-static void runtime_cache_insert_impl(const char *key, char *value)
+static time_t runtime_cache_now()
 {
 	struct timespec now;
 	clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+	return now.tv_sec;
+}
 
-	struct hybris_prop_value *entry = cache_find_internal(key);
-	if (entry) {
-		assert(entry->value == NULL);
-		// key,value pair was invalidated earlier,
-		// reuse entry in the property array
-		entry->value = strdup(value);
-		entry->last_update = now.tv_sec;
-	} else {
-		if (num_alloc == num_prop) {
-			num_alloc = 3 * num_alloc / 2;
-			prop_array = realloc(prop_array, num_alloc * sizeof(struct hybris_prop_value));
-		}
+/* Must be called with the mutex of the bucket of the entry held */
+static void runtime_cache_write_entry(struct hybris_prop_value *entry,
+		const char *value, time_t expires)
+{
+	unsigned int seq = entry->seq;
 
-		struct hybris_prop_value new_entry = { strdup(key), strdup(value), now.tv_sec };
-		prop_array[num_prop++] = new_entry;
+	__atomic_store_n(&entry->seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
 
-		qsort(prop_array, num_prop, sizeof(struct hybris_prop_value), prop_qcmp);
+	if (value) {
+		strncpy(entry->value, value, PROP_VALUE_MAX - 1);
+		entry->value[PROP_VALUE_MAX - 1] = '\0';
 	}
-}
+	entry->expires = expires;
 
-
-void runtime_cache_lock()
-{
-	pthread_mutex_lock(&array_mutex);
+	__atomic_store_n(&entry->seq, seq + 2, __ATOMIC_RELEASE);
 }
 
-void runtime_cache_unlock()
+/** Invalidate an entry in the cache
+  *
+  * Cache will never shrink. Instead, assume that the same key
+  * will be queried soon after invalidation and reuse the entry.
+  */
+void runtime_cache_remove(const char *key)
 {
-	pthread_mutex_unlock(&array_mutex);
+	struct hybris_prop_bucket *bucket;
+	struct hybris_prop_value *entry;
+
+	if (!key)
+		return;
+
+	runtime_cache_ensure_initialized();
+	bucket = runtime_cache_bucket(key);
+
+	pthread_mutex_lock(&bucket->mutex);
+	// also if the key isn't cached yet, a miss may be fetching it
+	__atomic_store_n(&bucket->generation, bucket->generation + 1, __ATOMIC_RELEASE);
+	entry = cache_find_internal(bucket, key);
+	if (entry)
+		runtime_cache_write_entry(entry, NULL, 0);
+	pthread_mutex_unlock(&bucket->mutex);
 }
 
-void runtime_cache_remove(const char *key)
+/** Returns the generation to pass to runtime_cache_insert, to be
+  * taken before the property is fetched
+  */
+unsigned int runtime_cache_generation(const char *key)
 {
+	if (!key)
+		return 0;
+
 	runtime_cache_ensure_initialized();
-	struct hybris_prop_value *entry = cache_find_internal(key);
-	if (entry) {
-		runtime_cache_invalidate_entry(entry);
-	}
+
+	return __atomic_load_n(&runtime_cache_bucket(key)->generation, __ATOMIC_ACQUIRE);
 }
 
 int runtime_cache_get(const char *key, char *value)
 {
+	char buf[PROP_VALUE_MAX];
+	struct hybris_prop_value *entry;
+	unsigned int seq;
+	time_t expires;
+
+	if (!key)
+		return -ENOENT;
+
 	runtime_cache_ensure_initialized();
-	return runtime_cache_get_impl(key, value);
+
+	entry = cache_find_internal(runtime_cache_bucket(key), key);
+	if (!entry)
+		return -ENOENT;
+
+	do {
+		seq = __atomic_load_n(&entry->seq, __ATOMIC_ACQUIRE);
+		if (seq & 1)
+			continue;
+
+		expires = entry->expires;
+		memcpy(buf, entry->value, sizeof(buf));
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	} while ((seq & 1) || __atomic_load_n(&entry->seq, __ATOMIC_RELAXED) != seq);
+
+	// an expired entry is left as it is, the caller fetches the
+	// property again and refreshes it with runtime_cache_insert
+	if (expires == 0 || runtime_cache_now() > expires)
+		return -ENOENT;
+
+	buf[PROP_VALUE_MAX - 1] = '\0';
+	strcpy(value, buf);
+	return 0;
 }
 
-void runtime_cache_insert(const char *key, char *value)
+void runtime_cache_insert(const char *key, char *value, unsigned int generation)
 {
+	struct hybris_prop_bucket *bucket;
+	struct hybris_prop_value *entry;
+	time_t expires;
+
+	if (!key)
+		return;
+
 	runtime_cache_ensure_initialized();
-	runtime_cache_insert_impl(key, value);
+	bucket = runtime_cache_bucket(key);
+	expires = runtime_cache_now() + runtime_cache_timeout_secs;
+
+	pthread_mutex_lock(&bucket->mutex);
+
+	// the key may have been invalidated after the value was fetched
+	if (bucket->generation != generation) {
+		pthread_mutex_unlock(&bucket->mutex);
+		return;
+	}
+
+	entry = cache_find_internal(bucket, key);
+	if (entry) {
+		// key,value pair was invalidated or expired earlier,
+		// reuse entry in the bucket
+		runtime_cache_write_entry(entry, value, expires);
+	} else {
+		entry = calloc(1, sizeof(struct hybris_prop_value));
+		if (entry) {
+			strncpy(entry->key, key, PROP_NAME_MAX - 1);
+			strncpy(entry->value, value, PROP_VALUE_MAX - 1);
+			entry->expires = expires;
+			entry->next = bucket->head;
+
+			// publish the fully initialized entry to the readers
+			__atomic_store_n(&bucket->head, entry, __ATOMIC_RELEASE);
+		}
+	}
+
+	pthread_mutex_unlock(&bucket->mutex);
 }
@@ -0,0 +1,47 @@
+#!/bin/sh
+#
+# Builds stand-ins for the vendor's libGLESv1_CM.so, libGLESv2.so and
+# libGLESv3.so, for timing the dispatch of the wrapper libraries on the
+# build host (see test_gles_dispatch). Their functions return 0 right
+# away. Like the libraries of gen_linker_bench_libs.sh, they are built
+# without any libc so that the hybris linker can load them.
+#
+# Usage: gen_gles_stub_libs.sh <output dir>
+#
+# On armhf, set CC="cc -mfloat-abi=softfp": bionic takes floating point
+# arguments in the core registers.
+#
+
+set -e
+
+OUT=${1:?usage: $0 <output dir>}
+CC=${CC:-cc}
+TOP=$(cd "$(dirname "$0")/.." && pwd)
+
+mkdir -p "$OUT"
+SRC=$(mktemp -d)
+trap 'rm -rf "$SRC"' EXIT
+
+stub() {
+	# <library> <functions list> <headers>...
+	lib=$1
+	list=$2
+	shift 2
+	{
+		echo "#define GL_GLEXT_PROTOTYPES"
+		for header in "$@"; do
+			echo "#include <$header>"
+		done
+		echo "#define HYBRIS_GL_FUNCTION(name, ret, params, args, return_, fp) \\"
+		echo "	ret name params { return_ (ret) 0; }"
+		echo "#include \"$list\""
+	} > "$SRC/$lib.c"
+	$CC -O1 -fno-builtin -shared -fPIC -nostdlib -Wl,-soname,$lib.so \
+		-I"$TOP/include" -o "$OUT/$lib.so" "$SRC/$lib.c"
+}
+
+stub libGLESv1_CM "$TOP/glesv1/glesv1_cm_functions.h" GLES/gl.h GLES/glext.h
+stub libGLESv2 "$TOP/glesv2/glesv2_functions.h" GLES2/gl2.h GLES2/gl2ext.h
+stub libGLESv3 "$TOP/glesv3/glesv3_functions.h" GLES3/gl31.h GLES2/gl2ext.h
+
+echo "built $OUT/libGLESv1_CM.so, $OUT/libGLESv2.so and $OUT/libGLESv3.so"
@@ -0,0 +1,132 @@
+#!/bin/sh
+#
+# Generates a synthetic dependency graph of shared libraries which can be
+# loaded by the hybris linker on the build host, for use with test_linker.
+#
+# The libraries are built without any libc. Library N needs libraries
+# N+1..N+fanout (3 by default), calls into them through the PLT, keeps pointer tables to
+# their functions and imports a few libc symbols which are resolved
+# through the hybris hooks, so linking them exercises the same paths
+# as a vendor graphics stack does. Function benchN_fM(depth) calls the
+# functions benchD_fM of the dependencies, depth levels deep.
+#
+# Usage: gen_linker_bench_libs.sh <output dir> [libraries] [functions per library] [fanout]
+#
+# A large fanout makes for wide levels in the dependency tree, which the
+# linker maps in parallel (see HYBRIS_LD_LOAD_THREADS).
+#
+# HASH_STYLE=sysv or HASH_STYLE=gnu builds the libraries with only a
+# DT_HASH or only a DT_GNU_HASH table, to compare the symbol lookups of
+# the two (the default is both, which the linkers look up as GNU hash).
+#
+# POINTER_TABLES=0 leaves out the pointer tables, so the functions of the
+# dependencies are only called through the PLT (see test_linker -l).
+#
+# RELATIVES=<n> adds a table of n pointers into the library itself, which
+# makes for n relative relocations. RELR=1 packs them into a DT_RELR
+# table (needs binutils 2.38 or lld).
+#
+# RELRO=1 makes the pointer tables const, which puts them into the RELRO
+# segment (see test_relro_share).
+#
+# PREFIX=<name> names the libraries lib<name>N.so and their symbols
+# <name>N_*, instead of bench, so that two graphs can be loaded together.
+#
+
+set -e
+
+OUT=${1:?usage: $0 <output dir> [libraries] [functions per library] [fanout]}
+LIBS=${2:-50}
+FUNCS=${3:-200}
+FANOUT=${4:-3}
+CC=${CC:-cc}
+HASH_STYLE=${HASH_STYLE:-both}
+POINTER_TABLES=${POINTER_TABLES:-1}
+RELATIVES=${RELATIVES:-0}
+RELR=${RELR:-0}
+RELRO=${RELRO:-0}
+PREFIX=${PREFIX:-bench}
+
+RELR_LDFLAGS=""
+if [ "$RELR" != 0 ]; then
+	RELR_LDFLAGS="-Wl,-z,pack-relative-relocs"
+fi
+
+mkdir -p "$OUT"
+SRC=$(mktemp -d)
+trap 'rm -rf "$SRC"' EXIT
+
+i=$((LIBS - 1))
+while [ $i -ge 0 ]; do
+	deps=""
+	d=$((i + 1))
+	while [ $d -le $((i + FANOUT)) ] && [ $d -lt $LIBS ]; do
+		deps="$deps $d"
+		d=$((d + 1))
+	done
+
+	c="$SRC/${PREFIX}$i.c"
+	{
+		echo "extern char malloc[], free[], memcpy[], strlen[];"
+		echo "extern char pthread_mutex_lock[], pthread_mutex_unlock[];"
+		echo "void *${PREFIX}${i}_libc[] = { malloc, free, memcpy, strlen,"
+		echo "	pthread_mutex_lock, pthread_mutex_unlock };"
+		echo "int ${PREFIX}${i}_counter;"
+
+		f=0
+		while [ $f -lt $FUNCS ]; do
+			for d in $deps; do
+				echo "extern int ${PREFIX}${d}_f$f(int);"
+			done
+			echo "int ${PREFIX}${i}_f$f(int x) {"
+			echo "	int r = x + ${PREFIX}${i}_counter;"
+			echo "	if (x > 0) {"
+			for d in $deps; do
+				echo "		r += ${PREFIX}${d}_f$f(x - 1);"
+			done
+			echo "	}"
+			echo "	return r;"
+			echo "}"
+			f=$((f + 1))
+		done
+
+		if [ "$POINTER_TABLES" != 0 ]; then
+			if [ "$RELRO" != 0 ]; then
+				echo "void *const ${PREFIX}${i}_table[] = {"
+			else
+				echo "void *${PREFIX}${i}_table[] = {"
+			fi
+			f=0
+			while [ $f -lt $FUNCS ]; do
+				for d in $deps; do
+					echo "	(void *) ${PREFIX}${d}_f$f,"
+				done
+				f=$((f + 1))
+			done
+			echo "	0 };"
+		fi
+
+		if [ "$RELATIVES" -gt 0 ]; then
+			echo "static char ${PREFIX}${i}_data[$RELATIVES];"
+			echo "char *${PREFIX}${i}_relative[] = {"
+			r=0
+			while [ $r -lt "$RELATIVES" ]; do
+				echo "	${PREFIX}${i}_data + $r,"
+				r=$((r + 1))
+			done
+			echo "	0 };"
+		fi
+	} > "$c"
+
+	libs=""
+	for d in $deps; do
+		libs="$libs -l${PREFIX}$d"
+	done
+
+	$CC -O1 -fno-builtin -shared -fPIC -nostdlib -Wl,-soname,lib${PREFIX}$i.so \
+		-Wl,--unresolved-symbols=ignore-all -Wl,--hash-style=$HASH_STYLE $RELR_LDFLAGS \
+		-o "$OUT/lib${PREFIX}$i.so" "$c" -L"$OUT" $libs
+	i=$((i - 1))
+done
+
+echo "generated $LIBS libraries in $OUT, load lib${PREFIX}0.so with test_linker -L $OUT"
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Measures how android_dlsym scales when several threads look up
+ * symbols at once, while another thread keeps loading and unloading a
+ * library (-k). Every call is timed, so a lookup which has to wait for a
+ * dlopen shows up in the maximum latency.
+ *
+ * -d loads the library with RTLD_GLOBAL and looks the symbols up in
+ * RTLD_DEFAULT instead of the library handle, which bypasses the
+ * per-handle cache of the mm linker.
+ *
+ * With two graphs from gen_linker_bench_libs.sh:
+ *
+ *   gen_linker_bench_libs.sh /tmp/bench 10
+ *   PREFIX=cycle gen_linker_bench_libs.sh /tmp/bench-cycle 50
+ *   test_dlsym -L /tmp/bench:/tmp/bench-cycle -t 4 -k libcycle0.so \
+ *       libbench0.so bench9_f0 bench9_f1
+ *
+ * -L sets the directories the libraries are searched in.
+ *
+ * Usage: test_dlsym [-L path] [-t threads] [-s seconds] [-d] [-k library] library symbol...
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <getopt.h>
+#include <dlfcn.h>
+
+#include <hybris/common/binding.h>
+
+/* RTLD_DEFAULT and RTLD_GLOBAL of bionic */
+#define BIONIC_RTLD_DEFAULT ((void *) 0)
+#if defined(__LP64__)
+#define BIONIC_RTLD_GLOBAL 0x00100
+#else
+#define BIONIC_RTLD_GLOBAL 0x00002
+#endif
+
+static void *handle;
+static char **symbols;
+static int symbol_count;
+static const char *cycled;
+static volatile int running = 1;
+static pthread_barrier_t barrier;
+
+struct reader {
+	pthread_t thread;
+	unsigned long calls;
+	double max_latency;
+	int failed;
+};
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+static void *reader_thread(void *arg)
+{
+	struct reader *r = arg;
+	int i = 0;
+
+	pthread_barrier_wait(&barrier);
+
+	while (running) {
+		double start = now(), latency;
+
+		if (!android_dlsym(handle, symbols[i]))
+			r->failed = 1;
+		latency = now() - start;
+
+		if (latency > r->max_latency)
+			r->max_latency = latency;
+		r->calls++;
+		if (++i == symbol_count)
+			i = 0;
+	}
+
+	return NULL;
+}
+
+static void *cycle_thread(void *arg)
+{
+	unsigned long *cycles = arg;
+
+	pthread_barrier_wait(&barrier);
+
+	while (running) {
+		void *h = android_dlopen(cycled, RTLD_NOW);
+
+		if (!h) {
+			fprintf(stderr, "failed to load %s: %s\n", cycled, android_dlerror());
+			break;
+		}
+		android_dlclose(h);
+		(*cycles)++;
+	}
+
+	return NULL;
+}
+
+/* Makes the linker search the directories in path, separated by colons,
+ * before its default ones. It doesn't read HYBRIS_LD_LIBRARY_PATH. */
+static int set_library_path(const char *path)
+{
+	void *libdl = android_dlopen("libdl.so", RTLD_NOW);
+	void (*update)(const char *) = libdl ? android_dlsym(libdl, "android_update_LD_LIBRARY_PATH") : NULL;
+
+	if (!update) {
+		fprintf(stderr, "can't set the library path: %s\n", android_dlerror());
+		return -1;
+	}
+
+	update(path);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	int threads = 4, seconds = 2, use_default = 0;
+	struct reader *readers;
+	void *library;
+	pthread_t cycler;
+	unsigned long cycles = 0, calls = 0;
+	double start, elapsed, max_latency = 0;
+	int opt, i, failed = 0;
+
+	while ((opt = getopt(argc, argv, "L:t:s:dk:")) != -1) {
+		switch (opt) {
+		case 'L':
+			if (set_library_path(optarg))
+				return 1;
+			break;
+		case 't':
+			threads = atoi(optarg);
+			break;
+		case 's':
+			seconds = atoi(optarg);
+			break;
+		case 'd':
+			use_default = 1;
+			break;
+		case 'k':
+			cycled = optarg;
+			break;
+		default:
+			goto usage;
+		}
+	}
+
+	if (argc - optind < 2 || threads < 1 || seconds < 1)
+		goto usage;
+
+	handle = library = android_dlopen(argv[optind], RTLD_NOW | (use_default ? BIONIC_RTLD_GLOBAL : 0));
+	if (!library) {
+		fprintf(stderr, "failed to load %s: %s\n", argv[optind], android_dlerror());
+		return 1;
+	}
+
+	symbols = &argv[optind + 1];
+	symbol_count = argc - optind - 1;
+	for (i = 0; i < symbol_count; i++) {
+		if (!android_dlsym(handle, symbols[i])) {
+			fprintf(stderr, "%s not found in %s\n", symbols[i], argv[optind]);
+			return 1;
+		}
+	}
+	if (use_default)
+		handle = BIONIC_RTLD_DEFAULT;
+
+	readers = calloc(threads, sizeof(struct reader));
+	pthread_barrier_init(&barrier, NULL, threads + (cycled ? 2 : 1));
+	for (i = 0; i < threads; i++)
+		pthread_create(&readers[i].thread, NULL, reader_thread, &readers[i]);
+	if (cycled)
+		pthread_create(&cycler, NULL, cycle_thread, &cycles);
+
+	pthread_barrier_wait(&barrier);
+	start = now();
+	sleep(seconds);
+	running = 0;
+
+	for (i = 0; i < threads; i++) {
+		pthread_join(readers[i].thread, NULL);
+		calls += readers[i].calls;
+		failed |= readers[i].failed;
+		if (readers[i].max_latency > max_latency)
+			max_latency = readers[i].max_latency;
+	}
+	if (cycled)
+		pthread_join(cycler, NULL);
+	elapsed = now() - start;
+
+	printf("%d threads%s: %.1f ns per dlsym, %.2f M lookups/s, max %.1f us\n", threads,
+		use_default ? " (RTLD_DEFAULT)" : "",
+		elapsed * threads * 1000000000.0 / calls, calls / elapsed / 1000000.0,
+		max_latency * 1000000.0);
+	if (cycled)
+		printf("%s: %lu dlopen/dlclose cycles meanwhile\n", cycled, cycles);
+
+	if (failed) {
+		fprintf(stderr, "some lookups failed\n");
+		return 1;
+	}
+
+	android_dlclose(library);
+	free(readers);
+	return 0;
+
+usage:
+	fprintf(stderr, "usage: %s [-L path] [-t threads] [-s seconds] [-d] [-k library] library symbol...\n", argv[0]);
+	return 1;
+}
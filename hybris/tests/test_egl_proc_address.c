@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Measures eglGetProcAddress: how long the first lookup of a name takes,
+ * which resolves it, and how long the lookups after it take, which come
+ * from the cache. The names are what an engine looks up at startup, for
+ * an OpenGL ES 2 context: core functions, extensions of GLES and EGL,
+ * libhybris' own, and names nobody has, which aren't cached and are
+ * resolved every time. The cached lookups must return what the first
+ * one did.
+ *
+ * Usage: test_egl_proc_address [-n lookups per name]
+ */
+
+#include <EGL/egl.h>
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+static const char *const names[] = {
+	"glActiveTexture", "glAttachShader", "glBindBuffer", "glBindFramebuffer",
+	"glBindTexture", "glBlendFunc", "glBufferData", "glBufferSubData",
+	"glClear", "glClearColor", "glCompileShader", "glCreateProgram",
+	"glCreateShader", "glDeleteBuffers", "glDeleteTextures", "glDrawArrays",
+	"glDrawElements", "glEnable", "glEnableVertexAttribArray", "glGenBuffers",
+	"glGenTextures", "glGetUniformLocation", "glLinkProgram", "glShaderSource",
+	"glTexImage2D", "glTexParameteri", "glUniform1i", "glUniformMatrix4fv",
+	"glUseProgram", "glVertexAttribPointer", "glViewport",
+	"glEGLImageTargetTexture2DOES", "glBindVertexArrayOES", "glGenVertexArraysOES",
+	"glMapBufferOES", "glUnmapBufferOES", "glDiscardFramebufferEXT",
+	"eglCreateImageKHR", "eglDestroyImageKHR", "eglCreateSyncKHR",
+	"eglClientWaitSyncKHR", "eglSwapBuffersWithDamageEXT",
+	"eglHybrisCreateNativeBuffer", "eglHybrisLockNativeBuffer",
+	"glNoSuchFunctionHYBRIS", "eglNoSuchFunctionHYBRIS",
+};
+
+#define NAMES (sizeof(names) / sizeof(names[0]))
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int main(int argc, char **argv)
+{
+	EGLint attr[] = {
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+		EGL_NONE
+	};
+	EGLint ctxattr[] = {
+		EGL_CONTEXT_CLIENT_VERSION, 2,
+		EGL_NONE
+	};
+	void (*first[NAMES])(void);
+	uint64_t first_ns[NAMES], total_first = 0, slowest = 0, start, cached_ns, unresolved_ns;
+	EGLDisplay display;
+	EGLConfig ecfg;
+	EGLint num_config;
+	EGLContext context;
+	int lookups = 100000, opt, i;
+	size_t n, resolved = 0;
+
+	while ((opt = getopt(argc, argv, "n:")) != -1) {
+		switch (opt) {
+		case 'n':
+			lookups = atoi(optarg);
+			break;
+		default:
+			goto usage;
+		}
+	}
+
+	if (optind != argc || lookups < 1)
+		goto usage;
+
+	display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	assert(display != EGL_NO_DISPLAY);
+	assert(eglInitialize(display, 0, 0) == EGL_TRUE);
+	assert(eglChooseConfig(display, attr, &ecfg, 1, &num_config) == EGL_TRUE);
+
+	/* libEGL resolves for the client version of the last context created */
+	context = eglCreateContext(display, ecfg, EGL_NO_CONTEXT, ctxattr);
+	assert(context != EGL_NO_CONTEXT);
+
+	for (n = 0; n < NAMES; n++) {
+		start = now_ns();
+		first[n] = eglGetProcAddress(names[n]);
+		first_ns[n] = now_ns() - start;
+
+		total_first += first_ns[n];
+		if (first_ns[n] > slowest)
+			slowest = first_ns[n];
+		if (first[n])
+			resolved++;
+	}
+
+	start = now_ns();
+	for (i = 0; i < lookups; i++) {
+		for (n = 0; n < NAMES; n++) {
+			if (first[n])
+				assert(eglGetProcAddress(names[n]) == first[n]);
+		}
+	}
+	cached_ns = now_ns() - start;
+
+	start = now_ns();
+	for (i = 0; i < lookups / 100 + 1; i++) {
+		for (n = 0; n < NAMES; n++) {
+			if (!first[n])
+				assert(eglGetProcAddress(names[n]) == NULL);
+		}
+	}
+	unresolved_ns = now_ns() - start;
+
+	for (n = 0; n < NAMES; n++)
+		printf("%-32s %p first lookup %8.1f us\n", names[n], (void *) first[n], first_ns[n] / 1e3);
+	printf("%zu names, %zu resolved: first lookup %.1f us on average, %.1f us at most\n",
+		NAMES, resolved, total_first / 1e3 / NAMES, slowest / 1e3);
+	if (resolved)
+		printf("after it %.1f ns per lookup from the cache\n",
+			(double) cached_ns / lookups / resolved);
+	if (resolved < NAMES)
+		printf("%.1f us per lookup of a name which doesn't resolve\n",
+			unresolved_ns / 1e3 / (lookups / 100 + 1) / (NAMES - resolved));
+
+	eglDestroyContext(display, context);
+	eglTerminate(display);
+	return 0;
+
+usage:
+	fprintf(stderr, "usage: %s [-n lookups per name]\n", argv[0]);
+	return 1;
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Measures what the entry points of libhybris' libGLESv2 add to a GL
+ * call: a few functions of the vendor library are called through them
+ * and directly through the pointers android_dlsym returns, and the
+ * time per call of both is printed, the best of several rounds.
+ *
+ * No context is needed. Without one, the functions of Android's
+ * libGLESv2 go to stubs which return right away, which leaves mostly
+ * the cost of the dispatch. On a build host, the stand-ins built by
+ * gen_gles_stub_libs.sh do the same:
+ *
+ *   gen_gles_stub_libs.sh /tmp/gles
+ *   test_gles_dispatch -L /tmp/gles
+ *
+ * -L sets the directories the libraries are searched in.
+ *
+ * Usage: test_gles_dispatch [-L path] [-n calls per round]
+ */
+
+#include <GLES2/gl2.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <dlfcn.h>
+
+#include <hybris/common/binding.h>
+
+#define ROUNDS 5
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* Sets best to the lowest time per call of call over ROUNDS rounds */
+#define TIME_CALLS(best, calls, call) \
+	do { \
+		int round, i; \
+		best = 1e9; \
+		for (round = 0; round < ROUNDS; round++) { \
+			uint64_t start = now_ns(); \
+			double ns; \
+			for (i = 0; i < calls; i++) \
+				call; \
+			ns = (double) (now_ns() - start) / calls; \
+			if (ns < best) \
+				best = ns; \
+		} \
+	} while (0)
+
+static void report(const char *function, double wrapper, double direct)
+{
+	printf("%-18s wrapper %6.2f ns/call, direct %6.2f ns/call, overhead %5.2f ns\n",
+		function, wrapper, direct, wrapper - direct);
+}
+
+/* Makes the linker search the directories in path, separated by colons,
+ * before its default ones. It doesn't read HYBRIS_LD_LIBRARY_PATH. */
+static int set_library_path(const char *path)
+{
+	void *libdl = android_dlopen("libdl.so", RTLD_NOW);
+	void (*update)(const char *) = libdl ? android_dlsym(libdl, "android_update_LD_LIBRARY_PATH") : NULL;
+
+	if (!update) {
+		fprintf(stderr, "can't set the library path: %s\n", android_dlerror());
+		return -1;
+	}
+
+	update(path);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	void (*direct_glUniform1i)(GLint, GLint) FP_ATTRIB;
+	void (*direct_glBindTexture)(GLenum, GLuint) FP_ATTRIB;
+	void (*direct_glVertexAttrib4f)(GLuint, GLfloat, GLfloat, GLfloat, GLfloat) FP_ATTRIB;
+	GLenum (*direct_glGetError)(void) FP_ATTRIB;
+	double wrapper, direct;
+	int calls = 10000000, opt;
+	void *handle;
+
+	while ((opt = getopt(argc, argv, "L:n:")) != -1) {
+		switch (opt) {
+		case 'L':
+			if (set_library_path(optarg))
+				return 1;
+			break;
+		case 'n':
+			calls = atoi(optarg);
+			break;
+		default:
+			goto usage;
+		}
+	}
+
+	if (optind != argc || calls < 1)
+		goto usage;
+
+	/* the library the wrapper forwards to */
+	handle = android_dlopen(getenv("LIBGLESV2") ? getenv("LIBGLESV2") : "libGLESv2.so", RTLD_NOW);
+	if (!handle) {
+		fprintf(stderr, "failed to load libGLESv2.so: %s\n", android_dlerror());
+		return 1;
+	}
+
+	direct_glUniform1i = android_dlsym(handle, "glUniform1i");
+	direct_glBindTexture = android_dlsym(handle, "glBindTexture");
+	direct_glVertexAttrib4f = android_dlsym(handle, "glVertexAttrib4f");
+	direct_glGetError = android_dlsym(handle, "glGetError");
+	if (!direct_glUniform1i || !direct_glBindTexture || !direct_glVertexAttrib4f || !direct_glGetError) {
+		fprintf(stderr, "libGLESv2.so lacks a function\n");
+		return 1;
+	}
+
+	printf("%d calls per round, best of %d rounds\n", calls, ROUNDS);
+
+	TIME_CALLS(wrapper, calls, glUniform1i(i, i));
+	TIME_CALLS(direct, calls, direct_glUniform1i(i, i));
+	report("glUniform1i", wrapper, direct);
+
+	TIME_CALLS(wrapper, calls, glBindTexture(GL_TEXTURE_2D, i));
+	TIME_CALLS(direct, calls, direct_glBindTexture(GL_TEXTURE_2D, i));
+	report("glBindTexture", wrapper, direct);
+
+	TIME_CALLS(wrapper, calls, glVertexAttrib4f(0, i, 0.f, 0.f, 1.f));
+	TIME_CALLS(direct, calls, direct_glVertexAttrib4f(0, i, 0.f, 0.f, 1.f));
+	report("glVertexAttrib4f", wrapper, direct);
+
+	TIME_CALLS(wrapper, calls, glGetError());
+	TIME_CALLS(direct, calls, direct_glGetError());
+	report("glGetError", wrapper, direct);
+
+	return 0;
+
+usage:
+	fprintf(stderr, "usage: %s [-L path] [-n calls per round]\n", argv[0]);
+	return 1;
+}
@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Checks the state filter of libGLESv2 (see glesv2/glesv2_filter.h) and
+ * measures it on a frame like a toolkit draws it: many quads, each one
+ * setting its texture, program and blending whether or not they changed.
+ *
+ * libEGL is played by calling the functions it notifies libGLESv2 with,
+ * with made up contexts, so no driver is needed: the vendor library can
+ * be the stand-in built by gen_gles_stub_libs.sh. The test enables the
+ * filter and checks which calls it forwarded through the statistics it
+ * writes at the end of every frame. libGLESv3 puts the same filter in
+ * front of its functions, calls through both libraries are checked to
+ * share the state.
+ *
+ *   gen_gles_stub_libs.sh /tmp/gles
+ *   test_gles_filter -L /tmp/gles
+ *
+ * -L sets the directories the libraries are searched in.
+ *
+ * Usage: test_gles_filter [-L path] [-n quads per frame]
+ */
+
+#include <GLES2/gl2.h>
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <dlfcn.h>
+
+#include <hybris/common/binding.h>
+
+#define FRAMES 100
+
+/* Exported by libGLESv2 for libEGL */
+extern void hybris_glesv2_make_current(void *context);
+extern void hybris_glesv2_destroy_context(void *context);
+extern void hybris_glesv2_swap_buffers(void);
+
+static char stats_path[] = "/tmp/test_gles_filter.XXXXXX";
+static FILE *stats;
+
+static void *context_a = (void *) 0x1000;
+static void *context_b = (void *) 0x2000;
+static void *context_c = (void *) 0x3000;
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* Ends the frame and checks how many calls the filter dropped and forwarded in it */
+static void expect(int line, unsigned filtered, unsigned forwarded)
+{
+	char buffer[512];
+	unsigned got_filtered, got_forwarded;
+
+	hybris_glesv2_swap_buffers();
+	do {
+		assert(fgets(buffer, sizeof(buffer), stats));
+	} while (buffer[0] == '#');
+
+	assert(sscanf(buffer, "%*s %*u %u %u", &got_filtered, &got_forwarded) == 2);
+	if (got_filtered != filtered || got_forwarded != forwarded) {
+		fprintf(stderr, "line %d: %u calls filtered, %u forwarded, expected %u and %u\n",
+			line, got_filtered, got_forwarded, filtered, forwarded);
+		exit(1);
+	}
+}
+
+#define EXPECT(filtered, forwarded) expect(__LINE__, filtered, forwarded)
+
+static void check(void)
+{
+	GLuint texture = 1;
+
+	hybris_glesv2_make_current(context_a);
+
+	/* nothing is known at first, then repeated calls go */
+	glActiveTexture(GL_TEXTURE0);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, 1);
+	glBindTexture(GL_TEXTURE_2D, 1);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, 1);
+	glUseProgram(3);
+	glUseProgram(3);
+	glEnable(GL_BLEND);
+	glEnable(GL_BLEND);
+	glDisable(GL_BLEND);
+	glBlendFunc(GL_ONE, GL_ZERO);
+	glBlendFunc(GL_ONE, GL_ZERO);
+	glBlendFuncSeparate(GL_ONE, GL_ZERO, GL_ONE, GL_ZERO);
+	glBindBuffer(GL_ARRAY_BUFFER, 4);
+	glBindBuffer(GL_ARRAY_BUFFER, 4);
+	EXPECT(7, 8);
+
+	/* the element array buffer isn't filtered, nor are other units and caps */
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 5);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 5);
+	glActiveTexture(GL_TEXTURE0 + 40);
+	glBindTexture(GL_TEXTURE_2D, 1);
+	glActiveTexture(GL_TEXTURE0 + 40);
+	glEnable(0x8D69 /* GL_PRIMITIVE_RESTART_FIXED_INDEX */);
+	glEnable(0x8D69);
+	EXPECT(0, 7);
+
+	/* another context has its own state */
+	hybris_glesv2_make_current(context_b);
+	glActiveTexture(GL_TEXTURE0);
+	glUseProgram(3);
+	glUseProgram(3);
+	EXPECT(1, 2);
+
+	/* which context a still has */
+	hybris_glesv2_make_current(context_a);
+	glActiveTexture(GL_TEXTURE1);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, 1);
+	glUseProgram(3);
+	glDisable(GL_BLEND);
+	EXPECT(3, 2);
+
+	/* deleting a texture in any context forgets all texture bindings,
+	 * contexts may share it */
+	hybris_glesv2_make_current(context_b);
+	glDeleteTextures(1, &texture);
+	hybris_glesv2_make_current(context_a);
+	glBindTexture(GL_TEXTURE_2D, 1);
+	glBindTexture(GL_TEXTURE_2D, 1);
+	glUseProgram(3);
+	EXPECT(2, 1);
+	glDeleteProgram(3);
+	glUseProgram(3);
+	EXPECT(0, 1);
+
+	/* a destroyed context's handle may come back as a new context */
+	hybris_glesv2_make_current(NULL);
+	hybris_glesv2_destroy_context(context_a);
+	hybris_glesv2_make_current(context_a);
+	glUseProgram(3);
+	glEnable(GL_BLEND);
+	EXPECT(0, 2);
+
+	/* destroyed while current, it lives on until released */
+	hybris_glesv2_destroy_context(context_a);
+	glUseProgram(3);
+	EXPECT(1, 0);
+	hybris_glesv2_make_current(context_b);
+	hybris_glesv2_make_current(context_a);
+	glUseProgram(3);
+	EXPECT(0, 1);
+
+	hybris_glesv2_make_current(NULL);
+	printf("filter checks: ok\n");
+}
+
+/* Mixes calls through libGLESv2 and libGLESv3, which change the state of
+ * the same context */
+static void check_mixed(void)
+{
+	void *libglesv3 = dlopen("libGLESv3.so.3", RTLD_LAZY);
+	void (*glesv3_make_current)(void *context);
+	void (*glesv3_BindTexture)(GLenum target, GLuint texture) FP_ATTRIB;
+	void (*glesv3_DeleteTextures)(GLsizei n, const GLuint *textures) FP_ATTRIB;
+	void (*glesv3_UseProgram)(GLuint program) FP_ATTRIB;
+	GLuint texture = 1;
+
+	assert(libglesv3);
+	*(void **) &glesv3_make_current = dlsym(libglesv3, "hybris_glesv3_make_current");
+	*(void **) &glesv3_BindTexture = dlsym(libglesv3, "glBindTexture");
+	*(void **) &glesv3_DeleteTextures = dlsym(libglesv3, "glDeleteTextures");
+	*(void **) &glesv3_UseProgram = dlsym(libglesv3, "glUseProgram");
+	assert(glesv3_make_current && glesv3_BindTexture && glesv3_DeleteTextures && glesv3_UseProgram);
+
+	hybris_glesv2_make_current(context_c);
+	glesv3_make_current(context_c);
+
+	/* a texture deleted and generated again through libGLESv3 is bound
+	 * again through libGLESv2 */
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, 1);
+	glesv3_DeleteTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, 1);
+	EXPECT(0, 3);
+
+	/* the bindings made through either library are known to both */
+	glesv3_BindTexture(GL_TEXTURE_2D, 2);
+	glBindTexture(GL_TEXTURE_2D, 1);
+	glesv3_BindTexture(GL_TEXTURE_2D, 1);
+	glesv3_UseProgram(5);
+	glUseProgram(5);
+	EXPECT(2, 3);
+
+	hybris_glesv2_make_current(NULL);
+	glesv3_make_current(NULL);
+	printf("mixed library checks: ok\n");
+}
+
+/* The functions a frame is drawn with, of libGLESv2 or the vendor library */
+struct gl {
+	void (*ActiveTexture)(GLenum texture) FP_ATTRIB;
+	void (*BindTexture)(GLenum target, GLuint texture) FP_ATTRIB;
+	void (*UseProgram)(GLuint program) FP_ATTRIB;
+	void (*Enable)(GLenum cap) FP_ATTRIB;
+	void (*Disable)(GLenum cap) FP_ATTRIB;
+	void (*BlendFunc)(GLenum sfactor, GLenum dfactor) FP_ATTRIB;
+	void (*BindBuffer)(GLenum target, GLuint buffer) FP_ATTRIB;
+	void (*DrawArrays)(GLenum mode, GLint first, GLsizei count) FP_ATTRIB;
+};
+
+#define GL_FUNCTIONS(gl, lookup) \
+	do { \
+		*(void **) &(gl)->ActiveTexture = lookup(glActiveTexture); \
+		*(void **) &(gl)->BindTexture = lookup(glBindTexture); \
+		*(void **) &(gl)->UseProgram = lookup(glUseProgram); \
+		*(void **) &(gl)->Enable = lookup(glEnable); \
+		*(void **) &(gl)->Disable = lookup(glDisable); \
+		*(void **) &(gl)->BlendFunc = lookup(glBlendFunc); \
+		*(void **) &(gl)->BindBuffer = lookup(glBindBuffer); \
+		*(void **) &(gl)->DrawArrays = lookup(glDrawArrays); \
+	} while (0)
+
+/* A frame of a toolkit: the quads use one of a few textures, and set
+ * all the state they need whether or not it changed */
+static void draw_frame(const struct gl *gl, int quads)
+{
+	int i;
+
+	for (i = 0; i < quads; i++) {
+		gl->ActiveTexture(GL_TEXTURE0);
+		gl->BindTexture(GL_TEXTURE_2D, 1 + (i / 16) % 4);
+		gl->UseProgram(1);
+		gl->Enable(GL_BLEND);
+		gl->BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+		gl->BindBuffer(GL_ARRAY_BUFFER, 1);
+		gl->DrawArrays(GL_TRIANGLE_STRIP, 4 * i, 4);
+	}
+	gl->Disable(GL_BLEND);
+}
+
+/* Returns the time per frame in us of drawing FRAMES frames with gl */
+static double time_frames(const struct gl *gl, int quads)
+{
+	uint64_t start = now_ns();
+	int frame;
+
+	for (frame = 0; frame < FRAMES; frame++) {
+		draw_frame(gl, quads);
+		hybris_glesv2_swap_buffers();
+	}
+
+	return (now_ns() - start) / 1e3 / FRAMES;
+}
+
+/* Makes the linker search the directories in path, separated by colons,
+ * before its default ones. It doesn't read HYBRIS_LD_LIBRARY_PATH. */
+static int set_library_path(const char *path)
+{
+	void *libdl = android_dlopen("libdl.so", RTLD_NOW);
+	void (*update)(const char *) = libdl ? android_dlsym(libdl, "android_update_LD_LIBRARY_PATH") : NULL;
+
+	if (!update) {
+		fprintf(stderr, "can't set the library path: %s\n", android_dlerror());
+		return -1;
+	}
+
+	update(path);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	struct gl wrapper, vendor;
+	char buffer[512];
+	unsigned filtered = 0, forwarded = 0;
+	double wrapper_us, vendor_us;
+	int quads = 500, opt, fd;
+	void *handle;
+
+	while ((opt = getopt(argc, argv, "L:n:")) != -1) {
+		switch (opt) {
+		case 'L':
+			if (set_library_path(optarg))
+				return 1;
+			break;
+		case 'n':
+			quads = atoi(optarg);
+			break;
+		default:
+			goto usage;
+		}
+	}
+
+	if (optind != argc || quads < 1)
+		goto usage;
+
+	/* before the first context is made current, which installs the filter */
+	fd = mkstemp(stats_path);
+	assert(fd >= 0);
+	close(fd);
+	setenv("HYBRIS_GLES_STATE_FILTER", "1", 1);
+	setenv("HYBRIS_GLES_STATE_FILTER_STATS", stats_path, 1);
+
+	hybris_glesv2_make_current(context_a);
+	stats = fopen(stats_path, "r");
+	assert(stats);
+	unlink(stats_path);
+
+	check();
+	check_mixed();
+
+	/* the library libGLESv2 forwards to */
+	handle = android_dlopen(getenv("LIBGLESV2") ? getenv("LIBGLESV2") : "libGLESv2.so", RTLD_NOW);
+	assert(handle);
+#define WRAPPER(name) ((void *) name)
+#define VENDOR(name) android_dlsym(handle, #name)
+	GL_FUNCTIONS(&wrapper, WRAPPER);
+	GL_FUNCTIONS(&vendor, VENDOR);
+
+	hybris_glesv2_make_current(context_b);
+	wrapper_us = time_frames(&wrapper, quads);
+	vendor_us = time_frames(&vendor, quads);
+
+	/* the totals of the last frame through libGLESv2, the frames drawn
+	 * directly have nothing filtered or forwarded */
+	while (fgets(buffer, sizeof(buffer), stats)) {
+		unsigned frame_filtered, frame_forwarded;
+
+		if (buffer[0] != '#' && sscanf(buffer, "%*s %*u %u %u", &frame_filtered, &frame_forwarded) == 2 &&
+				frame_filtered + frame_forwarded > 0) {
+			filtered = frame_filtered;
+			forwarded = frame_forwarded;
+		}
+	}
+
+	printf("%d quads per frame: %u state changes filtered, %u forwarded to the driver\n",
+		quads, filtered, forwarded);
+	printf("%.1f us per frame through the filter, %.1f us calling the driver directly\n",
+		wrapper_us, vendor_us);
+	return 0;
+
+usage:
+	fprintf(stderr, "usage: %s [-L path] [-n quads per frame]\n", argv[0]);
+	return 1;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Measures how long a process which links libGLESv2 but never creates a
+ * context takes to start and exit, like a toolkit application which
+ * doesn't draw with GLES. The program runs itself the given number of
+ * times, the copies exit right away.
+ *
+ * The vendor library can be any library the hybris linker can load, e.g.
+ * a library from gen_linker_bench_libs.sh as a stand-in for a driver.
+ * The copies can't set the library path without loading the linker, so
+ * it is given with its full path, and without dependencies:
+ *
+ *   gen_linker_bench_libs.sh /tmp/bench 1
+ *   LIBGLESV2=/tmp/bench/libbench0.so test_gles_startup -n 50
+ *
+ * Usage: test_gles_startup [-n runs]
+ */
+
+#include <GLES2/gl2.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int main(int argc, char **argv)
+{
+	uint64_t total = 0, best = UINT64_MAX;
+	int runs = 20, opt, i;
+
+	while ((opt = getopt(argc, argv, "n:x")) != -1) {
+		switch (opt) {
+		case 'n':
+			runs = atoi(optarg);
+			break;
+		case 'x':
+			/* a copy: linked, but never called */
+			return 0;
+		default:
+			goto usage;
+		}
+	}
+
+	if (optind != argc || runs < 1)
+		goto usage;
+
+	for (i = 0; i < runs; i++) {
+		uint64_t start = now_ns(), ns;
+		int status;
+		pid_t pid = fork();
+
+		if (pid == 0) {
+			execl("/proc/self/exe", argv[0], "-x", (char *) NULL);
+			_exit(1);
+		}
+		if (pid < 0 || waitpid(pid, &status, 0) != pid ||
+				!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+			fprintf(stderr, "run %d failed\n", i);
+			return 1;
+		}
+
+		ns = now_ns() - start;
+		total += ns;
+		if (ns < best)
+			best = ns;
+	}
+
+	printf("%d runs: %.2f ms per start on average, %.2f ms at best (glClear at %p)\n",
+		runs, total / 1e6 / runs, best / 1e6, (void *) glClear);
+	return 0;
+
+usage:
+	fprintf(stderr, "usage: %s [-n runs]\n", argv[0]);
+	return 1;
+}
@@ -0,0 +1,384 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Smoke test and benchmark of libGLESv3: creates an OpenGL ES 3 context
+ * and uses what ES 2.0 doesn't have, checking the results:
+ *
+ *   - uniform buffers and instanced draws, captured with transform
+ *     feedback and counted with a query,
+ *   - a compute shader writing a shader storage buffer, if the context
+ *     is ES 3.1,
+ *
+ * then reads the frames back for the given number of frames, once with
+ * glReadPixels into client memory, which waits for the frame, and once
+ * into pixel buffers which are mapped a frame later, after their fence
+ * signaled, and prints the time per frame of both.
+ *
+ * Usage: test_glesv3 [-n frames]
+ */
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES3/gl31.h>
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef EGL_OPENGL_ES3_BIT_KHR
+/* EGL_KHR_create_context */
+#define EGL_OPENGL_ES3_BIT_KHR 0x00000040
+#endif
+
+#define INSTANCES 16
+
+static const char vertex_src[] =
+	"#version 300 es\n"
+	"layout(std140) uniform Params {\n"
+	"	vec4 offsets[16];\n"
+	"};\n"
+	"in vec4 position;\n"
+	"out vec4 captured;\n"
+	"void main()\n"
+	"{\n"
+	"	captured = offsets[gl_InstanceID];\n"
+	"	gl_Position = position * 0.2 + vec4(captured.xy, 0.0, 0.0);\n"
+	"}\n";
+
+static const char fragment_src[] =
+	"#version 300 es\n"
+	"out mediump vec4 color;\n"
+	"void main()\n"
+	"{\n"
+	"	color = vec4(1.0, 0.9, 0.7, 1.0);\n"
+	"}\n";
+
+static const char compute_src[] =
+	"#version 310 es\n"
+	"layout(local_size_x = 16) in;\n"
+	"layout(std430, binding = 0) buffer Squares {\n"
+	"	uint squares[];\n"
+	"};\n"
+	"void main()\n"
+	"{\n"
+	"	squares[gl_GlobalInvocationID.x] = gl_GlobalInvocationID.x * gl_GlobalInvocationID.x;\n"
+	"}\n";
+
+static const GLfloat triangle[] = {
+	0.0f,  1.0f, 0.0f, 1.0f,
+	-1.0f, -1.0f, 0.0f, 1.0f,
+	1.0f, -1.0f, 0.0f, 1.0f,
+};
+
+static EGLDisplay display;
+static EGLSurface surface;
+static GLint width, height;
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static GLuint load_shader(const char *source, GLenum type)
+{
+	GLuint shader = glCreateShader(type);
+	GLint compiled;
+
+	glShaderSource(shader, 1, &source, NULL);
+	glCompileShader(shader);
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+	assert(compiled == GL_TRUE);
+
+	return shader;
+}
+
+static GLuint link_program(GLuint program)
+{
+	GLint linked;
+
+	glLinkProgram(program);
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	assert(linked == GL_TRUE);
+
+	return program;
+}
+
+/* Draws INSTANCES triangles at the offsets in the uniform buffer and
+ * checks that transform feedback captured the offsets */
+static void test_instancing(GLuint program)
+{
+	GLfloat offsets[INSTANCES][4], *captured;
+	GLuint buffers[3], vao, query, written = 0;
+	GLuint block;
+	int i;
+
+	for (i = 0; i < INSTANCES; i++) {
+		offsets[i][0] = (i % 4) * 0.5f - 0.75f;
+		offsets[i][1] = (i / 4) * 0.5f - 0.75f;
+		offsets[i][2] = (GLfloat) i;
+		offsets[i][3] = 1.0f;
+	}
+
+	glGenVertexArrays(1, &vao);
+	glBindVertexArray(vao);
+	glGenBuffers(3, buffers);
+
+	glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(triangle), triangle, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, NULL);
+	glEnableVertexAttribArray(0);
+
+	block = glGetUniformBlockIndex(program, "Params");
+	assert(block != GL_INVALID_INDEX);
+	glUniformBlockBinding(program, block, 0);
+	glBindBuffer(GL_UNIFORM_BUFFER, buffers[1]);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(offsets), offsets, GL_STATIC_DRAW);
+	glBindBufferBase(GL_UNIFORM_BUFFER, 0, buffers[1]);
+
+	/* one point per instance, the first vertex of the triangle */
+	glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, buffers[2]);
+	glBufferData(GL_TRANSFORM_FEEDBACK_BUFFER, sizeof(offsets), NULL, GL_STATIC_READ);
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, buffers[2]);
+	glGenQueries(1, &query);
+
+	glEnable(GL_RASTERIZER_DISCARD);
+	glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, query);
+	glBeginTransformFeedback(GL_POINTS);
+	glDrawArraysInstanced(GL_POINTS, 0, 1, INSTANCES);
+	glEndTransformFeedback();
+	glEndQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
+	glDisable(GL_RASTERIZER_DISCARD);
+
+	glGetQueryObjectuiv(query, GL_QUERY_RESULT, &written);
+	assert(written == INSTANCES);
+
+	captured = glMapBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, sizeof(offsets), GL_MAP_READ_BIT);
+	assert(captured);
+	assert(memcmp(captured, offsets, sizeof(offsets)) == 0);
+	assert(glUnmapBuffer(GL_TRANSFORM_FEEDBACK_BUFFER) == GL_TRUE);
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+
+	glDeleteQueries(1, &query);
+	assert(glGetError() == GL_NO_ERROR);
+	printf("instancing, uniform buffers, transform feedback: ok\n");
+}
+
+static void test_compute(void)
+{
+	GLuint program, buffer, *squares;
+	GLuint i;
+
+	program = glCreateProgram();
+	glAttachShader(program, load_shader(compute_src, GL_COMPUTE_SHADER));
+	link_program(program);
+	glUseProgram(program);
+
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, 64 * sizeof(GLuint), NULL, GL_STATIC_READ);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buffer);
+
+	glDispatchCompute(64 / 16, 1, 1);
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+	squares = glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, 64 * sizeof(GLuint), GL_MAP_READ_BIT);
+	assert(squares);
+	for (i = 0; i < 64; i++)
+		assert(squares[i] == i * i);
+	assert(glUnmapBuffer(GL_SHADER_STORAGE_BUFFER) == GL_TRUE);
+
+	glDeleteBuffers(1, &buffer);
+	glDeleteProgram(program);
+	assert(glGetError() == GL_NO_ERROR);
+	printf("compute shader, shader storage buffers: ok\n");
+}
+
+static void draw_frame(int frame)
+{
+	glClearColor((frame % 60) / 60.0f, 0.2f, 0.3f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glDrawArraysInstanced(GL_TRIANGLES, 0, 3, INSTANCES);
+}
+
+/* Returns the time per frame in ms of reading back with glReadPixels */
+static double readback_sync(int frames, void *pixels)
+{
+	uint64_t start = now_ns();
+	int frame;
+
+	for (frame = 0; frame < frames; frame++) {
+		draw_frame(frame);
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+		eglSwapBuffers(display, surface);
+	}
+
+	return (now_ns() - start) / 1e6 / frames;
+}
+
+/* The same, reading into two pixel buffers in turn, each one mapped when
+ * its fence signaled, a frame later */
+static double readback_async(int frames, void *pixels)
+{
+	GLsizeiptr size = (GLsizeiptr) width * height * 4;
+	GLsync fences[2] = { 0, 0 };
+	GLuint buffers[2];
+	uint64_t start;
+	int frame, i;
+
+	glGenBuffers(2, buffers);
+	for (i = 0; i < 2; i++) {
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, buffers[i]);
+		glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+	}
+
+	start = now_ns();
+	for (frame = 0; frame <= frames; frame++) {
+		GLsync fence;
+		GLenum waited;
+		void *mapped;
+
+		if (frame < frames) {
+			draw_frame(frame);
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, buffers[frame % 2]);
+			glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+			fences[frame % 2] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			eglSwapBuffers(display, surface);
+		}
+
+		if (frame == 0)
+			continue;
+
+		/* the previous frame */
+		fence = fences[(frame - 1) % 2];
+		waited = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ULL);
+		assert(waited == GL_ALREADY_SIGNALED || waited == GL_CONDITION_SATISFIED);
+		glDeleteSync(fence);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, buffers[(frame - 1) % 2]);
+		mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+		assert(mapped);
+		memcpy(pixels, mapped, size);
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	glDeleteBuffers(2, buffers);
+	return (now_ns() - start) / 1e6 / frames;
+}
+
+int main(int argc, char **argv)
+{
+	EGLint attr[] = {
+		EGL_BUFFER_SIZE, 32,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT_KHR,
+		EGL_NONE
+	};
+	EGLint ctxattr[] = {
+		EGL_CONTEXT_CLIENT_VERSION, 3,
+		EGL_NONE
+	};
+	EGLConfig ecfg;
+	EGLint num_config;
+	EGLContext context;
+	GLint major = 0, minor = 0;
+	GLuint program;
+	int frames = 300, opt;
+	double sync_ms, async_ms;
+	void *pixels;
+
+	while ((opt = getopt(argc, argv, "n:")) != -1) {
+		switch (opt) {
+		case 'n':
+			frames = atoi(optarg);
+			break;
+		default:
+			goto usage;
+		}
+	}
+
+	if (optind != argc || frames < 1)
+		goto usage;
+
+	display = eglGetDisplay(NULL);
+	assert(display != EGL_NO_DISPLAY);
+	assert(eglInitialize(display, 0, 0) == EGL_TRUE);
+
+	assert(eglChooseConfig(display, attr, &ecfg, 1, &num_config) == EGL_TRUE);
+	assert(num_config == 1);
+
+	surface = eglCreateWindowSurface(display, ecfg, (EGLNativeWindowType) NULL, NULL);
+	assert(surface != EGL_NO_SURFACE);
+
+	context = eglCreateContext(display, ecfg, EGL_NO_CONTEXT, ctxattr);
+	assert(context != EGL_NO_CONTEXT);
+
+	assert(eglMakeCurrent(display, surface, surface, context) == EGL_TRUE);
+
+	printf("%s\n", (const char *) glGetString(GL_VERSION));
+	glGetIntegerv(GL_MAJOR_VERSION, &major);
+	glGetIntegerv(GL_MINOR_VERSION, &minor);
+	assert(major >= 3);
+
+	program = glCreateProgram();
+	glAttachShader(program, load_shader(vertex_src, GL_VERTEX_SHADER));
+	glAttachShader(program, load_shader(fragment_src, GL_FRAGMENT_SHADER));
+	glBindAttribLocation(program, 0, "position");
+	{
+		const char *varyings[] = { "captured" };
+		glTransformFeedbackVaryings(program, 1, varyings, GL_INTERLEAVED_ATTRIBS);
+	}
+	link_program(program);
+	glUseProgram(program);
+
+	test_instancing(program);
+
+	if (major > 3 || minor >= 1) {
+		test_compute();
+		glUseProgram(program);
+	} else {
+		printf("compute shader, shader storage buffers: skipped, ES %d.%d\n", major, minor);
+	}
+
+	eglQuerySurface(display, surface, EGL_WIDTH, &width);
+	eglQuerySurface(display, surface, EGL_HEIGHT, &height);
+	glViewport(0, 0, width, height);
+	pixels = malloc((size_t) width * height * 4);
+	assert(pixels);
+
+	sync_ms = readback_sync(frames, pixels);
+	async_ms = readback_async(frames, pixels);
+	printf("%d frames of %dx%d: glReadPixels %.2f ms per frame, pixel buffers and fences %.2f ms per frame\n",
+		frames, width, height, sync_ms, async_ms);
+	assert(glGetError() == GL_NO_ERROR);
+
+	free(pixels);
+	eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	eglDestroyContext(display, context);
+	eglDestroySurface(display, surface);
+	eglTerminate(display);
+	return 0;
+
+usage:
+	fprintf(stderr, "usage: %s [-n frames]\n", argv[0]);
+	return 1;
+}
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Measures the overhead of the hook profiler.
+ *
+ * A number of threads call a few hooks, resolved the way the linker
+ * resolves them, in a loop. Run it once without and once with
+ * HYBRIS_HOOK_PROFILE=1 and compare the time per call; the profile table
+ * is printed at exit. Before that, hooks which pass floating point and
+ * variadic arguments, return floating point values, nest and fork are
+ * called to check that the profiler passes everything through.
+ *
+ * Usage: test_hook_profile [-t threads] [-n iterations per thread]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <getopt.h>
+#include <sys/wait.h>
+
+#include <hybris/common/hooks.h>
+#include "hook_profile.h"
+
+/* Large enough for bionic's pthread_mutex_t on all architectures */
+typedef struct {
+	uintptr_t value;
+	int32_t reserved[8];
+} bionic_mutex_t;
+
+static int (*hooked_lock)(void *);
+static int (*hooked_unlock)(void *);
+static size_t (*hooked_strlen)(const char *);
+static int (*hooked_snprintf)(char *, size_t, const char *, ...);
+static double (*hooked_strtod)(const char *, char **);
+static int (*hooked_once)(pthread_once_t *, void (*)(void));
+static pid_t (*hooked_fork)(void);
+
+static int iterations = 1000000;
+static pthread_barrier_t barrier;
+static size_t once_length;
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+static void once_routine(void)
+{
+	/* a profiled call inside another one */
+	once_length = hooked_strlen("nested");
+}
+
+static int check_hooks(void)
+{
+	static pthread_once_t once = PTHREAD_ONCE_INIT;
+	char buffer[64];
+	char *end;
+	pid_t pid;
+	int status;
+
+	hooked_snprintf(buffer, sizeof(buffer), "%s %d %.2f %.1f", "args", 42, 1.5, -0.25);
+	if (strcmp(buffer, "args 42 1.50 -0.2") != 0 && strcmp(buffer, "args 42 1.50 -0.3") != 0) {
+		fprintf(stderr, "snprintf through the hook returned \"%s\"\n", buffer);
+		return -1;
+	}
+
+	if (hooked_strtod("2.5x", &end) != 2.5 || *end != 'x') {
+		fprintf(stderr, "strtod through the hook failed\n");
+		return -1;
+	}
+
+	hooked_once(&once, once_routine);
+	if (once_length != 6) {
+		fprintf(stderr, "nested hook call failed\n");
+		return -1;
+	}
+
+	/* only hooked for newer Android versions */
+	if (!hooked_fork)
+		return 0;
+
+	pid = hooked_fork();
+	if (pid == 0) {
+		int ok = hooked_strlen("child") == 5;
+
+		fflush(stdout);
+		exit(ok ? 0 : 1);
+	}
+	if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+		fprintf(stderr, "forked child failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static void *worker(void *arg)
+{
+	bionic_mutex_t mutex;
+	size_t length = 0;
+	int n;
+
+	(void) arg;
+	memset(&mutex, 0, sizeof(mutex));
+
+	pthread_barrier_wait(&barrier);
+
+	for (n = 0; n < iterations; n++) {
+		hooked_lock(&mutex);
+		length += hooked_strlen("hook");
+		hooked_unlock(&mutex);
+	}
+
+	if (length != 4UL * iterations)
+		fprintf(stderr, "strlen through the hook failed\n");
+
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	int threads = 1, opt, i;
+	pthread_t *tids;
+	double start, elapsed;
+
+	while ((opt = getopt(argc, argv, "t:n:")) != -1) {
+		switch (opt) {
+		case 't':
+			threads = atoi(optarg);
+			break;
+		case 'n':
+			iterations = atoi(optarg);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-t threads] [-n iterations per thread]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (threads < 1 || iterations < 1)
+		return 1;
+
+	hooked_lock = hybris_get_hooked_symbol("pthread_mutex_lock");
+	hooked_unlock = hybris_get_hooked_symbol("pthread_mutex_unlock");
+	hooked_strlen = hybris_get_hooked_symbol("strlen");
+	hooked_snprintf = hybris_get_hooked_symbol("snprintf");
+	hooked_strtod = hybris_get_hooked_symbol("strtod");
+	hooked_once = hybris_get_hooked_symbol("pthread_once");
+	hooked_fork = hybris_get_hooked_symbol("fork");
+
+	if (!hooked_lock || !hooked_unlock || !hooked_strlen || !hooked_snprintf ||
+	    !hooked_strtod || !hooked_once) {
+		fprintf(stderr, "missing hooks\n");
+		return 1;
+	}
+
+	if (check_hooks() < 0)
+		return 1;
+
+	tids = calloc(threads, sizeof(pthread_t));
+	pthread_barrier_init(&barrier, NULL, threads + 1);
+	for (i = 0; i < threads; i++)
+		pthread_create(&tids[i], NULL, worker, NULL);
+
+	start = now();
+	pthread_barrier_wait(&barrier);
+	for (i = 0; i < threads; i++)
+		pthread_join(tids[i], NULL);
+	elapsed = now() - start;
+
+	printf("profiling %s, %d threads: %.1f ns per hook call\n",
+		hybris_hook_profile_enabled() ? "enabled" : "disabled", threads,
+		elapsed * 1000000000.0 / (3.0 * threads * iterations));
+
+	pthread_barrier_destroy(&barrier);
+	free(tids);
+	return 0;
+}
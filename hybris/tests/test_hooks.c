@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dlfcn.h>
+
+#include <hybris/common/hooks.h>
+
+/* A mix of symbols typically imported by vendor EGL/GLES libraries,
+ * both hooked ones and ones that are resolved by the linker itself */
+static const char *symbols[] = {
+	"malloc", "free", "calloc", "realloc", "memcpy", "memset", "memcmp",
+	"strlen", "strcmp", "strncmp", "strcpy", "strdup", "strchr",
+	"pthread_mutex_lock", "pthread_mutex_unlock", "pthread_mutex_init",
+	"pthread_cond_wait", "pthread_cond_signal", "pthread_create",
+	"pthread_getspecific", "pthread_setspecific", "pthread_key_create",
+	"fopen", "fclose", "fread", "fwrite", "fprintf", "snprintf",
+	"property_get", "__system_property_get", "getenv", "gettid",
+	"__android_log_print", "__android_log_buf_write", "__stack_chk_fail",
+	"__stack_chk_guard", "__cxa_atexit", "__cxa_finalize", "dlopen",
+	"dlsym", "dlclose", "ioctl", "mmap", "munmap", "open", "close",
+	"glDrawArrays", "glBindTexture", "eglGetProcAddress", "gralloc_alloc",
+	"_ZN7android6Parcel10writeInt32Ei", "_ZNK7android7RefBase9decStrongEPKv",
+};
+
+#define N_SYMBOLS (sizeof(symbols) / sizeof(symbols[0]))
+
+static unsigned long long lookups_during_load = 0;
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+static void *count_lookups(const char *symbol, const char *requester)
+{
+	lookups_during_load++;
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	int iterations = 20000;
+	unsigned long long lookups = 0;
+	unsigned int hooked = 0;
+	double start, elapsed, ns_per_lookup;
+	volatile void *sink = NULL;
+	unsigned int i;
+	int n;
+
+	/* The first lookup builds the hook table */
+	start = now();
+	hybris_get_hooked_symbol("malloc");
+	printf("hook table setup: %.3f ms\n", (now() - start) * 1000.0);
+
+	for (i = 0; i < N_SYMBOLS; i++)
+		if (hybris_get_hooked_symbol(symbols[i]) != NULL)
+			hooked++;
+
+	start = now();
+	for (n = 0; n < iterations; n++) {
+		for (i = 0; i < N_SYMBOLS; i++) {
+			sink = hybris_get_hooked_symbol(symbols[i]);
+			lookups++;
+		}
+	}
+	elapsed = now() - start;
+	ns_per_lookup = elapsed * 1000000000.0 / lookups;
+
+	printf("%llu lookups (%u/%zu symbols hooked) in %.3f ms\n",
+		lookups, hooked, N_SYMBOLS, elapsed * 1000.0);
+	printf("%.0f lookups/sec, %.1f ns/lookup\n", lookups / elapsed, ns_per_lookup);
+
+	/* Optionally load a library to see how much of its load time
+	 * is spent in hook resolution */
+	if (argc > 1) {
+		void *handle;
+
+		hybris_set_hook_callback(count_lookups);
+		start = now();
+		handle = android_dlopen(argv[1], RTLD_NOW);
+		elapsed = now() - start;
+		hybris_set_hook_callback(NULL);
+
+		if (!handle) {
+			fprintf(stderr, "failed to load %s: %s\n", argv[1], android_dlerror());
+			return 1;
+		}
+
+		printf("loaded %s in %.3f ms with %llu hook lookups, ~%.3f ms in hook resolution\n",
+			argv[1], elapsed * 1000.0, lookups_during_load,
+			lookups_during_load * ns_per_lookup / 1000000.0);
+		android_dlclose(handle);
+	}
+
+	(void) sink;
+	return 0;
+}
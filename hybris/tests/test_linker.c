@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Measures how long the hybris linker takes to load and link a library
+ * and all of its dependencies, by repeatedly calling android_dlopen and
+ * android_dlclose on it. The first cycle is the cold one, the following
+ * ones are warm (file pages cached, nothing else reused).
+ *
+ * A synthetic graph can be generated with gen_linker_bench_libs.sh:
+ *
+ *   gen_linker_bench_libs.sh /tmp/bench 50
+ *   test_linker -L /tmp/bench -n 20 libbench0.so
+ *
+ * -L sets the directories the libraries are searched in.
+ *
+ * HYBRIS_LINKER_PROFILE=<file> breaks the time down by library and phase
+ * (open, map, prelink, relocate, constructors), see linker_profile.h of
+ * the mm linker; <file>.folded can be fed to flamegraph.pl.
+ *
+ * Running it again with HYBRIS_RELOC_CACHE_DIR set compares against the
+ * relocation cache: the first cycle writes the cache, all later cycles
+ * (and later runs) link from it.
+ *
+ * HYBRIS_LD_LOAD_THREADS=1 compares against mapping the libraries of a
+ * dependency level one after another; use a large fanout to get wide
+ * levels.
+ *
+ * The relocation time with and without GNU hash tables is compared by
+ * generating the graph twice, with few large libraries:
+ *
+ *   HASH_STYLE=sysv gen_linker_bench_libs.sh /tmp/bench-sysv 8 5000
+ *   HASH_STYLE=gnu gen_linker_bench_libs.sh /tmp/bench-gnu 8 5000
+ *
+ * The throughput of relative relocations is measured with a graph of
+ * libraries which have many of them, as plain RELA/REL tables or packed
+ * into DT_RELR:
+ *
+ *   RELATIVES=50000 gen_linker_bench_libs.sh /tmp/bench-rel 8 10
+ *   RELR=1 RELATIVES=50000 gen_linker_bench_libs.sh /tmp/bench-relr 8 10
+ *
+ * -l loads with RTLD_LAZY, which binds the PLT lazily when
+ * HYBRIS_LD_BIND_LAZY=1 is set. -c calls a function int(int) with 3
+ * after each load, which for the generated libraries calls through the
+ * PLTs three levels deep; the result must not depend on the binding. The resident set
+ * size is printed after the first load (with the first call). Lazy
+ * binding only skips the lookups of symbols which are called, so the
+ * graph is best generated without pointer tables:
+ *
+ *   POINTER_TABLES=0 gen_linker_bench_libs.sh /tmp/bench-calls 50 2000
+ *   HYBRIS_LD_BIND_LAZY=1 test_linker -L /tmp/bench-calls -l -n 20 -c bench0_f0 libbench0.so
+ *
+ * -k keeps another library loaded during all cycles. Every dlopen and
+ * dlclose makes the linker's soinfo pages writable and read-only again,
+ * so keeping a large graph resident shows what that costs per cycle:
+ *
+ *   gen_linker_bench_libs.sh /tmp/bench-resident 200
+ *   PREFIX=small gen_linker_bench_libs.sh /tmp/bench-small 2
+ *   test_linker -L /tmp/bench-resident:/tmp/bench-small -n 1000 \
+ *       -k libbench0.so libsmall0.so
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dlfcn.h>
+#include <getopt.h>
+
+#include <hybris/common/binding.h>
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+/* VmRSS of this process in kB */
+static long resident_kb(void)
+{
+	char line[128];
+	long kb = -1;
+	FILE *f = fopen("/proc/self/status", "r");
+
+	if (!f)
+		return -1;
+
+	while (fgets(line, sizeof(line), f)) {
+		if (sscanf(line, "VmRSS: %ld", &kb) == 1)
+			break;
+	}
+
+	fclose(f);
+	return kb;
+}
+
+/* Makes the linker search the directories in path, separated by colons,
+ * before its default ones. It doesn't read HYBRIS_LD_LIBRARY_PATH. */
+static int set_library_path(const char *path)
+{
+	void *libdl = android_dlopen("libdl.so", RTLD_NOW);
+	void (*update)(const char *) = libdl ? android_dlsym(libdl, "android_update_LD_LIBRARY_PATH") : NULL;
+
+	if (!update) {
+		fprintf(stderr, "can't set the library path: %s\n", android_dlerror());
+		return -1;
+	}
+
+	update(path);
+	return 0;
+}
+
+static void usage(const char *name)
+{
+	fprintf(stderr, "usage: %s [-L path] [-l] [-n cycles] [-s symbol] [-c function] [-k library] library\n", name);
+	exit(1);
+}
+
+int main(int argc, char **argv)
+{
+	int cycles = 10;
+	const char *symbol = NULL, *function = NULL, *keep = NULL;
+	void *kept = NULL;
+	int flags = RTLD_NOW;
+	double first = 0, total = 0, best = 0, close_total = 0;
+	long rss_before, rss_first = 0;
+	int result = 0;
+	int opt, n;
+
+	while ((opt = getopt(argc, argv, "L:ln:s:c:k:")) != -1) {
+		switch (opt) {
+		case 'L':
+			if (set_library_path(optarg))
+				return 1;
+			break;
+		case 'l':
+			flags = RTLD_LAZY;
+			break;
+		case 'n':
+			cycles = atoi(optarg);
+			break;
+		case 's':
+			symbol = optarg;
+			break;
+		case 'c':
+			function = optarg;
+			break;
+		case 'k':
+			keep = optarg;
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	if (optind >= argc || cycles < 1)
+		usage(argv[0]);
+
+	if (keep) {
+		kept = android_dlopen(keep, RTLD_NOW);
+		if (!kept) {
+			fprintf(stderr, "failed to load %s: %s\n", keep, android_dlerror());
+			return 1;
+		}
+	}
+
+	rss_before = resident_kb();
+
+	for (n = 0; n < cycles; n++) {
+		double start = now(), elapsed;
+		void *handle = android_dlopen(argv[optind], flags);
+
+		if (!handle) {
+			fprintf(stderr, "failed to load %s: %s\n", argv[optind], android_dlerror());
+			return 1;
+		}
+
+		if (symbol && !android_dlsym(handle, symbol)) {
+			fprintf(stderr, "%s not found in %s\n", symbol, argv[optind]);
+			return 1;
+		}
+
+		if (function) {
+			int (*f)(int) = (int (*)(int)) android_dlsym(handle, function);
+
+			if (!f) {
+				fprintf(stderr, "%s not found in %s\n", function, argv[optind]);
+				return 1;
+			}
+			result = f(3);
+		}
+
+		elapsed = now() - start;
+		if (n == 0)
+			rss_first = resident_kb();
+		start = now();
+		android_dlclose(handle);
+		if (n > 0)
+			close_total += now() - start;
+
+		if (n == 0) {
+			first = elapsed;
+		} else {
+			total += elapsed;
+			if (best == 0 || elapsed < best)
+				best = elapsed;
+		}
+	}
+
+	printf("%s: first load %.3f ms (%s), %ld kB more resident\n", argv[optind],
+		first * 1000.0, flags == RTLD_LAZY ? "RTLD_LAZY" : "RTLD_NOW",
+		rss_first - rss_before);
+	if (function)
+		printf("%s: %s(3) returned %d\n", argv[optind], function, result);
+	if (cycles > 1)
+		printf("%s: %d more loads, avg %.3f ms, best %.3f ms\n", argv[optind],
+			cycles - 1, total * 1000.0 / (cycles - 1), best * 1000.0);
+	if (cycles > 1)
+		printf("%s: avg close %.3f ms\n", argv[optind],
+			close_total * 1000.0 / (cycles - 1));
+
+	if (kept)
+		android_dlclose(kept);
+
+	return 0;
+}
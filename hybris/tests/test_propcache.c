@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Test and benchmark of the build.prop property cache, which property_get
+ * falls back to when init doesn't answer property requests.
+ *
+ * A synthetic build.prop is written to a temporary directory and a
+ * stand-in for an unpatched init, which closes every connection without
+ * replying, is started. The test checks the values property_get returns,
+ * measures the latency and the number of system calls per lookup (by
+ * tracing a child process) and checks that a replaced build.prop is
+ * picked up.
+ *
+ * Usage: test_propcache [-k properties] [-n lookups]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <getopt.h>
+#include <sys/ptrace.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#include <hybris/properties/properties.h>
+
+static char dir[] = "/tmp/test_propcache.XXXXXX";
+static char build_prop[64], snapshot[64], service_socket[64];
+static int n_props = 500;
+static int iterations = 200000;
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+static void *unpatched_init(void *arg)
+{
+	int listener = (intptr_t) arg;
+
+	for (;;) {
+		prop_msg_t msg;
+		int s = accept(listener, NULL, NULL);
+
+		if (s < 0)
+			continue;
+
+		/* read the request and hang up, like Android's init does
+		 * for anything but SETPROP */
+		recv(s, &msg, sizeof(msg), MSG_WAITALL);
+		close(s);
+	}
+
+	return NULL;
+}
+
+static int start_service(void)
+{
+	struct sockaddr_un addr;
+	pthread_t tid;
+	int s;
+
+	s = socket(AF_LOCAL, SOCK_STREAM, 0);
+	if (s < 0)
+		return -1;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_LOCAL;
+	strncpy(addr.sun_path, service_socket, sizeof(addr.sun_path) - 1);
+
+	if (bind(s, (struct sockaddr *) &addr, sizeof(addr)) < 0 || listen(s, 16) < 0 ||
+	    pthread_create(&tid, NULL, unpatched_init, (void *) (intptr_t) s) != 0) {
+		close(s);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int write_build_prop(const char *version)
+{
+	char tmp[80];
+	FILE *f;
+	int n;
+
+	snprintf(tmp, sizeof(tmp), "%s.new", build_prop);
+	f = fopen(tmp, "w");
+	if (!f)
+		return -1;
+
+	fprintf(f, "# begin build properties\n");
+	fprintf(f, "ro.build.version.release=%s\r\n", version);
+	for (n = 0; n < n_props; n++)
+		fprintf(f, "ro.test.prop%d=value %d\n", n, n);
+	/* the first occurrence of a key wins */
+	fprintf(f, "ro.test.prop0=duplicate\n");
+	fprintf(f, "ro.test.long=%0200d\n", 0);
+	fclose(f);
+
+	/* replace it the way package managers do */
+	return rename(tmp, build_prop);
+}
+
+static int check(const char *key, const char *expected)
+{
+	char value[PROP_VALUE_MAX];
+
+	property_get(key, value, "(default)");
+	if (strcmp(value, expected) != 0) {
+		fprintf(stderr, "%s: got '%s' instead of '%s'\n", key, value, expected);
+		return 1;
+	}
+
+	return 0;
+}
+
+static void lookups(int count)
+{
+	char key[PROP_NAME_MAX], value[PROP_VALUE_MAX];
+	int n;
+
+	/* every fourth lookup is for a property which doesn't exist */
+	for (n = 0; n < count; n++) {
+		snprintf(key, sizeof(key), n % 4 ? "ro.test.prop%d" : "ro.test.none%d",
+			n % n_props);
+		property_get(key, value, NULL);
+	}
+}
+
+/* Returns the number of system calls made by lookups(count) */
+static long trace_lookups(int count)
+{
+	long stops = 0;
+	int status;
+	pid_t pid;
+
+	pid = fork();
+	if (pid == 0) {
+		ptrace(PTRACE_TRACEME, 0, NULL, NULL);
+		lookups(1);
+		raise(SIGSTOP);
+		lookups(count);
+		raise(SIGSTOP);
+		_exit(0);
+	}
+	if (pid < 0)
+		return -1;
+
+	if (waitpid(pid, &status, 0) < 0 || !WIFSTOPPED(status))
+		return -1;
+
+	/* every system call stops the child on entry and on exit */
+	for (;;) {
+		if (ptrace(PTRACE_SYSCALL, pid, NULL, NULL) < 0 ||
+		    waitpid(pid, &status, 0) < 0 || !WIFSTOPPED(status)) {
+			stops = -1;
+			break;
+		}
+		if (WSTOPSIG(status) == SIGSTOP)
+			break;
+		stops++;
+	}
+
+	kill(pid, SIGKILL);
+	waitpid(pid, &status, 0);
+
+	return stops < 0 ? -1 : stops / 2;
+}
+
+int main(int argc, char **argv)
+{
+	long base, traced;
+	double start, elapsed;
+	int opt, ret = 1;
+
+	while ((opt = getopt(argc, argv, "k:n:")) != -1) {
+		switch (opt) {
+		case 'k':
+			n_props = atoi(optarg);
+			break;
+		case 'n':
+			iterations = atoi(optarg);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-k properties] [-n lookups]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (n_props < 1 || iterations < 1)
+		return 1;
+
+	if (!mkdtemp(dir)) {
+		perror("mkdtemp");
+		return 1;
+	}
+
+	snprintf(build_prop, sizeof(build_prop), "%s/build.prop", dir);
+	snprintf(snapshot, sizeof(snapshot), "%s/snapshot", dir);
+	snprintf(service_socket, sizeof(service_socket), "%s/socket", dir);
+	setenv("HYBRIS_BUILD_PROP", build_prop, 1);
+	setenv("HYBRIS_PROPCACHE_SNAPSHOT", snapshot, 1);
+	setenv("HYBRIS_PROPERTY_SERVICE_SOCKET", service_socket, 1);
+
+	if (write_build_prop("1.0") < 0 || start_service() < 0) {
+		perror("setup");
+		goto out;
+	}
+
+	if (check("ro.build.version.release", "1.0") ||
+	    check("ro.test.prop0", "value 0") ||
+	    check("ro.test.prop1", "value 1") ||
+	    check("ro.test.long", "(default)") ||
+	    check("ro.test.none", "(default)"))
+		goto out;
+
+	start = now();
+	lookups(iterations);
+	elapsed = now() - start;
+	printf("%d properties: %.1f ns per lookup\n", n_props, elapsed * 1000000000.0 / iterations);
+
+	base = trace_lookups(0);
+	traced = trace_lookups(iterations / 10);
+	if (base < 0 || traced < 0)
+		printf("can't trace the system calls of lookups\n");
+	else
+		printf("%.3f system calls per lookup\n", (double) (traced - base) / (iterations / 10));
+
+	if (write_build_prop("2.0") < 0) {
+		perror("build.prop");
+		goto out;
+	}
+
+	/* changes are noticed within a second */
+	sleep(2);
+	if (check("ro.build.version.release", "2.0"))
+		goto out;
+
+	ret = 0;
+
+out:
+	unlink(build_prop);
+	unlink(snapshot);
+	unlink(service_socket);
+	rmdir(dir);
+	return ret;
+}
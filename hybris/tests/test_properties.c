@@ -0,0 +1,451 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Multithreaded benchmark of property_get and property_set.
+ *
+ * A stand-in property service is started on a private socket (see
+ * HYBRIS_PROPERTY_SERVICE_SOCKET). It stores the properties which are set
+ * and answers GETPROP requests for other properties with a value derived
+ * from the name. It supports persistent sessions (PROP_MSG_SESSION) and can
+ * be switched to behave like an init which doesn't.
+ *
+ * Then a number of threads look up properties, either a small set of
+ * properties which stays in the runtime property cache (hits), or
+ * properties which were never looked up before and have to be fetched
+ * from the service (misses), one at a time or with property_get_batch.
+ * Finally they set properties. Misses and sets are measured with sessions
+ * first, and then with one connection per request. The service can be
+ * slowed down to show whether misses of different threads wait for each
+ * other.
+ *
+ * The hit numbers are only meaningful with --enable-property-cache.
+ *
+ * Usage: test_properties [-t threads] [-n lookups per thread] [-k hit keys] [-b batch size]
+ *                        [-d service delay in us]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <getopt.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <hybris/properties/properties.h>
+
+enum mode {
+	MODE_HIT,
+	MODE_MISS,
+	MODE_BATCH,
+	MODE_SET,
+};
+
+static const char *mode_names[] = { "hit", "miss", "batch", "set" };
+
+static int iterations = 100000;
+static int n_keys = 64;
+static int batch = 16;
+static int delay_us;
+static enum mode mode;
+static int service_sessions = 1;
+static unsigned int generation;
+static int failed;
+static pthread_barrier_t barrier;
+
+/* the properties set with the stand-in service */
+struct stored_prop {
+	struct stored_prop *next;
+	char name[PROP_NAME_MAX];
+	char value[PROP_VALUE_MAX];
+};
+
+#define STORE_BUCKETS 1024
+static struct stored_prop *store[STORE_BUCKETS];
+static pthread_mutex_t store_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+static unsigned int store_hash(const char *name)
+{
+	unsigned int h = 0;
+
+	while (*name)
+		h = h * 31 + (unsigned char) *name++;
+
+	return h % STORE_BUCKETS;
+}
+
+static struct stored_prop *store_find(const char *name)
+{
+	struct stored_prop *prop;
+
+	for (prop = store[store_hash(name)]; prop; prop = prop->next) {
+		if (strcmp(prop->name, name) == 0)
+			break;
+	}
+
+	return prop;
+}
+
+/* Handles one request, returns 0 if the connection should be closed */
+static int service_handle(int s, prop_msg_t *msg, int in_session)
+{
+	struct stored_prop *prop;
+
+	msg->name[PROP_NAME_MAX - 1] = '\0';
+	msg->value[PROP_VALUE_MAX - 1] = '\0';
+
+	switch (msg->cmd) {
+	case PROP_MSG_GETPROP:
+		if (delay_us)
+			usleep(delay_us);
+
+		pthread_mutex_lock(&store_mutex);
+		prop = store_find(msg->name);
+		if (prop)
+			strcpy(msg->value, prop->value);
+		else
+			snprintf(msg->value, sizeof(msg->value), "value of %s", msg->name);
+		pthread_mutex_unlock(&store_mutex);
+
+		return send(s, msg, sizeof(*msg), MSG_NOSIGNAL) == sizeof(*msg) && in_session;
+
+	case PROP_MSG_SETPROP:
+		pthread_mutex_lock(&store_mutex);
+		prop = store_find(msg->name);
+		if (!prop) {
+			prop = calloc(1, sizeof(*prop));
+			strcpy(prop->name, msg->name);
+			prop->next = store[store_hash(msg->name)];
+			store[store_hash(msg->name)] = prop;
+		}
+		strcpy(prop->value, msg->value);
+		pthread_mutex_unlock(&store_mutex);
+
+		/* one-shot requests are answered by closing the connection */
+		return in_session && send(s, msg, sizeof(*msg), MSG_NOSIGNAL) == sizeof(*msg);
+
+	case PROP_MSG_SESSION:
+		if (in_session || !__sync_fetch_and_add(&service_sessions, 0))
+			return 0;
+
+		return send(s, msg, sizeof(*msg), MSG_NOSIGNAL) == sizeof(*msg);
+
+	default:
+		return 0;
+	}
+}
+
+static void *service_connection(void *arg)
+{
+	int s = (intptr_t) arg;
+	int in_session = 0;
+	prop_msg_t msg;
+
+	while (recv(s, &msg, sizeof(msg), MSG_WAITALL) == sizeof(msg)) {
+		int cmd = msg.cmd;
+
+		if (!service_handle(s, &msg, in_session))
+			break;
+		if (cmd == PROP_MSG_SESSION)
+			in_session = 1;
+	}
+
+	close(s);
+	return NULL;
+}
+
+static void *service(void *arg)
+{
+	int listener = (intptr_t) arg;
+
+	for (;;) {
+		pthread_t tid;
+		int s = accept(listener, NULL, NULL);
+
+		if (s < 0)
+			continue;
+
+		/* one thread per request, like init answers concurrently
+		 * from the point of view of the clients */
+		if (pthread_create(&tid, NULL, service_connection, (void *) (intptr_t) s) == 0)
+			pthread_detach(tid);
+		else
+			close(s);
+	}
+
+	return NULL;
+}
+
+static int start_service(char *path, size_t size)
+{
+	struct sockaddr_un addr;
+	pthread_t tid;
+	int s;
+
+	snprintf(path, size, "/tmp/test_properties.%d", (int) getpid());
+	unlink(path);
+
+	s = socket(AF_LOCAL, SOCK_STREAM, 0);
+	if (s < 0)
+		return -1;
+
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		close(s);
+		return -1;
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_LOCAL;
+	memcpy(addr.sun_path, path, strlen(path));
+
+	if (bind(s, (struct sockaddr *) &addr, sizeof(addr)) < 0 || listen(s, 128) < 0) {
+		close(s);
+		return -1;
+	}
+
+	if (pthread_create(&tid, NULL, service, (void *) (intptr_t) s) != 0)
+		return -1;
+
+	setenv("HYBRIS_PROPERTY_SERVICE_SOCKET", path, 1);
+	return 0;
+}
+
+static void check(const char *key, const char *value)
+{
+	char expected[PROP_VALUE_MAX];
+
+	/* check every result, the formatting costs much less
+	 * than a lookup of a miss */
+	snprintf(expected, sizeof(expected), "value of %s", key);
+	if (strcmp(value, expected) != 0)
+		__sync_fetch_and_add(&failed, 1);
+}
+
+static void get_batches(unsigned int index)
+{
+	char keys[batch][PROP_NAME_MAX], values[batch][PROP_VALUE_MAX];
+	const char *key_ptrs[batch];
+	char *value_ptrs[batch];
+	int n, i;
+
+	for (i = 0; i < batch; i++) {
+		key_ptrs[i] = keys[i];
+		value_ptrs[i] = values[i];
+	}
+
+	for (n = 0; n < iterations; n += batch) {
+		for (i = 0; i < batch; i++)
+			snprintf(keys[i], PROP_NAME_MAX, "batch.%u.%u.%d", generation, index, n + i);
+
+		property_get_batch(key_ptrs, value_ptrs, NULL, batch);
+
+		for (i = 0; i < batch; i++)
+			check(keys[i], values[i]);
+	}
+}
+
+static void set_props(unsigned int index)
+{
+	char key[PROP_NAME_MAX], value[PROP_VALUE_MAX], expected[PROP_VALUE_MAX];
+	int n;
+
+	snprintf(key, sizeof(key), "set.%u.%u", generation, index);
+
+	for (n = 0; n < iterations; n++) {
+		struct stored_prop *prop;
+
+		snprintf(value, sizeof(value), "%d", n);
+		property_set(key, value);
+
+		/* property_set only returns once the service has the value */
+		pthread_mutex_lock(&store_mutex);
+		prop = store_find(key);
+		if (!prop || strcmp(prop->value, value) != 0)
+			__sync_fetch_and_add(&failed, 1);
+		pthread_mutex_unlock(&store_mutex);
+	}
+
+	/* the last value has to be there */
+	snprintf(expected, sizeof(expected), "%d", iterations - 1);
+	property_get(key, value, NULL);
+	if (strcmp(value, expected) != 0)
+		__sync_fetch_and_add(&failed, 1);
+}
+
+static void *worker(void *arg)
+{
+	unsigned int index = (uintptr_t) arg;
+	char key[PROP_NAME_MAX], value[PROP_VALUE_MAX];
+	int n;
+
+	pthread_barrier_wait(&barrier);
+
+	switch (mode) {
+	case MODE_HIT:
+	case MODE_MISS:
+		for (n = 0; n < iterations; n++) {
+			if (mode == MODE_MISS)
+				snprintf(key, sizeof(key), "miss.%u.%u.%d", generation, index, n);
+			else
+				snprintf(key, sizeof(key), "hit.%d", (index + n) % n_keys);
+
+			property_get(key, value, NULL);
+			check(key, value);
+		}
+		break;
+
+	case MODE_BATCH:
+		get_batches(index);
+		break;
+
+	case MODE_SET:
+		set_props(index);
+		break;
+	}
+
+	return NULL;
+}
+
+static double run(int threads)
+{
+	pthread_t *tids = calloc(threads, sizeof(pthread_t));
+	double start, elapsed;
+	int i;
+
+	generation++;
+	pthread_barrier_init(&barrier, NULL, threads + 1);
+	for (i = 0; i < threads; i++)
+		pthread_create(&tids[i], NULL, worker, (void *) (uintptr_t) i);
+
+	start = now();
+	pthread_barrier_wait(&barrier);
+	for (i = 0; i < threads; i++)
+		pthread_join(tids[i], NULL);
+	elapsed = now() - start;
+
+	pthread_barrier_destroy(&barrier);
+	free(tids);
+
+	return elapsed;
+}
+
+static int report(int threads)
+{
+	/* misses are orders of magnitude slower */
+	int saved = iterations;
+	double elapsed;
+
+	if (mode != MODE_HIT && iterations > 1000)
+		iterations = 1000;
+	if (mode == MODE_BATCH)
+		iterations = iterations < batch ? batch : iterations - iterations % batch;
+
+	elapsed = run(threads);
+
+	if (failed) {
+		fprintf(stderr, "%s: got a wrong property value\n", mode_names[mode]);
+		return 1;
+	}
+
+	printf("%-6s %-8s %2d threads: %10.0f properties per sec, %8.1f ns per property\n",
+		mode_names[mode], mode == MODE_HIT ? "cached" : service_sessions ? "session" : "one-shot",
+		threads, (double) threads * iterations / elapsed,
+		elapsed * 1000000000.0 / ((double) threads * iterations));
+
+	iterations = saved;
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	int max_threads = 4, opt, threads;
+	char path[108], value[PROP_VALUE_MAX], key[PROP_NAME_MAX];
+
+	while ((opt = getopt(argc, argv, "t:n:k:b:d:")) != -1) {
+		switch (opt) {
+		case 't':
+			max_threads = atoi(optarg);
+			break;
+		case 'n':
+			iterations = atoi(optarg);
+			break;
+		case 'k':
+			n_keys = atoi(optarg);
+			break;
+		case 'b':
+			batch = atoi(optarg);
+			break;
+		case 'd':
+			delay_us = atoi(optarg);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-t threads] [-n lookups] [-k hit keys] [-b batch size] "
+				"[-d delay us]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (max_threads < 1 || iterations < 1 || n_keys < 1 || batch < 1 || batch > 1000 ||
+	    delay_us < 0)
+		return 1;
+
+	if (start_service(path, sizeof(path)) < 0) {
+		perror("property service");
+		return 1;
+	}
+
+	/* warm up the cache with the keys of the hit benchmark */
+	for (opt = 0; opt < n_keys; opt++) {
+		snprintf(key, sizeof(key), "hit.%d", opt);
+		property_get(key, value, NULL);
+	}
+
+	for (threads = 1; threads <= max_threads; threads *= 2) {
+		for (mode = MODE_HIT; mode <= MODE_SET; mode++) {
+			if (report(threads))
+				goto fail;
+		}
+	}
+
+	/* an init which doesn't know about sessions, the client falls
+	 * back to one connection per request for good */
+	service_sessions = 0;
+	for (threads = 1; threads <= max_threads; threads *= 2) {
+		for (mode = MODE_MISS; mode <= MODE_SET; mode++) {
+			if (report(threads))
+				goto fail;
+		}
+	}
+
+	unlink(path);
+	return 0;
+
+fail:
+	unlink(path);
+	return 1;
+}
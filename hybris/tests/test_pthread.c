@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Contention benchmark for the bionic pthread_mutex_* hooks.
+ *
+ * A number of threads lock and unlock statically initialized bionic
+ * mutexes through the hooks, the same way Android libraries do, and the
+ * throughput is compared against plain glibc mutexes. Every round starts
+ * from freshly initialized mutexes, so all threads race on their first
+ * use, and the shared counters verify that they all ended up using the
+ * same glibc mutex.
+ *
+ * Before that, the main thread forks repeatedly while other threads
+ * create and destroy mutexes, and every child has to be able to create
+ * a mutex of its own.
+ *
+ * Usage: test_pthread [-t threads] [-n iterations per thread] [-m mutexes] [-r rounds]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <getopt.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <hybris/common/hooks.h>
+
+/* Large enough for bionic's pthread_mutex_t on all architectures, the
+ * static initializer of a normal mutex is all zeroes */
+typedef struct {
+	uintptr_t value;
+	int32_t reserved[8];
+} bionic_mutex_t;
+
+struct lock {
+	union {
+		bionic_mutex_t bionic;
+		pthread_mutex_t glibc;
+	} mutex;
+	unsigned long counter;
+} __attribute__((aligned(64)));
+
+static int (*bionic_lock)(void *);
+static int (*bionic_unlock)(void *);
+static int (*bionic_destroy)(void *);
+
+static int use_hooks;
+static int iterations = 1000000;
+static int n_locks = 1;
+static struct lock *locks;
+static pthread_barrier_t barrier;
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+static void *worker(void *arg)
+{
+	unsigned int index = (uintptr_t) arg;
+	int n;
+
+	pthread_barrier_wait(&barrier);
+
+	for (n = 0; n < iterations; n++) {
+		struct lock *l = &locks[(index + n) % n_locks];
+
+		if (use_hooks) {
+			bionic_lock(&l->mutex.bionic);
+			l->counter++;
+			bionic_unlock(&l->mutex.bionic);
+		} else {
+			pthread_mutex_lock(&l->mutex.glibc);
+			l->counter++;
+			pthread_mutex_unlock(&l->mutex.glibc);
+		}
+	}
+
+	return NULL;
+}
+
+/* Returns the wall clock time of a round, or a negative value if
+ * the counters show that the mutexes didn't exclude each other */
+static double run(int threads)
+{
+	pthread_t *tids = calloc(threads, sizeof(pthread_t));
+	unsigned long total = 0;
+	double start, elapsed;
+	int i;
+
+	for (i = 0; i < n_locks; i++) {
+		memset(&locks[i], 0, sizeof(locks[i]));
+		if (!use_hooks)
+			pthread_mutex_init(&locks[i].mutex.glibc, NULL);
+	}
+
+	pthread_barrier_init(&barrier, NULL, threads + 1);
+	for (i = 0; i < threads; i++)
+		pthread_create(&tids[i], NULL, worker, (void *) (uintptr_t) i);
+
+	start = now();
+	pthread_barrier_wait(&barrier);
+	for (i = 0; i < threads; i++)
+		pthread_join(tids[i], NULL);
+	elapsed = now() - start;
+
+	pthread_barrier_destroy(&barrier);
+	free(tids);
+
+	for (i = 0; i < n_locks; i++) {
+		total += locks[i].counter;
+		if (use_hooks)
+			bionic_destroy(&locks[i].mutex.bionic);
+		else
+			pthread_mutex_destroy(&locks[i].mutex.glibc);
+	}
+
+	if (total != (unsigned long) threads * iterations)
+		return -1;
+
+	return elapsed;
+}
+
+static volatile int churning;
+
+static void *churn(void *arg)
+{
+	bionic_mutex_t mutex;
+
+	while (churning) {
+		memset(&mutex, 0, sizeof(mutex));
+		bionic_lock(&mutex);
+		bionic_unlock(&mutex);
+		bionic_destroy(&mutex);
+	}
+
+	return NULL;
+}
+
+/* Returns nonzero if a child forked while the other threads were
+ * creating mutexes couldn't create one */
+static int check_fork(int threads)
+{
+	pthread_t *tids = calloc(threads, sizeof(pthread_t));
+	int failed = 0;
+	int i;
+
+	churning = 1;
+	for (i = 0; i < threads; i++)
+		pthread_create(&tids[i], NULL, churn, NULL);
+
+	for (i = 0; i < 200 && !failed; i++) {
+		int status;
+		pid_t pid = fork();
+
+		if (pid == 0) {
+			bionic_mutex_t mutex;
+
+			/* a deadlock kills the child */
+			alarm(5);
+			memset(&mutex, 0, sizeof(mutex));
+			bionic_lock(&mutex);
+			bionic_unlock(&mutex);
+			bionic_destroy(&mutex);
+			_exit(0);
+		}
+
+		if (pid < 0 || waitpid(pid, &status, 0) != pid ||
+				!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			failed = 1;
+	}
+
+	churning = 0;
+	for (i = 0; i < threads; i++)
+		pthread_join(tids[i], NULL);
+	free(tids);
+
+	return failed;
+}
+
+static int report(const char *name, int threads, int rounds)
+{
+	double best = 0;
+	int r;
+
+	for (r = 0; r < rounds; r++) {
+		double elapsed = run(threads);
+
+		if (elapsed < 0) {
+			fprintf(stderr, "%s: lost updates, mutual exclusion is broken\n", name);
+			return 1;
+		}
+
+		if (best == 0 || elapsed < best)
+			best = elapsed;
+	}
+
+	printf("%-8s %2d threads, %d mutexes: %6.1f M lock/unlock per sec, %.1f ns per pair\n",
+		name, threads, n_locks, (double) threads * iterations / best / 1000000.0,
+		best * 1000000000.0 / ((double) threads * iterations));
+
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	int max_threads = 4, rounds = 5;
+	int opt, threads;
+
+	while ((opt = getopt(argc, argv, "t:n:m:r:")) != -1) {
+		switch (opt) {
+		case 't':
+			max_threads = atoi(optarg);
+			break;
+		case 'n':
+			iterations = atoi(optarg);
+			break;
+		case 'm':
+			n_locks = atoi(optarg);
+			break;
+		case 'r':
+			rounds = atoi(optarg);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-t threads] [-n iterations] [-m mutexes] [-r rounds]\n",
+				argv[0]);
+			return 1;
+		}
+	}
+
+	if (max_threads < 1 || iterations < 1 || n_locks < 1 || rounds < 1)
+		return 1;
+
+	bionic_lock = hybris_get_hooked_symbol("pthread_mutex_lock");
+	bionic_unlock = hybris_get_hooked_symbol("pthread_mutex_unlock");
+	bionic_destroy = hybris_get_hooked_symbol("pthread_mutex_destroy");
+	if (!bionic_lock || !bionic_unlock || !bionic_destroy) {
+		fprintf(stderr, "pthread_mutex hooks not found\n");
+		return 1;
+	}
+
+	if (check_fork(max_threads)) {
+		fprintf(stderr, "a child forked while creating mutexes deadlocked\n");
+		return 1;
+	}
+
+	if (posix_memalign((void **) &locks, 64, n_locks * sizeof(struct lock)) != 0)
+		return 1;
+
+	for (threads = 1; threads <= max_threads; threads *= 2) {
+		use_hooks = 0;
+		if (report("glibc", threads, rounds))
+			return 1;
+
+		use_hooks = 1;
+		if (report("hooked", threads, rounds))
+			return 1;
+	}
+
+	free(locks);
+	return 0;
+}
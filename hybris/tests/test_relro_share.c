@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Measures the memory used by several processes which load the same
+ * library, to see what sharing the RELRO segments between them saves
+ * (HYBRIS_RELRO_SHARE_DIR). The clients are started one after another,
+ * each one loads the library and waits; then the proportional set size
+ * and private dirty memory of all of them are added up from
+ * /proc/<pid>/smaps. Pages mapped from the sharing directory are counted
+ * separately.
+ *
+ * The pointer tables of the generated libraries are only in the RELRO
+ * segment when they are const:
+ *
+ *   RELRO=1 gen_linker_bench_libs.sh /tmp/bench-relro 50 2000
+ *   test_relro_share -L /tmp/bench-relro -n 10 libbench0.so
+ *   HYBRIS_RELRO_SHARE_DIR=/tmp/relro test_relro_share -L /tmp/bench-relro -n 10 libbench0.so
+ *
+ * -L sets the directories the libraries are searched in.
+ *
+ * Usage: test_relro_share [-L path] [-n clients] library
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <dlfcn.h>
+
+#include <hybris/common/binding.h>
+
+struct client {
+	pid_t pid;
+	int hold;
+};
+
+struct usage {
+	unsigned long pss;
+	unsigned long private_dirty;
+	unsigned long shared_relro;
+};
+
+/* Makes the linker search the directories in path, separated by colons,
+ * before its default ones. It doesn't read HYBRIS_LD_LIBRARY_PATH. */
+static int set_library_path(const char *path)
+{
+	void *libdl = android_dlopen("libdl.so", RTLD_NOW);
+	void (*update)(const char *) = libdl ? android_dlsym(libdl, "android_update_LD_LIBRARY_PATH") : NULL;
+
+	if (!update) {
+		fprintf(stderr, "can't set the library path: %s\n", android_dlerror());
+		return -1;
+	}
+
+	update(path);
+	return 0;
+}
+
+/* Loads the library and waits until stdin is closed. */
+static int run_client(const char *library)
+{
+	char c = 1;
+
+	if (!android_dlopen(library, RTLD_NOW)) {
+		fprintf(stderr, "failed to load %s: %s\n", library, android_dlerror());
+		c = 0;
+	}
+	if (write(1, &c, 1) != 1 || !c)
+		return 1;
+
+	while (read(0, &c, 1) > 0)
+		;
+	return 0;
+}
+
+static int start_client(const char *argv0, const char *path, const char *library,
+		struct client *client)
+{
+	int ready[2], hold[2];
+	char c;
+
+	/* close-on-exec, or the later clients keep the earlier ones waiting */
+	if (pipe2(ready, O_CLOEXEC) || pipe2(hold, O_CLOEXEC))
+		return -1;
+
+	client->pid = fork();
+	if (client->pid == 0) {
+		dup2(hold[0], 0);
+		dup2(ready[1], 1);
+		close(hold[1]);
+		close(ready[0]);
+		if (path)
+			execl("/proc/self/exe", argv0, "-L", path, "-w", library, (char *) NULL);
+		else
+			execl("/proc/self/exe", argv0, "-w", library, (char *) NULL);
+		_exit(1);
+	}
+
+	close(hold[0]);
+	close(ready[1]);
+	client->hold = hold[1];
+
+	if (client->pid < 0 || read(ready[0], &c, 1) != 1 || !c) {
+		close(ready[0]);
+		return -1;
+	}
+	close(ready[0]);
+	return 0;
+}
+
+static void add_usage(pid_t pid, const char *share_dir, struct usage *usage)
+{
+	char path[64], line[512];
+	int in_share_dir = 0;
+	unsigned long kb;
+	FILE *f;
+
+	snprintf(path, sizeof(path), "/proc/%d/smaps", pid);
+	f = fopen(path, "r");
+	if (!f)
+		return;
+
+	while (fgets(line, sizeof(line), f)) {
+		if (sscanf(line, "Pss: %lu kB", &kb) == 1) {
+			usage->pss += kb;
+		} else if (sscanf(line, "Private_Dirty: %lu kB", &kb) == 1) {
+			usage->private_dirty += kb;
+		} else if (sscanf(line, "Size: %lu kB", &kb) == 1) {
+			if (in_share_dir)
+				usage->shared_relro += kb;
+		} else if (strchr(line, '-') && strchr(line, '-') < strchr(line, ' ')) {
+			/* the header line of the next mapping */
+			char *name = strchr(line, '/');
+			in_share_dir = share_dir && name &&
+				strncmp(name, share_dir, strlen(share_dir)) == 0;
+		}
+	}
+	fclose(f);
+}
+
+int main(int argc, char **argv)
+{
+	const char *share_dir = getenv("HYBRIS_RELRO_SHARE_DIR");
+	struct client *clients;
+	struct usage usage = { 0, 0, 0 };
+	const char *path = NULL;
+	int count = 10, opt, i, started = 0, failed = 0;
+
+	while ((opt = getopt(argc, argv, "L:n:w")) != -1) {
+		switch (opt) {
+		case 'L':
+			path = optarg;
+			if (set_library_path(path))
+				return 1;
+			break;
+		case 'n':
+			count = atoi(optarg);
+			break;
+		case 'w':
+			if (optind != argc - 1)
+				goto usage;
+			return run_client(argv[optind]);
+		default:
+			goto usage;
+		}
+	}
+
+	if (optind != argc - 1 || count < 1)
+		goto usage;
+
+	if (share_dir && !*share_dir)
+		share_dir = NULL;
+
+	clients = calloc(count, sizeof(struct client));
+	for (i = 0; i < count; i++) {
+		if (start_client(argv[0], path, argv[optind], &clients[i])) {
+			fprintf(stderr, "client %d failed\n", i);
+			failed = 1;
+			break;
+		}
+		started++;
+	}
+
+	for (i = 0; i < started; i++)
+		add_usage(clients[i].pid, share_dir, &usage);
+
+	for (i = 0; i < count; i++) {
+		if (clients[i].pid <= 0)
+			continue;
+		close(clients[i].hold);
+		waitpid(clients[i].pid, NULL, 0);
+	}
+
+	if (started) {
+		printf("%d clients%s: Pss %lu kB (%lu kB per client), private dirty %lu kB per client,"
+			" %lu kB per client mapped from the RELRO files\n",
+			started, share_dir ? " sharing RELRO" : "", usage.pss, usage.pss / started,
+			usage.private_dirty / started, usage.shared_relro / started);
+	}
+
+	free(clients);
+	return failed;
+
+usage:
+	fprintf(stderr, "usage: %s [-L path] [-n clients] library\n", argv[0]);
+	return 1;
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Multi-process stress test for process-shared bionic locks, which the
+ * hooks keep in the hybris shared memory region.
+ *
+ * Several processes lock and unlock one process-shared mutex through the
+ * hooks and report the average latency of a lock/unlock pair. Meanwhile
+ * every process keeps creating and destroying process-shared mutexes and
+ * conditions of its own. The size of the shared memory region is printed
+ * after every round: it should level off instead of growing with the
+ * number of rounds.
+ *
+ * Usage: test_shm [-p processes] [-n iterations] [-c init/destroy cycles] [-r rounds]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <getopt.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <hybris/common/hooks.h>
+
+/* where shm_open puts the region of the hooks */
+#define SHM_FILE "/dev/shm/hybris_shm_data_v2"
+
+/* Large enough for bionic's lock types on all architectures */
+typedef struct {
+	uintptr_t value;
+	int32_t reserved[11];
+} bionic_lock_t;
+
+struct shared {
+	bionic_lock_t mutex;
+	unsigned long counter;
+	double latency_ns[64];
+};
+
+static int (*bionic_mutex_init)(void *, const pthread_mutexattr_t *);
+static int (*bionic_mutex_destroy)(void *);
+static int (*bionic_mutex_lock)(void *);
+static int (*bionic_mutex_unlock)(void *);
+static int (*bionic_cond_init)(void *, const pthread_condattr_t *);
+static int (*bionic_cond_destroy)(void *);
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+static long shm_size(void)
+{
+	struct stat st;
+
+	if (stat(SHM_FILE, &st) != 0)
+		return -1;
+
+	return st.st_size;
+}
+
+static void child(struct shared *shared, int index, int iterations, int cycles)
+{
+	pthread_mutexattr_t mattr;
+	pthread_condattr_t cattr;
+	bionic_lock_t mutex, cond;
+	double start;
+	int n;
+
+	pthread_mutexattr_init(&mattr);
+	pthread_mutexattr_setpshared(&mattr, PTHREAD_PROCESS_SHARED);
+	pthread_condattr_init(&cattr);
+	pthread_condattr_setpshared(&cattr, PTHREAD_PROCESS_SHARED);
+
+	start = now();
+	for (n = 0; n < iterations; n++) {
+		bionic_mutex_lock(&shared->mutex);
+		shared->counter++;
+		bionic_mutex_unlock(&shared->mutex);
+
+		/* interleave the churn with the locking */
+		if ((long long) n * cycles / iterations != (long long) (n + 1) * cycles / iterations) {
+			memset(&mutex, 0, sizeof(mutex));
+			memset(&cond, 0, sizeof(cond));
+			bionic_mutex_init(&mutex, &mattr);
+			bionic_cond_init(&cond, &cattr);
+			bionic_cond_destroy(&cond);
+			bionic_mutex_destroy(&mutex);
+		}
+	}
+	shared->latency_ns[index] = (now() - start) * 1000000000.0 / iterations;
+
+	/* don't run the atexit handlers of the parent */
+	_exit(0);
+}
+
+int main(int argc, char **argv)
+{
+	int processes = 4, iterations = 100000, cycles = 1000, rounds = 10;
+	pthread_mutexattr_t attr;
+	struct shared *shared;
+	int opt, r, i;
+
+	while ((opt = getopt(argc, argv, "p:n:c:r:")) != -1) {
+		switch (opt) {
+		case 'p':
+			processes = atoi(optarg);
+			break;
+		case 'n':
+			iterations = atoi(optarg);
+			break;
+		case 'c':
+			cycles = atoi(optarg);
+			break;
+		case 'r':
+			rounds = atoi(optarg);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-p processes] [-n iterations] [-c cycles] [-r rounds]\n",
+				argv[0]);
+			return 1;
+		}
+	}
+
+	if (processes < 1 || processes > 64 || iterations < 1 || cycles < 0 ||
+	    cycles > iterations || rounds < 1)
+		return 1;
+
+	bionic_mutex_init = hybris_get_hooked_symbol("pthread_mutex_init");
+	bionic_mutex_destroy = hybris_get_hooked_symbol("pthread_mutex_destroy");
+	bionic_mutex_lock = hybris_get_hooked_symbol("pthread_mutex_lock");
+	bionic_mutex_unlock = hybris_get_hooked_symbol("pthread_mutex_unlock");
+	bionic_cond_init = hybris_get_hooked_symbol("pthread_cond_init");
+	bionic_cond_destroy = hybris_get_hooked_symbol("pthread_cond_destroy");
+	if (!bionic_mutex_init || !bionic_mutex_destroy || !bionic_mutex_lock ||
+	    !bionic_mutex_unlock || !bionic_cond_init || !bionic_cond_destroy) {
+		fprintf(stderr, "pthread hooks not found\n");
+		return 1;
+	}
+
+	shared = mmap(NULL, sizeof(*shared), PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (shared == MAP_FAILED) {
+		perror("mmap");
+		return 1;
+	}
+
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+	bionic_mutex_init(&shared->mutex, &attr);
+	pthread_mutexattr_destroy(&attr);
+
+	printf("initial shm size %ld bytes\n", shm_size());
+
+	for (r = 0; r < rounds; r++) {
+		double avg = 0;
+
+		shared->counter = 0;
+
+		for (i = 0; i < processes; i++) {
+			pid_t pid = fork();
+
+			if (pid == 0)
+				child(shared, i, iterations, cycles);
+			if (pid < 0) {
+				perror("fork");
+				return 1;
+			}
+		}
+
+		for (i = 0; i < processes; i++)
+			wait(NULL);
+
+		if (shared->counter != (unsigned long) processes * iterations) {
+			fprintf(stderr, "lost updates: %lu instead of %lu\n", shared->counter,
+				(unsigned long) processes * iterations);
+			return 1;
+		}
+
+		for (i = 0; i < processes; i++)
+			avg += shared->latency_ns[i] / processes;
+
+		printf("round %d: %d processes, %.1f ns per lock/unlock, "
+			"%d shared init/destroy cycles, shm size %ld bytes\n",
+			r + 1, processes, avg, processes * cycles, shm_size());
+	}
+
+	bionic_mutex_destroy(&shared->mutex);
+	munmap(shared, sizeof(*shared));
+
+	return 0;
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Measures the cost of the HYBRIS_TRACE_* tracepoints.
+ *
+ * A number of threads record begin/end pairs and counters as fast as they
+ * can. Run it with HYBRIS_TRACE=1, and either with HYBRIS_LOGGING_TARGET
+ * set to print the tracepoints, or with HYBRIS_TRACE_FILE set to record
+ * them in binary form. The binary trace can be converted with
+ * hybris-trace2json. The threads produce events much faster than the
+ * drainer writes them out, so most of them show up as dropped.
+ *
+ * Usage: test_trace [-t threads] [-n events per thread]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <getopt.h>
+
+/* the tracepoints are only compiled in debug builds */
+#ifndef DEBUG
+#define DEBUG
+#endif
+#include "logging.h"
+
+static int iterations = 100000;
+static pthread_barrier_t barrier;
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+static void *worker(void *arg)
+{
+	int n;
+
+	pthread_barrier_wait(&barrier);
+
+	for (n = 0; n < iterations; n++) {
+		HYBRIS_TRACE_BEGIN("test-trace", "work", "-%p", arg);
+		HYBRIS_TRACE_COUNTER("test-trace", "iteration", "%i", n);
+		HYBRIS_TRACE_END("test-trace", "work", "-%p", arg);
+	}
+
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	int threads = 2, opt, i;
+	pthread_t *tids;
+	double start, elapsed;
+
+	while ((opt = getopt(argc, argv, "t:n:")) != -1) {
+		switch (opt) {
+		case 't':
+			threads = atoi(optarg);
+			break;
+		case 'n':
+			iterations = atoi(optarg);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-t threads] [-n events per thread]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (threads < 1 || iterations < 1)
+		return 1;
+
+	if (!hybris_should_trace("test-trace", "work"))
+		fprintf(stderr, "tracing is disabled, set HYBRIS_TRACE=1\n");
+
+	tids = calloc(threads, sizeof(pthread_t));
+	pthread_barrier_init(&barrier, NULL, threads + 1);
+	for (i = 0; i < threads; i++)
+		pthread_create(&tids[i], NULL, worker, (void *) (long) i);
+
+	start = now();
+	pthread_barrier_wait(&barrier);
+	for (i = 0; i < threads; i++)
+		pthread_join(tids[i], NULL);
+	elapsed = now() - start;
+
+	fprintf(stderr, "%s backend, %d threads: %.1f ns per tracepoint\n",
+		hybris_should_trace("test-trace", "work") ?
+			(hybris_trace_binary() ? "binary" : "text") : "no",
+		threads, elapsed * 1000000000.0 / (3.0 * threads * iterations));
+
+	pthread_barrier_destroy(&barrier);
+	free(tids);
+	return 0;
+}
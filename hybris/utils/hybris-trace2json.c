@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2016 The libhybris authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * Converts binary traces written with HYBRIS_TRACE=1 HYBRIS_TRACE_FILE=...
+ * to the Chrome trace event format, which chrome://tracing and Perfetto
+ * can load. The traces of several processes can be merged into one file.
+ *
+ * Usage: hybris-trace2json <trace file>... > trace.json
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "trace.h"
+
+struct tracepoint {
+	uint64_t id;
+	char what;
+	const char *module;
+	const char *name;
+	const char *format;
+};
+
+static struct tracepoint *tracepoints;
+static size_t n_tracepoints, alloc_tracepoints;
+static int first_event = 1;
+
+static const struct tracepoint *find_tracepoint(uint64_t id)
+{
+	size_t n;
+
+	/* few tracepoints, and the recently defined ones are the hot ones */
+	for (n = n_tracepoints; n-- > 0;) {
+		if (tracepoints[n].id == id)
+			return &tracepoints[n];
+	}
+
+	return NULL;
+}
+
+static void print_string(const char *s)
+{
+	putchar('"');
+	for (; *s; s++) {
+		unsigned char c = *s;
+
+		if (c == '"' || c == '\\')
+			printf("\\%c", c);
+		else if (c < 0x20)
+			printf("\\u%04x", c);
+		else
+			putchar(c);
+	}
+	putchar('"');
+}
+
+/* Applies a printf format to the raw arguments of an event */
+/* Signed arguments are recorded sign extended to 64 bits, unsigned ones
+ * and pointers are cut back to the word size with word_mask */
+static void format_args(const char *format, const uint64_t *args, unsigned int nargs,
+			uint64_t word_mask, char *out, size_t size)
+{
+	size_t len = 0;
+	unsigned int arg = 0;
+
+	out[0] = '\0';
+
+	while (*format && len + 1 < size) {
+		char spec[32], conversion;
+		size_t spec_len = 0;
+		int n;
+
+		if (*format != '%' || format[1] == '%') {
+			out[len++] = *format;
+			format += *format == '%' ? 2 : 1;
+			out[len] = '\0';
+			continue;
+		}
+
+		/* copy flags, width and precision, drop the length modifiers */
+		spec[spec_len++] = *format++;
+		while (*format && strchr("-+ #0123456789.", *format) && spec_len < sizeof(spec) - 4)
+			spec[spec_len++] = *format++;
+		while (*format && strchr("hljztL", *format))
+			format++;
+
+		conversion = *format;
+		if (!conversion)
+			break;
+		format++;
+
+		if (arg >= nargs) {
+			n = snprintf(out + len, size - len, "?");
+		} else if (strchr("di", conversion)) {
+			strcpy(spec + spec_len, "lld");
+			n = snprintf(out + len, size - len, spec, (long long) (int64_t) args[arg++]);
+		} else if (strchr("uoxXc", conversion)) {
+			spec[spec_len] = conversion == 'c' ? 'c' : 'l';
+			spec[spec_len + 1] = conversion == 'c' ? '\0' : 'l';
+			spec[spec_len + 2] = conversion;
+			spec[spec_len + 3] = '\0';
+			if (conversion == 'c')
+				n = snprintf(out + len, size - len, spec, (int) args[arg++]);
+			else
+				n = snprintf(out + len, size - len, spec, (unsigned long long) (args[arg++] & word_mask));
+		} else {
+			/* pointers, and strings or floats, which are not recorded
+			 * by value, as hexadecimal numbers */
+			n = snprintf(out + len, size - len, "0x%" PRIx64, args[arg++] & word_mask);
+		}
+
+		if (n < 0)
+			break;
+		len += (size_t) n < size - len ? (size_t) n : size - len - 1;
+	}
+}
+
+static void print_event(uint32_t pid, uint64_t word_mask, const struct hybris_trace_event *event)
+{
+	const struct tracepoint *tracepoint = find_tracepoint(event->tracepoint);
+	unsigned int nargs = event->nargs < HYBRIS_TRACE_MAX_ARGS ? event->nargs : HYBRIS_TRACE_MAX_ARGS;
+	char message[512];
+
+	if (!tracepoint)
+		return;
+
+	printf("%s\n{\"name\":", first_event ? "" : ",");
+	first_event = 0;
+	print_string(tracepoint->name);
+	printf(",\"cat\":");
+	print_string(tracepoint->module);
+	printf(",\"ph\":\"%c\",\"ts\":%" PRIu64 ".%03u,\"pid\":%u,\"tid\":%u",
+		tracepoint->what == 'B' || tracepoint->what == 'E' ? tracepoint->what : 'C',
+		event->timestamp / 1000, (unsigned int) (event->timestamp % 1000), pid, event->tid);
+
+	if (tracepoint->what == 'B' || tracepoint->what == 'E') {
+		format_args(tracepoint->format, event->args, nargs, word_mask, message, sizeof(message));
+		printf(",\"args\":{\"message\":");
+		print_string(message);
+		printf("}}");
+	} else {
+		printf(",\"args\":{\"value\":%" PRId64 "}}", nargs ? (int64_t) event->args[0] : 0);
+	}
+}
+
+static void print_dropped(uint32_t pid, uint32_t tid, uint32_t count, uint64_t timestamp)
+{
+	printf("%s\n{\"name\":\"dropped %u events\",\"ph\":\"i\",\"s\":\"t\","
+		"\"ts\":%" PRIu64 ".%03u,\"pid\":%u,\"tid\":%u}",
+		first_event ? "" : ",", count, timestamp / 1000,
+		(unsigned int) (timestamp % 1000), pid, tid);
+	first_event = 0;
+}
+
+static int add_tracepoint(const char *data, size_t size)
+{
+	struct tracepoint tracepoint;
+	const char *end = data + size;
+	const char *strings[3];
+	int i;
+
+	if (size < sizeof(uint64_t) + 1)
+		return -1;
+
+	memcpy(&tracepoint.id, data, sizeof(uint64_t));
+	data += sizeof(uint64_t);
+	tracepoint.what = *data++;
+
+	for (i = 0; i < 3; i++) {
+		const char *nul = memchr(data, '\0', end - data);
+
+		if (!nul)
+			return -1;
+		strings[i] = data;
+		data = nul + 1;
+	}
+
+	tracepoint.module = strings[0];
+	tracepoint.name = strings[1];
+	tracepoint.format = strings[2];
+
+	if (n_tracepoints == alloc_tracepoints) {
+		alloc_tracepoints = alloc_tracepoints ? 2 * alloc_tracepoints : 64;
+		tracepoints = realloc(tracepoints, alloc_tracepoints * sizeof(*tracepoints));
+		if (!tracepoints)
+			return -1;
+	}
+
+	tracepoints[n_tracepoints++] = tracepoint;
+	return 0;
+}
+
+static int convert(const char *path)
+{
+	struct hybris_trace_file_header header;
+	uint64_t last_timestamp = 0, word_mask = UINT64_MAX;
+	size_t size, offset;
+	char *data;
+	long len;
+	FILE *f;
+
+	f = fopen(path, "rb");
+	if (!f) {
+		perror(path);
+		return -1;
+	}
+
+	if (fseek(f, 0, SEEK_END) != 0 || (len = ftell(f)) < 0 || fseek(f, 0, SEEK_SET) != 0) {
+		perror(path);
+		fclose(f);
+		return -1;
+	}
+
+	size = len;
+	/* the strings of the tracepoints stay in here */
+	data = malloc(size + 1);
+	if (!data || fread(data, 1, size, f) != size) {
+		fprintf(stderr, "%s: read error\n", path);
+		fclose(f);
+		return -1;
+	}
+	fclose(f);
+
+	if (size < sizeof(header) || memcmp(data, HYBRIS_TRACE_MAGIC, sizeof(header.magic)) != 0) {
+		fprintf(stderr, "%s: not a hybris trace\n", path);
+		return -1;
+	}
+	memcpy(&header, data, sizeof(header));
+	if (header.word_size > 0 && header.word_size < sizeof(uint64_t))
+		word_mask = (UINT64_C(1) << (8 * header.word_size)) - 1;
+
+	/* tracepoint ids are addresses in the traced process */
+	n_tracepoints = 0;
+
+	for (offset = sizeof(header); offset + sizeof(struct hybris_trace_record_header) <= size;) {
+		struct hybris_trace_record_header record;
+		const char *payload = data + offset + sizeof(record);
+
+		memcpy(&record, data + offset, sizeof(record));
+		if (record.size < sizeof(record) || record.size > size - offset) {
+			/* the process died while the drainer was writing */
+			fprintf(stderr, "%s: truncated at offset %zu\n", path, offset);
+			break;
+		}
+
+		switch (record.type) {
+		case HYBRIS_TRACE_RECORD_TRACEPOINT:
+			if (add_tracepoint(payload, record.size - sizeof(record)) < 0)
+				fprintf(stderr, "%s: bad tracepoint at offset %zu\n", path, offset);
+			break;
+		case HYBRIS_TRACE_RECORD_EVENT:
+			if (record.size >= sizeof(struct hybris_trace_event)) {
+				struct hybris_trace_event event;
+
+				memcpy(&event, data + offset, sizeof(event));
+				print_event(header.pid, word_mask, &event);
+				last_timestamp = event.timestamp;
+			}
+			break;
+		case HYBRIS_TRACE_RECORD_DROPPED:
+			if (record.size >= sizeof(record) + 2 * sizeof(uint32_t)) {
+				uint32_t dropped[2];
+
+				memcpy(dropped, payload, sizeof(dropped));
+				print_dropped(header.pid, dropped[0], dropped[1], last_timestamp);
+			}
+			break;
+		default:
+			/* skip records of newer versions */
+			break;
+		}
+
+		offset += record.size;
+	}
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	int ret = 0;
+	int i;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: hybris-trace2json <trace file>... > trace.json\n");
+		return 1;
+	}
+
+	printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+	for (i = 1; i < argc; i++) {
+		if (convert(argv[i]) < 0)
+			ret = 1;
+	}
+
+	printf("\n]}\n");
+
+	return ret;
+}
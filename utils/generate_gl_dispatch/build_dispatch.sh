@@ -0,0 +1,8 @@
+#!/bin/sh
+HYBRIS=../../hybris
+python generate_dispatch.py glesv1_cm_symbols $HYBRIS/include/GLES/gl.h $HYBRIS/include/GLES/glext.h \
+	> $HYBRIS/glesv1/glesv1_cm_functions.h
+python generate_dispatch.py glesv2_symbols $HYBRIS/include/GLES2/gl2.h $HYBRIS/include/GLES2/gl2ext.h \
+	> $HYBRIS/glesv2/glesv2_functions.h
+python generate_dispatch.py glesv3_symbols $HYBRIS/include/GLES3/gl31.h $HYBRIS/include/GLES2/gl2ext.h \
+	> $HYBRIS/glesv3/glesv3_functions.h
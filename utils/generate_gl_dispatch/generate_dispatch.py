@@ -0,0 +1,170 @@
+#!/usr/bin/python
+# generate_dispatch.py: Build the list of entry points of a GLES wrapper
+# library from a symbol list and the Khronos headers or registry (gl.xml)
+#
+# Copyright (c) 2016 The libhybris authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# The output has a HYBRIS_GL_FUNCTION line per symbol, in the order of
+# the symbol list, which hybris/include/hybris/internal/gl_dispatch.h
+# turns into the dispatch pointers, trampolines and wrappers:
+#
+#   HYBRIS_GL_FUNCTION(name, return type, (parameters), (arguments), return, float)
+#
+# "return" is empty for functions returning void and float is 1 for
+# functions which take floating point arguments by value, or "own" for
+# functions whose entry point the library writes itself.
+#
+# A line of the symbol list is a function name or the name of a version
+# or extension, e.g. GL_ES_VERSION_3_0 or GL_OES_EGL_image, which stands
+# for all its functions. Versions and extensions are taken from the
+# <feature> and <extension> elements of gl.xml, or from the
+# "#ifndef GL_ES_VERSION_3_0 / #define GL_ES_VERSION_3_0 1" blocks of the
+# headers generated from it. A function name can be followed by "own"
+# for an entry point written by hand, e.g. to change what it returns.
+
+from __future__ import print_function
+
+import re
+import sys
+import xml.etree.ElementTree as ElementTree
+
+PROTOTYPE = re.compile(r'^\s*GL_API(?:CALL)?\s+(.+?)\s*GL_APIENTRY\s+([A-Za-z0-9_]+)\s*\((.*)\)\s*;')
+BLOCK_BEGIN = re.compile(r'^#define\s+(GL_[A-Za-z0-9_]+)\s+1\s*$')
+BLOCK_END = re.compile(r'^#endif\s*/\*\s*(GL_[A-Za-z0-9_]+)\s*\*/')
+
+FLOAT_TYPES = ('GLfloat', 'GLclampf')
+
+
+def clean_type(type_):
+    # "const GLvoid* *" -> "const GLvoid **"
+    type_ = re.sub(r'\s*\*\s*', '*', ' '.join(type_.split()))
+    return re.sub(r'(?<=[A-Za-z0-9_])\*', ' *', type_)
+
+
+class Function:
+    def __init__(self, retval, name, params):
+        self.retval = clean_type(retval)
+        self.name = name
+        self.params = []
+        self.args = []
+        self.has_float = False
+        self.own = False
+
+        params = ' '.join(params.split())
+        if params in ('', 'void'):
+            return
+
+        for n, param in enumerate(params.split(',')):
+            param = param.strip()
+            match = re.match(r'^(.*[\s*])([A-Za-z0-9_]+)\s*(\[[0-9]*\])?$', param)
+            if match and match.group(1).strip() not in ('', 'const'):
+                type_, arg, array = match.group(1).strip(), match.group(2), match.group(3)
+            else:
+                # No parameter name in the prototype
+                type_, arg, array = param, 'a%d' % (n + 1), None
+            type_ = clean_type(type_)
+            if type_.replace('const', '').strip() in FLOAT_TYPES and not array:
+                self.has_float = True
+            if not type_.endswith('*'):
+                type_ += ' '
+            self.params.append(type_ + arg + (array or ''))
+            self.args.append(arg)
+
+    def line(self):
+        return 'HYBRIS_GL_FUNCTION(%s, %s, (%s), (%s), %s, %s)' % (
+                self.name, self.retval, ', '.join(self.params) or 'void',
+                ', '.join(self.args), '' if self.retval == 'void' else 'return',
+                'own' if self.own else 1 if self.has_float else 0)
+
+
+def read_header(path, prototypes, features):
+    block, previous = None, None
+    for line in open(path):
+        match = BLOCK_BEGIN.match(line)
+        if match and previous.split() == ['#ifndef', match.group(1)]:
+            block = match.group(1)
+            features.setdefault(block, [])
+        match = BLOCK_END.match(line)
+        if match and match.group(1) == block:
+            block = None
+        match = PROTOTYPE.match(line)
+        if match:
+            if match.group(2) not in prototypes:
+                prototypes[match.group(2)] = Function(*match.groups())
+            if block:
+                features[block].append(match.group(2))
+        previous = line
+
+
+def read_registry(path, prototypes, features):
+    registry = ElementTree.parse(path).getroot()
+    for command in registry.iter('command'):
+        proto = command.find('proto')
+        if proto is None:
+            # a <command name="..."/> of a <require>
+            continue
+        name = proto.find('name').text
+        if name not in prototypes:
+            retval = ''.join(proto.itertext())[:-len(name)]
+            params = ', '.join(''.join(param.itertext()) for param in command.findall('param'))
+            prototypes[name] = Function(retval, name, params)
+    for feature in list(registry.iter('feature')) + list(registry.iter('extension')):
+        names = features.setdefault(feature.get('name'), [])
+        for require in feature.findall('require'):
+            names.extend(command.get('name') for command in require.findall('command'))
+
+
+def main(argv):
+    if len(argv) < 3:
+        print('Usage: %s <symbol list> <header or gl.xml>...' % argv[0], file=sys.stderr)
+        return 1
+
+    prototypes, features = {}, {}
+    for path in argv[2:]:
+        if path.endswith('.xml'):
+            read_registry(path, prototypes, features)
+        else:
+            read_header(path, prototypes, features)
+
+    functions, seen = [], set()
+    for symbol in open(argv[1]):
+        symbol = symbol.split('#')[0].split()
+        if not symbol:
+            continue
+        own = symbol[1:] == ['own']
+        if symbol[1:] and (not own or symbol[0] in features):
+            print('%s: bad line in %s: %s' % (argv[0], argv[1], ' '.join(symbol)), file=sys.stderr)
+            return 1
+        symbol = symbol[0]
+        for name in features.get(symbol, [symbol]):
+            if name in seen:
+                continue
+            if name not in prototypes:
+                print('%s: no prototype for %s' % (argv[0], name), file=sys.stderr)
+                return 1
+            seen.add(name)
+            prototypes[name].own = own
+            functions.append(prototypes[name])
+
+    print('/* Generated by utils/generate_gl_dispatch/generate_dispatch.py from %s, do not edit */'
+          % argv[1].split('/')[-1])
+    print()
+    for function in functions:
+        print(function.line())
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
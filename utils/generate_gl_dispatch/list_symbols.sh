@@ -0,0 +1,6 @@
+#!/bin/sh
+# List symbols in shared object, e.g. list_symbols.sh /system/lib/libGLESv2.so
+
+LIBRARY=${1:-/system/lib/libGLESv1_CM.so}
+
+objdump -T $LIBRARY | grep 'DF .text' | awk '{ print $6 }'
@@ -1,5 +0,0 @@
-
-#define GL_GLEXT_PROTOTYPES
-#include <GLES/gl.h>
-#include <GLES/glext.h>
-